@@ -0,0 +1,311 @@
+/*
+ * Shared pieces of the GlyphGL benchmarks: an in-memory synthetic TrueType
+ * font, a best-of-N timing harness and the JSON report.
+ */
+
+#ifndef GLYPH_BENCH_COMMON_H
+#define GLYPH_BENCH_COMMON_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/* ---- Synthetic TrueType font ---------------------------------------------------------- */
+
+struct FontWriter {
+    std::vector<unsigned char> bytes;
+    void u8(int v) { bytes.push_back((unsigned char)v); }
+    void u16(int v) { u8((v >> 8) & 0xFF); u8(v & 0xFF); }
+    void u32(uint32_t v) { u16((int)(v >> 16)); u16((int)(v & 0xFFFF)); }
+    void pad4() { while (bytes.size() % 4) u8(0); }
+};
+
+struct CmapRange {
+    int first, last;
+};
+
+/* Codepoint ranges of the synthetic font: ASCII, Latin-1, Greek and Cyrillic */
+static const CmapRange kRanges[] = {{0x20, 0x7E}, {0xA0, 0xFF}, {0x391, 0x3C9}, {0x410, 0x44F}};
+static const int kNumRanges = sizeof(kRanges) / sizeof(kRanges[0]);
+static const int kUnitsPerEm = 1000;
+static const int kAdvance = 600;
+
+struct Point {
+    int x, y, on;
+};
+
+/*
+ * Outline of glyph 'g': a closed curve of alternating on/off-curve points
+ * (2 * (3 + g % 5) points), a square counter on every third glyph and a
+ * separate dot on every fourth. Glyph 0 is the .notdef box.
+ */
+static inline std::vector<std::vector<Point> > glyph_outline(int g) {
+    std::vector<std::vector<Point> > contours;
+    if (g == 0) {
+        Point outer[] = {{50, 0, 1}, {50, 700, 1}, {550, 700, 1}, {550, 0, 1}};
+        Point inner[] = {{100, 50, 1}, {500, 50, 1}, {500, 650, 1}, {100, 650, 1}};
+        contours.push_back(std::vector<Point>(outer, outer + 4));
+        contours.push_back(std::vector<Point>(inner, inner + 4));
+        return contours;
+    }
+    int corners = 3 + g % 5;
+    int cx = 300, cy = 300 + (g % 7) * 20;
+    int radius = 220 + (g % 11) * 8;
+    std::vector<Point> outer;
+    for (int i = 0; i < corners * 2; i++) {
+        /* Clockwise, with off-curve points pushed outwards to form bulges */
+        double angle = -6.283185307179586 * i / (corners * 2);
+        double r = (i & 1) ? radius * 1.25 : radius;
+        Point p = {cx + (int)(r * cos(angle)), cy + (int)(r * sin(angle)), (i & 1) ? 0 : 1};
+        outer.push_back(p);
+    }
+    contours.push_back(outer);
+    if (g % 3 == 0) {
+        Point inner[] = {{cx - 80, cy - 80, 1}, {cx + 80, cy - 80, 1}, {cx + 80, cy + 80, 1}, {cx - 80, cy + 80, 1}};
+        contours.push_back(std::vector<Point>(inner, inner + 4));
+    }
+    if (g % 4 == 1) {
+        Point dot[] = {{260, 640, 1}, {260, 720, 1}, {340, 720, 1}, {340, 640, 1}};
+        contours.push_back(std::vector<Point>(dot, dot + 4));
+    }
+    return contours;
+}
+
+static inline void write_glyph(FontWriter& w, const std::vector<std::vector<Point> >& contours) {
+    int x_min = 32767, y_min = 32767, x_max = -32768, y_max = -32768;
+    for (size_t c = 0; c < contours.size(); c++) {
+        for (size_t i = 0; i < contours[c].size(); i++) {
+            const Point& p = contours[c][i];
+            x_min = std::min(x_min, p.x); x_max = std::max(x_max, p.x);
+            y_min = std::min(y_min, p.y); y_max = std::max(y_max, p.y);
+        }
+    }
+    w.u16((int)contours.size());
+    w.u16(x_min); w.u16(y_min); w.u16(x_max); w.u16(y_max);
+    int end = -1;
+    for (size_t c = 0; c < contours.size(); c++) {
+        end += (int)contours[c].size();
+        w.u16(end);
+    }
+    w.u16(0); /* No instructions */
+    /* Flags: on-curve bit only, so both coordinates are int16 deltas */
+    for (size_t c = 0; c < contours.size(); c++)
+        for (size_t i = 0; i < contours[c].size(); i++) w.u8(contours[c][i].on ? 1 : 0);
+    int prev = 0;
+    for (size_t c = 0; c < contours.size(); c++)
+        for (size_t i = 0; i < contours[c].size(); i++) { w.u16(contours[c][i].x - prev); prev = contours[c][i].x; }
+    prev = 0;
+    for (size_t c = 0; c < contours.size(); c++)
+        for (size_t i = 0; i < contours[c].size(); i++) { w.u16(contours[c][i].y - prev); prev = contours[c][i].y; }
+    while (w.bytes.size() % 4) w.u8(0);
+}
+
+/* Builds a TrueType font with cmap (format 4), glyf, head, hhea, hmtx, loca and maxp tables */
+static inline std::vector<unsigned char> build_synthetic_font() {
+    int num_glyphs = 1;
+    for (int r = 0; r < kNumRanges; r++) num_glyphs += kRanges[r].last - kRanges[r].first + 1;
+
+    /* glyf + loca (long offsets); the space is an empty glyph */
+    FontWriter glyf, loca;
+    loca.u32(0);
+    write_glyph(glyf, glyph_outline(0));
+    loca.u32((uint32_t)glyf.bytes.size());
+    int g = 1;
+    for (int r = 0; r < kNumRanges; r++) {
+        for (int cp = kRanges[r].first; cp <= kRanges[r].last; cp++, g++) {
+            if (cp != ' ') write_glyph(glyf, glyph_outline(g));
+            loca.u32((uint32_t)glyf.bytes.size());
+        }
+    }
+
+    FontWriter cmap;
+    int seg_count = kNumRanges + 1;
+    cmap.u16(0); cmap.u16(1);                 /* version, one encoding record */
+    cmap.u16(3); cmap.u16(1); cmap.u32(12);   /* Windows Unicode BMP */
+    cmap.u16(4); cmap.u16(16 + seg_count * 8); cmap.u16(0);
+    cmap.u16(seg_count * 2);
+    int search = 1, selector = 0;
+    while (search * 2 <= seg_count) { search *= 2; selector++; }
+    cmap.u16(search * 2); cmap.u16(selector); cmap.u16(seg_count * 2 - search * 2);
+    for (int r = 0; r < kNumRanges; r++) cmap.u16(kRanges[r].last);
+    cmap.u16(0xFFFF);
+    cmap.u16(0);                              /* reservedPad */
+    for (int r = 0; r < kNumRanges; r++) cmap.u16(kRanges[r].first);
+    cmap.u16(0xFFFF);
+    g = 1;
+    for (int r = 0; r < kNumRanges; r++) {
+        cmap.u16((g - kRanges[r].first) & 0xFFFF);
+        g += kRanges[r].last - kRanges[r].first + 1;
+    }
+    cmap.u16(1);
+    for (int r = 0; r <= kNumRanges; r++) cmap.u16(0);
+
+    FontWriter head;
+    head.u32(0x00010000); head.u32(0x00010000); head.u32(0); head.u32(0x5F0F3CF5);
+    head.u16(0); head.u16(kUnitsPerEm);
+    head.u32(0); head.u32(0); head.u32(0); head.u32(0);
+    head.u16(0); head.u16(-300); head.u16(kAdvance); head.u16(1000);
+    head.u16(0); head.u16(8); head.u16(2);
+    head.u16(1);                              /* indexToLocFormat: long */
+    head.u16(0);
+
+    FontWriter hhea;
+    hhea.u32(0x00010000);
+    hhea.u16(800); hhea.u16(-200 & 0xFFFF); hhea.u16(100);
+    hhea.u16(kAdvance); hhea.u16(0); hhea.u16(0); hhea.u16(kAdvance);
+    hhea.u16(1); hhea.u16(0); hhea.u16(0);
+    for (int i = 0; i < 5; i++) hhea.u16(0);
+    hhea.u16(num_glyphs);                     /* numberOfHMetrics */
+
+    FontWriter hmtx;
+    for (int i = 0; i < num_glyphs; i++) { hmtx.u16(kAdvance); hmtx.u16(50); }
+
+    FontWriter maxp;
+    maxp.u32(0x00005000); maxp.u16(num_glyphs);
+
+    struct Table { const char* tag; std::vector<unsigned char>* data; };
+    Table tables[] = {{"cmap", &cmap.bytes}, {"glyf", &glyf.bytes}, {"head", &head.bytes}, {"hhea", &hhea.bytes},
+                      {"hmtx", &hmtx.bytes}, {"loca", &loca.bytes}, {"maxp", &maxp.bytes}};
+    const int num_tables = sizeof(tables) / sizeof(tables[0]);
+
+    FontWriter font;
+    font.u32(0x00010000); font.u16(num_tables);
+    font.u16(64); font.u16(2); font.u16(num_tables * 16 - 64);
+    uint32_t offset = 12 + 16 * num_tables;
+    for (int t = 0; t < num_tables; t++) {
+        uint32_t sum = 0;
+        std::vector<unsigned char> padded = *tables[t].data;
+        while (padded.size() % 4) padded.push_back(0);
+        for (size_t i = 0; i < padded.size(); i += 4)
+            sum += ((uint32_t)padded[i] << 24) | (padded[i + 1] << 16) | (padded[i + 2] << 8) | padded[i + 3];
+        for (int i = 0; i < 4; i++) font.u8(tables[t].tag[i]);
+        font.u32(sum); font.u32(offset); font.u32((uint32_t)tables[t].data->size());
+        offset += (uint32_t)padded.size();
+    }
+    for (int t = 0; t < num_tables; t++) {
+        font.bytes.insert(font.bytes.end(), tables[t].data->begin(), tables[t].data->end());
+        font.pad4();
+    }
+    return font.bytes;
+}
+
+/* ---- Harness ---------------------------------------------------------------------------- */
+
+struct Result {
+    std::string name;
+    double ns_per_op;
+    double ops;
+    const char* unit;
+    int reps;
+};
+
+static std::vector<Result> g_results;
+
+static inline double now_ns() {
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+ * Runs fn() (which performs 'ops' operations of 'unit') after one warm-up
+ * call until 0.5 s have passed or 50 repetitions are done, keeping the best.
+ */
+template <typename F>
+static inline void bench(const std::string& name, double ops, const char* unit, F fn) {
+    fn();
+    double best = 1e300, total = 0.0;
+    int reps = 0;
+    while ((total < 0.5e9 || reps < 3) && reps < 50) {
+        double start = now_ns();
+        fn();
+        double elapsed = now_ns() - start;
+        total += elapsed;
+        if (elapsed < best) best = elapsed;
+        reps++;
+    }
+    Result r = {name, best / ops, ops, unit, reps};
+    g_results.push_back(r);
+    fprintf(stderr, "%-28s %12.1f ns/%s\n", name.c_str(), r.ns_per_op, unit);
+}
+
+static inline void record(const std::string& name, double ns_per_op, double ops, const char* unit) {
+    Result r = {name, ns_per_op, ops, unit, 1};
+    g_results.push_back(r);
+    fprintf(stderr, "%-28s %12.1f ns/%s\n", name.c_str(), ns_per_op, unit);
+}
+
+struct Counter {
+    std::string name;
+    double value;
+    const char* unit;
+};
+
+static std::vector<Counter> g_counters;
+
+/* Records a non-timing figure, e.g. GL calls per frame */
+static inline void record_counter(const std::string& name, double value, const char* unit) {
+    Counter c = {name, value, unit};
+    g_counters.push_back(c);
+    fprintf(stderr, "%-28s %12.1f %s\n", name.c_str(), value, unit);
+}
+
+static volatile size_t g_sink; /* Keeps results alive so loops are not optimized away */
+
+/* Returns: Every character of the synthetic font as UTF-8, for atlas charsets */
+static inline std::string synthetic_charset() {
+    std::string charset;
+    for (int r = 0; r < kNumRanges; r++) {
+        for (int cp = kRanges[r].first; cp <= kRanges[r].last; cp++) {
+            if (cp < 0x80) {
+                charset += (char)cp;
+            } else {
+                charset += (char)(0xC0 | (cp >> 6));
+                charset += (char)(0x80 | (cp & 0x3F));
+            }
+        }
+    }
+    return charset;
+}
+
+/* Writes the synthetic font to 'path' for APIs that load fonts from files */
+static inline bool write_synthetic_font(const char* path) {
+    std::vector<unsigned char> data = build_synthetic_font();
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+    return fclose(f) == 0 && ok;
+}
+
+/* Prints the results as JSON and, if a path was given, writes them there too */
+static inline int write_results(int argc, char** argv) {
+    std::string json = "{\n  \"library\": \"GlyphGL\",\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < g_results.size(); i++) {
+        char entry[256];
+        snprintf(entry, sizeof(entry), "    {\"name\": \"%s\", \"ns_per_op\": %.3f, \"unit\": \"%s\", \"ops\": %.0f, \"reps\": %d}%s\n",
+                 g_results[i].name.c_str(), g_results[i].ns_per_op, g_results[i].unit, g_results[i].ops, g_results[i].reps,
+                 i + 1 < g_results.size() ? "," : "");
+        json += entry;
+    }
+    json += "  ],\n  \"counters\": [\n";
+    for (size_t i = 0; i < g_counters.size(); i++) {
+        char entry[256];
+        snprintf(entry, sizeof(entry), "    {\"name\": \"%s\", \"value\": %.3f, \"unit\": \"%s\"}%s\n",
+                 g_counters[i].name.c_str(), g_counters[i].value, g_counters[i].unit, i + 1 < g_counters.size() ? "," : "");
+        json += entry;
+    }
+    json += "  ]\n}\n";
+    fputs(json.c_str(), stdout);
+    if (argc > 1) {
+        FILE* out = fopen(argv[1], "w");
+        if (!out) return 1;
+        fputs(json.c_str(), out);
+        fclose(out);
+    }
+    return 0;
+}
+
+#endif
@@ -0,0 +1,157 @@
+/*
+ * GlyphGL headless benchmarks
+ *
+ * Measures the CPU side of the library without a GPU, a window or any font
+ * files: the font is generated in memory (see build_synthetic_font) with
+ * known outlines, so results only change when the library does.
+ *
+ * Build:  g++ -O2 -std=c++11 -I.. glyph_bench.cpp -o glyph_bench
+ * Run:    ./glyph_bench [results.json]
+ *
+ * Results are printed as JSON (and written to the given file) with the best
+ * time per operation of several repetitions, for comparison across versions.
+ */
+
+#define GLYPHGL_STATS
+#include <glyph_atlas.h>
+#include <glyph_emit.h>
+#include <glyph_image.h>
+#include <glyph_soft.h>
+
+#include "bench_common.h"
+
+/* ---- Benchmarks ------------------------------------------------------------------------- */
+
+int main(int argc, char** argv) {
+    std::vector<unsigned char> font_data = build_synthetic_font();
+    glyph_font_t font;
+    if (!glyph_ttf_init(&font, font_data.data(), 0)) {
+        fprintf(stderr, "synthetic font rejected\n");
+        return 1;
+    }
+
+    std::vector<int> codepoints;
+    for (int r = 0; r < kNumRanges; r++)
+        for (int cp = kRanges[r].first; cp <= kRanges[r].last; cp++) codepoints.push_back(cp);
+
+    bench("cmap_lookup", (double)codepoints.size() * 100, "lookup", [&] {
+        size_t sum = 0;
+        for (int i = 0; i < 100; i++)
+            for (size_t c = 0; c < codepoints.size(); c++) sum += glyph_ttf_find_glyph_index(&font, codepoints[c]);
+        g_sink = sum;
+    });
+
+    const float sizes[] = {12.0f, 24.0f, 48.0f, 96.0f};
+    for (int s = 0; s < 4; s++) {
+        float scale = glyph_ttf_scale_for_pixel_height(&font, sizes[s]);
+        bench("rasterize_" + std::to_string((int)sizes[s]) + "px", (double)font.numGlyphs, "glyph", [&] {
+            for (int g = 0; g < font.numGlyphs; g++) {
+                int w, h, xoff, yoff;
+                unsigned char* bitmap = glyph_ttf_get_glyph_bitmap(&font, g, scale, scale, &w, &h, &xoff, &yoff);
+                glyph_ttf_free_bitmap(bitmap);
+            }
+        });
+    }
+
+    {
+        float scale = glyph_ttf_scale_for_pixel_height(&font, 48.0f);
+        std::vector<unsigned char*> bitmaps;
+        std::vector<int> widths, heights;
+        for (int g = 1; g < font.numGlyphs; g++) {
+            int w, h, xoff, yoff;
+            unsigned char* bitmap = glyph_ttf_get_glyph_bitmap(&font, g, scale, scale, &w, &h, &xoff, &yoff);
+            if (!bitmap) continue;
+            bitmaps.push_back(bitmap);
+            widths.push_back(w);
+            heights.push_back(h);
+        }
+        bench("sdf_48px", (double)bitmaps.size(), "glyph", [&] {
+            for (size_t i = 0; i < bitmaps.size(); i++)
+                glyph_ttf_free_bitmap(glyph_ttf_get_glyph_sdf_bitmap(bitmaps[i], widths[i], heights[i], 4));
+        });
+        for (size_t i = 0; i < bitmaps.size(); i++) glyph_ttf_free_bitmap(bitmaps[i]);
+    }
+
+    /* The atlas loads its font from a file */
+    const char* font_path = "glyph_bench_synthetic.ttf";
+    if (!write_synthetic_font(font_path)) return 1;
+
+    std::string charset = synthetic_charset();
+
+    double pack_ns = 1e300;
+    bench("atlas_create_32px", (double)codepoints.size(), "glyph", [&] {
+        glyph_atlas_t atlas = glyph_atlas_create(font_path, 32.0f, charset.c_str(), GLYPH_UTF8, 0);
+        glyph_stats_t stats = glyph_atlas_get_stats(&atlas);
+        if (stats.pack_ns < pack_ns) pack_ns = (double)stats.pack_ns;
+        glyph_atlas_free(&atlas);
+    });
+    record("atlas_pack_32px", pack_ns / codepoints.size(), (double)codepoints.size(), "glyph");
+
+    glyph_atlas_t atlas = glyph_atlas_create(font_path, 32.0f, charset.c_str(), GLYPH_UTF8, 0);
+    glyph_soft_renderer_t soft = glyph_soft_renderer_create(font_path, 32.0f, charset.c_str(), GLYPH_UTF8, 0);
+    remove(font_path);
+    if (!atlas.chars || !soft.initialized) {
+        fprintf(stderr, "atlas creation failed\n");
+        return 1;
+    }
+
+    std::string text;
+    while (text.size() < (1 << 20)) text += "The quick brown fox jumps over the lazy dog. \xCE\x91\xCE\xB2\xCE\xB3 \xD0\x96\xD0\xB8\xD0\xB7\xD0\xBD\xD1\x8C \xC3\xA9t\xC3\xA9. ";
+    bench("utf8_decode", (double)text.size(), "byte", [&] {
+        size_t index = 0, sum = 0;
+        while (index < text.size()) sum += glyph_atlas_utf8_decode_len(text.c_str(), text.size(), &index);
+        g_sink = sum;
+    });
+
+    std::string line = text.substr(0, 4096);
+    std::vector<glyph_quad_t> quads(line.size() * GLYPH_EMIT_MAX_QUADS);
+    size_t line_quads = glyph_emit_text_quads(&atlas, line.c_str(), line.size(), 0.0f, 32.0f, 1.0f, NULL, quads.data(), quads.size());
+    bench("emit_quads", (double)line_quads, "quad", [&] {
+        g_sink = glyph_emit_text_quads(&atlas, line.c_str(), line.size(), 0.0f, 32.0f, 1.0f, NULL, quads.data(), quads.size());
+    });
+
+    /* Software rendering of a 1280x720 RGBA frame of text, 20 lines of 60 glyphs */
+    {
+        std::vector<unsigned char> frame((size_t)1280 * 720 * 4, 0x20);
+        glyph_surface_t surface = glyph_surface_create(frame.data(), 1280, 720, 0, 4);
+        std::string sentence = "The quick brown fox jumps over the lazy dog. 0123456789 ";
+        std::vector<std::string> lines;
+        for (int i = 0; i < 20; i++) lines.push_back((sentence + sentence).substr(i % sentence.size(), 60));
+        size_t frame_glyphs = 0;
+        for (int i = 0; i < 20; i++)
+            frame_glyphs += (size_t)glyph_soft_renderer_draw_text(&soft, &surface, lines[i].c_str(), 8.0f, 32.0f + i * 34.0f, 1.0f,
+                                                                   0.9f, 0.9f, 0.8f, 0);
+        bench("soft_render_frame", (double)frame_glyphs, "glyph", [&] {
+            for (int i = 0; i < 20; i++)
+                glyph_soft_renderer_draw_text(&soft, &surface, lines[i].c_str(), 8.0f, 32.0f + i * 34.0f, 1.0f, 0.9f, 0.9f, 0.8f, 0);
+            g_sink = frame[0];
+        });
+        record_counter("soft_render_glyphs_per_sec", 1e9 / g_results.back().ns_per_op, "glyph/s");
+    }
+    glyph_soft_renderer_free(&soft);
+
+    /* Checksums over the atlas pixels: the dispatched entry points and the portable kernels */
+    const unsigned char* pixels = atlas.image.data;
+    size_t pixel_bytes = (size_t)atlas.image.width * atlas.image.height * 3;
+    bench("crc32", (double)pixel_bytes, "byte", [&] { g_sink = glyph__crc32_update(0, pixels, pixel_bytes); });
+    bench("crc32_slice8", (double)pixel_bytes, "byte", [&] { g_sink = glyph__crc32_slice8(0, pixels, pixel_bytes); });
+    bench("adler32", (double)pixel_bytes, "byte", [&] { g_sink = glyph__adler32_update(1, pixels, pixel_bytes); });
+    bench("adler32_scalar", (double)pixel_bytes, "byte", [&] { g_sink = glyph__adler32_scalar(1, pixels, pixel_bytes); });
+
+    /* BC4 compression of the coverage plane, as glyph_renderer_create uploads it with GLYPHGL_BC4 */
+    std::vector<unsigned char> coverage((size_t)atlas.image.width * atlas.image.height);
+    for (size_t i = 0; i < coverage.size(); i++) coverage[i] = pixels[i * 3];
+    std::vector<unsigned char> blocks(glyph_image_bc4_size(atlas.image.width, atlas.image.height));
+    bench("bc4_encode_atlas", (double)coverage.size(), "pixel", [&] {
+        glyph_image_encode_bc4(coverage.data(), atlas.image.width, atlas.image.height, blocks.data());
+        g_sink = blocks[0];
+    });
+
+    const char* png_path = "glyph_bench_atlas.png";
+    double png_bytes = (double)atlas.image.width * atlas.image.height * 3;
+    bench("png_encode_atlas", png_bytes, "byte", [&] { g_sink = (size_t)glyph_write_png(png_path, &atlas.image); });
+    remove(png_path);
+    glyph_atlas_free(&atlas);
+
+    return write_results(argc, argv);
+}
@@ -0,0 +1,161 @@
+/*
+ * GlyphGL renderer stress benchmark
+ *
+ * Builds with GLYPHGL_GL_STUB, so every GL call lands in the recording stub
+ * instead of a driver: no GPU, display or libGL is needed and the measured
+ * time is the library's own CPU cost. Each frame draws 100k glyphs spread
+ * over 2000 strings with mixed effects and colors, in immediate mode, with
+ * the run cache and as one batch, and reports ns/glyph plus the GL calls,
+ * draws and uploaded bytes per frame recorded by the stub. A 300x100
+ * glyph_grid_t is redrawn in full and with one dirty row (target: under
+ * 1 ms per full frame).
+ *
+ * Build:  g++ -O2 -std=c++11 -I.. glyph_renderer_bench.cpp -o glyph_renderer_bench
+ * Run:    ./glyph_renderer_bench [results.json]
+ */
+
+#define GLYPHGL_GL_STUB
+#include <glyph.h>
+#include <glyph_grid.h>
+
+#include "bench_common.h"
+
+static const int kStrings = 2000;
+static const int kGlyphsPerString = 50;
+static const int kGridColumns = 300;
+static const int kGridRows = 100;
+
+struct Line {
+    std::string text;
+    float x, y;
+    float r, g, b;
+    int effects;
+};
+
+/* Deterministic strings of words from the synthetic font's ASCII, Latin-1 and Greek ranges */
+static std::vector<Line> build_scene() {
+    static const char* words[] = {"glyph", "atlas", "render", "quick", "brown", "fox", "\xC3\xA9t\xC3\xA9",
+                                  "\xCE\xB1\xCE\xB2\xCE\xB3", "Lorem", "ipsum", "42", "frame", "{text}", "na\xC3\xAFve"};
+    static const int effects[] = {0, GLYPHGL_BOLD, GLYPHGL_ITALIC, GLYPHGL_UNDERLINE, GLYPHGL_BOLD | GLYPHGL_ITALIC};
+    static const float colors[][3] = {{1.0f, 1.0f, 1.0f}, {1.0f, 0.4f, 0.3f}, {0.3f, 0.8f, 0.4f}, {0.4f, 0.6f, 1.0f}};
+    const int num_words = sizeof(words) / sizeof(words[0]);
+    std::vector<Line> lines;
+    uint32_t seed = 12345;
+    for (int i = 0; i < kStrings; i++) {
+        Line line;
+        int glyphs = 0;
+        while (glyphs < kGlyphsPerString) {
+            seed = seed * 1664525u + 1013904223u;
+            std::string word = words[(seed >> 16) % num_words];
+            size_t index = 0;
+            while (index < word.size() && glyphs < kGlyphsPerString) {
+                size_t start = index;
+                glyph_atlas_utf8_decode_len(word.c_str(), word.size(), &index);
+                line.text.append(word, start, index - start);
+                glyphs++;
+            }
+            if (glyphs < kGlyphsPerString) {
+                line.text += ' ';
+                glyphs++;
+            }
+        }
+        line.x = (float)(i % 4) * 200.0f;
+        line.y = 20.0f + (float)(i / 4 % 50) * 16.0f;
+        line.effects = effects[i % 5];
+        line.r = colors[i / 3 % 4][0];
+        line.g = colors[i / 3 % 4][1];
+        line.b = colors[i / 3 % 4][2];
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+static void draw_immediate(glyph_renderer_t* renderer, const std::vector<Line>& lines) {
+    glyph_renderer_begin_frame(renderer);
+    for (size_t i = 0; i < lines.size(); i++) {
+        const Line& l = lines[i];
+        glyph_renderer_draw_text(renderer, l.text.c_str(), l.x, l.y, 0.5f, l.r, l.g, l.b, l.effects);
+    }
+}
+
+static void draw_batched(glyph_renderer_t* renderer, const std::vector<Line>& lines) {
+    glyph_renderer_begin_frame(renderer);
+    glyph_renderer_begin_batch(renderer);
+    for (size_t i = 0; i < lines.size(); i++) {
+        const Line& l = lines[i];
+        glyph_renderer_batch_text(renderer, l.text.c_str(), l.x, l.y, 0.5f, l.effects, NULL);
+    }
+    glyph_renderer_end_batch(renderer, 1.0f, 1.0f, 1.0f, 0);
+}
+
+/* Rewrites 'rows' rows of the grid starting at 'first' and draws it */
+static void draw_grid(glyph_renderer_t* renderer, glyph_grid_t* grid, int first, int rows, int frame) {
+    for (int row = first; row < first + rows; row++) {
+        for (int column = 0; column < kGridColumns; column++) {
+            glyph_grid_set_cell(grid, column, row, 33 + (column + row + frame) % 90, GLYPH_RGBA(220, 220, 220, 255), 0);
+        }
+    }
+    glyph_renderer_draw_grid(renderer, grid, 0.0f, 0.0f, 0);
+}
+
+/* Records the stub's GL traffic for one frame of 'draw' */
+template <typename F>
+static void record_gl_frame(const std::string& name, F draw) {
+    draw();
+    glyph_gl_stub_reset_stats();
+    draw();
+    glyph_gl_stub_stats_t stats = glyph_gl_stub_get_stats();
+    record_counter(name + "_gl_calls", (double)stats.calls, "calls/frame");
+    record_counter(name + "_draw_calls", (double)stats.draw_calls, "draws/frame");
+    record_counter(name + "_state_changes", (double)stats.state_changes + stats.uniform_updates, "changes/frame");
+    record_counter(name + "_bytes_uploaded", (double)stats.bytes_uploaded, "bytes/frame");
+}
+
+int main(int argc, char** argv) {
+    const char* font_path = "glyph_renderer_bench.ttf";
+    if (!write_synthetic_font(font_path)) return 1;
+    std::string charset = synthetic_charset();
+
+    bench("renderer_create", 1.0, "renderer", [&] {
+        glyph_renderer_t renderer = glyph_renderer_create(font_path, 32.0f, charset.c_str(), GLYPH_UTF8, NULL, 0);
+        glyph_renderer_free(&renderer);
+    });
+
+    glyph_renderer_t renderer = glyph_renderer_create(font_path, 32.0f, charset.c_str(), GLYPH_UTF8, NULL, 0);
+    remove(font_path);
+    if (!renderer.initialized) {
+        fprintf(stderr, "renderer creation failed\n");
+        return 1;
+    }
+    glyph_renderer_set_projection(&renderer, 800, 800);
+
+    std::vector<Line> lines = build_scene();
+    const double glyphs = (double)kStrings * kGlyphsPerString;
+
+    bench("draw_text_100k", glyphs, "glyph", [&] { draw_immediate(&renderer, lines); });
+    record_gl_frame("draw_text_100k", [&] { draw_immediate(&renderer, lines); });
+
+    bench("batch_text_100k", glyphs, "glyph", [&] { draw_batched(&renderer, lines); });
+    record_gl_frame("batch_text_100k", [&] { draw_batched(&renderer, lines); });
+
+    /* Twice the strings drawn per frame, as glyph_renderer_enable_run_cache recommends */
+    glyph_renderer_enable_run_cache(&renderer, kStrings * 2);
+    bench("draw_text_100k_run_cache", glyphs, "glyph", [&] { draw_immediate(&renderer, lines); });
+    record_gl_frame("draw_text_100k_run_cache", [&] { draw_immediate(&renderer, lines); });
+    record_counter("draw_text_100k_run_cache_hit_rate", 100.0 * glyph_renderer_get_run_cache_stats(&renderer).hit_rate, "%");
+
+    glyph_grid_t grid = glyph_grid_create(&renderer, kGridColumns, kGridRows, 0.5f);
+    if (!grid.initialized) {
+        fprintf(stderr, "grid creation failed\n");
+        return 1;
+    }
+    int frame = 0;
+    bench("grid_300x100_full", 1.0, "frame", [&] { draw_grid(&renderer, &grid, 0, kGridRows, frame++); });
+    record_gl_frame("grid_300x100_full", [&] { draw_grid(&renderer, &grid, 0, kGridRows, frame++); });
+    bench("grid_300x100_one_row", 1.0, "frame", [&] { draw_grid(&renderer, &grid, frame % kGridRows, 1, frame); frame++; });
+    record_gl_frame("grid_300x100_one_row", [&] { draw_grid(&renderer, &grid, frame % kGridRows, 1, frame); frame++; });
+    glyph_grid_free(&grid);
+
+    glyph_renderer_free(&renderer);
+    return write_results(argc, argv);
+}
@@ -18,27 +18,29 @@ int main()
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+    /* A frame is everything from one loop iteration to the next: clearing,
+       drawing the text, swapping and event polling. The displayed average
+       covers the frames completed so far. */
     double totalFrameTime = 0.0;
     int frameCount = 0;
+    double frameStart = glfwGetTime();
 
     while(!glfwWindowShouldClose(window))
     {
-        double frameStart = glfwGetTime();
-
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
 
-        double frameEnd = glfwGetTime();
-        double frameTime = frameEnd - frameStart;
-        totalFrameTime += frameTime;
-        frameCount++;
-        double averageFrameTime = totalFrameTime / frameCount;
-
+        double averageFrameTime = frameCount > 0 ? totalFrameTime / frameCount : 0.0;
         std::string timerText = "Average frame time: " + std::to_string(averageFrameTime * 1000.0) + " ms";
         glyph_renderer_draw_text(&renderer, timerText.c_str(), 50.0f, 300.0f, 1.0f, 1.0f, 1.0f, 1.0f, GLYPHGL_SDF);
 
         glfwSwapBuffers(window);
         glfwPollEvents();
+
+        double frameEnd = glfwGetTime();
+        totalFrameTime += frameEnd - frameStart;
+        frameCount++;
+        frameStart = frameEnd;
     }
 
     glyph_renderer_free(&renderer);
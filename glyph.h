@@ -68,6 +68,64 @@
  * v1.0.9 | 2025-11-14
  * | - Provided detailed comments on every aspect of the GlyphGL.
  * | - Renamed variables for readability and consistancy.
+ * v1.1.0 | 2026-10-18
+ * | - Added opt-in glyph-run cache ('glyph_renderer_enable_run_cache') with LRU and frame aging ('glyph_renderer_begin_frame')
+ * | - Fixed vertex buffer growth mixing bytes and floats, GPU buffer now grows with the CPU buffer
+ * | - 'glyph_utf8_decode' no longer rescans the string per character or stalls on malformed input
+ * | - Added 'glyph_renderer_measure_text' backed by a word-width cache
+ * | - Atlas now stores hhea line metrics and 'kern' table pairs, kerning is applied when drawing
+ * | - Added 'glyph_layout.h': wrapping, alignment, tab stops and hard breaks into a reusable glyph array
+ * | - Added 'glyph_renderer_draw_layout' to draw a precomputed layout without re-shaping
+ * | - Added 'glyph_document_t' for incremental relayout of editable text and 'glyph_renderer_draw_document'
+ * |   which patches only the changed paragraphs in the GPU buffer
+ * | - Added 'glyph_text_hit_test', 'glyph_text_caret_rect', 'glyph_text_selection_rects' and
+ * |   'glyph_renderer_draw_layout_selection' (selection drawn in the same upload as the text)
+ * | - Fixed underline quads sampling the atlas instead of rendering solid
+ * | - Added 'glyph_line_index_t' and the virtualized 'glyph_text_view_t' ('glyph_renderer_draw_text_view')
+ * |   for very large buffers: only visible rows are emitted and rows are reused while scrolling
+ * | - Added glyph_grid.h: instanced monospace cell renderer ('glyph_grid_t', 'glyph_renderer_draw_grid')
+ * |   with per-row dirty tracking, for terminals and consoles
+ * | - 'glyph_atlas_find_char' now uses an ASCII table and a sorted codepoint index instead of a linear scan
+ * | - Added 'glyph_renderer_draw_text_clipped' and batches ('glyph_renderer_begin_batch', '_batch_text',
+ * |   '_batch_layout', '_end_batch'): glyphs outside a clip rectangle are culled before emission and
+ * |   glyphs crossing it are cropped on the CPU, so clipped panes share one draw call without glScissor
+ * | - Added glyph_emit.h: GL-free quad emission ('glyph_emit_text', 'glyph_emit_text_quads', 'glyph_emit_layout')
+ * |   for engines with their own batcher; the renderer now emits its vertices through the same functions
+ * | - Added glyph_soft.h: headless CPU renderer ('glyph_soft_renderer_draw_text', '_draw_layout') that
+ * |   blends glyph spans into RGB/RGBA pixel buffers without a GL context, with SSE2 span blending
+ * | - Added command lists ('glyph_command_list_t', 'glyph_command_list_text', '_layout') recorded on any
+ * |   thread without GL calls and drawn with 'glyph_renderer_submit'; atlas lookups now take a const atlas
+ * | - Library initialization is thread-safe: constant CRC32 table, once-guarded GL loader and shader
+ * |   sources, so atlases can be built and saved to PNG on several threads at once
+ * | - Added 'glyph_set_executor': glyph rasterization/SDF, PNG row filtering and document paragraph
+ * |   layout are split into tasks run by the host's job system (serial by default)
+ * | - Added 'glyph_allocator_t' with per-object callbacks and current/peak byte accounting per category
+ * |   (font, atlas, scratch, vertex, layout); pass it to the '_ex' font, atlas and renderer constructors;
+ * |   layouts, documents and text views use the allocator of their atlas or renderer
+ * | - Added GLYPHGL_STATS: 'glyph_renderer_get_stats' / 'glyph_atlas_get_stats' report nanosecond timers
+ * |   for font load, cmap lookup, rasterization, SDF, packing and upload plus per-frame draw counters
+ * | - Added GLYPHGL_TRACE: per-thread lock-free event rings around font loading, glyph rasterization/SDF,
+ * |   packing, texture upload and draws, dumped as Chrome trace JSON with 'glyph_trace_write_json'
+ * | - Added 'benchmarks/glyph_bench.cpp': headless JSON benchmarks on a generated font (no GPU or font files);
+ * |   the timer demo now measures whole frames instead of an empty interval
+ * | - Added GLYPHGL_GL_STUB: a recording no-op GL loader counting calls, draws, uploads and state changes
+ * |   ('glyph_gl_stub_get_stats'), used by the renderer stress benchmark to run without a GPU
+ * | - Added GLYPHGL_GPU_TIMERS: renderer draws and the atlas upload are wrapped in GL_TIME_ELAPSED queries,
+ * |   read back a few frames later without stalling and reported per effect type in 'glyph_stats_t'
+ * | - 'glyph_write_png' now compresses: LZ77 with hash chains, fixed/dynamic Huffman blocks and per-row
+ * |   None/Sub/Up/Paeth filter selection; chunk CRCs are computed in place without copying
+ * | - With an executor installed 'glyph_write_png' compresses row chunks in parallel (GLYPHGL_PNG_CHUNK_SIZE),
+ * |   joined by sync flushes into one zlib stream with combined Adler32
+ * | - Slice-by-8 CRC32 and block-deferred Adler32, with PCLMULQDQ CRC32 and SSSE3 Adler32 picked at runtime
+ * |   on x86 and ARMv8 CRC32 instructions when available (GLYPHGL_NO_SIMD for portable kernels only)
+ * | - Added sink writers ('glyph_write_func_t', 'glyph_write_png_to', 'glyph_write_png_pixels_to', 'glyph_write_bmp_to'):
+ * |   PNG rows are filtered and compressed in bounded groups and streamed out, with grayscale and RGBA output;
+ * |   BMP rows are written whole instead of per byte
+ * | - Optional atlas mip chain (GLYPHGL_MIP_LEVELS): 2x2 box-filtered levels with trilinear sampling and
+ * |   glyph padding sized for the last level; packed rows now account for baseline-aligned glyph extents
+ * | - BC4 atlas textures: GLYPHGL_BC4 in glyph_renderer_create uploads GL_COMPRESSED_RED_RGTC1 (half of GL_RED),
+ * |   encoded by 'glyph_image_encode_bc4' (SSE2 index search, bands on the executor); 'glyph_atlas_save_ktx' and
+ * |   'glyph_write_ktx_bc4_to' store the compressed blocks and mips as KTX
  * ========================================================
  */
 
@@ -108,6 +166,21 @@
 #ifndef GLYPHGL_VERTEX_BUFFER_SIZE
 #define GLYPHGL_VERTEX_BUFFER_SIZE 73728  /* Default vertex buffer size (vertices) */
 #endif
+#ifndef GLYPHGL_RUN_CACHE_SIZE
+#define GLYPHGL_RUN_CACHE_SIZE 256  /* Default number of cached glyph runs */
+#endif
+#ifndef GLYPHGL_RUN_CACHE_MAX_AGE
+#define GLYPHGL_RUN_CACHE_MAX_AGE 120  /* Frames a cached run may stay unused before eviction */
+#endif
+#ifndef GLYPHGL_WORD_CACHE_SIZE
+#define GLYPHGL_WORD_CACHE_SIZE 1024  /* Number of cached word widths used by glyph_renderer_measure_text */
+#endif
+#ifndef GLYPHGL_GPU_TIMER_FRAMES
+#define GLYPHGL_GPU_TIMER_FRAMES 4  /* GLYPHGL_GPU_TIMERS: query sets in flight; results are read this many frames minus one later */
+#endif
+#ifndef GLYPHGL_GPU_TIMER_QUERIES
+#define GLYPHGL_GPU_TIMER_QUERIES 1024  /* GLYPHGL_GPU_TIMERS: timed draws per frame, later draws are not timed */
+#endif
 
 
 #include <stdlib.h>
@@ -124,8 +197,14 @@
 #define GLYPHGL_ITALIC      (1 << 1)  /* Apply italic shear transformation to glyphs */
 #define GLYPHGL_UNDERLINE   (1 << 2)  /* Draw underline beneath text */
 #define GLYPHGL_SDF         (1 << 3)  /* Enable Signed Distance Field rendering for scalable text */
+#define GLYPHGL_BC4         (1 << 4)  /* glyph_renderer_create: keep the atlas texture BC4-compressed (GL_COMPRESSED_RED_RGTC1) */
+
+/* Texture coordinate the built-in shader renders at full coverage (underline, selection) */
+#define GLYPHGL_SOLID_UV    (-1.0f)
 
 #include "glyph_atlas.h"
+#include "glyph_layout.h"
+#include "glyph_emit.h"
 
 
 /*
@@ -142,6 +221,86 @@
  */
 static int glyph_utf8_decode(const char* str, size_t* index);
 
+/*
+ * Cached glyph run produced by a previous glyph_renderer_draw_text call
+ *
+ * Holds the emitted quads for one (text, scale, effects) combination with
+ * positions relative to the run origin, so a hit only needs a translation.
+ */
+typedef struct {
+    uint64_t hash;                    /* Hash of text bytes, scale and effects (0 = empty slot) */
+    char* text;                       /* Copy of the cached text, compared on lookup */
+    size_t text_len;                  /* Length of the cached text in bytes */
+    size_t text_capacity;             /* Allocated size of 'text' */
+    float scale;                      /* Scale the run was emitted with */
+    int effects;                      /* Effects bitmask the run was emitted with */
+    float* vertices;                  /* Origin-relative vertex data [x, y, u, v] */
+    size_t vertex_count;              /* Number of vertices in the run */
+    size_t capacity;                  /* Allocated size of 'vertices' (in floats) */
+    uint32_t last_used;               /* Frame index of the last hit */
+} glyph_run_cache_entry_t;
+
+/*
+ * Opt-in cache of emitted glyph runs for immediate-mode UIs
+ *
+ * Entries live in a set-associative table: the hash picks one aligned set of
+ * GLYPH__RUN_CACHE_WAYS consecutive entries. When a set is full
+ * the least recently used entry is replaced, and entries that were not used
+ * for GLYPHGL_RUN_CACHE_MAX_AGE frames are released by glyph_renderer_begin_frame.
+ */
+typedef struct {
+    glyph_run_cache_entry_t* entries; /* Entry table (NULL when the cache is disabled) */
+    int capacity;                     /* Number of entries in the table */
+    uint32_t frame;                   /* Current frame index */
+    uint64_t hits;                    /* Draws served from the cache */
+    uint64_t misses;                  /* Draws that had to emit glyphs */
+    uint64_t evictions;               /* Entries replaced or aged out */
+} glyph_run_cache_t;
+
+/* Entries per set of the run cache */
+#define GLYPH__RUN_CACHE_WAYS 8
+
+/*
+ * Run cache counters reported by glyph_renderer_get_run_cache_stats
+ */
+typedef struct {
+    uint64_t hits;                    /* Draws served from the cache */
+    uint64_t misses;                  /* Draws that had to emit glyphs */
+    uint64_t evictions;               /* Entries replaced or aged out */
+    int entries;                      /* Entries currently holding a run */
+    float hit_rate;                   /* hits / (hits + misses), 0 when unused */
+} glyph_run_cache_stats_t;
+
+/*
+ * Cached width of a word used by glyph_renderer_measure_text
+ *
+ * Widths are stored at scale 1.0 together with the first and last codepoint
+ * so kerning across word boundaries can still be applied. A lookup only hits
+ * when the stored word bytes match, not just the hash.
+ */
+typedef struct {
+    uint64_t hash;                    /* Hash of the word bytes (0 = empty slot) */
+    char* word;                       /* Copy of the word, compared on lookup */
+    size_t len;                       /* Length of the word in bytes */
+    size_t word_capacity;             /* Allocated size of 'word' */
+    float width;                      /* Advance width of the word at scale 1.0 */
+    int first, last;                  /* First and last codepoint of the word */
+} glyph_word_cache_entry_t;
+
+#ifdef GLYPHGL_GPU_TIMERS
+/*
+ * GL_TIME_ELAPSED queries issued during one frame (GLYPHGL_GPU_TIMERS)
+ *
+ * Query objects are created on demand and reused when the renderer comes
+ * back to this set GLYPHGL_GPU_TIMER_FRAMES frames later.
+ */
+typedef struct {
+    GLuint* queries;                  /* One query per timed draw */
+    int used;                         /* Queries issued in the frame */
+    int allocated;                    /* Query objects created */
+} glyph_gpu_timer_frame_t;
+#endif
+
 /*
  * Main renderer structure containing all OpenGL resources and state for text rendering
  *
@@ -157,15 +316,110 @@ typedef struct {
     GLuint vbo;                       /* Vertex Buffer Object for batched vertex data */
     float* vertex_buffer;             /* CPU-side vertex buffer for batching glyph quads */
     size_t vertex_buffer_size;        /* Current allocated size of vertex buffer (in floats) */
+    size_t vbo_size;                  /* Current allocated size of the GPU buffer (in floats) */
     int initialized;                  /* Flag indicating if renderer was successfully created */
     uint32_t char_type;               /* Character encoding type (ASCII or UTF-8) */
     float cached_text_color[3];       /* Cached RGB color values to avoid redundant uniform updates */
     int cached_effects;               /* Cached effects bitmask to avoid redundant uniform updates */
+    float projection[16];             /* Current projection matrix (column-major) */
+    glyph_run_cache_t run_cache;      /* Optional glyph-run cache (see glyph_renderer_enable_run_cache) */
+    glyph_word_cache_entry_t* word_cache; /* Word width cache for text measurement (allocated on first use) */
+    size_t batch_vertices;            /* Vertices collected since glyph_renderer_begin_batch */
+#ifdef GLYPHGL_STATS
+    glyph_stats_t stats;              /* Timings and frame counters (see glyph_renderer_get_stats) */
+#endif
+#ifdef GLYPHGL_GPU_TIMERS
+    glyph_gpu_timer_frame_t gpu_timers[GLYPHGL_GPU_TIMER_FRAMES]; /* Query sets of the frames in flight */
+    int gpu_timer_frame;              /* Set receiving this frame's queries */
+    GLuint gpu_upload_query;          /* Atlas upload query until its result is read */
+#endif
 #ifndef GLYPHGL_MINIMAL
     glyph_effect_t effect;            /* Custom shader effect configuration (disabled in minimal mode) */
 #endif
 } glyph_renderer_t;
 
+/*
+ * Forward declaration for run cache management used by glyph_renderer_free
+ */
+static inline int glyph_renderer_enable_run_cache(glyph_renderer_t* renderer, int capacity);
+
+/*
+ * Uploads mip levels 1.. of the bound atlas texture
+ *
+ * The chain comes from glyph_image_build_mips, up to GLYPHGL_MIP_LEVELS
+ * levels in total or a 1x1 level. Sets
+ * GL_TEXTURE_MAX_LEVEL so the texture is complete with a partial chain.
+ *
+ * Parameters:
+ *   base: Level 0 pixels, already uploaded
+ *   width, height: Level 0 size in pixels
+ *   channels: Bytes per pixel of 'base'
+ *   format: GL format and internal format of the texture
+ *   allocator: Source of the scratch buffer (NULL = GLYPH_MALLOC)
+ *
+ * Returns: Number of levels in the texture (1 if no chain was built)
+ */
+static inline int glyph_renderer__upload_mips(const unsigned char* base, unsigned int width, unsigned int height,
+                                              int channels, GLenum format, glyph_allocator_t* allocator) {
+    size_t chain_bytes;
+    int levels = glyph_image_mip_chain(width, height, channels, GLYPHGL_MIP_LEVELS, &chain_bytes);
+    if (levels == 1) return 1;
+
+    unsigned char* chain = (unsigned char*)glyph__mem_alloc(allocator, chain_bytes, GLYPH_MEMORY_SCRATCH);
+    if (!chain) return 1;
+    glyph_image_build_mips(base, width, height, channels, levels, chain);
+    const unsigned char* level_pixels = chain;
+    for (int level = 1; level < levels; level++) {
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+        glTexImage2D(GL_TEXTURE_2D, level, (GLint)format, (GLsizei)width, (GLsizei)height, 0, format, GL_UNSIGNED_BYTE, level_pixels);
+        level_pixels += (size_t)width * height * channels;
+    }
+    glyph__mem_free(allocator, chain);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    return levels;
+}
+
+/*
+ * Uploads a coverage plane to the bound texture as BC4 (GL_COMPRESSED_RED_RGTC1)
+ *
+ * Half the video memory of GL_RED; shaders still read coverage from .r.
+ * Mip levels (GLYPHGL_MIP_LEVELS) are built from the uncompressed plane with
+ * glyph_image_build_mips and encoded one after another, reusing one block
+ * buffer.
+ *
+ * Parameters:
+ *   base: Level 0 coverage, one byte per pixel
+ *   width, height: Level 0 size in pixels
+ *   allocator: Source of the scratch buffers (NULL = GLYPH_MALLOC)
+ *
+ * Returns: Number of levels uploaded, or 0 if scratch memory ran out (nothing uploaded)
+ */
+static inline int glyph_renderer__upload_bc4(const unsigned char* base, unsigned int width, unsigned int height, glyph_allocator_t* allocator) {
+    size_t chain_bytes;
+    int levels = glyph_image_mip_chain(width, height, 1, GLYPHGL_MIP_LEVELS, &chain_bytes);
+    size_t block_bytes = glyph_image_bc4_size(width, height);
+    unsigned char* blocks = (unsigned char*)glyph__mem_alloc(allocator, block_bytes + chain_bytes, GLYPH_MEMORY_SCRATCH);
+    if (!blocks) return 0;
+
+    unsigned char* chain = blocks + block_bytes;
+    glyph_image_build_mips(base, width, height, 1, levels, chain);
+    const unsigned char* src = base;
+    for (int level = 0; level < levels; level++) {
+        if (level > 0) {
+            src = level == 1 ? chain : src + (size_t)width * height;
+            width = width > 1 ? width / 2 : 1;
+            height = height > 1 ? height / 2 : 1;
+        }
+        glyph_image_encode_bc4(src, width, height, blocks);
+        glyph__glCompressedTexImage2D(GL_TEXTURE_2D, level, GL_COMPRESSED_RED_RGTC1, (GLsizei)width, (GLsizei)height, 0,
+                                      (GLsizei)glyph_image_bc4_size(width, height), blocks);
+    }
+    glyph__mem_free(allocator, blocks);
+    if (levels > 1) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    return levels;
+}
+
 
 /*
  * Creates and initializes a new glyph renderer with the specified font and configuration
@@ -183,12 +437,15 @@ typedef struct {
  *   charset: String containing all characters to include in the atlas
  *   char_type: Character encoding (GLYPH_UTF8 or GLYPH_ASCII)
  *   effect: Pointer to glyph_effect_t struct for custom shaders (NULL for default)
- *   use_sdf: Enable SDF rendering (GLYPHGL_SDF flag) for scalable text
+ *   use_sdf: Enable SDF rendering (GLYPHGL_SDF flag) for scalable text; add GLYPHGL_BC4 to
+ *            store the atlas texture BC4-compressed (half the video memory of GL_RED)
+ *   allocator: Source of the atlas, vertex buffers and caches (NULL = GLYPH_MALLOC);
+ *              kept in renderer.atlas.allocator and must outlive the renderer
  *
  * Returns: Initialized glyph_renderer_t struct, or zero-initialized struct on failure
  *          Check renderer.initialized field to verify success
  */
-static inline glyph_renderer_t glyph_renderer_create(const char* font_path, float pixel_height, const char* charset, uint32_t char_type, void* effect, int use_sdf) {
+static inline glyph_renderer_t glyph_renderer_create_ex(const char* font_path, float pixel_height, const char* charset, uint32_t char_type, void* effect, int use_sdf, glyph_allocator_t* allocator) {
     /* Set up default effect if none provided (only in full mode) */
 #ifndef GLYPHGL_MINIMAL
     glyph_effect_t default_effect = {(glyph_effect_type_t)GLYPH_NONE, NULL, NULL};
@@ -199,6 +456,8 @@ static inline glyph_renderer_t glyph_renderer_create(const char* font_path, floa
 
     /* Initialize renderer struct to zero */
     glyph_renderer_t renderer = {0};
+    int compress = (use_sdf & GLYPHGL_BC4) != 0;
+    use_sdf &= ~GLYPHGL_BC4;
 
     /* Load OpenGL function pointers - required for cross-platform compatibility */
     if (!glyph_gl_load_functions()) {
@@ -217,20 +476,23 @@ static inline glyph_renderer_t glyph_renderer_create(const char* font_path, floa
 #endif
 
     /* Generate glyph atlas from font file - this is the core text processing step */
-    renderer.atlas = glyph_atlas_create(font_path, pixel_height, charset, char_type, use_sdf);
+    renderer.atlas = glyph_atlas_create_ex(font_path, pixel_height, charset, char_type, use_sdf, allocator);
     if (!renderer.atlas.chars || !renderer.atlas.image.data) {
         #ifdef GLYPHGL_DEBUG
         GLYPH_LOG("Failed to create font atlas\n");
         #endif
         return renderer;
     }
+#ifdef GLYPHGL_STATS
+    renderer.stats = renderer.atlas.stats;
+#endif
 
     /* Create OpenGL texture for glyph atlas - different paths for minimal vs full mode */
     // Defer atlas channel copy for minimal builds - upload directly from RGB data
 #ifndef GLYPHGL_MINIMAL
     /* Full mode: Extract red channel from RGB atlas for GL_RED texture format */
     /* This reduces texture memory usage and is optimal for luminance-based alpha */
-    unsigned char* red_channel = (unsigned char*)GLYPH_MALLOC(renderer.atlas.image.width * renderer.atlas.image.height);
+    unsigned char* red_channel = (unsigned char*)glyph__mem_alloc(allocator, (size_t)renderer.atlas.image.width * renderer.atlas.image.height, GLYPH_MEMORY_SCRATCH);
     if (!red_channel) {
         glyph_atlas_free(&renderer.atlas);
         return renderer;
@@ -242,28 +504,68 @@ static inline glyph_renderer_t glyph_renderer_create(const char* font_path, floa
     }
 
     /* Create and configure OpenGL texture with red channel data */
+    GLYPH__STATS_BEGIN(upload_start);
+    GLYPH__TRACE_BEGIN(upload_trace);
+#ifdef GLYPHGL_GPU_TIMERS
+    glyph__glGenQueries(1, &renderer.gpu_upload_query);
+    glyph__glBeginQuery(GL_TIME_ELAPSED, renderer.gpu_upload_query);
+#endif
     glGenTextures(1, &renderer.texture);
     glBindTexture(GL_TEXTURE_2D, renderer.texture);
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, renderer.atlas.image.width, renderer.atlas.image.height,
-                  0, GL_RED, GL_UNSIGNED_BYTE, red_channel);
+    int mip_levels = compress ? glyph_renderer__upload_bc4(red_channel, renderer.atlas.image.width, renderer.atlas.image.height, allocator) : 0;
+    if (!mip_levels) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, renderer.atlas.image.width, renderer.atlas.image.height,
+                      0, GL_RED, GL_UNSIGNED_BYTE, red_channel);
+        mip_levels = glyph_renderer__upload_mips(red_channel, renderer.atlas.image.width, renderer.atlas.image.height, 1, GL_RED, allocator);
+    }
+#ifdef GLYPHGL_GPU_TIMERS
+    glyph__glEndQuery(GL_TIME_ELAPSED);
+#endif
+    GLYPH__TRACE_END(upload_trace, "texture_upload", "bytes", renderer.atlas.image.width * renderer.atlas.image.height);
+    GLYPH__STATS_END(upload_start, renderer.stats.upload_ns);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mip_levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    GLYPH_FREE(red_channel);
+    glyph__mem_free(allocator, red_channel);
 #else
     /* Minimal mode: Upload RGB texture directly (no channel extraction) */
     /* Simpler but uses more memory - suitable for basic rendering without effects */
+    GLYPH__STATS_BEGIN(upload_start);
+    GLYPH__TRACE_BEGIN(upload_trace);
+#ifdef GLYPHGL_GPU_TIMERS
+    glyph__glGenQueries(1, &renderer.gpu_upload_query);
+    glyph__glBeginQuery(GL_TIME_ELAPSED, renderer.gpu_upload_query);
+#endif
     glGenTextures(1, &renderer.texture);
     glBindTexture(GL_TEXTURE_2D, renderer.texture);
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, renderer.atlas.image.width, renderer.atlas.image.height,
-                  0, GL_RGB, GL_UNSIGNED_BYTE, renderer.atlas.image.data);
+    int mip_levels = 0;
+    if (compress) {
+        /* BC4 holds one channel: compress the red plane, as full mode uploads it */
+        size_t pixel_count = (size_t)renderer.atlas.image.width * renderer.atlas.image.height;
+        unsigned char* red_channel = (unsigned char*)glyph__mem_alloc(allocator, pixel_count, GLYPH_MEMORY_SCRATCH);
+        if (red_channel) {
+            for (size_t i = 0; i < pixel_count; i++) red_channel[i] = renderer.atlas.image.data[i * 3];
+            mip_levels = glyph_renderer__upload_bc4(red_channel, renderer.atlas.image.width, renderer.atlas.image.height, allocator);
+            glyph__mem_free(allocator, red_channel);
+        }
+    }
+    if (!mip_levels) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, renderer.atlas.image.width, renderer.atlas.image.height,
+                      0, GL_RGB, GL_UNSIGNED_BYTE, renderer.atlas.image.data);
+        mip_levels = glyph_renderer__upload_mips(renderer.atlas.image.data, renderer.atlas.image.width, renderer.atlas.image.height, 3, GL_RGB, allocator);
+    }
+#ifdef GLYPHGL_GPU_TIMERS
+    glyph__glEndQuery(GL_TIME_ELAPSED);
+#endif
+    GLYPH__TRACE_END(upload_trace, "texture_upload", "bytes", renderer.atlas.image.width * renderer.atlas.image.height);
+    GLYPH__STATS_END(upload_start, renderer.stats.upload_ns);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mip_levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 #endif
 
@@ -294,6 +596,7 @@ static inline glyph_renderer_t glyph_renderer_create(const char* font_path, floa
     glyph__glBindBuffer(GL_ARRAY_BUFFER, renderer.vbo);
     /* Allocate GPU buffer for batched vertex data - will be updated each draw call */
     glyph__glBufferData(GL_ARRAY_BUFFER, sizeof(float) * GLYPHGL_VERTEX_BUFFER_SIZE, NULL, GL_DYNAMIC_DRAW);
+    renderer.vbo_size = GLYPHGL_VERTEX_BUFFER_SIZE;
     /* Configure vertex attributes: position (vec2) and texture coords (vec2) */
     glyph__glEnableVertexAttribArray(0);
     glyph__glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
@@ -304,7 +607,7 @@ static inline glyph_renderer_t glyph_renderer_create(const char* font_path, floa
 
     /* Allocate CPU-side vertex buffer for batching glyph quads before GPU upload */
     renderer.vertex_buffer_size = GLYPHGL_VERTEX_BUFFER_SIZE * 4; /* Initial size for vertices (float * 4 per vertex) */
-    renderer.vertex_buffer = (float*)GLYPH_MALLOC(sizeof(float) * renderer.vertex_buffer_size);
+    renderer.vertex_buffer = (float*)glyph__mem_alloc(allocator, sizeof(float) * renderer.vertex_buffer_size, GLYPH_MEMORY_VERTEX);
     if (!renderer.vertex_buffer) {
         /* Cleanup on memory allocation failure */
         glyph__glDeleteVertexArrays(1, &renderer.vao);
@@ -326,6 +629,11 @@ static inline glyph_renderer_t glyph_renderer_create(const char* font_path, floa
     return renderer;
 }
 
+/* glyph_renderer_create_ex using GLYPH_MALLOC for all memory */
+static inline glyph_renderer_t glyph_renderer_create(const char* font_path, float pixel_height, const char* charset, uint32_t char_type, void* effect, int use_sdf) {
+    return glyph_renderer_create_ex(font_path, pixel_height, charset, char_type, effect, use_sdf, NULL);
+}
+
 /*
  * Frees all resources associated with a glyph renderer
  *
@@ -347,12 +655,32 @@ static inline void glyph_renderer_free(glyph_renderer_t* renderer) {
     glyph__glDeleteBuffers(1, &renderer->vbo);
     glDeleteTextures(1, &renderer->texture);
     glyph__glDeleteProgram(renderer->shader);
-
-    /* Free glyph atlas and its associated memory */
-    glyph_atlas_free(&renderer->atlas);
+#ifdef GLYPHGL_GPU_TIMERS
+    for (int i = 0; i < GLYPHGL_GPU_TIMER_FRAMES; i++) {
+        glyph_gpu_timer_frame_t* frame = &renderer->gpu_timers[i];
+        if (frame->allocated > 0) glyph__glDeleteQueries(frame->allocated, frame->queries);
+        glyph__mem_free(renderer->atlas.allocator, frame->queries);
+    }
+    if (renderer->gpu_upload_query) glyph__glDeleteQueries(1, &renderer->gpu_upload_query);
+#endif
 
     /* Free CPU-side vertex buffer */
-    GLYPH_FREE(renderer->vertex_buffer);
+    glyph__mem_free(renderer->atlas.allocator, renderer->vertex_buffer);
+
+    /* Release cached glyph runs */
+    glyph_renderer_enable_run_cache(renderer, 0);
+
+    /* Release cached word widths */
+    if (renderer->word_cache) {
+        for (int i = 0; i < GLYPHGL_WORD_CACHE_SIZE; i++) {
+            glyph__mem_free(renderer->atlas.allocator, renderer->word_cache[i].word);
+        }
+    }
+    glyph__mem_free(renderer->atlas.allocator, renderer->word_cache);
+    renderer->word_cache = NULL;
+
+    /* Free glyph atlas and its associated memory (last: it holds the allocator) */
+    glyph_atlas_free(&renderer->atlas);
 
     /* Mark renderer as uninitialized to prevent double-free */
     renderer->initialized = 0;
@@ -384,9 +712,13 @@ static inline void glyph_renderer_set_projection(glyph_renderer_t* renderer, int
         -1.0f, 1.0f, 0.0f, 1.0f              /* Translation: center at (0,0) */
     };
 
+    /* Keep a copy for draws that offset the projection (glyph_renderer_draw_document) */
+    memcpy(renderer->projection, projection, sizeof(projection));
+
     /* Upload projection matrix to shader uniform */
     glyph__glUseProgram(renderer->shader);
     glyph__glUniformMatrix4fv(glyph__glGetUniformLocation(renderer->shader, "projection"), 1, GL_FALSE, projection);
+    GLYPH__STATS_ADD(renderer->stats.uniform_updates, 1);
     glyph__glUseProgram(0);
 }
 
@@ -416,317 +748,2025 @@ static inline void glyph_renderer_update_projection(glyph_renderer_t* renderer,
         -1.0f, 1.0f, 0.0f, 1.0f
     };
 
+    /* Keep a copy for draws that offset the projection (glyph_renderer_draw_document) */
+    memcpy(renderer->projection, projection, sizeof(projection));
+
     /* Update shader uniform with new projection matrix */
     glyph__glUseProgram(renderer->shader);
     glyph__glUniformMatrix4fv(glyph__glGetUniformLocation(renderer->shader, "projection"), 1, GL_FALSE, projection);
+    GLYPH__STATS_ADD(renderer->stats.uniform_updates, 1);
     glyph__glUseProgram(0);
 }
 
 /*
- * Renders text to the screen with specified styling and effects
+ * Uploads projection * translate(x, y) to the bound shader
  *
- * This is the core rendering function that processes text strings, looks up
- * glyph data from the atlas, applies text effects, and batches everything
- * into a single OpenGL draw call for optimal performance.
+ * Lets a draw place vertices emitted at another origin without rewriting
+ * them. The caller restores renderer->projection afterwards.
+ *
+ * Parameters:
+ *   renderer: Renderer whose shader is bound
+ *   location: Location of the "projection" uniform
+ *   x, y: Translation in pixels
+ */
+static inline void glyph_renderer__translate(glyph_renderer_t* renderer, GLint location, float x, float y) {
+    const float* p = renderer->projection;
+    float translated[16];
+    memcpy(translated, p, sizeof(translated));
+    translated[12] = p[0] * x + p[4] * y + p[12];
+    translated[13] = p[1] * x + p[5] * y + p[13];
+    glyph__glUniformMatrix4fv(location, 1, GL_FALSE, translated);
+    GLYPH__STATS_ADD(renderer->stats.uniform_updates, 1);
+}
+
+/*
+ * Writes a quad as two triangles in the [x, y, u, v] format used by the renderer VAO
+ *
+ * Vertex order: bottom-left, top-left, top-right, bottom-left, top-right,
+ * bottom-right (the bottom edge carries the italic skew).
+ */
+static inline void glyph_renderer__quad_vertices(const glyph_quad_t* quad, float* vertices) {
+    float bx0 = quad->x0 + quad->skew;
+    float bx1 = quad->x1 + quad->skew;
+    float quad_vertices[24] = {
+        /* Triangle 1 */
+        bx0,      quad->y1, quad->u0, quad->v1,
+        quad->x0, quad->y0, quad->u0, quad->v0,
+        quad->x1, quad->y0, quad->u1, quad->v0,
+
+        /* Triangle 2 */
+        bx0,      quad->y1, quad->u0, quad->v1,
+        quad->x1, quad->y0, quad->u1, quad->v0,
+        bx1,      quad->y1, quad->u1, quad->v1
+    };
+    memcpy(vertices, quad_vertices, sizeof(quad_vertices));
+}
+
+/*
+ * Writes the quads for one glyph into a vertex array
+ *
+ * Emits the base quad plus bold and underline geometry when requested (see
+ * glyph_emit_glyph), in the [x, y, u, v] format used by the renderer VAO.
  *
  * Parameters:
  *   renderer: Pointer to initialized glyph renderer
- *   text: UTF-8 or ASCII string to render
- *   x, y: Screen coordinates for text baseline start position
+ *   ch: Atlas glyph to emit (must have a non-zero width)
+ *   pen_x, y: Pen position on the baseline
+ *   advance: Scaled advance, used as the underline length
  *   scale: Text scaling factor (1.0 = normal size)
- *   r, g, b: Text color as RGB values (0.0-1.0 range)
  *   effects: Bitmask of text effects (GLYPHGL_BOLD, GLYPHGL_ITALIC, etc.)
+ *   vertices: Output array with room for 18 vertices (72 floats)
  *
- * Performance features:
- * - Vertex batching: All glyphs rendered in single draw call
- * - Uniform caching: Only updates shader uniforms when values change
- * - Dynamic buffer growth: Expands vertex buffer as needed
- * - Effect stacking: Multiple effects can be applied simultaneously
+ * Returns: Number of vertices written
  */
-static inline void glyph_renderer_draw_text(glyph_renderer_t* renderer, const char* text, float x, float y, float scale,
-                                  float r, float g, float b, int effects) {
-    /* Validate renderer state */
-    if (!renderer || !renderer->initialized) return;
-
-    /* Bind shader program and OpenGL state for rendering */
-    glyph__glUseProgram(renderer->shader);
-    glyph__glBindVertexArray(renderer->vao);
-    glyph__glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, renderer->texture);
-
-    /* Performance optimization: Only update uniforms if values have changed */
-    if (renderer->cached_text_color[0] != r || renderer->cached_text_color[1] != g || renderer->cached_text_color[2] != b) {
-        glyph__glUniform3f(glyph__glGetUniformLocation(renderer->shader, "textColor"), r, g, b);
-        renderer->cached_text_color[0] = r;
-        renderer->cached_text_color[1] = g;
-        renderer->cached_text_color[2] = b;
-    }
-#ifndef GLYPHGL_MINIMAL
-    if (renderer->cached_effects != effects) {
-        glyph__glUniform1i(glyph__glGetUniformLocation(renderer->shader, "effects"), effects);
-        renderer->cached_effects = effects;
+static inline size_t glyph_renderer__emit_glyph(glyph_renderer_t* renderer, const glyph_atlas_char_t* ch, float pen_x, float y,
+                                                float advance, float scale, int effects, float* vertices) {
+    glyph_quad_t quads[GLYPH_EMIT_MAX_QUADS];
+    int count = glyph_emit_glyph(&renderer->atlas, ch, pen_x, y, advance, scale, effects, quads);
+    for (int i = 0; i < count; i++) {
+        glyph_renderer__quad_vertices(&quads[i], vertices + i * 24);
     }
-#endif
+    return (size_t)count * 6;
+}
 
-    /* Calculate text length and estimate vertex buffer requirements */
-    size_t text_len = strlen(text);
-    /* Conservative estimate: 24 floats per glyph * 3 for max effects (normal + bold + underline) */
-    size_t required_size = sizeof(float) * 24 * text_len * 3;
-    if (required_size > renderer->vertex_buffer_size) {
-        /* Grow vertex buffer dynamically to accommodate text */
-        size_t new_size = required_size * 2; /* Double size to minimize future reallocations */
-        float* new_buffer = (float*)GLYPH_REALLOC(renderer->vertex_buffer, new_size);
-        if (!new_buffer) return; /* Memory allocation failure - skip rendering */
-        renderer->vertex_buffer = new_buffer;
-        renderer->vertex_buffer_size = new_size;
-    }
-    float* vertices = renderer->vertex_buffer;
-    size_t vertex_count = 0;
+/*
+ * Writes a solid quad (two triangles) into a vertex array
+ *
+ * Returns: Number of vertices written (6)
+ */
+static inline size_t glyph_renderer__emit_rect(float x, float y, float w, float h, float* vertices) {
+    const float u = GLYPHGL_SOLID_UV;
+    float rect_vertices[24] = {
+        x,     y + h, u, u,
+        x,     y,     u, u,
+        x + w, y,     u, u,
+
+        x,     y + h, u, u,
+        x + w, y,     u, u,
+        x + w, y + h, u, u
+    };
+    memcpy(vertices, rect_vertices, sizeof(rect_vertices));
+    return 6;
+}
 
-    /* Process each character in the text string */
-    float current_x = x; /* Track horizontal position for kerning */
-    size_t i = 0;
-    while (i < text_len) {
-        /* Decode next character based on encoding type */
-        int codepoint;
-        if (renderer->char_type == GLYPH_UTF8) {
-            codepoint = glyph_utf8_decode(text, &i); /* Handle multi-byte UTF-8 sequences */
-        } else {
-            codepoint = (unsigned char)text[i]; /* Simple ASCII byte */
-            i++;
+/* Worst-case vertices written per emitted quad by glyph_renderer__clip_quads (sheared quad, 2 x 5 triangles) */
+#define GLYPH__CLIP_MAX_VERTICES 30
+
+/* Clips a convex polygon [x, y, u, v] against one edge (Sutherland-Hodgman step) */
+static inline int glyph_renderer__clip_edge(const float* in, int n, float* out, int axis, float bound, float sign) {
+    int m = 0;
+    for (int i = 0; i < n; i++) {
+        const float* a = in + i * 4;
+        const float* b = in + ((i + 1) % n) * 4;
+        float da = (a[axis] - bound) * sign;   /* >= 0 means inside */
+        float db = (b[axis] - bound) * sign;
+        if (da >= 0.0f) {
+            memcpy(out + m * 4, a, 4 * sizeof(float));
+            m++;
+        }
+        if ((da >= 0.0f) != (db >= 0.0f)) {
+            float t = da / (da - db);
+            for (int k = 0; k < 4; k++) out[m * 4 + k] = a[k] + (b[k] - a[k]) * t;
+            m++;
         }
+    }
+    return m;
+}
 
-        /* Look up glyph data in atlas */
-        glyph_atlas_char_t* ch = glyph_atlas_find_char(&renderer->atlas, codepoint);
-        if (!ch) {
-            /* Fallback to question mark for missing characters */
-            ch = glyph_atlas_find_char(&renderer->atlas, '?');
+/*
+ * Clips quads against a rectangle on the CPU
+ *
+ * Expects quads in the order written by glyph_renderer__quad_vertices (6 vertices:
+ * bottom-left, top-left, top-right, bottom-left, top-right, bottom-right; only
+ * the bottom corners carry the italic skew).
+ * Quads outside the rectangle are dropped, quads inside are copied, and
+ * axis-aligned quads crossing an edge are cropped with interpolated texture
+ * coordinates. Sheared (italic) quads are clipped per triangle. Because the
+ * clip is baked into the vertices, runs with different clip rectangles can
+ * share one draw call and the shader and vertex format stay unchanged.
+ *
+ * Parameters:
+ *   src: Source quads [x, y, u, v]
+ *   count: Number of source vertices (multiple of 6)
+ *   dx, dy: Translation applied to the source positions
+ *   clip: Clip rectangle in screen coordinates
+ *   dst: Output array with room for GLYPH__CLIP_MAX_VERTICES vertices per source quad
+ *        (6 per quad if no quad is sheared); must not overlap 'src'
+ *
+ * Returns: Number of vertices written
+ */
+static inline size_t glyph_renderer__clip_quads(const float* src, size_t count, float dx, float dy,
+                                                const glyph_rect_t* clip, float* dst) {
+    float cx0 = clip->x, cy0 = clip->y, cx1 = clip->x + clip->w, cy1 = clip->y + clip->h;
+    size_t written = 0;
+    for (size_t q = 0; q + 6 <= count; q += 6) {
+        float quad[24];
+        for (int i = 0; i < 6; i++) {
+            quad[i * 4 + 0] = src[(q + i) * 4 + 0] + dx;
+            quad[i * 4 + 1] = src[(q + i) * 4 + 1] + dy;
+            quad[i * 4 + 2] = src[(q + i) * 4 + 2];
+            quad[i * 4 + 3] = src[(q + i) * 4 + 3];
         }
-        if (!ch || ch->width == 0) {
-            /* Skip invalid/missing glyphs, advance cursor */
-            current_x += ch ? ch->advance * scale : (renderer->atlas.pixel_height * 0.5f * scale);
-            continue;
+        float min_x = quad[0], max_x = quad[0], min_y = quad[1], max_y = quad[1];
+        for (int i = 1; i < 6; i++) {
+            if (quad[i * 4] < min_x) min_x = quad[i * 4];
+            if (quad[i * 4] > max_x) max_x = quad[i * 4];
+            if (quad[i * 4 + 1] < min_y) min_y = quad[i * 4 + 1];
+            if (quad[i * 4 + 1] > max_y) max_y = quad[i * 4 + 1];
         }
 
-        /* Calculate glyph quad position and size in screen space */
-        float xpos = current_x + ch->xoff * scale; /* Apply left bearing offset */
-        float ypos = y - ch->yoff * scale;         /* Apply baseline offset (inverted Y) */
-        float w = ch->width * scale;               /* Scaled glyph width */
-        float h = ch->height * scale;              /* Scaled glyph height */
-
-        /* Calculate texture coordinates for glyph in atlas */
-        float tex_x1 = (float)ch->x / renderer->atlas.image.width;
-        float tex_y1 = (float)ch->y / renderer->atlas.image.height;
-        float tex_x2 = (float)(ch->x + ch->width) / renderer->atlas.image.width;
-        float tex_y2 = (float)(ch->y + ch->height) / renderer->atlas.image.height;
-
-        /* Build vertex data for glyph quad (two triangles = 6 vertices) */
-        /* Format: [pos_x, pos_y, tex_u, tex_v] per vertex */
-        float glyph_vertices[24] = {
-            /* Triangle 1 */
-            xpos,     ypos + h,   tex_x1, tex_y2,  /* Top-left */
-            xpos,     ypos,       tex_x1, tex_y1,  /* Bottom-left */
-            xpos + w, ypos,       tex_x2, tex_y1,  /* Bottom-right */
-
-            /* Triangle 2 */
-            xpos,     ypos + h,   tex_x1, tex_y2,  /* Top-left */
-            xpos + w, ypos,       tex_x2, tex_y1,  /* Bottom-right */
-            xpos + w, ypos + h,   tex_x2, tex_y2   /* Top-right */
-        };
-
-        /* Apply italic effect by shearing glyph vertices */
-#ifndef GLYPHGL_MINIMAL
-        if (effects & GLYPHGL_ITALIC) {
-            float shear = 0.2f; /* Shear factor for italic slant */
-            /* Apply shear to top vertices of both triangles */
-            glyph_vertices[0] -= shear * h;   /* Triangle 1 top-left X */
-            glyph_vertices[12] -= shear * h;  /* Triangle 2 top-left X */
-            glyph_vertices[20] -= shear * h;  /* Triangle 2 top-right X */
+        /* Trivial reject / accept */
+        if (max_x <= cx0 || min_x >= cx1 || max_y <= cy0 || min_y >= cy1) continue;
+        if (min_x >= cx0 && max_x <= cx1 && min_y >= cy0 && max_y <= cy1) {
+            memcpy(dst + written * 4, quad, sizeof(quad));
+            written += 6;
+            continue;
         }
-#endif
 
-        /* Copy base glyph vertices to batch buffer */
-        memcpy(vertices + vertex_count * 4, glyph_vertices, sizeof(glyph_vertices));
-        vertex_count += 6;
-
-        /* Render additional geometry for text effects */
-#ifndef GLYPHGL_MINIMAL
-        if (effects & GLYPHGL_BOLD) {
-            /* Create bold effect by rendering duplicate glyph with offset */
-            float bold_offset = 1.0f * scale; /* Pixel offset for bold thickness */
-            float bold_vertices[24] = {
-                /* Offset duplicate of base glyph */
-                xpos + bold_offset,     ypos + h,   tex_x1, tex_y2,
-                xpos + bold_offset,     ypos,       tex_x1, tex_y1,
-                xpos + w + bold_offset, ypos,       tex_x2, tex_y1,
-
-                xpos + bold_offset,     ypos + h,   tex_x1, tex_y2,
-                xpos + w + bold_offset, ypos,       tex_x2, tex_y1,
-                xpos + w + bold_offset, ypos + h,   tex_x2, tex_y2
+        if (quad[0] == quad[4] && quad[8] == quad[20]) {
+            /* Axis-aligned: crop the rectangle and interpolate texture coordinates */
+            float x0 = quad[4], y0 = quad[5], u0 = quad[6], v0 = quad[7];     /* Vertex 1, top-left */
+            float x1 = quad[20], y1 = quad[21], u1 = quad[22], v1 = quad[23]; /* Vertex 5, bottom-right */
+            if (x1 == x0 || y1 == y0) continue;
+            float nx0 = x0 > cx0 ? x0 : cx0, nx1 = x1 < cx1 ? x1 : cx1;
+            float ny0 = y0 > cy0 ? y0 : cy0, ny1 = y1 < cy1 ? y1 : cy1;
+            float nu0 = u0 + (u1 - u0) * (nx0 - x0) / (x1 - x0);
+            float nu1 = u0 + (u1 - u0) * (nx1 - x0) / (x1 - x0);
+            float nv0 = v0 + (v1 - v0) * (ny0 - y0) / (y1 - y0);
+            float nv1 = v0 + (v1 - v0) * (ny1 - y0) / (y1 - y0);
+            float cropped[24] = {
+                nx0, ny1, nu0, nv1,
+                nx0, ny0, nu0, nv0,
+                nx1, ny0, nu1, nv0,
+
+                nx0, ny1, nu0, nv1,
+                nx1, ny0, nu1, nv0,
+                nx1, ny1, nu1, nv1
             };
-
-            /* Apply italic shear to bold glyph if both effects active */
-            if (effects & GLYPHGL_ITALIC) {
-                float shear = 0.2f;
-                bold_vertices[0] -= shear * h;
-                bold_vertices[12] -= shear * h;
-                bold_vertices[20] -= shear * h;
-            }
-
-            /* Add bold glyph vertices to batch */
-            memcpy(vertices + vertex_count * 4, bold_vertices, sizeof(bold_vertices));
-            vertex_count += 6;
+            memcpy(dst + written * 4, cropped, sizeof(cropped));
+            written += 6;
+            continue;
         }
 
-        if (effects & GLYPHGL_UNDERLINE) {
-            /* Render underline as a thin quad beneath the text */
-            float underline_y = y + h * 0.1f; /* Position slightly below baseline */
-            float underline_vertices[24] = {
-                /* Horizontal line quad spanning glyph advance width */
-                current_x, underline_y + 2, 0.0f, 0.0f,     /* Top-left of line */
-                current_x, underline_y,     0.0f, 0.0f,     /* Bottom-left of line */
-                current_x + ch->advance * scale, underline_y,     0.0f, 0.0f, /* Bottom-right */
-
-                current_x, underline_y + 2, 0.0f, 0.0f,     /* Top-left */
-                current_x + ch->advance * scale, underline_y,     0.0f, 0.0f, /* Bottom-right */
-                current_x + ch->advance * scale, underline_y + 2, 0.0f, 0.0f  /* Top-right */
-            };
-            /* Add underline vertices to batch */
-            memcpy(vertices + vertex_count * 4, underline_vertices, sizeof(underline_vertices));
-            vertex_count += 6;
+        /* Sheared: clip each triangle and fan-triangulate the result */
+        for (int t = 0; t < 2; t++) {
+            float poly_a[7 * 4], poly_b[7 * 4];
+            memcpy(poly_a, quad + t * 12, 12 * sizeof(float));
+            int n = 3;
+            n = glyph_renderer__clip_edge(poly_a, n, poly_b, 0, cx0, 1.0f);
+            n = glyph_renderer__clip_edge(poly_b, n, poly_a, 0, cx1, -1.0f);
+            n = glyph_renderer__clip_edge(poly_a, n, poly_b, 1, cy0, 1.0f);
+            n = glyph_renderer__clip_edge(poly_b, n, poly_a, 1, cy1, -1.0f);
+            for (int i = 1; i + 1 < n; i++) {
+                memcpy(dst + written * 4, poly_a, 4 * sizeof(float));
+                memcpy(dst + (written + 1) * 4, poly_a + i * 4, 4 * sizeof(float));
+                memcpy(dst + (written + 2) * 4, poly_a + (i + 1) * 4, 4 * sizeof(float));
+                written += 3;
+            }
         }
-#endif
-
-        /* Advance cursor to next character position */
-        current_x += ch->advance * scale;
     }
+    return written;
+}
 
-    /* Upload batched vertex data to GPU and execute draw call */
-    glyph__glBindBuffer(GL_ARRAY_BUFFER, renderer->vbo);
-    glyph__glBufferSubData(GL_ARRAY_BUFFER, 0, vertex_count * 4 * sizeof(float), vertices);
-    glyph__glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    /* Render all batched glyphs in single draw call - highly efficient! */
-    glDrawArrays(GL_TRIANGLES, 0, vertex_count);
+/* Vertex output of glyph_renderer__push_quad */
+typedef struct {
+    float* vertices;                  /* Destination vertex array */
+    size_t count;                     /* Vertices written so far */
+    const glyph_rect_t* clip;         /* Clip rectangle applied to each quad (NULL = none) */
+} glyph_renderer__sink_t;
+
+/* glyph_quad_callback_t writing quads to a glyph_renderer__sink_t, cropped to its clip rectangle */
+static inline void glyph_renderer__push_quad(const glyph_quad_t* quad, void* user) {
+    glyph_renderer__sink_t* sink = (glyph_renderer__sink_t*)user;
+    float* out = sink->vertices + sink->count * 4;
+    if (!sink->clip) {
+        glyph_renderer__quad_vertices(quad, out);
+        sink->count += 6;
+        return;
+    }
+    float local[24];
+    glyph_renderer__quad_vertices(quad, local);
+    sink->count += glyph_renderer__clip_quads(local, 6, 0.0f, 0.0f, sink->clip, out);
+}
 
-    /* Clean up OpenGL state */
-    glyph__glBindVertexArray(0);
-    glyph__glUseProgram(0);
+/*
+ * Worst-case vertices per glyph (per byte of text) for a clipped or unclipped run
+ */
+static inline size_t glyph_renderer__clip_capacity(int effects, const glyph_rect_t* clip) {
+#ifndef GLYPHGL_MINIMAL
+    if (clip && (effects & GLYPHGL_ITALIC)) return 2 * GLYPH__CLIP_MAX_VERTICES + 6;
+#else
+    (void)effects;
+    (void)clip;
+#endif
+    return 18;
 }
 
 /*
- * Returns the OpenGL Vertex Array Object handle for advanced rendering control
+ * Emits the glyph quads for a string into a vertex array
  *
- * This getter provides access to the internal VAO for users who need to
- * integrate GlyphGL rendering with their own OpenGL state management or
- * custom rendering pipelines.
+ * Runs glyph_emit_text and writes two triangles per quad in the [x, y, u, v]
+ * format used by the renderer VAO. No OpenGL calls are made.
  *
  * Parameters:
  *   renderer: Pointer to initialized glyph renderer
+ *   text: UTF-8 or ASCII string to emit
+ *   text_len: Length of the string in bytes
+ *   x, y: Baseline start position of the run
+ *   scale: Text scaling factor (1.0 = normal size)
+ *   effects: Bitmask of text effects (GLYPHGL_BOLD, GLYPHGL_ITALIC, etc.)
+ *   clip: Optional clip rectangle; glyphs outside it are culled, glyphs crossing it are cropped (NULL = none)
+ *   vertices: Output array with room for glyph_renderer__clip_capacity(effects, clip) vertices per byte of text
  *
- * Returns: OpenGL VAO handle (GLuint), or 0 if renderer invalid
+ * Returns: Number of vertices written
  */
-static inline GLuint glyph_renderer_get_vao(glyph_renderer_t* renderer) {
-    return renderer->vao;
+static inline size_t glyph_renderer__emit_text(glyph_renderer_t* renderer, const char* text, size_t text_len,
+                                               float x, float y, float scale, int effects, const glyph_rect_t* clip,
+                                               float* vertices) {
+    glyph_emit_options_t options;
+    options.effects = effects;
+    options.visible = clip;
+    options.char_type = renderer->char_type;
+
+    glyph_renderer__sink_t sink;
+    sink.vertices = vertices;
+    sink.count = 0;
+    sink.clip = clip;
+    glyph_emit_text(&renderer->atlas, text, text_len, x, y, scale, &options, glyph_renderer__push_quad, &sink);
+    return sink.count;
 }
 
 /*
- * Returns the OpenGL Vertex Buffer Object handle for advanced rendering control
- *
- * Provides access to the internal VBO containing batched vertex data.
- * Useful for debugging, custom batching, or integration with external
- * rendering systems.
+ * Ensures the CPU vertex buffer and the GPU buffer can hold 'floats' floats
  *
- * Parameters:
- *   renderer: Pointer to initialized glyph renderer
+ * The CPU buffer is grown through the renderer's allocator, the GPU buffer is re-specified
+ * with glBufferData. Both are doubled to amortize future growth.
  *
- * Returns: OpenGL VBO handle (GLuint), or 0 if renderer invalid
+ * Returns: 1 on success, 0 on allocation failure
  */
-static inline GLuint glyph_renderer_get_vbo(glyph_renderer_t* renderer) {
-    return renderer->vbo;
+static inline int glyph_renderer__reserve(glyph_renderer_t* renderer, size_t floats) {
+    if (floats > renderer->vertex_buffer_size) {
+        size_t new_size = floats * 2; /* Double size to minimize future reallocations */
+        float* new_buffer = (float*)glyph__mem_realloc(renderer->atlas.allocator, renderer->vertex_buffer, sizeof(float) * new_size, GLYPH_MEMORY_VERTEX);
+        if (!new_buffer) return 0;
+        renderer->vertex_buffer = new_buffer;
+        renderer->vertex_buffer_size = new_size;
+    }
+    if (floats > renderer->vbo_size) {
+        size_t new_size = floats * 2;
+        glyph__glBindBuffer(GL_ARRAY_BUFFER, renderer->vbo);
+        glyph__glBufferData(GL_ARRAY_BUFFER, sizeof(float) * new_size, NULL, GL_DYNAMIC_DRAW);
+        glyph__glBindBuffer(GL_ARRAY_BUFFER, 0);
+        renderer->vbo_size = new_size;
+    }
+    return 1;
 }
 
 /*
- * Returns the OpenGL shader program handle for advanced shader management
+ * Enables, resizes or disables the glyph-run cache of a renderer
  *
- * Allows access to the compiled shader program for custom uniform setting,
- * shader introspection, or integration with effect systems that need
- * to modify shader state directly.
+ * When enabled, glyph_renderer_draw_text stores the emitted vertices of each
+ * (text, scale, effects) combination relative to the run origin. Drawing the
+ * same string again skips decoding, atlas lookup and emission entirely: the
+ * cached vertices are uploaded as they are and placed through the projection
+ * uniform. Resizing discards all cached runs.
+ *
+ * Runs are spread over sets of 8 entries by hash, so a capacity about twice
+ * the number of distinct runs drawn per frame keeps sets from overflowing.
  *
  * Parameters:
  *   renderer: Pointer to initialized glyph renderer
+ *   capacity: Number of runs to keep, rounded up to a multiple of 8 above 8
+ *             (0 disables the cache and frees its memory)
  *
- * Returns: OpenGL shader program handle (GLuint), or 0 if renderer invalid
+ * Returns: 0 on success, -1 on failure
  */
-static inline GLuint glyph_renderer_get_shader(glyph_renderer_t* renderer) {
-    return renderer->shader;
+static inline int glyph_renderer_enable_run_cache(glyph_renderer_t* renderer, int capacity) {
+    if (!renderer) return -1;
+    glyph_run_cache_t* cache = &renderer->run_cache;
+
+    /* Release any previously cached runs */
+    if (cache->entries) {
+        for (int i = 0; i < cache->capacity; i++) {
+            glyph__mem_free(renderer->atlas.allocator, cache->entries[i].vertices);
+            glyph__mem_free(renderer->atlas.allocator, cache->entries[i].text);
+        }
+        glyph__mem_free(renderer->atlas.allocator, cache->entries);
+        cache->entries = NULL;
+    }
+    cache->capacity = 0;
+    if (capacity <= 0) return 0;
+    if (capacity > GLYPH__RUN_CACHE_WAYS) {
+        capacity = (capacity + GLYPH__RUN_CACHE_WAYS - 1) / GLYPH__RUN_CACHE_WAYS * GLYPH__RUN_CACHE_WAYS;
+    }
+
+    cache->entries = (glyph_run_cache_entry_t*)glyph__mem_alloc(renderer->atlas.allocator, sizeof(glyph_run_cache_entry_t) * capacity, GLYPH_MEMORY_VERTEX);
+    if (!cache->entries) return -1;
+    memset(cache->entries, 0, sizeof(glyph_run_cache_entry_t) * capacity);
+    cache->capacity = capacity;
+    return 0;
+}
+
+#ifdef GLYPHGL_GPU_TIMERS
+/* Index into glyph_stats_t.gpu_draw_ns for this renderer's draws */
+static inline int glyph_renderer__effect_slot(const glyph_renderer_t* renderer) {
+#ifndef GLYPHGL_MINIMAL
+    int type = (int)renderer->effect.type;
+    if (type > 0 && type < GLYPH_STATS_EFFECT_TYPES) return type;
+#endif
+    (void)renderer;
+    return 0;
 }
 
 /*
- * Decodes a single UTF-8 codepoint from a string and advances the index
- *
- * This function implements UTF-8 decoding according to RFC 3629, handling
- * 1-4 byte sequences correctly. It advances the index past the decoded
- * character and returns the Unicode codepoint value.
- *
- * Parameters:
- *   str: UTF-8 encoded string to decode from
- *   index: Pointer to current position in string (updated on return)
- *
- * Returns:
- *   Unicode codepoint (int), or 0xFFFD (replacement character) on error
- *   Returns 0 if end of string reached
+ * Reads finished GPU timer queries without waiting for the GPU
  *
- * UTF-8 encoding:
- * - 1 byte:  0xxxxxxx (ASCII, 0-127)
- * - 2 bytes: 110xxxxx 10xxxxxx (128-2047)
- * - 3 bytes: 1110xxxx 10xxxxxx 10xxxxxx (2048-65535)
- * - 4 bytes: 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx (65536-1114111)
+ * The oldest query set is about to be reused for the new frame: if its last
+ * query has completed (so have the earlier ones) the frame's total is stored
+ * under the renderer's effect type, otherwise the frame is counted as
+ * dropped. The atlas upload query is read whenever it becomes available.
  */
-static inline int glyph_utf8_decode(const char* str, size_t* index) {
-    size_t i = *index;
-    /* Check for end of string */
-    if (i >= strlen(str)) {
-        return 0;
+static inline void glyph_renderer__resolve_gpu_timers(glyph_renderer_t* renderer) {
+    GLint available = 0;
+    uint64_t elapsed = 0;
+    if (renderer->gpu_upload_query) {
+        glyph__glGetQueryObjectiv(renderer->gpu_upload_query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            glyph__glGetQueryObjectui64v(renderer->gpu_upload_query, GL_QUERY_RESULT, &elapsed);
+            renderer->stats.gpu_upload_ns = elapsed;
+            glyph__glDeleteQueries(1, &renderer->gpu_upload_query);
+            renderer->gpu_upload_query = 0;
+        }
+    }
+
+    renderer->gpu_timer_frame = (renderer->gpu_timer_frame + 1) % GLYPHGL_GPU_TIMER_FRAMES;
+    glyph_gpu_timer_frame_t* frame = &renderer->gpu_timers[renderer->gpu_timer_frame];
+    if (frame->used == 0) return;
+    available = 0;
+    glyph__glGetQueryObjectiv(frame->queries[frame->used - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available) {
+        uint64_t total = 0;
+        for (int i = 0; i < frame->used; i++) {
+            glyph__glGetQueryObjectui64v(frame->queries[i], GL_QUERY_RESULT, &elapsed);
+            total += elapsed;
+        }
+        renderer->stats.gpu_draw_ns[glyph_renderer__effect_slot(renderer)] = total;
+        renderer->stats.gpu_frames_resolved++;
+    } else {
+        renderer->stats.gpu_frames_dropped++;
     }
+    frame->used = 0;
+}
 
-    unsigned char c = (unsigned char)str[i++];
-    /* Handle 1-byte ASCII characters (most common case) */
-    if (c < 0x80) {
-        *index = i;
-        return c;
-    }
-    /* Handle 2-byte sequences (Latin-1 supplement, etc.) */
-    else if ((c & 0xE0) == 0xC0) {
-        if (i >= strlen(str)) return 0xFFFD; /* Incomplete sequence */
-        unsigned char c2 = (unsigned char)str[i++];
-        if ((c2 & 0xC0) != 0x80) return 0xFFFD; /* Invalid continuation byte */
-        *index = i;
-        return ((c & 0x1F) << 6) | (c2 & 0x3F); /* Decode 11-bit codepoint */
-    }
-    /* Handle 3-byte sequences (Basic Multilingual Plane) */
-    else if ((c & 0xF0) == 0xE0) {
-        if (i + 1 >= strlen(str)) return 0xFFFD; /* Incomplete sequence */
-        unsigned char c2 = (unsigned char)str[i++];
-        unsigned char c3 = (unsigned char)str[i++];
-        if ((c2 & 0xC0) != 0x80 || (c3 & 0xC0) != 0x80) return 0xFFFD; /* Invalid continuation */
-        *index = i;
-        return ((c & 0x0F) << 12) | ((c2 & 0x3F) << 6) | (c3 & 0x3F); /* Decode 16-bit codepoint */
-    }
-    /* Handle 4-byte sequences (astral planes, emojis, etc.) */
-    /* Its still really buggy right now */
-    else if ((c & 0xF8) == 0xF0) {
-        if (i + 2 >= strlen(str)) return 0xFFFD; /* Incomplete sequence */
-        unsigned char c2 = (unsigned char)str[i++];
-        unsigned char c3 = (unsigned char)str[i++];
-        unsigned char c4 = (unsigned char)str[i++];
-        if ((c2 & 0xC0) != 0x80 || (c3 & 0xC0) != 0x80 || (c4 & 0xC0) != 0x80) return 0xFFFD; /* Invalid continuation */
-        *index = i;
-        return ((c & 0x07) << 18) | ((c2 & 0x3F) << 12) | ((c3 & 0x3F) << 6) | (c4 & 0x3F); /* Decode 21-bit codepoint */
-    }
-    /* Invalid UTF-8 lead byte */
-    *index = i;
-    return 0xFFFD; /* Unicode replacement character */
+/*
+ * Starts a GL_TIME_ELAPSED query for the next draw
+ *
+ * Returns: 1 if a query was started, 0 if the frame's query budget is spent
+ *          or no query object could be allocated
+ */
+static inline int glyph_renderer__gpu_timer_begin(glyph_renderer_t* renderer) {
+    glyph_gpu_timer_frame_t* frame = &renderer->gpu_timers[renderer->gpu_timer_frame];
+    if (frame->used == frame->allocated) {
+        int grown = frame->allocated ? frame->allocated * 2 : 16;
+        if (grown > GLYPHGL_GPU_TIMER_QUERIES) grown = GLYPHGL_GPU_TIMER_QUERIES;
+        if (grown <= frame->allocated) {
+            renderer->stats.gpu_untimed_draws++;
+            return 0;
+        }
+        GLuint* queries = (GLuint*)glyph__mem_realloc(renderer->atlas.allocator, frame->queries,
+                                                      (size_t)grown * sizeof(GLuint), GLYPH_MEMORY_VERTEX);
+        if (!queries) {
+            renderer->stats.gpu_untimed_draws++;
+            return 0;
+        }
+        frame->queries = queries;
+        glyph__glGenQueries(grown - frame->allocated, frame->queries + frame->allocated);
+        frame->allocated = grown;
+    }
+    glyph__glBeginQuery(GL_TIME_ELAPSED, frame->queries[frame->used++]);
+    return 1;
+}
+#endif
+
+/*
+ * Marks the start of a new frame
+ *
+ * Advances the frame counter used for run cache aging and releases cached
+ * runs that have not been drawn for GLYPHGL_RUN_CACHE_MAX_AGE frames, and
+ * resets the GLYPHGL_STATS frame counters. With GLYPHGL_GPU_TIMERS it also
+ * reads the GPU timer results that have become available and starts a new
+ * query set. Call once per frame before drawing text.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ */
+static inline void glyph_renderer_begin_frame(glyph_renderer_t* renderer) {
+    if (!renderer || !renderer->initialized) return;
+#ifdef GLYPHGL_STATS
+    renderer->stats.glyphs_emitted = 0;
+    renderer->stats.bytes_uploaded = 0;
+    renderer->stats.draw_calls = 0;
+    renderer->stats.uniform_updates = 0;
+#endif
+#ifdef GLYPHGL_GPU_TIMERS
+    glyph_renderer__resolve_gpu_timers(renderer);
+#endif
+    glyph_run_cache_t* cache = &renderer->run_cache;
+    cache->frame++;
+
+    /* Age out runs that were not used recently */
+    for (int i = 0; i < cache->capacity; i++) {
+        glyph_run_cache_entry_t* e = &cache->entries[i];
+        if (e->hash && cache->frame - e->last_used > GLYPHGL_RUN_CACHE_MAX_AGE) {
+            glyph__mem_free(renderer->atlas.allocator, e->vertices);
+            glyph__mem_free(renderer->atlas.allocator, e->text);
+            memset(e, 0, sizeof(*e));
+            cache->evictions++;
+        }
+    }
+}
+
+/*
+ * Returns the hit/miss counters of the glyph-run cache
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *
+ * Returns: glyph_run_cache_stats_t snapshot (all zero if the cache is disabled)
+ */
+static inline glyph_run_cache_stats_t glyph_renderer_get_run_cache_stats(const glyph_renderer_t* renderer) {
+    glyph_run_cache_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+    if (!renderer) return stats;
+    const glyph_run_cache_t* cache = &renderer->run_cache;
+    stats.hits = cache->hits;
+    stats.misses = cache->misses;
+    stats.evictions = cache->evictions;
+    for (int i = 0; i < cache->capacity; i++) {
+        if (cache->entries[i].hash) stats.entries++;
+    }
+    if (cache->hits + cache->misses > 0) {
+        stats.hit_rate = (float)((double)cache->hits / (double)(cache->hits + cache->misses));
+    }
+    return stats;
+}
+
+/*
+ * Returns the performance counters of a renderer
+ *
+ * Holds the atlas build timings and texture upload time from creation plus
+ * the frame counters accumulated since the last glyph_renderer_begin_frame.
+ * With GLYPHGL_GPU_TIMERS the gpu_* fields hold GPU times of an earlier
+ * frame (see glyph_renderer_begin_frame).
+ * Only populated when compiled with GLYPHGL_STATS; otherwise all zero.
+ *
+ * Parameters:
+ *   renderer: Pointer to glyph renderer
+ *
+ * Returns: glyph_stats_t snapshot
+ */
+static inline glyph_stats_t glyph_renderer_get_stats(const glyph_renderer_t* renderer) {
+    glyph_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+#ifdef GLYPHGL_STATS
+    if (renderer) stats = renderer->stats;
+#else
+    (void)renderer;
+#endif
+    return stats;
+}
+
+/*
+ * Finds a run in the run cache, emitting and storing it on a miss
+ *
+ * The hash of (text, scale, effects) selects one aligned set of
+ * GLYPH__RUN_CACHE_WAYS entries; a hit also compares the text bytes. On a
+ * miss the run is emitted at the origin into 'scratch' and copied into the
+ * least recently used entry of the set.
+ *
+ * Parameters:
+ *   scratch: Receives the emitted run on a miss (origin-relative)
+ *   vertex_count: Receives the number of vertices in the run
+ *
+ * Returns: The cached entry, or NULL if the run could not be stored (it is
+ *          then only in 'scratch')
+ */
+static inline const glyph_run_cache_entry_t* glyph_renderer__lookup_run(glyph_renderer_t* renderer, const char* text, size_t text_len,
+                                                                         float scale, int effects, float* scratch, size_t* vertex_count) {
+    glyph_run_cache_t* cache = &renderer->run_cache;
+
+    /* Key: text bytes, with scale and effects folded into the seed */
+    uint32_t scale_bits;
+    memcpy(&scale_bits, &scale, sizeof(scale_bits));
+    uint64_t hash = glyph__hash64(text, text_len, ((uint64_t)scale_bits << 32) | (uint32_t)effects);
+    if (hash == 0) hash = 1; /* 0 marks an empty slot */
+
+    int ways = cache->capacity < GLYPH__RUN_CACHE_WAYS ? cache->capacity : GLYPH__RUN_CACHE_WAYS;
+    glyph_run_cache_entry_t* set = cache->entries + (size_t)(hash % (uint64_t)(cache->capacity / ways)) * ways;
+    glyph_run_cache_entry_t* victim = set;
+    for (int w = 0; w < ways; w++) {
+        glyph_run_cache_entry_t* e = &set[w];
+        if (e->hash == hash && e->text_len == text_len && e->scale == scale && e->effects == effects &&
+            (text_len == 0 || memcmp(e->text, text, text_len) == 0)) {
+            cache->hits++;
+            e->last_used = cache->frame;
+            *vertex_count = e->vertex_count;
+            return e;
+        }
+        /* Prefer empty slots, otherwise the least recently used one */
+        if (victim->hash && (!e->hash || e->last_used < victim->last_used)) victim = e;
+    }
+
+    /* Miss: emit relative to the origin and store the run in the victim slot */
+    cache->misses++;
+    size_t count = glyph_renderer__emit_text(renderer, text, text_len, 0.0f, 0.0f, scale, effects, NULL, scratch);
+    *vertex_count = count;
+    size_t floats = count * 4;
+    if (victim->hash) cache->evictions++;
+    victim->hash = 0;
+    if (floats > victim->capacity) {
+        float* new_vertices = (float*)glyph__mem_realloc(renderer->atlas.allocator, victim->vertices, sizeof(float) * floats, GLYPH_MEMORY_VERTEX);
+        if (!new_vertices) return NULL; /* Allocation failed - leave the slot empty */
+        victim->vertices = new_vertices;
+        victim->capacity = floats;
+    }
+    if (text_len > victim->text_capacity) {
+        char* new_text = (char*)glyph__mem_realloc(renderer->atlas.allocator, victim->text, text_len, GLYPH_MEMORY_VERTEX);
+        if (!new_text) return NULL;
+        victim->text = new_text;
+        victim->text_capacity = text_len;
+    }
+    if (floats) memcpy(victim->vertices, scratch, sizeof(float) * floats);
+    if (text_len) memcpy(victim->text, text, text_len);
+    victim->hash = hash;
+    victim->text_len = text_len;
+    victim->scale = scale;
+    victim->effects = effects;
+    victim->vertex_count = count;
+    victim->last_used = cache->frame;
+    return victim;
+}
+
+/*
+ * Emits a run through the run cache at (x, y)
+ *
+ * The origin-relative run is copied out and translated in one pass over the
+ * buffer. Runs are cached unclipped; a clip rectangle is applied while
+ * copying them out.
+ *
+ * Returns: Number of vertices written to 'vertices'
+ */
+static inline size_t glyph_renderer__emit_cached(glyph_renderer_t* renderer, const char* text, size_t text_len,
+                                                 float x, float y, float scale, int effects, const glyph_rect_t* clip,
+                                                 float* vertices) {
+    size_t vertex_count;
+    const glyph_run_cache_entry_t* e = glyph_renderer__lookup_run(renderer, text, text_len, scale, effects, vertices, &vertex_count);
+    if (clip) {
+        if (e) return glyph_renderer__clip_quads(e->vertices, vertex_count, x, y, clip, vertices);
+        return glyph_renderer__emit_text(renderer, text, text_len, x, y, scale, effects, clip, vertices);
+    }
+    if (e && vertex_count) memcpy(vertices, e->vertices, sizeof(float) * 4 * vertex_count);
+    for (size_t i = 0; i < vertex_count * 4; i += 4) {
+        vertices[i + 0] += x;
+        vertices[i + 1] += y;
+    }
+    return vertex_count;
+}
+
+/*
+ * Emits a run through the run cache when it is enabled, directly otherwise
+ *
+ * Returns: Number of vertices written
+ */
+static inline size_t glyph_renderer__emit_run(glyph_renderer_t* renderer, const char* text, size_t text_len,
+                                              float x, float y, float scale, int effects, const glyph_rect_t* clip,
+                                              float* vertices) {
+    if (renderer->run_cache.capacity > 0) {
+        return glyph_renderer__emit_cached(renderer, text, text_len, x, y, scale, effects, clip, vertices);
+    }
+    return glyph_renderer__emit_text(renderer, text, text_len, x, y, scale, effects, clip, vertices);
+}
+
+/* Issues glDrawArrays for a triangle range, feeding the stats counters, GPU timers and the trace */
+static inline void glyph_renderer__draw_arrays(glyph_renderer_t* renderer, size_t first, size_t count) {
+    GLYPH__TRACE_BEGIN(trace_start);
+#ifdef GLYPHGL_GPU_TIMERS
+    int timed = glyph_renderer__gpu_timer_begin(renderer);
+#endif
+    glDrawArrays(GL_TRIANGLES, (GLint)first, (GLsizei)count);
+#ifdef GLYPHGL_GPU_TIMERS
+    if (timed) glyph__glEndQuery(GL_TIME_ELAPSED);
+#endif
+    GLYPH__TRACE_END(trace_start, "draw", "vertices", count);
+    GLYPH__STATS_ADD(renderer->stats.draw_calls, 1);
+    GLYPH__STATS_ADD(renderer->stats.glyphs_emitted, count / 6);
+    (void)renderer;
+}
+
+/*
+ * Binds the renderer's shader, VAO and atlas texture for drawing
+ *
+ * Performance optimization: the color and effect uniforms are only updated
+ * when they differ from the cached values.
+ */
+static inline void glyph_renderer__bind(glyph_renderer_t* renderer, float r, float g, float b, int effects) {
+    glyph__glUseProgram(renderer->shader);
+    glyph__glBindVertexArray(renderer->vao);
+    glyph__glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, renderer->texture);
+
+    /* Performance optimization: Only update uniforms if values have changed */
+    if (renderer->cached_text_color[0] != r || renderer->cached_text_color[1] != g || renderer->cached_text_color[2] != b) {
+        glyph__glUniform3f(glyph__glGetUniformLocation(renderer->shader, "textColor"), r, g, b);
+        GLYPH__STATS_ADD(renderer->stats.uniform_updates, 1);
+        renderer->cached_text_color[0] = r;
+        renderer->cached_text_color[1] = g;
+        renderer->cached_text_color[2] = b;
+    }
+#ifndef GLYPHGL_MINIMAL
+    if (renderer->cached_effects != effects) {
+        glyph__glUniform1i(glyph__glGetUniformLocation(renderer->shader, "effects"), effects);
+        GLYPH__STATS_ADD(renderer->stats.uniform_updates, 1);
+        renderer->cached_effects = effects;
+    }
+#else
+    (void)effects;
+#endif
+}
+
+/* Uploads 'vertex_count' vertices to the renderer's VBO and draws them, leaving the state bound */
+static inline void glyph_renderer__upload_draw(glyph_renderer_t* renderer, const float* vertices, size_t vertex_count) {
+    /* Upload batched vertex data to GPU and execute draw call */
+    glyph__glBindBuffer(GL_ARRAY_BUFFER, renderer->vbo);
+    glyph__glBufferSubData(GL_ARRAY_BUFFER, 0, vertex_count * 4 * sizeof(float), vertices);
+    glyph__glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GLYPH__STATS_ADD(renderer->stats.bytes_uploaded, vertex_count * 4 * sizeof(float));
+
+    /* Render all batched glyphs in single draw call - highly efficient! */
+    glyph_renderer__draw_arrays(renderer, 0, vertex_count);
+}
+
+/*
+ * Uploads the first 'vertex_count' vertices of the CPU buffer and draws them
+ *
+ * Expects the state set by glyph_renderer__bind and unbinds it afterwards.
+ */
+static inline void glyph_renderer__submit(glyph_renderer_t* renderer, size_t vertex_count) {
+    glyph_renderer__upload_draw(renderer, renderer->vertex_buffer, vertex_count);
+
+    /* Clean up OpenGL state */
+    glyph__glBindVertexArray(0);
+    glyph__glUseProgram(0);
+}
+
+/*
+ * Renders text to the screen with specified styling and effects
+ *
+ * This is the core rendering function that processes text strings, looks up
+ * glyph data from the atlas, applies text effects, and batches everything
+ * into a single OpenGL draw call for optimal performance.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   text: UTF-8 or ASCII string to render
+ *   x, y: Screen coordinates for text baseline start position
+ *   scale: Text scaling factor (1.0 = normal size)
+ *   r, g, b: Text color as RGB values (0.0-1.0 range)
+ *   effects: Bitmask of text effects (GLYPHGL_BOLD, GLYPHGL_ITALIC, etc.)
+ *
+ * Performance features:
+ * - Vertex batching: All glyphs rendered in single draw call
+ * - Uniform caching: Only updates shader uniforms when values change
+ * - Dynamic buffer growth: Expands vertex buffer as needed
+ * - Effect stacking: Multiple effects can be applied simultaneously
+ * - Run caching: Repeated strings skip emission when the run cache is enabled
+ */
+static inline void glyph_renderer_draw_text(glyph_renderer_t* renderer, const char* text, float x, float y, float scale,
+                                  float r, float g, float b, int effects) {
+    /* Validate renderer state */
+    if (!renderer || !renderer->initialized) return;
+
+    glyph_renderer__bind(renderer, r, g, b, effects);
+
+    /* Calculate text length and estimate vertex buffer requirements */
+    size_t text_len = strlen(text);
+    /* Conservative estimate: 24 floats per glyph * 3 for max effects (normal + bold + underline) */
+    if (!glyph_renderer__reserve(renderer, 24 * text_len * 3)) {
+        /* Memory allocation failure - skip rendering */
+        glyph__glBindVertexArray(0);
+        glyph__glUseProgram(0);
+        return;
+    }
+
+    if (renderer->run_cache.capacity > 0) {
+        /* Draw the origin-relative run straight from the cache, translated by the projection */
+        size_t vertex_count;
+        const glyph_run_cache_entry_t* e = glyph_renderer__lookup_run(renderer, text, text_len, scale, effects,
+                                                                      renderer->vertex_buffer, &vertex_count);
+        GLint projection_location = glyph__glGetUniformLocation(renderer->shader, "projection");
+        glyph_renderer__translate(renderer, projection_location, x, y);
+        glyph_renderer__upload_draw(renderer, e ? e->vertices : renderer->vertex_buffer, vertex_count);
+        glyph__glUniformMatrix4fv(projection_location, 1, GL_FALSE, renderer->projection);
+        GLYPH__STATS_ADD(renderer->stats.uniform_updates, 1);
+        glyph__glBindVertexArray(0);
+        glyph__glUseProgram(0);
+        return;
+    }
+    size_t vertex_count = glyph_renderer__emit_text(renderer, text, text_len, x, y, scale, effects, NULL, renderer->vertex_buffer);
+
+    glyph_renderer__submit(renderer, vertex_count);
+}
+
+/*
+ * Renders text clipped to a rectangle
+ *
+ * Glyphs outside the clip rectangle are culled before any vertex is written,
+ * glyphs crossing an edge are cropped on the CPU. No scissor state is touched,
+ * so clipped text can also be mixed with other runs in a batch
+ * (see glyph_renderer_begin_batch).
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   text: UTF-8 or ASCII string to render
+ *   x, y: Screen coordinates for text baseline start position
+ *   scale: Text scaling factor (1.0 = normal size)
+ *   r, g, b: Text color as RGB values (0.0-1.0 range)
+ *   effects: Bitmask of text effects (GLYPHGL_BOLD, GLYPHGL_ITALIC, etc.)
+ *   clip: Visible rectangle in screen coordinates (NULL = unclipped)
+ */
+static inline void glyph_renderer_draw_text_clipped(glyph_renderer_t* renderer, const char* text, float x, float y, float scale,
+                                                    float r, float g, float b, int effects, const glyph_rect_t* clip) {
+    if (!renderer || !renderer->initialized || !text) return;
+
+    size_t text_len = strlen(text);
+    if (!glyph_renderer__reserve(renderer, 4 * text_len * glyph_renderer__clip_capacity(effects, clip))) return;
+    size_t vertex_count = glyph_renderer__emit_run(renderer, text, text_len, x, y, scale, effects, clip, renderer->vertex_buffer);
+    if (vertex_count == 0) return;
+
+    glyph_renderer__bind(renderer, r, g, b, effects);
+    glyph_renderer__submit(renderer, vertex_count);
+}
+
+/*
+ * Emits the glyphs of a layout, skipping lines and glyphs outside an optional clip rectangle
+ *
+ * Runs glyph_emit_layout: lines are sorted by baseline, so the first visible
+ * line is found by binary search and emission stops below the clip rectangle.
+ *
+ * Returns: Number of vertices written
+ */
+static inline size_t glyph_renderer__emit_layout(glyph_renderer_t* renderer, const glyph_layout_t* layout, float x, float y,
+                                                 int effects, const glyph_rect_t* clip, float* vertices) {
+    glyph_emit_options_t options;
+    options.effects = effects;
+    options.visible = clip;
+    options.char_type = renderer->char_type;
+
+    glyph_renderer__sink_t sink;
+    sink.vertices = vertices;
+    sink.count = 0;
+    sink.clip = clip;
+    glyph_emit_layout(&renderer->atlas, layout, x, y, &options, glyph_renderer__push_quad, &sink);
+    return sink.count;
+}
+
+/*
+ * Renders a precomputed layout in a single draw call
+ *
+ * Glyphs were resolved to atlas entries by glyph_layout_text, so drawing
+ * skips decoding, lookups, kerning and line breaking entirely. The layout
+ * must have been computed with this renderer's atlas.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   layout: Layout produced by glyph_layout_text
+ *   x, y: Screen coordinates of the top-left corner of the layout box
+ *   r, g, b: Text color as RGB values (0.0-1.0 range)
+ *   effects: Bitmask of text effects (GLYPHGL_BOLD, GLYPHGL_ITALIC, etc.)
+ */
+static inline void glyph_renderer_draw_layout(glyph_renderer_t* renderer, const glyph_layout_t* layout, float x, float y,
+                                              float r, float g, float b, int effects) {
+    if (!renderer || !renderer->initialized || !layout || layout->num_glyphs == 0) return;
+
+    glyph_renderer__bind(renderer, r, g, b, effects);
+
+    if (!glyph_renderer__reserve(renderer, 24 * layout->num_glyphs * 3)) {
+        glyph__glBindVertexArray(0);
+        glyph__glUseProgram(0);
+        return;
+    }
+    size_t vertex_count = glyph_renderer__emit_layout(renderer, layout, x, y, effects, NULL, renderer->vertex_buffer);
+
+    glyph_renderer__submit(renderer, vertex_count);
+}
+
+/*
+ * Starts collecting runs into one draw call
+ *
+ * Runs added with glyph_renderer_batch_text and glyph_renderer_batch_layout
+ * are emitted into the renderer's vertex buffer, each with its own position,
+ * effects and clip rectangle, and drawn together by glyph_renderer_end_batch.
+ * Many clipped panes (list rows, scroll views, table cells) therefore cost one
+ * upload and one draw call instead of a scissor change and a draw per pane.
+ * Other glyph_renderer_draw_* calls must not be made while a batch is open.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ */
+static inline void glyph_renderer_begin_batch(glyph_renderer_t* renderer) {
+    if (!renderer) return;
+    renderer->batch_vertices = 0;
+}
+
+/*
+ * Adds a text run to the open batch
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   text: UTF-8 or ASCII string
+ *   x, y: Screen coordinates for text baseline start position
+ *   scale: Text scaling factor (1.0 = normal size)
+ *   effects: Geometry effects of this run (GLYPHGL_BOLD, GLYPHGL_ITALIC, GLYPHGL_UNDERLINE)
+ *   clip: Visible rectangle of this run (NULL = unclipped)
+ *
+ * Returns: 0 on success, -1 on failure
+ */
+static inline int glyph_renderer_batch_text(glyph_renderer_t* renderer, const char* text, float x, float y, float scale,
+                                            int effects, const glyph_rect_t* clip) {
+    if (!renderer || !renderer->initialized || !text) return -1;
+    size_t text_len = strlen(text);
+    if (!glyph_renderer__reserve(renderer, 4 * (renderer->batch_vertices + text_len * glyph_renderer__clip_capacity(effects, clip)))) {
+        return -1;
+    }
+    renderer->batch_vertices += glyph_renderer__emit_run(renderer, text, text_len, x, y, scale, effects, clip,
+                                                         renderer->vertex_buffer + renderer->batch_vertices * 4);
+    return 0;
+}
+
+/*
+ * Adds a precomputed layout to the open batch
+ *
+ * Lines outside the clip rectangle are skipped without touching their glyphs.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   layout: Layout produced by glyph_layout_text
+ *   x, y: Screen coordinates of the top-left corner of the layout box
+ *   effects: Geometry effects of this layout (GLYPHGL_BOLD, GLYPHGL_ITALIC, GLYPHGL_UNDERLINE)
+ *   clip: Visible rectangle of this layout (NULL = unclipped)
+ *
+ * Returns: 0 on success, -1 on failure
+ */
+static inline int glyph_renderer_batch_layout(glyph_renderer_t* renderer, const glyph_layout_t* layout, float x, float y,
+                                              int effects, const glyph_rect_t* clip) {
+    if (!renderer || !renderer->initialized || !layout) return -1;
+    if (!glyph_renderer__reserve(renderer, 4 * (renderer->batch_vertices + layout->num_glyphs * glyph_renderer__clip_capacity(effects, clip)))) {
+        return -1;
+    }
+    renderer->batch_vertices += glyph_renderer__emit_layout(renderer, layout, x, y, effects, clip,
+                                                            renderer->vertex_buffer + renderer->batch_vertices * 4);
+    return 0;
+}
+
+/*
+ * Draws every run of the open batch with one upload and one draw call
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   r, g, b: Text color as RGB values (0.0-1.0 range)
+ *   effects: Shader effects for the whole batch (e.g. GLYPHGL_SDF); geometry effects are taken per run
+ */
+static inline void glyph_renderer_end_batch(glyph_renderer_t* renderer, float r, float g, float b, int effects) {
+    if (!renderer || !renderer->initialized) return;
+    size_t vertex_count = renderer->batch_vertices;
+    renderer->batch_vertices = 0;
+    if (vertex_count == 0) return;
+
+    glyph_renderer__bind(renderer, r, g, b, effects);
+    glyph_renderer__submit(renderer, vertex_count);
+}
+
+/*
+ * One draw recorded in a command list: a vertex range and its shading state
+ */
+typedef struct {
+    size_t first;                     /* First vertex of the range within the list */
+    size_t count;                     /* Number of vertices */
+    float r, g, b;                    /* Text color as RGB values (0.0-1.0 range) */
+    int effects;                      /* Effects passed to the shader for this range */
+} glyph_command_t;
+
+/*
+ * Text draws recorded away from the GL thread
+ *
+ * A command list decodes text, looks glyphs up in a renderer's atlas and
+ * emits vertices without making any OpenGL call, so it can be filled on any
+ * thread. The atlas is only read, which makes it safe for several threads to
+ * record lists against the same renderer at once, as long as each list is
+ * used by one thread at a time. The lists are then handed to
+ * glyph_renderer_submit on the GL thread, which only uploads and draws.
+ * The renderer's run cache is not used while recording.
+ */
+typedef struct {
+    const glyph_atlas_t* atlas;       /* Atlas of the renderer the list was created for (not owned) */
+    uint32_t char_type;               /* Character encoding used to decode recorded text */
+    float* vertices;                  /* Recorded vertices in the renderer's [x, y, u, v] format */
+    size_t vertex_count;              /* Number of recorded vertices */
+    size_t vertex_capacity;           /* Capacity of 'vertices' in vertices */
+    glyph_command_t* commands;        /* Recorded draws, in submission order */
+    size_t num_commands;              /* Number of recorded draws */
+    size_t command_capacity;          /* Capacity of 'commands' */
+    int initialized;                  /* Flag indicating if the list was successfully created */
+} glyph_command_list_t;
+
+/*
+ * Creates an empty command list recording against a renderer's atlas
+ *
+ * Must be called after glyph_renderer_create has returned; the list keeps a
+ * pointer to the renderer's atlas, so the renderer must outlive it. The list
+ * can only be submitted to that same renderer (glyph_renderer_submit
+ * returns -1 otherwise).
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *
+ * Returns: Initialized list, or a zeroed struct on failure
+ */
+static inline glyph_command_list_t glyph_command_list_create(const glyph_renderer_t* renderer) {
+    glyph_command_list_t list;
+    memset(&list, 0, sizeof(list));
+    if (!renderer || !renderer->initialized) return list;
+    list.atlas = &renderer->atlas;
+    list.char_type = renderer->char_type;
+    list.initialized = 1;
+    return list;
+}
+
+/*
+ * Releases the memory of a command list
+ */
+static inline void glyph_command_list_free(glyph_command_list_t* list) {
+    if (!list) return;
+    glyph_allocator_t* allocator = list->atlas ? list->atlas->allocator : NULL;
+    glyph__mem_free(allocator, list->vertices);
+    glyph__mem_free(allocator, list->commands);
+    memset(list, 0, sizeof(*list));
+}
+
+/*
+ * Empties a command list while keeping its memory for the next frame
+ */
+static inline void glyph_command_list_reset(glyph_command_list_t* list) {
+    if (!list) return;
+    list->vertex_count = 0;
+    list->num_commands = 0;
+}
+
+/*
+ * Makes room for 'vertices' more vertices and one more command
+ *
+ * Returns: 1 on success, 0 on allocation failure
+ */
+static inline int glyph_command_list__reserve(glyph_command_list_t* list, size_t vertices) {
+    if (list->vertex_count + vertices > list->vertex_capacity) {
+        size_t new_capacity = (list->vertex_count + vertices) * 2;
+        float* new_vertices = (float*)glyph__mem_realloc(list->atlas->allocator, list->vertices, sizeof(float) * 4 * new_capacity, GLYPH_MEMORY_VERTEX);
+        if (!new_vertices) return 0;
+        list->vertices = new_vertices;
+        list->vertex_capacity = new_capacity;
+    }
+    if (list->num_commands == list->command_capacity) {
+        size_t new_capacity = list->command_capacity ? list->command_capacity * 2 : 16;
+        glyph_command_t* new_commands = (glyph_command_t*)glyph__mem_realloc(list->atlas->allocator, list->commands, sizeof(glyph_command_t) * new_capacity, GLYPH_MEMORY_VERTEX);
+        if (!new_commands) return 0;
+        list->commands = new_commands;
+        list->command_capacity = new_capacity;
+    }
+    return 1;
+}
+
+/*
+ * Records the vertices just written past the end of the list as one draw
+ *
+ * Consecutive draws with the same color and effects are merged into one range.
+ */
+static inline void glyph_command_list__commit(glyph_command_list_t* list, size_t count, float r, float g, float b, int effects) {
+    if (count == 0) return;
+    if (list->num_commands > 0) {
+        glyph_command_t* last = &list->commands[list->num_commands - 1];
+        if (last->r == r && last->g == g && last->b == b && last->effects == effects &&
+            last->first + last->count == list->vertex_count) {
+            last->count += count;
+            list->vertex_count += count;
+            return;
+        }
+    }
+    glyph_command_t* cmd = &list->commands[list->num_commands++];
+    cmd->first = list->vertex_count;
+    cmd->count = count;
+    cmd->r = r;
+    cmd->g = g;
+    cmd->b = b;
+    cmd->effects = effects;
+    list->vertex_count += count;
+}
+
+/*
+ * Records a text run into a command list
+ *
+ * Does the same work as glyph_renderer_draw_text_clipped up to the upload:
+ * decoding, atlas lookup, kerning, effects and clipping. Makes no OpenGL calls.
+ *
+ * Parameters:
+ *   list: Command list created with glyph_command_list_create
+ *   text: UTF-8 or ASCII string
+ *   x, y: Screen coordinates for text baseline start position
+ *   scale: Text scaling factor (1.0 = normal size)
+ *   r, g, b: Text color as RGB values (0.0-1.0 range)
+ *   effects: Bitmask of text effects (GLYPHGL_BOLD, GLYPHGL_ITALIC, etc.)
+ *   clip: Visible rectangle of this run (NULL = unclipped)
+ *
+ * Returns: 0 on success, -1 on failure
+ */
+static inline int glyph_command_list_text(glyph_command_list_t* list, const char* text, float x, float y, float scale,
+                                          float r, float g, float b, int effects, const glyph_rect_t* clip) {
+    if (!list || !list->initialized || !text) return -1;
+    size_t text_len = strlen(text);
+    if (!glyph_command_list__reserve(list, text_len * glyph_renderer__clip_capacity(effects, clip))) return -1;
+
+    glyph_emit_options_t options;
+    options.effects = effects;
+    options.visible = clip;
+    options.char_type = list->char_type;
+
+    glyph_renderer__sink_t sink;
+    sink.vertices = list->vertices + list->vertex_count * 4;
+    sink.count = 0;
+    sink.clip = clip;
+    glyph_emit_text(list->atlas, text, text_len, x, y, scale, &options, glyph_renderer__push_quad, &sink);
+    glyph_command_list__commit(list, sink.count, r, g, b, effects);
+    return 0;
+}
+
+/*
+ * Records a precomputed layout into a command list
+ *
+ * Parameters:
+ *   list: Command list created with glyph_command_list_create
+ *   layout: Layout produced by glyph_layout_text with the renderer's atlas
+ *   x, y: Screen coordinates of the top-left corner of the layout box
+ *   r, g, b: Text color as RGB values (0.0-1.0 range)
+ *   effects: Bitmask of text effects (GLYPHGL_BOLD, GLYPHGL_ITALIC, etc.)
+ *   clip: Visible rectangle of this layout (NULL = unclipped)
+ *
+ * Returns: 0 on success, -1 on failure
+ */
+static inline int glyph_command_list_layout(glyph_command_list_t* list, const glyph_layout_t* layout, float x, float y,
+                                            float r, float g, float b, int effects, const glyph_rect_t* clip) {
+    if (!list || !list->initialized || !layout) return -1;
+    if (!glyph_command_list__reserve(list, layout->num_glyphs * glyph_renderer__clip_capacity(effects, clip))) return -1;
+
+    glyph_emit_options_t options;
+    options.effects = effects;
+    options.visible = clip;
+    options.char_type = list->char_type;
+
+    glyph_renderer__sink_t sink;
+    sink.vertices = list->vertices + list->vertex_count * 4;
+    sink.count = 0;
+    sink.clip = clip;
+    glyph_emit_layout(list->atlas, layout, x, y, &options, glyph_renderer__push_quad, &sink);
+    glyph_command_list__commit(list, sink.count, r, g, b, effects);
+    return 0;
+}
+
+/*
+ * Draws recorded command lists on the GL thread
+ *
+ * All lists are copied into the renderer's vertex buffer and uploaded with a
+ * single glBufferSubData. Draws then follow in list order; adjacent draws
+ * sharing a color and effects (also across lists) become one glDrawArrays.
+ * The lists are left untouched and can be reset by their recording threads
+ * once this returns.
+ *
+ * Parameters:
+ *   renderer: Renderer the lists were created for
+ *   lists: Array of command lists
+ *   count: Number of lists in the array
+ *
+ * Returns: Number of draw calls issued, or -1 on failure (including any list
+ *          created for a different renderer, in which case nothing is drawn)
+ */
+static inline int glyph_renderer_submit(glyph_renderer_t* renderer, const glyph_command_list_t* lists, size_t count) {
+    if (!renderer || !renderer->initialized || (!lists && count)) return -1;
+
+    /* Quads from another atlas would sample the wrong texture: reject the whole submit */
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (lists[i].atlas != &renderer->atlas) return -1;
+        total += lists[i].vertex_count;
+    }
+    if (total == 0) return 0;
+    if (!glyph_renderer__reserve(renderer, 4 * total)) return -1;
+
+    size_t base = 0;
+    for (size_t i = 0; i < count; i++) {
+        memcpy(renderer->vertex_buffer + base * 4, lists[i].vertices, sizeof(float) * 4 * lists[i].vertex_count);
+        base += lists[i].vertex_count;
+    }
+    glyph__glBindBuffer(GL_ARRAY_BUFFER, renderer->vbo);
+    glyph__glBufferSubData(GL_ARRAY_BUFFER, 0, total * 4 * sizeof(float), renderer->vertex_buffer);
+    glyph__glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GLYPH__STATS_ADD(renderer->stats.bytes_uploaded, total * 4 * sizeof(float));
+
+    /* Walk the commands of all lists as one stream, drawing whenever the state changes */
+    int draws = 0;
+    glyph_command_t run;  /* Draw being extended, in renderer buffer coordinates */
+    run.count = 0;
+    base = 0;
+    for (size_t i = 0; i < count; i++) {
+        for (size_t c = 0; c < lists[i].num_commands; c++) {
+            const glyph_command_t* cmd = &lists[i].commands[c];
+            if (run.count && cmd->r == run.r && cmd->g == run.g && cmd->b == run.b && cmd->effects == run.effects &&
+                base + cmd->first == run.first + run.count) {
+                run.count += cmd->count;
+                continue;
+            }
+            if (run.count) {
+                glyph_renderer__bind(renderer, run.r, run.g, run.b, run.effects);
+                glyph_renderer__draw_arrays(renderer, run.first, run.count);
+                draws++;
+            }
+            run = *cmd;
+            run.first += base;
+        }
+        base += lists[i].vertex_count;
+    }
+    if (run.count) {
+        glyph_renderer__bind(renderer, run.r, run.g, run.b, run.effects);
+        glyph_renderer__draw_arrays(renderer, run.first, run.count);
+        draws++;
+    }
+
+    glyph__glBindVertexArray(0);
+    glyph__glUseProgram(0);
+    return draws;
+}
+
+/*
+ * Renders a layout together with a selection highlight or caret
+ *
+ * Selection quads and glyph quads are written to the same buffer and
+ * uploaded once; the highlight is drawn first so the text stays on top.
+ * An empty selection (start == end) draws the caret instead.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   layout: Layout produced by glyph_layout_text
+ *   x, y: Screen coordinates of the top-left corner of the layout box
+ *   selection_start, selection_end: Selected byte range in the layout's source text
+ *   r, g, b: Text color as RGB values (0.0-1.0 range)
+ *   sel_r, sel_g, sel_b: Selection (or caret) color as RGB values
+ *   effects: Bitmask of text effects (GLYPHGL_BOLD, GLYPHGL_ITALIC, etc.)
+ */
+static inline void glyph_renderer_draw_layout_selection(glyph_renderer_t* renderer, const glyph_layout_t* layout, float x, float y,
+                                                        size_t selection_start, size_t selection_end,
+                                                        float r, float g, float b, float sel_r, float sel_g, float sel_b, int effects) {
+    if (!renderer || !renderer->initialized || !layout || layout->num_lines == 0) return;
+
+    if (selection_start > selection_end) {
+        size_t t = selection_start;
+        selection_start = selection_end;
+        selection_end = t;
+    }
+    size_t first_line = glyph_text__line_at_offset(layout, selection_start);
+    size_t last_line = glyph_text__line_at_offset(layout, selection_end);
+    if (!glyph_renderer__reserve(renderer, 24 * (last_line - first_line + 1) + 24 * layout->num_glyphs * 3)) return;
+    float* vertices = renderer->vertex_buffer;
+
+    /* Selection quads first (or the caret for an empty selection) */
+    size_t rect_vertices = 0;
+    if (selection_start == selection_end) {
+        glyph_rect_t caret = glyph_text_caret_rect(layout, selection_start);
+        rect_vertices += glyph_renderer__emit_rect(x + caret.x, y + caret.y, caret.w, caret.h, vertices);
+    } else {
+        for (size_t l = first_line; l <= last_line; l++) {
+            glyph_rect_t rect;
+            if (!glyph_text__line_selection(layout, l, selection_start, selection_end, &rect)) continue;
+            rect_vertices += glyph_renderer__emit_rect(x + rect.x, y + rect.y, rect.w, rect.h, vertices + rect_vertices * 4);
+        }
+    }
+
+    /* Glyph quads */
+    size_t vertex_count = rect_vertices;
+    for (size_t i = 0; i < layout->num_glyphs; i++) {
+        const glyph_positioned_t* pg = &layout->glyphs[i];
+        if (pg->char_index < 0 || pg->char_index >= renderer->atlas.num_chars) continue;
+        vertex_count += glyph_renderer__emit_glyph(renderer, &renderer->atlas.chars[pg->char_index], x + pg->x, y + pg->y,
+                                                   pg->advance, layout->scale, effects, vertices + vertex_count * 4);
+    }
+
+    glyph_renderer__bind(renderer, sel_r, sel_g, sel_b, effects);
+    glyph__glBindBuffer(GL_ARRAY_BUFFER, renderer->vbo);
+    glyph__glBufferSubData(GL_ARRAY_BUFFER, 0, vertex_count * 4 * sizeof(float), vertices);
+    glyph__glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GLYPH__STATS_ADD(renderer->stats.bytes_uploaded, vertex_count * 4 * sizeof(float));
+    if (rect_vertices) glyph_renderer__draw_arrays(renderer, 0, rect_vertices);
+
+    glyph__glUniform3f(glyph__glGetUniformLocation(renderer->shader, "textColor"), r, g, b);
+    GLYPH__STATS_ADD(renderer->stats.uniform_updates, 1);
+    renderer->cached_text_color[0] = r;
+    renderer->cached_text_color[1] = g;
+    renderer->cached_text_color[2] = b;
+    glyph_renderer__draw_arrays(renderer, rect_vertices, vertex_count - rect_vertices);
+
+    glyph__glBindVertexArray(0);
+    glyph__glUseProgram(0);
+}
+
+/*
+ * GPU storage for an incrementally updated document
+ *
+ * Each paragraph of a glyph_document_t owns a slot (a vertex range) in one
+ * shared buffer. Slots are sized with slack so edits are patched in place
+ * with glBufferSubData; unused slot space holds degenerate triangles so
+ * neighbouring slots can still be drawn with a single call.
+ */
+typedef struct {
+    GLuint vao;                       /* Vertex Array Object bound to the document buffer */
+    GLuint vbo;                       /* Buffer holding all paragraph slots */
+    size_t vbo_vertices;              /* Capacity of the buffer in vertices */
+    size_t used_vertices;             /* End of the last allocated slot */
+    int effects;                      /* Effects the current geometry was emitted with (-1 = none) */
+    int initialized;                  /* Flag indicating if the view was successfully created */
+} glyph_document_view_t;
+
+#ifndef GLYPHGL_DOCUMENT_BUFFER_VERTICES
+#define GLYPHGL_DOCUMENT_BUFFER_VERTICES 65536  /* Initial vertex capacity of a document view */
+#endif
+
+/*
+ * Creates the GPU buffer used to draw a document
+ *
+ * Returns: Initialized view, or a zeroed struct on failure
+ */
+static inline glyph_document_view_t glyph_document_view_create(void) {
+    glyph_document_view_t view;
+    memset(&view, 0, sizeof(view));
+    glyph__glGenVertexArrays(1, &view.vao);
+    glyph__glGenBuffers(1, &view.vbo);
+    if (!view.vao || !view.vbo) return view;
+    glyph__glBindVertexArray(view.vao);
+    glyph__glBindBuffer(GL_ARRAY_BUFFER, view.vbo);
+    glyph__glBufferData(GL_ARRAY_BUFFER, GLYPHGL_DOCUMENT_BUFFER_VERTICES * 4 * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+    glyph__glEnableVertexAttribArray(0);
+    glyph__glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glyph__glEnableVertexAttribArray(1);
+    glyph__glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glyph__glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glyph__glBindVertexArray(0);
+    view.vbo_vertices = GLYPHGL_DOCUMENT_BUFFER_VERTICES;
+    view.effects = -1;
+    view.initialized = 1;
+    return view;
+}
+
+/*
+ * Releases the GPU resources of a document view
+ */
+static inline void glyph_document_view_free(glyph_document_view_t* view) {
+    if (!view || !view->initialized) return;
+    glyph__glDeleteVertexArrays(1, &view->vao);
+    glyph__glDeleteBuffers(1, &view->vbo);
+    memset(view, 0, sizeof(*view));
+}
+
+/*
+ * Drops every slot of a document so geometry is rebuilt from the start of the buffer
+ *
+ * Used when the buffer has to grow (glBufferData discards its contents) and to
+ * compact the buffer once removed paragraphs have left too much unused space.
+ */
+static inline void glyph_document_view__reset(glyph_document_view_t* view, glyph_document_t* doc, size_t min_vertices) {
+    if (min_vertices > view->vbo_vertices) {
+        size_t new_vertices = view->vbo_vertices * 2;
+        while (new_vertices < min_vertices) new_vertices *= 2;
+        glyph__glBindBuffer(GL_ARRAY_BUFFER, view->vbo);
+        glyph__glBufferData(GL_ARRAY_BUFFER, new_vertices * 4 * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+        view->vbo_vertices = new_vertices;
+    }
+    for (size_t i = 0; i < doc->num_paragraphs; i++) {
+        doc->paragraphs[i].vertex_capacity = 0;
+        doc->paragraphs[i].stale = 1;
+    }
+    view->used_vertices = 0;
+    doc->released_vertices = 0;
+}
+
+/*
+ * Re-emits a stale paragraph into its slot, moving it to a new slot if it grew
+ *
+ * Returns: 1 on success, 0 if the buffer is full (caller grows it by at least
+ *          *required vertices and retries), -1 on allocation failure
+ */
+static inline int glyph_document_view__emit(glyph_renderer_t* renderer, glyph_document_view_t* view,
+                                            glyph_document_t* doc, glyph_paragraph_t* para, int effects, size_t* required) {
+    int per_glyph = 6;
+#ifndef GLYPHGL_MINIMAL
+    if (effects & GLYPHGL_BOLD) per_glyph += 6;
+    if (effects & GLYPHGL_UNDERLINE) per_glyph += 6;
+#endif
+    size_t visible = 0;
+    for (size_t g = 0; g < para->layout.num_glyphs; g++) {
+        if (para->layout.glyphs[g].char_index >= 0) visible++;
+    }
+    size_t needed = visible * per_glyph;
+
+    /* Move to a new slot with slack when the current one is too small */
+    if (needed > para->vertex_capacity || para->vertex_capacity == 0) {
+        size_t capacity = needed + needed / 2 + 6 * per_glyph;
+        if (view->used_vertices + capacity > view->vbo_vertices) {
+            *required = capacity;
+            return 0;
+        }
+        doc->released_vertices += para->vertex_capacity;
+        para->vertex_offset = view->used_vertices;
+        para->vertex_capacity = capacity;
+        view->used_vertices += capacity;
+    }
+
+    if (!glyph_renderer__reserve(renderer, para->vertex_capacity * 4)) return -1;
+    float* vertices = renderer->vertex_buffer;
+    size_t vertex_count = 0;
+    for (size_t g = 0; g < para->layout.num_glyphs; g++) {
+        const glyph_positioned_t* pg = &para->layout.glyphs[g];
+        if (pg->char_index < 0 || pg->char_index >= renderer->atlas.num_chars) continue;
+        vertex_count += glyph_renderer__emit_glyph(renderer, &renderer->atlas.chars[pg->char_index], pg->x, para->y + pg->y,
+                                                   pg->advance, doc->scale, effects, vertices + vertex_count * 4);
+    }
+    /* Degenerate triangles fill the slack so the slot can be drawn in full */
+    memset(vertices + vertex_count * 4, 0, (para->vertex_capacity - vertex_count) * 4 * sizeof(float));
+
+    glyph__glBindBuffer(GL_ARRAY_BUFFER, view->vbo);
+    glyph__glBufferSubData(GL_ARRAY_BUFFER, para->vertex_offset * 4 * sizeof(float),
+                           para->vertex_capacity * 4 * sizeof(float), vertices);
+    GLYPH__STATS_ADD(renderer->stats.bytes_uploaded, para->vertex_capacity * 4 * sizeof(float));
+    para->emitted_y = para->y;
+    para->stale = 0;
+    return 1;
+}
+
+/*
+ * Renders the visible part of a document, updating only what changed
+ *
+ * Runs glyph_document_update, re-emits the stale paragraphs that are visible
+ * and patches their slots in place. Paragraphs that only moved vertically
+ * (e.g. below an inserted line) are not re-emitted: their offset is applied
+ * through the projection, and neighbouring slots with the same offset are
+ * drawn with one call. Off-screen paragraphs stay stale until they scroll in.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer (projection must be set)
+ *   view: Document view created with glyph_document_view_create
+ *   doc: Document to draw (laid out with renderer's atlas)
+ *   x, y: Screen position of the document's top-left corner
+ *   visible_top, visible_bottom: Visible range in document coordinates
+ *                                (visible_bottom <= visible_top draws everything)
+ *   r, g, b: Text color as RGB values (0.0-1.0 range)
+ *   effects: Bitmask of text effects (GLYPHGL_BOLD, GLYPHGL_ITALIC, etc.)
+ *
+ * Returns: Number of paragraphs re-emitted, or -1 on failure
+ */
+static inline int glyph_renderer_draw_document(glyph_renderer_t* renderer, glyph_document_view_t* view, glyph_document_t* doc,
+                                               float x, float y, float visible_top, float visible_bottom,
+                                               float r, float g, float b, int effects) {
+    if (!renderer || !renderer->initialized || !view || !view->initialized || !doc || !doc->paragraphs) return -1;
+    if (glyph_document_update(doc) < 0) return -1;
+
+    /* Geometry depends on the effects, re-emit everything when they change */
+    if (view->effects != effects) {
+        glyph_document_view__reset(view, doc, 0);
+        view->effects = effects;
+    }
+    /* Compact once removed or relocated slots waste more than half the buffer */
+    if (doc->released_vertices > view->vbo_vertices / 2) {
+        glyph_document_view__reset(view, doc, 0);
+    }
+
+    size_t first = 0, last = doc->num_paragraphs - 1;
+    if (visible_bottom > visible_top) {
+        first = glyph_document_paragraph_at_y(doc, visible_top);
+        last = glyph_document_paragraph_at_y(doc, visible_bottom);
+    }
+
+    int emitted = 0;
+    for (size_t i = first; i <= last; i++) {
+        glyph_paragraph_t* para = &doc->paragraphs[i];
+        if (!para->stale) continue;
+        size_t required = 0;
+        int result = glyph_document_view__emit(renderer, view, doc, para, effects, &required);
+        if (result == 0) {
+            /* Out of space - rebuild the visible range into a larger buffer. Slots dropped
+               by an earlier reset count as 0, so the failed slot is added explicitly: the
+               buffer always grows and a paragraph bigger than the whole buffer fits next time */
+            size_t in_use = required;
+            for (size_t j = first; j <= last; j++) in_use += doc->paragraphs[j].vertex_capacity;
+            glyph_document_view__reset(view, doc, in_use * 2 + view->vbo_vertices);
+            i = first - 1;
+            emitted = 0;
+            continue;
+        }
+        if (result < 0) return -1;
+        emitted++;
+    }
+    glyph__glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glyph_renderer__bind(renderer, r, g, b, effects);
+    glyph__glBindVertexArray(view->vao);
+    GLint projection_location = glyph__glGetUniformLocation(renderer->shader, "projection");
+
+    /* Batch neighbouring slots that share the same vertical offset */
+    size_t i = first;
+    while (i <= last) {
+        glyph_paragraph_t* para = &doc->paragraphs[i];
+        float offset = para->y - para->emitted_y;
+        size_t start = para->vertex_offset;
+        size_t end = start + para->vertex_capacity;
+        size_t j = i + 1;
+        while (j <= last && doc->paragraphs[j].vertex_offset == end &&
+               doc->paragraphs[j].y - doc->paragraphs[j].emitted_y == offset) {
+            end += doc->paragraphs[j].vertex_capacity;
+            j++;
+        }
+
+        glyph_renderer__translate(renderer, projection_location, x, y + offset);
+        glyph_renderer__draw_arrays(renderer, start, end - start);
+        i = j;
+    }
+
+    glyph__glUniformMatrix4fv(projection_location, 1, GL_FALSE, renderer->projection);
+    GLYPH__STATS_ADD(renderer->stats.uniform_updates, 1);
+    glyph__glBindVertexArray(0);
+    glyph__glUseProgram(0);
+    return emitted;
+}
+
+/*
+ * Virtualized view over a large unwrapped text buffer
+ *
+ * Only the lines intersecting the viewport are emitted. The GPU buffer is a
+ * ring of row slots: line L lives in slot L % rows, so scrolling keeps every
+ * line that stays on screen and only emits the rows that scrolled in. All
+ * slots are drawn with a single call; slot slack holds degenerate triangles.
+ * Vertex y positions are stored relative to an anchor line that is moved when
+ * the view scrolls far away, keeping float precision independent of the
+ * document length.
+ *
+ * Frame cost depends on the viewport size, not the buffer size: the line
+ * index gives O(1) access to any line and emission of a line stops at the
+ * right edge of the viewport.
+ */
+typedef struct {
+    const char* text;                 /* Text buffer (not owned, may be memory-mapped) */
+    glyph_line_index_t lines;         /* Line-offset index over the text */
+    float scale;                      /* Text scaling factor */
+    float line_height;                /* Distance between baselines in pixels */
+    float ascender;                   /* Scaled ascender (baseline offset within a row) */
+    float tab_width;                  /* Tab stop interval in pixels */
+    GLuint vao;                       /* Vertex Array Object bound to the row ring */
+    GLuint vbo;                       /* Row ring buffer */
+    size_t rows;                      /* Number of row slots */
+    size_t slot_vertices;             /* Vertex capacity of each slot */
+    size_t* slot_line;                /* Line held by each slot ((size_t)-1 = empty), from lines.allocator */
+    size_t anchor;                    /* Line whose top is y = 0 in the stored vertices */
+    float emitted_scroll_x;           /* Horizontal scroll the slots were culled for */
+    float emitted_width;              /* Viewport width the slots were culled for */
+    int effects;                      /* Effects the slots were emitted with */
+    size_t emitted_rows;              /* Rows emitted by the last draw */
+    int initialized;                  /* Flag indicating if the view was successfully created */
+} glyph_text_view_t;
+
+#ifndef GLYPHGL_TEXT_VIEW_ANCHOR_LINES
+#define GLYPHGL_TEXT_VIEW_ANCHOR_LINES 16384  /* Lines the view may scroll from its anchor before re-basing */
+#endif
+
+/*
+ * Creates a virtualized view over a text buffer
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer (provides the atlas)
+ *   text: UTF-8 or ASCII buffer (must stay valid while the view uses it)
+ *   len: Length of the buffer in bytes
+ *   scale: Text scaling factor (1.0 = atlas pixel height)
+ *
+ * Returns: Initialized view, or a zeroed struct on failure
+ */
+static inline glyph_text_view_t glyph_text_view_create(glyph_renderer_t* renderer, const char* text, size_t len, float scale) {
+    glyph_text_view_t view;
+    memset(&view, 0, sizeof(view));
+    if (!renderer || !renderer->initialized) return view;
+    view.lines.allocator = renderer->atlas.allocator;
+    if (glyph_line_index_update(&view.lines, text, len) != 0) return view;
+    view.text = text;
+    view.scale = scale;
+    view.ascender = renderer->atlas.ascender * scale;
+    view.line_height = (renderer->atlas.ascender - renderer->atlas.descender + renderer->atlas.line_gap) * scale;
+    view.tab_width = glyph_atlas_get_advance(&renderer->atlas, ' ') * 4.0f * scale;
+    if (view.tab_width <= 0.0f) view.tab_width = renderer->atlas.pixel_height * scale;
+    view.effects = -1;
+
+    glyph__glGenVertexArrays(1, &view.vao);
+    glyph__glGenBuffers(1, &view.vbo);
+    glyph__glBindVertexArray(view.vao);
+    glyph__glBindBuffer(GL_ARRAY_BUFFER, view.vbo);
+    glyph__glEnableVertexAttribArray(0);
+    glyph__glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glyph__glEnableVertexAttribArray(1);
+    glyph__glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glyph__glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glyph__glBindVertexArray(0);
+    view.initialized = 1;
+    return view;
+}
+
+/*
+ * Points the view at new text content
+ *
+ * Parameters:
+ *   view: Text view
+ *   text: Text buffer (may differ from the previous pointer, e.g. after a remap)
+ *   len: Length of the buffer in bytes
+ *   appended: 1 if the first bytes are unchanged and data was only appended
+ *             (only the new bytes are indexed), 0 to re-index everything
+ *
+ * Returns: 0 on success, -1 on failure
+ */
+static inline int glyph_text_view_set_text(glyph_text_view_t* view, const char* text, size_t len, int appended) {
+    if (!view || !view->initialized) return -1;
+    size_t old_lines = view->lines.num_lines;
+    if (!appended) view->lines.num_lines = 0;
+    if (glyph_line_index_update(&view->lines, text, len) != 0) return -1;
+    view->text = text;
+    for (size_t s = 0; s < view->rows; s++) {
+        /* The previous last line may have grown; new lines replace empty rows */
+        if (!appended || view->slot_line[s] + 1 >= old_lines) view->slot_line[s] = (size_t)-1;
+    }
+    return 0;
+}
+
+/*
+ * Releases the GPU resources and line index of a text view
+ */
+static inline void glyph_text_view_free(glyph_text_view_t* view) {
+    if (!view || !view->initialized) return;
+    glyph__glDeleteVertexArrays(1, &view->vao);
+    glyph__glDeleteBuffers(1, &view->vbo);
+    glyph__mem_free(view->lines.allocator, view->slot_line);
+    glyph_line_index_free(&view->lines);
+    memset(view, 0, sizeof(*view));
+}
+
+/*
+ * (Re)allocates the row ring and empties every slot
+ *
+ * Returns: 1 on success, 0 on allocation failure
+ */
+static inline int glyph_text_view__resize(glyph_text_view_t* view, size_t rows, size_t slot_vertices) {
+    if (rows != view->rows) {
+        size_t* slot_line = (size_t*)glyph__mem_realloc(view->lines.allocator, view->slot_line, rows * sizeof(size_t), GLYPH_MEMORY_LAYOUT);
+        if (!slot_line) return 0;
+        view->slot_line = slot_line;
+    }
+    view->rows = rows;
+    view->slot_vertices = slot_vertices;
+    for (size_t s = 0; s < rows; s++) view->slot_line[s] = (size_t)-1;
+    glyph__glBindBuffer(GL_ARRAY_BUFFER, view->vbo);
+    glyph__glBufferData(GL_ARRAY_BUFFER, rows * slot_vertices * 4 * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+    return 1;
+}
+
+/*
+ * Emits one line into its row slot, culled to [scroll_x, scroll_x + width]
+ *
+ * Returns: Vertices needed for the line (greater than slot_vertices if it did not fit)
+ */
+static inline size_t glyph_text_view__emit_row(glyph_renderer_t* renderer, glyph_text_view_t* view, size_t line,
+                                               float scroll_x, float width, int effects, float* vertices) {
+    size_t vertex_count = 0;
+    if (line < view->lines.num_lines) {
+        size_t start, end;
+        glyph_line_index_range(&view->lines, view->text, line, &start, &end);
+        const char* text = view->text + start;
+        size_t len = end - start;
+        float baseline = (float)((double)line - (double)view->anchor) * view->line_height + view->ascender;
+        float right = scroll_x + width;
+        float pen_x = 0.0f;
+        int prev = -1;
+        size_t i = 0;
+        int per_glyph = 6;
+#ifndef GLYPHGL_MINIMAL
+        if (effects & GLYPHGL_BOLD) per_glyph += 6;
+        if (effects & GLYPHGL_UNDERLINE) per_glyph += 6;
+#endif
+        while (i < len && pen_x < right) {
+            int codepoint;
+            if (renderer->char_type == GLYPH_UTF8) {
+                codepoint = glyph_atlas_utf8_decode_len(text, len, &i);
+            } else {
+                codepoint = (unsigned char)text[i++];
+            }
+            if (codepoint == '\t') {
+                pen_x = (floorf(pen_x / view->tab_width) + 1.0f) * view->tab_width;
+                prev = -1;
+                continue;
+            }
+            if (prev >= 0 && renderer->atlas.num_kerning) {
+                pen_x += glyph_atlas_get_kerning(&renderer->atlas, prev, codepoint) * view->scale;
+            }
+            prev = codepoint;
+            glyph_atlas_char_t* ch = glyph_atlas_find_char(&renderer->atlas, codepoint);
+            if (!ch) ch = glyph_atlas_find_char(&renderer->atlas, '?');
+            float advance = ch ? ch->advance * view->scale : renderer->atlas.pixel_height * 0.5f * view->scale;
+            /* Horizontal culling - glyphs left of the viewport are skipped */
+            if (ch && ch->width > 0 && pen_x + advance >= scroll_x) {
+                if (vertex_count + per_glyph <= view->slot_vertices) {
+                    vertex_count += glyph_renderer__emit_glyph(renderer, ch, pen_x, baseline, advance, view->scale, effects,
+                                                               vertices + vertex_count * 4);
+                } else {
+                    vertex_count += per_glyph;
+                }
+            }
+            pen_x += advance;
+        }
+    }
+    if (vertex_count <= view->slot_vertices) {
+        memset(vertices + vertex_count * 4, 0, (view->slot_vertices - vertex_count) * 4 * sizeof(float));
+    }
+    return vertex_count;
+}
+
+/*
+ * Renders the part of a text view visible in a viewport
+ *
+ * Rows overlapping the viewport are drawn; the first and last row can
+ * extend past its top and bottom edge by less than one line. Rows already
+ * emitted by previous frames are reused, so a scroll by N lines emits N rows.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer (projection must be set)
+ *   view: Text view created with glyph_text_view_create
+ *   x, y: Screen position of the viewport's top-left corner
+ *   width, height: Viewport size in pixels
+ *   scroll_x: Horizontal scroll in pixels
+ *   scroll_y: Vertical scroll in pixels (double keeps precision for millions of lines)
+ *   r, g, b: Text color as RGB values (0.0-1.0 range)
+ *   effects: Bitmask of text effects (GLYPHGL_BOLD, GLYPHGL_ITALIC, etc.)
+ *
+ * Returns: Number of rows emitted this frame, or -1 on failure
+ */
+static inline int glyph_renderer_draw_text_view(glyph_renderer_t* renderer, glyph_text_view_t* view, float x, float y,
+                                                float width, float height, float scroll_x, double scroll_y,
+                                                float r, float g, float b, int effects) {
+    if (!renderer || !renderer->initialized || !view || !view->initialized || view->line_height <= 0.0f) return -1;
+    if (scroll_y < 0.0) scroll_y = 0.0;
+
+    /* Ring size follows the viewport height */
+    size_t rows = (size_t)ceil(height / view->line_height) + 1;
+    if (rows != view->rows || view->slot_vertices == 0) {
+        size_t slot_vertices = view->slot_vertices;
+        if (slot_vertices == 0) {
+            /* Initial guess: a row of narrow glyphs with every effect */
+            slot_vertices = ((size_t)(width / (renderer->atlas.pixel_height * view->scale * 0.25f)) + 4) * 18;
+        }
+        if (!glyph_text_view__resize(view, rows, slot_vertices)) return -1;
+    }
+
+    /* Culling window and effects are baked into the rows */
+    if (view->effects != effects || view->emitted_scroll_x != scroll_x || view->emitted_width != width) {
+        for (size_t s = 0; s < view->rows; s++) view->slot_line[s] = (size_t)-1;
+        view->effects = effects;
+        view->emitted_scroll_x = scroll_x;
+        view->emitted_width = width;
+    }
+
+    size_t first = (size_t)(scroll_y / view->line_height);
+    if (first > view->anchor + GLYPHGL_TEXT_VIEW_ANCHOR_LINES || first + GLYPHGL_TEXT_VIEW_ANCHOR_LINES < view->anchor) {
+        /* Re-base stored positions near the viewport */
+        view->anchor = first;
+        for (size_t s = 0; s < view->rows; s++) view->slot_line[s] = (size_t)-1;
+    }
+
+    int emitted = 0;
+    glyph__glBindBuffer(GL_ARRAY_BUFFER, view->vbo);
+    for (size_t line = first; line < first + view->rows; line++) {
+        size_t slot = line % view->rows;
+        if (view->slot_line[slot] == line) continue;
+        if (!glyph_renderer__reserve(renderer, view->slot_vertices * 4)) return -1;
+        size_t needed = glyph_text_view__emit_row(renderer, view, line, scroll_x, width, effects, renderer->vertex_buffer);
+        if (needed > view->slot_vertices) {
+            /* Row too long for the slots - grow every slot and start over */
+            if (!glyph_text_view__resize(view, view->rows, needed * 2)) return -1;
+            glyph__glBindBuffer(GL_ARRAY_BUFFER, view->vbo);
+            line = first - 1;
+            emitted = 0;
+            continue;
+        }
+        glyph__glBufferSubData(GL_ARRAY_BUFFER, slot * view->slot_vertices * 4 * sizeof(float),
+                               view->slot_vertices * 4 * sizeof(float), renderer->vertex_buffer);
+        GLYPH__STATS_ADD(renderer->stats.bytes_uploaded, view->slot_vertices * 4 * sizeof(float));
+        view->slot_line[slot] = line;
+        emitted++;
+    }
+    glyph__glBindBuffer(GL_ARRAY_BUFFER, 0);
+    view->emitted_rows = (size_t)emitted;
+
+    /* One draw for the whole ring, translated by the anchor and scroll */
+    glyph_renderer__bind(renderer, r, g, b, effects);
+    glyph__glBindVertexArray(view->vao);
+    GLint projection_location = glyph__glGetUniformLocation(renderer->shader, "projection");
+    float tx = x - scroll_x;
+    float ty = y + (float)((double)view->anchor * view->line_height - scroll_y);
+    glyph_renderer__translate(renderer, projection_location, tx, ty);
+    glyph_renderer__draw_arrays(renderer, 0, view->rows * view->slot_vertices);
+    glyph__glUniformMatrix4fv(projection_location, 1, GL_FALSE, renderer->projection);
+    GLYPH__STATS_ADD(renderer->stats.uniform_updates, 1);
+    glyph__glBindVertexArray(0);
+    glyph__glUseProgram(0);
+    return emitted;
+}
+
+/*
+ * Measures the advance width of a single word at scale 1.0
+ *
+ * Parameters:
+ *   atlas: Glyph atlas
+ *   char_type: GLYPH_UTF8 or GLYPH_ASCII
+ *   text, len: Word bytes (must not be empty)
+ *   first, last: Receive the first and last codepoint of the word
+ *
+ * Returns: Sum of advances plus internal kerning in pixels
+ */
+static inline float glyph_renderer__measure_word(const glyph_atlas_t* atlas, uint32_t char_type, const char* text, size_t len,
+                                                 int* first, int* last) {
+    float width = 0.0f;
+    int prev = -1;
+    size_t i = 0;
+    while (i < len) {
+        int codepoint;
+        if (char_type == GLYPH_UTF8) {
+            codepoint = glyph_atlas_utf8_decode_len(text, len, &i);
+        } else {
+            codepoint = (unsigned char)text[i++];
+        }
+        if (prev >= 0) {
+            width += glyph_atlas_get_kerning(atlas, prev, codepoint);
+        } else {
+            *first = codepoint;
+        }
+        width += glyph_atlas_get_advance(atlas, codepoint);
+        prev = codepoint;
+    }
+    *last = prev;
+    return width;
+}
+
+/*
+ * Measures the size of a string without drawing it
+ *
+ * The width uses the same advances and kerning as glyph_renderer_draw_text;
+ * the height comes from the font's hhea ascender, descender and line gap.
+ * '\n' starts a new line: the width is that of the widest line and each extra
+ * line adds one line height (ascender - descender + line gap).
+ *
+ * Word widths are kept in a small cache, so re-measuring the same paragraphs
+ * (for example during window resizes) costs O(words) rather than O(glyphs).
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *   text: UTF-8 or ASCII string to measure
+ *   len: Length of the string in bytes
+ *   scale: Text scaling factor (1.0 = normal size)
+ *   width: Receives the width in pixels (may be NULL)
+ *   height: Receives the height in pixels (may be NULL)
+ *
+ * Returns: 0 on success, -1 on failure
+ */
+static inline int glyph_renderer_measure_text(glyph_renderer_t* renderer, const char* text, size_t len, float scale,
+                                              float* width, float* height) {
+    if (!renderer || !renderer->initialized || !text) return -1;
+    glyph_atlas_t* atlas = &renderer->atlas;
+
+    /* Allocate the word cache lazily */
+    if (!renderer->word_cache) {
+        renderer->word_cache = (glyph_word_cache_entry_t*)glyph__mem_alloc(renderer->atlas.allocator, sizeof(glyph_word_cache_entry_t) * GLYPHGL_WORD_CACHE_SIZE, GLYPH_MEMORY_VERTEX);
+        if (renderer->word_cache) {
+            memset(renderer->word_cache, 0, sizeof(glyph_word_cache_entry_t) * GLYPHGL_WORD_CACHE_SIZE);
+        }
+    }
+
+    float space_advance = glyph_atlas_get_advance(atlas, ' ');
+    float line_width = 0.0f;
+    float max_width = 0.0f;
+    int lines = 1;
+    int prev = -1; /* Last codepoint on the current line, for kerning across words */
+    size_t i = 0;
+    while (i < len) {
+        char c = text[i];
+        if (c == '\n') {
+            if (line_width > max_width) max_width = line_width;
+            line_width = 0.0f;
+            prev = -1;
+            lines++;
+            i++;
+            continue;
+        }
+        if (c == ' ') {
+            if (prev >= 0) line_width += glyph_atlas_get_kerning(atlas, prev, ' ');
+            line_width += space_advance;
+            prev = ' ';
+            i++;
+            continue;
+        }
+
+        /* Find the end of the word */
+        size_t end = i;
+        while (end < len && text[end] != ' ' && text[end] != '\n') end++;
+        size_t word_len = end - i;
+
+        /* Look the word up in the direct-mapped cache */
+        float word_width;
+        int first = -1, last = -1;
+        glyph_word_cache_entry_t* entry = NULL;
+        uint64_t hash = 0;
+        if (renderer->word_cache) {
+            hash = glyph__hash64(text + i, word_len, 0);
+            if (hash == 0) hash = 1;
+            entry = &renderer->word_cache[hash % GLYPHGL_WORD_CACHE_SIZE];
+        }
+        if (entry && entry->hash == hash && entry->len == word_len && memcmp(entry->word, text + i, word_len) == 0) {
+            word_width = entry->width;
+            first = entry->first;
+            last = entry->last;
+        } else {
+            word_width = glyph_renderer__measure_word(atlas, renderer->char_type, text + i, word_len, &first, &last);
+            if (entry && word_len > entry->word_capacity) {
+                char* new_word = (char*)glyph__mem_realloc(renderer->atlas.allocator, entry->word, word_len, GLYPH_MEMORY_VERTEX);
+                if (new_word) {
+                    entry->word = new_word;
+                    entry->word_capacity = word_len;
+                } else {
+                    entry->hash = 0; /* Allocation failed - leave the slot empty */
+                    entry = NULL;
+                }
+            }
+            if (entry) {
+                memcpy(entry->word, text + i, word_len);
+                entry->hash = hash;
+                entry->len = word_len;
+                entry->width = word_width;
+                entry->first = first;
+                entry->last = last;
+            }
+        }
+
+        if (prev >= 0) line_width += glyph_atlas_get_kerning(atlas, prev, first);
+        line_width += word_width;
+        prev = last;
+        i = end;
+    }
+    if (line_width > max_width) max_width = line_width;
+
+    if (width) *width = max_width * scale;
+    if (height) {
+        float line_height = atlas->ascender - atlas->descender + atlas->line_gap;
+        *height = (atlas->ascender - atlas->descender + (lines - 1) * line_height) * scale;
+    }
+    return 0;
+}
+
+/*
+ * Returns the OpenGL Vertex Array Object handle for advanced rendering control
+ *
+ * This getter provides access to the internal VAO for users who need to
+ * integrate GlyphGL rendering with their own OpenGL state management or
+ * custom rendering pipelines.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *
+ * Returns: OpenGL VAO handle (GLuint), or 0 if renderer invalid
+ */
+static inline GLuint glyph_renderer_get_vao(glyph_renderer_t* renderer) {
+    return renderer->vao;
+}
+
+/*
+ * Returns the OpenGL Vertex Buffer Object handle for advanced rendering control
+ *
+ * Provides access to the internal VBO containing batched vertex data.
+ * Useful for debugging, custom batching, or integration with external
+ * rendering systems.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *
+ * Returns: OpenGL VBO handle (GLuint), or 0 if renderer invalid
+ */
+static inline GLuint glyph_renderer_get_vbo(glyph_renderer_t* renderer) {
+    return renderer->vbo;
+}
+
+/*
+ * Returns the OpenGL shader program handle for advanced shader management
+ *
+ * Allows access to the compiled shader program for custom uniform setting,
+ * shader introspection, or integration with effect systems that need
+ * to modify shader state directly.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer
+ *
+ * Returns: OpenGL shader program handle (GLuint), or 0 if renderer invalid
+ */
+static inline GLuint glyph_renderer_get_shader(glyph_renderer_t* renderer) {
+    return renderer->shader;
+}
+
+/*
+ * Decodes a single UTF-8 codepoint from a string and advances the index
+ *
+ * This function implements UTF-8 decoding according to RFC 3629, handling
+ * 1-4 byte sequences correctly. It advances the index past the decoded
+ * character and returns the Unicode codepoint value.
+ *
+ * Only the bytes of the current sequence are read, so walking a whole
+ * string costs O(n). Callers that know the length can use
+ * glyph_atlas_utf8_decode_len directly.
+ *
+ * Parameters:
+ *   str: UTF-8 encoded string to decode from
+ *   index: Pointer to current position in string, at most strlen(str) (updated on return)
+ *
+ * Returns:
+ *   Unicode codepoint (int), or 0xFFFD (replacement character) on error
+ *   Returns 0 if end of string reached
+ *
+ * UTF-8 encoding:
+ * - 1 byte:  0xxxxxxx (ASCII, 0-127)
+ * - 2 bytes: 110xxxxx 10xxxxxx (128-2047)
+ * - 3 bytes: 1110xxxx 10xxxxxx 10xxxxxx (2048-65535)
+ * - 4 bytes: 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx (65536-1114111)
+ */
+static inline int glyph_utf8_decode(const char* str, size_t* index) {
+    /* A sequence spans at most 4 bytes: only look that far for the terminator */
+    size_t len = *index;
+    while (len < *index + 4 && str[len]) len++;
+    /* Check for end of string */
+    if (len == *index) {
+        return 0;
+    }
+    /* Malformed sequences consume one byte and yield 0xFFFD */
+    return glyph_atlas_utf8_decode_len(str, len, index);
 }
 
 #endif
\ No newline at end of file
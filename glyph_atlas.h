@@ -52,6 +52,23 @@
 #define GLYPHGL_ATLAS_WIDTH 2048   /* Default atlas width in pixels */
 #define GLYPHGL_ATLAS_HEIGHT 2048  /* Default atlas height in pixels */
 
+/*
+ * Mip levels the renderer builds for the atlas texture (1 = base level only).
+ * Extra levels keep text drawn well below the atlas pixel height stable and
+ * cheap to sample; glyph padding grows with the count so that bilinear taps
+ * at the smallest level never reach a neighbouring glyph. Padding stops
+ * growing after six levels: by then a glyph covers about a texel and the
+ * deeper levels are a uniform blur anyway.
+ */
+#ifndef GLYPHGL_MIP_LEVELS
+#define GLYPHGL_MIP_LEVELS 1
+#endif
+#if GLYPHGL_MIP_LEVELS > 1
+#define GLYPH_ATLAS__PADDING (3 << ((GLYPHGL_MIP_LEVELS < 6 ? GLYPHGL_MIP_LEVELS : 6) - 1)) /* One texel plus its bilinear neighbour at the last level */
+#else
+#define GLYPH_ATLAS__PADDING 4
+#endif
+
 #if defined(_WIN32) || defined(_WIN64)
     #include <windows.h>
     #include <stdio.h>
@@ -122,6 +139,56 @@ static int glyph_atlas_utf8_decode(const char* str, size_t* index) {
     return 0xFFFD; /* Unicode replacement character */
 }
 
+/*
+ * Length-bounded UTF-8 decoder used by the text rendering paths
+ *
+ * Unlike glyph_atlas_utf8_decode, this variant never reads past 'len' and
+ * validates continuation bytes. Malformed sequences consume a single byte and
+ * yield the replacement character, so callers always make forward progress.
+ *
+ * Parameters:
+ *   str: UTF-8 encoded string
+ *   len: Length of the string in bytes
+ *   index: Current position in string (updated to next character)
+ *
+ * Returns: Unicode codepoint or 0xFFFD (replacement character) on error
+ */
+static inline int glyph_atlas_utf8_decode_len(const char* str, size_t len, size_t* index) {
+    size_t i = *index;
+    unsigned char c = (unsigned char)str[i];
+    /* 1-byte ASCII character (most common case) */
+    if (c < 0x80) {
+        *index = i + 1;
+        return c;
+    }
+    /* Determine sequence length from the lead byte */
+    int extra;
+    int codepoint;
+    if ((c & 0xE0) == 0xC0)      { extra = 1; codepoint = c & 0x1F; }
+    else if ((c & 0xF0) == 0xE0) { extra = 2; codepoint = c & 0x0F; }
+    else if ((c & 0xF8) == 0xF0) { extra = 3; codepoint = c & 0x07; }
+    else {
+        *index = i + 1;
+        return 0xFFFD; /* Invalid lead byte */
+    }
+    /* Incomplete sequence at end of input */
+    if (i + extra >= len) {
+        *index = i + 1;
+        return 0xFFFD;
+    }
+    /* Accumulate continuation bytes */
+    for (int k = 1; k <= extra; k++) {
+        unsigned char cc = (unsigned char)str[i + k];
+        if ((cc & 0xC0) != 0x80) {
+            *index = i + 1;
+            return 0xFFFD; /* Invalid continuation byte */
+        }
+        codepoint = (codepoint << 6) | (cc & 0x3F);
+    }
+    *index = i + 1 + extra;
+    return codepoint;
+}
+
 /*
  * Individual character data stored in the atlas
  *
@@ -136,6 +203,22 @@ typedef struct {
     int advance;       /* Horizontal advance width for cursor positioning */
 } glyph_atlas_char_t;
 
+/*
+ * Kerning pair between two atlas characters
+ *
+ * Pairs are sorted by (left, right) codepoint for binary search.
+ */
+typedef struct {
+    int left, right;   /* Codepoints of the kerned pair */
+    float advance;     /* Advance adjustment in pixels at the atlas pixel height */
+} glyph_atlas_kern_t;
+
+/* Codepoint lookup entry, sorted by codepoint for binary search */
+typedef struct {
+    int codepoint;     /* Unicode codepoint */
+    int char_index;    /* Index into atlas->chars */
+} glyph_atlas_lookup_t;
+
 /*
  * Font atlas containing pre-rasterized glyphs packed into a texture
  *
@@ -148,6 +231,18 @@ typedef struct {
     glyph_atlas_char_t* chars;  /* Array of character data (one per glyph) */
     int num_chars;              /* Number of characters in the atlas */
     float pixel_height;         /* Font size used for rasterization */
+    uint32_t char_type;         /* Character encoding the atlas was built for (GLYPH_UTF8 or GLYPH_ASCII) */
+    float ascender;             /* hhea ascender in pixels (above baseline, positive) */
+    float descender;            /* hhea descender in pixels (below baseline, negative) */
+    float line_gap;             /* hhea line gap in pixels */
+    glyph_atlas_kern_t* kerning; /* Sorted kerning pairs between atlas characters (may be NULL) */
+    int num_kerning;            /* Number of kerning pairs */
+    glyph_atlas_lookup_t* lookup; /* Characters sorted by codepoint (NULL = linear search) */
+    int ascii_index[128];       /* Direct char index for ASCII codepoints (-1 = missing) */
+    glyph_allocator_t* allocator; /* Allocator the atlas memory came from (NULL = GLYPH_MALLOC) */
+#ifdef GLYPHGL_STATS
+    glyph_stats_t stats;        /* Build phase timings (see glyph_atlas_get_stats) */
+#endif
 } glyph_atlas_t;
 
 /*
@@ -174,6 +269,213 @@ static int glyph_atlas__next_pow2(int v) {
 }
 
 
+/* Glyph index to atlas character mapping used while collecting kerning pairs */
+typedef struct {
+    int glyph_index;
+    int char_index;
+} glyph_atlas__glyph_map_t;
+
+static int glyph_atlas__cmp_glyph_map(const void* a, const void* b) {
+    int ga = ((const glyph_atlas__glyph_map_t*)a)->glyph_index;
+    int gb = ((const glyph_atlas__glyph_map_t*)b)->glyph_index;
+    return (ga > gb) - (ga < gb);
+}
+
+static int glyph_atlas__cmp_kern(const void* a, const void* b) {
+    const glyph_atlas_kern_t* ka = (const glyph_atlas_kern_t*)a;
+    const glyph_atlas_kern_t* kb = (const glyph_atlas_kern_t*)b;
+    if (ka->left != kb->left) return (ka->left > kb->left) - (ka->left < kb->left);
+    return (ka->right > kb->right) - (ka->right < kb->right);
+}
+
+/* Returns the first map entry with the given glyph index, or -1 */
+static int glyph_atlas__find_glyph_map(const glyph_atlas__glyph_map_t* map, int count, int glyph_index) {
+    int lo = 0, hi = count;
+    while (lo < hi) {
+        int mid = (lo + hi) >> 1;
+        if (map[mid].glyph_index < glyph_index) lo = mid + 1;
+        else hi = mid;
+    }
+    return (lo < count && map[lo].glyph_index == glyph_index) ? lo : -1;
+}
+
+static int glyph_atlas__cmp_lookup(const void* a, const void* b) {
+    const glyph_atlas_lookup_t* la = (const glyph_atlas_lookup_t*)a;
+    const glyph_atlas_lookup_t* lb = (const glyph_atlas_lookup_t*)b;
+    if (la->codepoint != lb->codepoint) return (la->codepoint > lb->codepoint) - (la->codepoint < lb->codepoint);
+    return (la->char_index > lb->char_index) - (la->char_index < lb->char_index);
+}
+
+/*
+ * Builds the codepoint lookup used by glyph_atlas_find_char
+ *
+ * ASCII codepoints resolve through a direct table, everything else through
+ * binary search. Duplicate codepoints resolve to the first character, as
+ * with a linear search. On allocation failure the atlas keeps using linear
+ * search.
+ */
+static void glyph_atlas__build_lookup(glyph_atlas_t* atlas) {
+    for (int c = 0; c < 128; c++) atlas->ascii_index[c] = -1;
+    if (atlas->num_chars <= 0) return;
+    atlas->lookup = (glyph_atlas_lookup_t*)glyph__mem_alloc(atlas->allocator, atlas->num_chars * sizeof(glyph_atlas_lookup_t), GLYPH_MEMORY_ATLAS);
+    if (!atlas->lookup) return;
+    for (int i = 0; i < atlas->num_chars; i++) {
+        atlas->lookup[i].codepoint = atlas->chars[i].codepoint;
+        atlas->lookup[i].char_index = i;
+    }
+    qsort(atlas->lookup, atlas->num_chars, sizeof(glyph_atlas_lookup_t), glyph_atlas__cmp_lookup);
+    for (int i = atlas->num_chars - 1; i >= 0; i--) {
+        int codepoint = atlas->chars[i].codepoint;
+        if (codepoint >= 0 && codepoint < 128) atlas->ascii_index[codepoint] = i;
+    }
+}
+
+/*
+ * Collects the 'kern' table pairs whose glyphs are both present in the atlas
+ *
+ * Font pairs are keyed by glyph index; the atlas stores them by codepoint,
+ * scaled to pixels, sorted for binary search in glyph_atlas_get_kerning.
+ *
+ * Parameters:
+ *   atlas: Atlas being created (chars[] must hold the codepoints)
+ *   font: Loaded font
+ *   scale: Font units to pixel conversion factor
+ *   glyph_indices: Font glyph index of each atlas character
+ */
+static void glyph_atlas__build_kerning(glyph_atlas_t* atlas, const glyph_font_t* font, float scale, const int* glyph_indices) {
+    int num_pairs;
+    int pairs = glyph_ttf__find_kern_pairs(font, &num_pairs);
+    if (!pairs || num_pairs == 0) return;
+
+    /* Sorted glyph -> character map (skip .notdef) */
+    glyph_atlas__glyph_map_t* map = (glyph_atlas__glyph_map_t*)glyph__mem_alloc(atlas->allocator, atlas->num_chars * sizeof(glyph_atlas__glyph_map_t), GLYPH_MEMORY_SCRATCH);
+    if (!map) return;
+    int map_count = 0;
+    for (int i = 0; i < atlas->num_chars; i++) {
+        if (glyph_indices[i] == 0) continue;
+        map[map_count].glyph_index = glyph_indices[i];
+        map[map_count].char_index = i;
+        map_count++;
+    }
+    qsort(map, map_count, sizeof(glyph_atlas__glyph_map_t), glyph_atlas__cmp_glyph_map);
+
+    int capacity = 0;
+    for (int p = 0; p < num_pairs; p++) {
+        int record = pairs + p * 6;
+        int left = glyph_atlas__find_glyph_map(map, map_count, glyph_ttf__get16u(font->data, record));
+        if (left < 0) continue;
+        int right = glyph_atlas__find_glyph_map(map, map_count, glyph_ttf__get16u(font->data, record + 2));
+        if (right < 0) continue;
+        float advance = glyph_ttf__get16(font->data, record + 4) * scale;
+
+        /* Several codepoints may share a glyph - emit every combination */
+        for (int l = left; l < map_count && map[l].glyph_index == map[left].glyph_index; l++) {
+            for (int r = right; r < map_count && map[r].glyph_index == map[right].glyph_index; r++) {
+                if (atlas->num_kerning == capacity) {
+                    int new_capacity = capacity ? capacity * 2 : 256;
+                    glyph_atlas_kern_t* grown = (glyph_atlas_kern_t*)glyph__mem_realloc(atlas->allocator, atlas->kerning, new_capacity * sizeof(glyph_atlas_kern_t), GLYPH_MEMORY_ATLAS);
+                    if (!grown) {
+                        glyph__mem_free(atlas->allocator, map);
+                        return;
+                    }
+                    atlas->kerning = grown;
+                    capacity = new_capacity;
+                }
+                glyph_atlas_kern_t* k = &atlas->kerning[atlas->num_kerning++];
+                k->left = atlas->chars[map[l].char_index].codepoint;
+                k->right = atlas->chars[map[r].char_index].codepoint;
+                k->advance = advance;
+            }
+        }
+    }
+    glyph__mem_free(atlas->allocator, map);
+
+    if (atlas->num_kerning > 1) {
+        qsort(atlas->kerning, atlas->num_kerning, sizeof(glyph_atlas_kern_t), glyph_atlas__cmp_kern);
+    }
+}
+
+/* Temporary structure to hold glyph bitmaps during atlas creation */
+typedef struct {
+    unsigned char* bitmap;  /* Rasterized glyph bitmap data */
+    int width, height;      /* Bitmap dimensions */
+    int xoff, yoff;         /* Baseline offsets */
+    int advance;            /* Cursor advance width */
+    int glyph_index;        /* Font glyph index (for kerning) */
+#ifdef GLYPHGL_STATS
+    uint64_t rasterize_ns;  /* Time spent rasterizing this glyph */
+    uint64_t sdf_ns;        /* Time spent converting it to an SDF */
+#endif
+} glyph_atlas__temp_glyph_t;
+
+/* Shared state of the per-glyph rasterization tasks */
+typedef struct {
+    const glyph_font_t* font;               /* Loaded font (read-only) */
+    float scale;                            /* Font units to pixel conversion factor */
+    float pixel_height;                     /* Requested pixel height (for missing glyphs) */
+    int use_sdf;                            /* Convert bitmaps to SDF */
+    glyph_atlas__temp_glyph_t* glyphs;      /* Output slot per character */
+    glyph_atlas_char_t* chars;              /* Atlas characters (codepoints set, advance written) */
+} glyph_atlas__raster_job_t;
+
+/*
+ * Rasterizes one charset character (a glyph_task_func_t)
+ *
+ * Only reads the font and writes the character's own slots, so the
+ * characters can be processed in parallel through the executor.
+ */
+static void glyph_atlas__rasterize_task(void* arg, size_t index) {
+    glyph_atlas__raster_job_t* job = (glyph_atlas__raster_job_t*)arg;
+    glyph_atlas__temp_glyph_t* g = &job->glyphs[index];
+    int codepoint = job->chars[index].codepoint;
+
+    /* Handle missing glyphs (glyph_idx == 0 means .notdef glyph) */
+    if (g->glyph_index == 0 && codepoint != ' ') {
+        /* Create fallback data for missing characters */
+        g->bitmap = NULL;
+        g->width = 0;
+        g->height = 0;
+        g->xoff = 0;
+        g->yoff = 0;
+        g->advance = (int)(job->pixel_height * 0.5f); /* Half-width fallback */
+        job->chars[index].advance = g->advance;
+        return;
+    }
+
+    /* Rasterize the glyph into a bitmap */
+    int width, height, xoff, yoff;
+    GLYPH__STATS_BEGIN(raster_start);
+    GLYPH__TRACE_BEGIN(raster_trace);
+    unsigned char* bitmap = glyph_ttf_get_glyph_bitmap(job->font, g->glyph_index, job->scale, job->scale,
+                                                       &width, &height, &xoff, &yoff);
+    GLYPH__TRACE_END(raster_trace, "rasterize", "codepoint", codepoint);
+    GLYPH__STATS_END(raster_start, g->rasterize_ns);
+
+    /* Convert to Signed Distance Field if requested */
+    if (job->use_sdf && bitmap) {
+        GLYPH__STATS_BEGIN(sdf_start);
+        GLYPH__TRACE_BEGIN(sdf_trace);
+        /* Generate SDF bitmap for smooth scaling */
+        unsigned char* sdf = glyph_ttf_get_glyph_sdf_bitmap_ex(bitmap, width, height, 4, job->font->allocator);
+        /* Free original bitmap */
+        glyph_ttf_free_font_bitmap(job->font, bitmap);
+        bitmap = sdf; /* Use SDF bitmap instead */
+        GLYPH__TRACE_END(sdf_trace, "sdf", "codepoint", codepoint);
+        GLYPH__STATS_END(sdf_start, g->sdf_ns);
+    }
+
+    /* Store glyph data in temporary structure */
+    g->bitmap = bitmap;
+    g->width = width;
+    g->height = height;
+    g->xoff = xoff;
+    g->yoff = yoff;
+
+    /* Get horizontal advance width */
+    g->advance = (int)(glyph_ttf_get_glyph_advance(job->font, g->glyph_index) * job->scale);
+    job->chars[index].advance = g->advance;
+}
+
 /*
  * Creates a font atlas by rasterizing and packing glyphs into a texture
  *
@@ -193,26 +495,38 @@ static int glyph_atlas__next_pow2(int v) {
  *   charset: String containing all characters to include
  *   char_type: GLYPH_UTF8 or GLYPH_ASCII encoding type
  *   use_sdf: Enable Signed Distance Field rendering (smoother scaling)
+ *   allocator: Source of the atlas memory and the font/rasterizer temporaries (NULL = GLYPH_MALLOC)
  *
  * Returns: Complete glyph_atlas_t or zero-initialized struct on failure
  */
-static inline glyph_atlas_t glyph_atlas_create(const char* font_path, float pixel_height, const char* charset, uint32_t char_type, int use_sdf) {
+static inline glyph_atlas_t glyph_atlas_create_ex(const char* font_path, float pixel_height, const char* charset, uint32_t char_type, int use_sdf, glyph_allocator_t* allocator) {
     /* Initialize atlas structure */
     glyph_atlas_t atlas = {0};
+    atlas.allocator = allocator;
 
     /* Font structure */
     glyph_font_t ttf_font;
     float scale; /* Font units to pixel conversion factor */
 
     /* Load TrueType font */
-    if (!glyph_ttf_load_font_from_file(&ttf_font, font_path)) {
+    GLYPH__STATS_BEGIN(load_start);
+    if (!glyph_ttf_load_font_from_file_ex(&ttf_font, font_path, allocator)) {
         GLYPH_LOG("Failed to load TTF font: %s\n", font_path);
         return atlas;
     }
+    GLYPH__STATS_END(load_start, atlas.stats.font_load_ns);
     scale = glyph_ttf_scale_for_pixel_height(&ttf_font, pixel_height);
     
-    /* Store the pixel height for reference */
+    /* Store the pixel height, encoding and line metrics for layout */
     atlas.pixel_height = pixel_height;
+    atlas.char_type = char_type;
+    {
+        int ascent, descent, line_gap;
+        glyph_ttf_get_vmetrics(&ttf_font, &ascent, &descent, &line_gap);
+        atlas.ascender = ascent * scale;
+        atlas.descender = descent * scale;
+        atlas.line_gap = line_gap * scale;
+    }
 
     /* Use default ASCII charset if none provided */
     if (!charset) {
@@ -240,36 +554,25 @@ static inline glyph_atlas_t glyph_atlas_create(const char* font_path, float pixe
 
     /* Allocate character data array */
     atlas.num_chars = charset_len;
-    atlas.chars = (glyph_atlas_char_t*)GLYPH_MALLOC(charset_len * sizeof(glyph_atlas_char_t));
+    atlas.chars = (glyph_atlas_char_t*)glyph__mem_alloc(allocator, charset_len * sizeof(glyph_atlas_char_t), GLYPH_MEMORY_ATLAS);
     if (!atlas.chars) {
         /* Cleanup on allocation failure */
         glyph_ttf_free_font(&ttf_font);
         return atlas;
     }
 
-    /* Temporary structure to hold glyph bitmaps during processing */
-    typedef struct {
-        unsigned char* bitmap;  /* Rasterized glyph bitmap data */
-        int width, height;      /* Bitmap dimensions */
-        int xoff, yoff;         /* Baseline offsets */
-        int advance;            /* Cursor advance width */
-        int is_default;         /* Flag for SDF-generated bitmaps */
-    } temp_glyph_t;
-
     /* Allocate temporary glyph storage */
-    temp_glyph_t* temp_glyphs = (temp_glyph_t*)GLYPH_MALLOC(charset_len * sizeof(temp_glyph_t));
+    glyph_atlas__temp_glyph_t* temp_glyphs = (glyph_atlas__temp_glyph_t*)glyph__mem_alloc(allocator, charset_len * sizeof(glyph_atlas__temp_glyph_t), GLYPH_MEMORY_SCRATCH);
     if (!temp_glyphs) {
         /* Cleanup on allocation failure */
-        GLYPH_FREE(atlas.chars);
+        glyph__mem_free(allocator, atlas.chars);
         atlas.chars = NULL;
         glyph_ttf_free_font(&ttf_font);
         return atlas;
     }
 
-    /* Phase 1: Rasterize all glyphs and calculate atlas requirements */
-    int total_width = 0;  /* Estimate total width needed for all glyphs */
-    int max_height = 0;   /* Track maximum glyph height */
-
+    /* Phase 1: Decode the charset and map codepoints to font glyphs */
+    GLYPH__STATS_BEGIN(cmap_start);
     size_t charset_idx = 0; /* Index for UTF-8 charset traversal */
     for (int i = 0; i < charset_len; i++) {
         /* Decode next character from charset */
@@ -279,72 +582,52 @@ static inline glyph_atlas_t glyph_atlas_create(const char* font_path, float pixe
         } else {
             codepoint = (unsigned char)charset[i];
         }
+        atlas.chars[i].codepoint = codepoint;
 
         /* Find glyph index in font (maps codepoint to glyph) */
-        int glyph_idx = glyph_ttf_find_glyph_index(&ttf_font, codepoint);
-
-        /* Handle missing glyphs (glyph_idx == 0 means .notdef glyph) */
-        if (glyph_idx == 0 && codepoint != ' ') {
-            /* Create fallback data for missing characters */
-            temp_glyphs[i].bitmap = NULL;
-            temp_glyphs[i].width = 0;
-            temp_glyphs[i].height = 0;
-            temp_glyphs[i].xoff = 0;
-            temp_glyphs[i].yoff = 0;
-            temp_glyphs[i].advance = (int)(pixel_height * 0.5f); /* Half-width fallback */
-            temp_glyphs[i].is_default = 0;
-            atlas.chars[i].codepoint = codepoint;
-            continue;
-        }
-
-        /* Rasterize the glyph into a bitmap */
-        int width, height, xoff, yoff;
-        unsigned char* bitmap;
-
-        /* Get glyph bitmap from TrueType font */
-        bitmap = glyph_ttf_get_glyph_bitmap(&ttf_font, glyph_idx, scale, scale,
-                                             &width, &height, &xoff, &yoff);
-
-        /* Convert to Signed Distance Field if requested */
-        if (use_sdf && bitmap) {
-            /* Generate SDF bitmap for smooth scaling */
-            unsigned char* sdf = glyph_ttf_get_glyph_sdf_bitmap(bitmap, width, height, 4);
-            /* Free original bitmap */
-            glyph_ttf_free_bitmap(bitmap);
-            bitmap = sdf; /* Use SDF bitmap instead */
-            temp_glyphs[i].is_default = 1; /* Mark as SDF-generated */
-        }
-
-        /* Store glyph data in temporary structure */
-        temp_glyphs[i].bitmap = bitmap;
-        temp_glyphs[i].width = width;
-        temp_glyphs[i].height = height;
-        temp_glyphs[i].xoff = xoff;
-        temp_glyphs[i].yoff = yoff;
-
-        /* Get horizontal advance width */
-        temp_glyphs[i].advance = (int)(glyph_ttf_get_glyph_advance(&ttf_font, glyph_idx) * scale);
-        temp_glyphs[i].is_default = use_sdf ? 1 : 0;
-
-        /* Store basic character info */
-        atlas.chars[i].codepoint = codepoint;
-        atlas.chars[i].advance = temp_glyphs[i].advance;
+        temp_glyphs[i].glyph_index = glyph_ttf_find_glyph_index(&ttf_font, codepoint);
+#ifdef GLYPHGL_STATS
+        temp_glyphs[i].rasterize_ns = 0;
+        temp_glyphs[i].sdf_ns = 0;
+#endif
+    }
+    GLYPH__STATS_END(cmap_start, atlas.stats.cmap_lookup_ns);
+
+    /* Rasterize all glyphs - one task per character through the executor */
+    glyph_atlas__raster_job_t raster_job;
+    raster_job.font = &ttf_font;
+    raster_job.scale = scale;
+    raster_job.pixel_height = pixel_height;
+    raster_job.use_sdf = use_sdf;
+    raster_job.glyphs = temp_glyphs;
+    raster_job.chars = atlas.chars;
+    glyph__parallel_for(glyph_atlas__rasterize_task, &raster_job, (size_t)charset_len);
+
+    /* Calculate atlas requirements */
+    int total_width = 0;  /* Estimate total width needed for all glyphs */
+    int max_height = 0;   /* Track maximum glyph height */
+    for (int i = 0; i < charset_len; i++) {
+        GLYPH__STATS_ADD(atlas.stats.rasterize_ns, temp_glyphs[i].rasterize_ns);
+        GLYPH__STATS_ADD(atlas.stats.sdf_ns, temp_glyphs[i].sdf_ns);
+        if (temp_glyphs[i].glyph_index == 0 && atlas.chars[i].codepoint != ' ') continue; /* Missing glyph */
 
         /* Accumulate atlas size requirements */
-        total_width += width + 4; /* Add padding between glyphs */
-        if (height > max_height) {
-            max_height = height;
+        total_width += temp_glyphs[i].width + GLYPH_ATLAS__PADDING; /* Add padding between glyphs */
+        if (temp_glyphs[i].height > max_height) {
+            max_height = temp_glyphs[i].height;
         }
     }
 
     /* Phase 2: Sort glyphs by height for optimal packing */
     /* Sort glyphs tallest-first to minimize wasted vertical space */
-    int* glyph_order = (int*)GLYPH_MALLOC(charset_len * sizeof(int));
+    GLYPH__STATS_BEGIN(pack_start);
+    GLYPH__TRACE_BEGIN(pack_trace);
+    int* glyph_order = (int*)glyph__mem_alloc(allocator, charset_len * sizeof(int), GLYPH_MEMORY_SCRATCH);
     if (!glyph_order) {
         /* Cleanup on allocation failure */
-        GLYPH_FREE(atlas.chars);
+        glyph__mem_free(allocator, atlas.chars);
         atlas.chars = NULL;
-        GLYPH_FREE(temp_glyphs);
+        glyph__mem_free(allocator, temp_glyphs);
         glyph_ttf_free_font(&ttf_font);
         return atlas;
     }
@@ -367,7 +650,7 @@ static inline glyph_atlas_t glyph_atlas_create(const char* font_path, float pixe
     }
     
     /* Phase 3: Create atlas texture and pack glyphs */
-    int padding = 4; /* Pixels between glyphs to prevent bleeding */
+    int padding = GLYPH_ATLAS__PADDING; /* Pixels between glyphs to prevent bleeding */
 
     /* Estimate atlas size using square root of total area, round up to power-of-2 */
     int atlas_width = glyph_atlas__next_pow2((int)sqrtf(total_width * max_height) + 256);
@@ -378,7 +661,7 @@ static inline glyph_atlas_t glyph_atlas_create(const char* font_path, float pixe
     if (atlas_height < GLYPHGL_ATLAS_HEIGHT) atlas_height = GLYPHGL_ATLAS_HEIGHT;
 
     /* Create RGB image for atlas texture */
-    atlas.image = glyph_image_create(atlas_width, atlas_height);
+    atlas.image = glyph_image_create_ex(atlas_width, atlas_height, allocator);
     memset(atlas.image.data, 0, atlas_width * atlas_height * 3); /* Clear to black */
     
     /* Initialize packing cursor and row tracking */
@@ -393,7 +676,7 @@ static inline glyph_atlas_t glyph_atlas_create(const char* font_path, float pixe
     } row_glyph_t;
 
     /* Allocate space for tracking current row */
-    row_glyph_t* current_row = (row_glyph_t*)GLYPH_MALLOC(charset_len * sizeof(row_glyph_t));
+    row_glyph_t* current_row = (row_glyph_t*)glyph__mem_alloc(allocator, charset_len * sizeof(row_glyph_t), GLYPH_MEMORY_SCRATCH);
     int row_count = 0; /* Number of glyphs in current row */
 
     /* Pack glyphs into atlas using sorted order */
@@ -445,6 +728,9 @@ static inline glyph_atlas_t glyph_atlas_create(const char* font_path, float pixe
 
                 /* Update final Y position after baseline alignment */
                 atlas.chars[idx].y = atlas.chars[idx].y + glyph_top;
+
+                /* Alignment can push a glyph below the tallest one: the row ends at the lowest bottom */
+                if (glyph_top + temp_glyphs[idx].height > row_height) row_height = glyph_top + temp_glyphs[idx].height;
             }
 
             /* Start new row */
@@ -460,8 +746,8 @@ static inline glyph_atlas_t glyph_atlas_create(const char* font_path, float pixe
             /* Double atlas size and restart packing */
             atlas_width *= 2;
             atlas_height *= 2;
-            glyph_image_free(&atlas.image);
-            atlas.image = glyph_image_create(atlas_width, atlas_height);
+            glyph_image_free_ex(&atlas.image, allocator);
+            atlas.image = glyph_image_create_ex(atlas_width, atlas_height, allocator);
             memset(atlas.image.data, 0, atlas_width * atlas_height * 3);
             /* Reset packing state */
             pen_x = padding;
@@ -528,23 +814,34 @@ static inline glyph_atlas_t glyph_atlas_create(const char* font_path, float pixe
         }
     }
     
+    GLYPH__TRACE_END(pack_trace, "pack", "glyphs", charset_len);
+    GLYPH__STATS_END(pack_start, atlas.stats.pack_ns);
+
+    /* Collect kerning pairs between characters present in the atlas */
+    int* glyph_indices = (int*)glyph__mem_alloc(allocator, charset_len * sizeof(int), GLYPH_MEMORY_SCRATCH);
+    if (glyph_indices) {
+        for (int i = 0; i < charset_len; i++) {
+            glyph_indices[i] = temp_glyphs[i].glyph_index;
+        }
+        glyph_atlas__build_kerning(&atlas, &ttf_font, scale, glyph_indices);
+        glyph__mem_free(allocator, glyph_indices);
+    }
+
+    /* Fast codepoint -> character lookup */
+    glyph_atlas__build_lookup(&atlas);
+
     /* Cleanup temporary resources */
-    GLYPH_FREE(current_row);
-    GLYPH_FREE(glyph_order);
+    glyph__mem_free(allocator, current_row);
+    glyph__mem_free(allocator, glyph_order);
 
     /* Free all glyph bitmaps */
     for (int i = 0; i < charset_len; i++) {
         if (temp_glyphs[i].bitmap) {
-            if (temp_glyphs[i].is_default) {
-                /* SDF bitmaps allocated with GLYPH_MALLOC */
-                GLYPH_FREE(temp_glyphs[i].bitmap);
-            } else {
-                /* Regular bitmaps from font parsers */
-                glyph_ttf_free_bitmap(temp_glyphs[i].bitmap);
-            }
+            /* Plain and SDF bitmaps both come from the font's allocator */
+            glyph_ttf_free_font_bitmap(&ttf_font, temp_glyphs[i].bitmap);
         }
     }
-    GLYPH_FREE(temp_glyphs);
+    glyph__mem_free(allocator, temp_glyphs);
 
     /* Free font resources */
     glyph_ttf_free_font(&ttf_font);
@@ -553,11 +850,17 @@ static inline glyph_atlas_t glyph_atlas_create(const char* font_path, float pixe
     return atlas;
 }
 
+/* glyph_atlas_create_ex using GLYPH_MALLOC for all memory */
+static inline glyph_atlas_t glyph_atlas_create(const char* font_path, float pixel_height, const char* charset, uint32_t char_type, int use_sdf) {
+    return glyph_atlas_create_ex(font_path, pixel_height, charset, char_type, use_sdf, NULL);
+}
+
 /*
  * Frees all resources associated with a glyph atlas
  *
- * Deallocates the character array and atlas image. Safe to call
- * on partially initialized or empty atlases.
+ * Deallocates the character array and atlas image, returning them to the
+ * allocator the atlas was created with. Safe to call on partially
+ * initialized or empty atlases.
  *
  * Parameters:
  *   atlas: Pointer to glyph_atlas_t to free
@@ -566,11 +869,22 @@ static inline void glyph_atlas_free(glyph_atlas_t* atlas) {
     if (!atlas) return;
     /* Free character data array */
     if (atlas->chars) {
-        GLYPH_FREE(atlas->chars);
+        glyph__mem_free(atlas->allocator, atlas->chars);
         atlas->chars = NULL;
     }
+    /* Free kerning pairs */
+    if (atlas->kerning) {
+        glyph__mem_free(atlas->allocator, atlas->kerning);
+        atlas->kerning = NULL;
+    }
+    atlas->num_kerning = 0;
+    /* Free codepoint lookup */
+    if (atlas->lookup) {
+        glyph__mem_free(atlas->allocator, atlas->lookup);
+        atlas->lookup = NULL;
+    }
     /* Free atlas texture image */
-    glyph_image_free(&atlas->image);
+    glyph_image_free_ex(&atlas->image, atlas->allocator);
     atlas->num_chars = 0;
 }
 
@@ -608,6 +922,31 @@ static inline int glyph_atlas_save_bmp(glyph_atlas_t* atlas, const char* output_
     return glyph_write_bmp(output_path, &atlas->image);
 }
 
+/*
+ * Saves the atlas coverage as a BC4-compressed KTX texture
+ *
+ * Stores the red channel as GL_COMPRESSED_RED_RGTC1 with GLYPHGL_MIP_LEVELS
+ * levels, the texture glyph_renderer_create builds with GLYPHGL_BC4, so an
+ * engine can load the blocks directly instead of encoding them at startup.
+ * Pair it with glyph_atlas_save_metadata for the glyph positions.
+ *
+ * Parameters:
+ *   atlas: Pointer to glyph atlas
+ *   output_path: Path where KTX file will be written
+ *
+ * Returns: 0 on success, -1 on failure
+ */
+static inline int glyph_atlas_save_ktx(glyph_atlas_t* atlas, const char* output_path) {
+    if (!atlas || !atlas->image.data) return -1;
+    size_t pixel_count = (size_t)atlas->image.width * atlas->image.height;
+    unsigned char* red_channel = (unsigned char*)glyph__mem_alloc(atlas->allocator, pixel_count, GLYPH_MEMORY_SCRATCH);
+    if (!red_channel) return -1;
+    for (size_t i = 0; i < pixel_count; i++) red_channel[i] = atlas->image.data[i * 3];
+    int result = glyph_write_ktx_bc4(output_path, red_channel, atlas->image.width, atlas->image.height, GLYPHGL_MIP_LEVELS);
+    glyph__mem_free(atlas->allocator, red_channel);
+    return result;
+}
+
 /*
  * Saves glyph positioning metadata to a text file
  *
@@ -652,6 +991,8 @@ static inline int glyph_atlas_save_metadata(glyph_atlas_t* atlas, const char* ou
  *
  * Searches the atlas for glyph information corresponding to a
  * specific Unicode character. Returns NULL if character not found.
+ * ASCII resolves through a direct table and other codepoints through
+ * binary search; the lookup is read-only and safe to share across threads.
  *
  * Parameters:
  *   atlas: Pointer to glyph atlas
@@ -659,10 +1000,29 @@ static inline int glyph_atlas_save_metadata(glyph_atlas_t* atlas, const char* ou
  *
  * Returns: Pointer to glyph_atlas_char_t or NULL if not found
  */
-static inline glyph_atlas_char_t* glyph_atlas_find_char(glyph_atlas_t* atlas, int codepoint) {
+static inline glyph_atlas_char_t* glyph_atlas_find_char(const glyph_atlas_t* atlas, int codepoint) {
     if (!atlas || !atlas->chars) return NULL;
 
-    /* Linear search through character array */
+    if (atlas->lookup) {
+        /* Direct table for ASCII */
+        if (codepoint >= 0 && codepoint < 128) {
+            int index = atlas->ascii_index[codepoint];
+            return index >= 0 ? &atlas->chars[index] : NULL;
+        }
+        /* Binary search for everything else */
+        int lo = 0, hi = atlas->num_chars;
+        while (lo < hi) {
+            int mid = (lo + hi) >> 1;
+            if (atlas->lookup[mid].codepoint < codepoint) lo = mid + 1;
+            else hi = mid;
+        }
+        if (lo < atlas->num_chars && atlas->lookup[lo].codepoint == codepoint) {
+            return &atlas->chars[atlas->lookup[lo].char_index];
+        }
+        return NULL;
+    }
+
+    /* Linear search through character array (atlases built without a lookup) */
     for (int i = 0; i < atlas->num_chars; i++) {
         if (atlas->chars[i].codepoint == codepoint) {
             return &atlas->chars[i];
@@ -671,6 +1031,64 @@ static inline glyph_atlas_char_t* glyph_atlas_find_char(glyph_atlas_t* atlas, in
     return NULL;
 }
 
+/*
+ * Returns the kerning adjustment between two codepoints
+ *
+ * Parameters:
+ *   atlas: Pointer to glyph atlas
+ *   left, right: Codepoints of the adjacent characters
+ *
+ * Returns: Advance adjustment in pixels at the atlas pixel height (0 if none)
+ */
+static inline float glyph_atlas_get_kerning(const glyph_atlas_t* atlas, int left, int right) {
+    if (!atlas->num_kerning) return 0.0f;
+
+    int lo = 0, hi = atlas->num_kerning - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) >> 1;
+        const glyph_atlas_kern_t* k = &atlas->kerning[mid];
+        if (k->left < left || (k->left == left && k->right < right)) lo = mid + 1;
+        else if (k->left > left || k->right > right) hi = mid - 1;
+        else return k->advance;
+    }
+    return 0.0f;
+}
+
+/*
+ * Returns the build phase timings of an atlas
+ *
+ * Only populated when compiled with GLYPHGL_STATS; otherwise all zero.
+ * The per-frame counters are unused for a bare atlas.
+ */
+static inline glyph_stats_t glyph_atlas_get_stats(const glyph_atlas_t* atlas) {
+    glyph_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+#ifdef GLYPHGL_STATS
+    if (atlas) stats = atlas->stats;
+#else
+    (void)atlas;
+#endif
+    return stats;
+}
+
+/*
+ * Returns the horizontal advance used when drawing a codepoint
+ *
+ * Mirrors the renderer: characters missing from the atlas fall back to '?',
+ * and to half the pixel height if the atlas has no '?' either.
+ *
+ * Parameters:
+ *   atlas: Pointer to glyph atlas
+ *   codepoint: Unicode codepoint
+ *
+ * Returns: Advance in pixels at the atlas pixel height
+ */
+static inline float glyph_atlas_get_advance(const glyph_atlas_t* atlas, int codepoint) {
+    glyph_atlas_char_t* ch = glyph_atlas_find_char(atlas, codepoint);
+    if (!ch) ch = glyph_atlas_find_char(atlas, '?');
+    return ch ? (float)ch->advance : atlas->pixel_height * 0.5f;
+}
+
 /*
  * Prints detailed information about the atlas to the log
  *
@@ -97,18 +97,21 @@ typedef struct {
  */
 
 static const char* glyph__glow_vertex_shader = NULL;
+static glyph_once_t glyph__glow_vertex_shader_once = GLYPH_ONCE_INIT;
 static const char* glyph__get_glow_vertex_shader() {
-    if (!glyph__glow_vertex_shader) {
+    if (glyph__once_begin(&glyph__glow_vertex_shader_once)) {
         glyph__glow_vertex_shader = glyph__get_vertex_shader_source_cached();
+        glyph__once_end(&glyph__glow_vertex_shader_once, 1);
     }
     return glyph__glow_vertex_shader;
 }
 
 static char glyph__glow_fragment_shader_buffer[2048];
 static const char* glyph__glow_fragment_shader = NULL;
+static glyph_once_t glyph__glow_fragment_shader_once = GLYPH_ONCE_INIT;
 static const char* glyph__get_glow_fragment_shader() {
-    if (!glyph__glow_fragment_shader) {
-        sprintf(glyph__glow_fragment_shader_buffer, "%s%s", glyph_glsl_version_str,
+    if (glyph__once_begin(&glyph__glow_fragment_shader_once)) {
+        snprintf(glyph__glow_fragment_shader_buffer, sizeof(glyph__glow_fragment_shader_buffer), "%s%s", glyph_glsl_version_str,
             "in vec2 TexCoord;\n"
             "out vec4 FragColor;\n"
             "uniform sampler2D textTexture;\n"
@@ -134,6 +137,7 @@ static const char* glyph__get_glow_fragment_shader() {
             "    FragColor = vec4(textColor, min(finalAlpha, 1.0));\n"
             "}\n");
         glyph__glow_fragment_shader = glyph__glow_fragment_shader_buffer;
+        glyph__once_end(&glyph__glow_fragment_shader_once, 1);
     }
     return glyph__glow_fragment_shader;
 }
@@ -158,9 +162,10 @@ static inline glyph_effect_t glyph_effect_create_custom(const char* vertex_shade
 
 static char glyph__rainbow_fragment_shader_buffer[2048];
 static const char* glyph__rainbow_fragment_shader = NULL;
+static glyph_once_t glyph__rainbow_fragment_shader_once = GLYPH_ONCE_INIT;
 static const char* glyph__get_rainbow_fragment_shader() {
-    if (!glyph__rainbow_fragment_shader) {
-        sprintf(glyph__rainbow_fragment_shader_buffer, "%s%s", glyph_glsl_version_str,
+    if (glyph__once_begin(&glyph__rainbow_fragment_shader_once)) {
+        snprintf(glyph__rainbow_fragment_shader_buffer, sizeof(glyph__rainbow_fragment_shader_buffer), "%s%s", glyph_glsl_version_str,
             "in vec2 TexCoord;\n"
             "out vec4 FragColor;\n"
             "uniform sampler2D textTexture;\n"
@@ -184,6 +189,7 @@ static const char* glyph__get_rainbow_fragment_shader() {
             "    }\n"
             "}\n");
         glyph__rainbow_fragment_shader = glyph__rainbow_fragment_shader_buffer;
+        glyph__once_end(&glyph__rainbow_fragment_shader_once, 1);
     }
     return glyph__rainbow_fragment_shader;
 }
@@ -204,9 +210,10 @@ static inline glyph_effect_t glyph_effect_create_glow() {
 
 static char glyph__outline_fragment_shader_buffer[2048];
 static const char* glyph__outline_fragment_shader = NULL;
+static glyph_once_t glyph__outline_fragment_shader_once = GLYPH_ONCE_INIT;
 static const char* glyph__get_outline_fragment_shader() {
-    if (!glyph__outline_fragment_shader) {
-        sprintf(glyph__outline_fragment_shader_buffer, "%s%s", glyph_glsl_version_str,
+    if (glyph__once_begin(&glyph__outline_fragment_shader_once)) {
+        snprintf(glyph__outline_fragment_shader_buffer, sizeof(glyph__outline_fragment_shader_buffer), "%s%s", glyph_glsl_version_str,
             "in vec2 TexCoord;\n"
             "out vec4 FragColor;\n"
             "uniform sampler2D textTexture;\n"
@@ -228,15 +235,17 @@ static const char* glyph__get_outline_fragment_shader() {
             "    FragColor = vec4(finalColor, finalAlpha);\n"
             "}\n");
         glyph__outline_fragment_shader = glyph__outline_fragment_shader_buffer;
+        glyph__once_end(&glyph__outline_fragment_shader_once, 1);
     }
     return glyph__outline_fragment_shader;
 }
 
 static char glyph__shadow_fragment_shader_buffer[2048];
 static const char* glyph__shadow_fragment_shader = NULL;
+static glyph_once_t glyph__shadow_fragment_shader_once = GLYPH_ONCE_INIT;
 static const char* glyph__get_shadow_fragment_shader() {
-    if (!glyph__shadow_fragment_shader) {
-        sprintf(glyph__shadow_fragment_shader_buffer, "%s%s", glyph_glsl_version_str,
+    if (glyph__once_begin(&glyph__shadow_fragment_shader_once)) {
+        snprintf(glyph__shadow_fragment_shader_buffer, sizeof(glyph__shadow_fragment_shader_buffer), "%s%s", glyph_glsl_version_str,
             "in vec2 TexCoord;\n"
             "out vec4 FragColor;\n"
             "uniform sampler2D textTexture;\n"
@@ -252,15 +261,17 @@ static const char* glyph__get_shadow_fragment_shader() {
             "    FragColor = vec4(finalColor, finalAlpha);\n"
             "}\n");
         glyph__shadow_fragment_shader = glyph__shadow_fragment_shader_buffer;
+        glyph__once_end(&glyph__shadow_fragment_shader_once, 1);
     }
     return glyph__shadow_fragment_shader;
 }
 
 static char glyph__wave_fragment_shader_buffer[2048];
 static const char* glyph__wave_fragment_shader = NULL;
+static glyph_once_t glyph__wave_fragment_shader_once = GLYPH_ONCE_INIT;
 static const char* glyph__get_wave_fragment_shader() {
-    if (!glyph__wave_fragment_shader) {
-        sprintf(glyph__wave_fragment_shader_buffer, "%s%s", glyph_glsl_version_str,
+    if (glyph__once_begin(&glyph__wave_fragment_shader_once)) {
+        snprintf(glyph__wave_fragment_shader_buffer, sizeof(glyph__wave_fragment_shader_buffer), "%s%s", glyph_glsl_version_str,
             "in vec2 TexCoord;\n"
             "out vec4 FragColor;\n"
             "uniform sampler2D textTexture;\n"
@@ -275,15 +286,17 @@ static const char* glyph__get_wave_fragment_shader() {
             "    FragColor = vec4(textColor, alpha);\n"
             "}\n");
         glyph__wave_fragment_shader = glyph__wave_fragment_shader_buffer;
+        glyph__once_end(&glyph__wave_fragment_shader_once, 1);
     }
     return glyph__wave_fragment_shader;
 }
 
 static char glyph__gradient_fragment_shader_buffer[2048];
 static const char* glyph__gradient_fragment_shader = NULL;
+static glyph_once_t glyph__gradient_fragment_shader_once = GLYPH_ONCE_INIT;
 static const char* glyph__get_gradient_fragment_shader() {
-    if (!glyph__gradient_fragment_shader) {
-        sprintf(glyph__gradient_fragment_shader_buffer, "%s%s", glyph_glsl_version_str,
+    if (glyph__once_begin(&glyph__gradient_fragment_shader_once)) {
+        snprintf(glyph__gradient_fragment_shader_buffer, sizeof(glyph__gradient_fragment_shader_buffer), "%s%s", glyph_glsl_version_str,
             "in vec2 TexCoord;\n"
             "out vec4 FragColor;\n"
             "uniform sampler2D textTexture;\n"
@@ -297,15 +310,17 @@ static const char* glyph__get_gradient_fragment_shader() {
             "    FragColor = vec4(gradientColor, alpha);\n"
             "}\n");
         glyph__gradient_fragment_shader = glyph__gradient_fragment_shader_buffer;
+        glyph__once_end(&glyph__gradient_fragment_shader_once, 1);
     }
     return glyph__gradient_fragment_shader;
 }
 
 static char glyph__neon_fragment_shader_buffer[2048];
 static const char* glyph__neon_fragment_shader = NULL;
+static glyph_once_t glyph__neon_fragment_shader_once = GLYPH_ONCE_INIT;
 static const char* glyph__get_neon_fragment_shader() {
-    if (!glyph__neon_fragment_shader) {
-        sprintf(glyph__neon_fragment_shader_buffer, "%s%s", glyph_glsl_version_str,
+    if (glyph__once_begin(&glyph__neon_fragment_shader_once)) {
+        snprintf(glyph__neon_fragment_shader_buffer, sizeof(glyph__neon_fragment_shader_buffer), "%s%s", glyph_glsl_version_str,
             "in vec2 TexCoord;\n"
             "out vec4 FragColor;\n"
             "uniform sampler2D textTexture;\n"
@@ -319,6 +334,7 @@ static const char* glyph__get_neon_fragment_shader() {
             "    FragColor = vec4(neonColor, alpha);\n"
             "}\n");
         glyph__neon_fragment_shader = glyph__neon_fragment_shader_buffer;
+        glyph__once_end(&glyph__neon_fragment_shader_once, 1);
     }
     return glyph__neon_fragment_shader;
 }
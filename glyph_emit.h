@@ -0,0 +1,351 @@
+/*
+    MIT License
+
+    Copyright (c) 2025 Darek
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/*
+ * Glyph Emit Module - Positioned Quads Without OpenGL
+ *
+ * This module turns text into positioned, textured quads:
+ * - UTF-8 or single-byte decoding, kerning and missing-glyph fallback
+ * - Bold, italic and underline geometry identical to the GL renderer
+ * - Optional culling against a visible rectangle
+ * - Quads delivered through a callback or written to a caller-owned array
+ *
+ * It only depends on the atlas, so engines with their own sprite batcher can
+ * merge text into existing batches (upload the atlas image once, then draw
+ * the quads with their own shader). The GL renderer is built on the same
+ * functions, so both produce the same geometry.
+ */
+
+#ifndef __GLYPH_EMIT_H
+#define __GLYPH_EMIT_H
+
+#include "glyph_atlas.h"
+#include "glyph_layout.h"
+
+/* Effect flags and the solid texture coordinate (also defined by glyph.h) */
+#ifndef GLYPHGL_BOLD
+#define GLYPHGL_BOLD        (1 << 0)  /* Render text with bold effect (duplicate glyphs offset) */
+#define GLYPHGL_ITALIC      (1 << 1)  /* Apply italic shear transformation to glyphs */
+#define GLYPHGL_UNDERLINE   (1 << 2)  /* Draw underline beneath text */
+#define GLYPHGL_SDF         (1 << 3)  /* Enable Signed Distance Field rendering for scalable text */
+#endif
+#ifndef GLYPHGL_SOLID_UV
+#define GLYPHGL_SOLID_UV    (-1.0f)
+#endif
+
+/* Maximum number of quads emitted for one glyph (glyph, bold copy, underline) */
+#define GLYPH_EMIT_MAX_QUADS 3
+
+/*
+ * A positioned, textured quad
+ *
+ * Screen coordinates use the renderer's convention (y pointing down). The
+ * texture coordinates map (u0, v0) to the top-left and (u1, v1) to the
+ * bottom-right corner. Italic quads are parallelograms: the bottom edge is
+ * shifted horizontally by 'skew'. Solid quads (underline) use
+ * GLYPHGL_SOLID_UV for all texture coordinates.
+ */
+typedef struct {
+    float x0, y0;             /* Top-left corner */
+    float x1, y1;             /* Bottom-right corner (before skew) */
+    float u0, v0, u1, v1;     /* Atlas texture coordinates */
+    float skew;               /* Horizontal offset of the bottom edge (0 = upright) */
+    int codepoint;            /* Codepoint the quad belongs to */
+    size_t byte_offset;       /* Byte offset of that codepoint in the source text */
+} glyph_quad_t;
+
+/* Receives each emitted quad */
+typedef void (*glyph_quad_callback_t)(const glyph_quad_t* quad, void* user);
+
+/*
+ * Emission options
+ *
+ * A zero-initialized struct (or NULL) emits plain UTF-8 text without culling.
+ */
+typedef struct {
+    int effects;                  /* Geometry effects (GLYPHGL_BOLD, GLYPHGL_ITALIC, GLYPHGL_UNDERLINE) */
+    const glyph_rect_t* visible;  /* Glyphs entirely outside this rectangle are skipped (NULL = none) */
+    uint32_t char_type;           /* GLYPH_ASCII treats each byte as a character, anything else decodes UTF-8 */
+} glyph_emit_options_t;
+
+/*
+ * Builds the quads of one glyph
+ *
+ * Parameters:
+ *   atlas: Atlas the glyph belongs to
+ *   ch: Atlas glyph (must have a non-zero width)
+ *   pen_x, y: Pen position on the baseline
+ *   advance: Scaled advance, used as the underline length
+ *   scale: Text scaling factor (1.0 = atlas pixel size)
+ *   effects: Geometry effects (ignored in GLYPHGL_MINIMAL builds)
+ *   quads: Output array with room for GLYPH_EMIT_MAX_QUADS quads
+ *
+ * Returns: Number of quads written (codepoint and byte_offset are left at 0)
+ */
+static inline int glyph_emit_glyph(const glyph_atlas_t* atlas, const glyph_atlas_char_t* ch, float pen_x, float y,
+                                   float advance, float scale, int effects, glyph_quad_t* quads) {
+    int count = 0;
+    glyph_quad_t* q = &quads[count++];
+    q->x0 = pen_x + ch->xoff * scale;       /* Apply left bearing offset */
+    q->y0 = y - ch->yoff * scale;           /* Apply baseline offset (inverted Y) */
+    q->x1 = q->x0 + ch->width * scale;
+    q->y1 = q->y0 + ch->height * scale;
+    q->u0 = (float)ch->x / atlas->image.width;
+    q->v0 = (float)ch->y / atlas->image.height;
+    q->u1 = (float)(ch->x + ch->width) / atlas->image.width;
+    q->v1 = (float)(ch->y + ch->height) / atlas->image.height;
+    q->skew = 0.0f;
+    q->codepoint = 0;
+    q->byte_offset = 0;
+
+#ifndef GLYPHGL_MINIMAL
+    float h = ch->height * scale;
+    if (effects & GLYPHGL_ITALIC) {
+        q->skew = -0.2f * h;                /* Shear factor for italic slant */
+    }
+    if (effects & GLYPHGL_BOLD) {
+        /* Duplicate glyph offset by one pixel */
+        quads[count] = *q;
+        quads[count].x0 += 1.0f * scale;
+        quads[count].x1 += 1.0f * scale;
+        count++;
+    }
+    if (effects & GLYPHGL_UNDERLINE) {
+        /* Thin solid quad slightly below the baseline spanning the advance */
+        glyph_quad_t* u = &quads[count++];
+        u->x0 = pen_x;
+        u->y0 = y + h * 0.1f;
+        u->x1 = pen_x + advance;
+        u->y1 = u->y0 + 2.0f;
+        u->u0 = u->v0 = u->u1 = u->v1 = GLYPHGL_SOLID_UV;
+        u->skew = 0.0f;
+        u->codepoint = 0;
+        u->byte_offset = 0;
+    }
+#else
+    (void)advance;
+    (void)effects;
+#endif
+    return count;
+}
+
+/*
+ * Tests whether a glyph's quads may overlap a rectangle
+ *
+ * Uses the same geometry as glyph_emit_glyph without building the quads.
+ *
+ * Returns: 0 if the glyph is entirely outside, 1 if it is entirely inside, 2 if it crosses an edge
+ */
+static inline int glyph_emit__glyph_visibility(const glyph_atlas_char_t* ch, float pen_x, float y, float advance,
+                                               float scale, int effects, const glyph_rect_t* rect) {
+    float h = ch->height * scale;
+    float x0 = pen_x + ch->xoff * scale;
+    float x1 = x0 + ch->width * scale;
+    float y0 = y - ch->yoff * scale;
+    float y1 = y0 + h;
+#ifndef GLYPHGL_MINIMAL
+    if (effects & GLYPHGL_ITALIC) x0 -= 0.2f * h;
+    if (effects & GLYPHGL_BOLD) x1 += 1.0f * scale;
+    if (effects & GLYPHGL_UNDERLINE) {
+        if (pen_x < x0) x0 = pen_x;
+        if (pen_x + advance > x1) x1 = pen_x + advance;
+        if (y + h * 0.1f + 2.0f > y1) y1 = y + h * 0.1f + 2.0f;
+    }
+#else
+    (void)advance;
+    (void)effects;
+#endif
+    if (x1 <= rect->x || x0 >= rect->x + rect->w || y1 <= rect->y || y0 >= rect->y + rect->h) return 0;
+    if (x0 >= rect->x && x1 <= rect->x + rect->w && y0 >= rect->y && y1 <= rect->y + rect->h) return 1;
+    return 2;
+}
+
+/*
+ * Emits the quads of a single-line run through a callback
+ *
+ * Decodes the text, applies kerning, falls back to '?' for missing glyphs and
+ * reports every quad in drawing order. With a visible rectangle, runs whose
+ * baseline is far outside it are skipped without decoding and emission stops
+ * once the pen has passed its right edge.
+ *
+ * Parameters:
+ *   atlas: Atlas to take glyphs from
+ *   text: String to emit
+ *   len: Length of the string in bytes
+ *   x, y: Baseline start position of the run
+ *   scale: Text scaling factor (1.0 = atlas pixel size)
+ *   options: Effects, culling rectangle and encoding (NULL = defaults)
+ *   callback: Function receiving each quad
+ *   user: Pointer passed through to the callback
+ *
+ * Returns: Number of quads emitted
+ */
+static inline size_t glyph_emit_text(const glyph_atlas_t* atlas, const char* text, size_t len, float x, float y, float scale,
+                                     const glyph_emit_options_t* options, glyph_quad_callback_t callback, void* user) {
+    if (!atlas || !text || !callback) return 0;
+    int effects = options ? options->effects : 0;
+    const glyph_rect_t* visible = options ? options->visible : NULL;
+    int utf8 = !options || options->char_type != GLYPH_ASCII;
+
+    /* Glyph geometry stays within two ems of the baseline and at most one em left of the pen */
+    float em = atlas->pixel_height * scale;
+    if (visible && (y + 2.0f * em <= visible->y || y - 2.0f * em >= visible->y + visible->h)) return 0;
+
+    size_t emitted = 0;
+    float current_x = x;
+    int prev_codepoint = -1;
+    size_t i = 0;
+    while (i < len) {
+        size_t start = i;
+        int codepoint;
+        if (utf8) {
+            codepoint = glyph_atlas_utf8_decode_len(text, len, &i);
+        } else {
+            codepoint = (unsigned char)text[i];
+            i++;
+        }
+
+        /* Apply pair kerning from the font's 'kern' table */
+        if (prev_codepoint >= 0 && atlas->num_kerning) {
+            current_x += glyph_atlas_get_kerning(atlas, prev_codepoint, codepoint) * scale;
+        }
+        prev_codepoint = codepoint;
+
+        glyph_atlas_char_t* ch = glyph_atlas_find_char(atlas, codepoint);
+        if (!ch) ch = glyph_atlas_find_char(atlas, '?'); /* Fallback for missing characters */
+        if (!ch || ch->width == 0) {
+            current_x += ch ? ch->advance * scale : (atlas->pixel_height * 0.5f * scale);
+            continue;
+        }
+
+        float advance = ch->advance * scale;
+        if (!visible || glyph_emit__glyph_visibility(ch, current_x, y, advance, scale, effects, visible)) {
+            glyph_quad_t quads[GLYPH_EMIT_MAX_QUADS];
+            int n = glyph_emit_glyph(atlas, ch, current_x, y, advance, scale, effects, quads);
+            for (int k = 0; k < n; k++) {
+                quads[k].codepoint = codepoint;
+                quads[k].byte_offset = start;
+                callback(&quads[k], user);
+            }
+            emitted += (size_t)n;
+        }
+        current_x += advance;
+
+        /* The rest of the run starts past the right edge of the visible rectangle */
+        if (visible && current_x - em >= visible->x + visible->w) break;
+    }
+    return emitted;
+}
+
+/* Output span state used by glyph_emit_text_quads */
+typedef struct {
+    glyph_quad_t* quads;
+    size_t count;
+    size_t capacity;
+} glyph_emit__span_t;
+
+static inline void glyph_emit__span_push(const glyph_quad_t* quad, void* user) {
+    glyph_emit__span_t* span = (glyph_emit__span_t*)user;
+    if (span->count < span->capacity) span->quads[span->count] = *quad;
+    span->count++;
+}
+
+/*
+ * Emits the quads of a single-line run into a caller-owned array
+ *
+ * Parameters:
+ *   atlas, text, len, x, y, scale, options: As for glyph_emit_text
+ *   quads: Output array (may be NULL when max_quads is 0)
+ *   max_quads: Capacity of the output array
+ *
+ * Returns: Total number of quads of the run; if larger than max_quads only the
+ *          first max_quads were written (len * GLYPH_EMIT_MAX_QUADS always suffices)
+ */
+static inline size_t glyph_emit_text_quads(const glyph_atlas_t* atlas, const char* text, size_t len, float x, float y, float scale,
+                                           const glyph_emit_options_t* options, glyph_quad_t* quads, size_t max_quads) {
+    glyph_emit__span_t span;
+    span.quads = quads;
+    span.count = 0;
+    span.capacity = quads ? max_quads : 0;
+    glyph_emit_text(atlas, text, len, x, y, scale, options, glyph_emit__span_push, &span);
+    return span.count;
+}
+
+/*
+ * Emits the quads of a precomputed layout through a callback
+ *
+ * With a visible rectangle, lines outside it are skipped by binary search on
+ * their baselines. options->char_type is ignored (the layout is already decoded).
+ *
+ * Parameters:
+ *   atlas: Atlas the layout was computed with
+ *   layout: Layout produced by glyph_layout_text
+ *   x, y: Screen coordinates of the top-left corner of the layout box
+ *   options: Effects and culling rectangle (NULL = defaults)
+ *   callback: Function receiving each quad (byte_offset refers to the layout's source text)
+ *   user: Pointer passed through to the callback
+ *
+ * Returns: Number of quads emitted
+ */
+static inline size_t glyph_emit_layout(const glyph_atlas_t* atlas, const glyph_layout_t* layout, float x, float y,
+                                       const glyph_emit_options_t* options, glyph_quad_callback_t callback, void* user) {
+    if (!atlas || !layout || !callback) return 0;
+    int effects = options ? options->effects : 0;
+    const glyph_rect_t* visible = options ? options->visible : NULL;
+
+    size_t first_glyph = 0, end_glyph = layout->num_glyphs;
+    if (visible && layout->num_lines > 0) {
+        float margin = layout->line_height; /* Glyphs may reach above the ascender or below the descender */
+        size_t first_line = glyph_text__line_at_y(layout, visible->y - y - margin);
+        size_t end_line = first_line;
+        while (end_line < layout->num_lines &&
+               y + layout->lines[end_line].baseline - layout->ascender - margin < visible->y + visible->h) {
+            end_line++;
+        }
+        if (end_line == first_line) return 0;
+        first_glyph = layout->lines[first_line].first_glyph;
+        end_glyph = layout->lines[end_line - 1].first_glyph + layout->lines[end_line - 1].num_glyphs;
+    }
+
+    size_t emitted = 0;
+    for (size_t i = first_glyph; i < end_glyph; i++) {
+        const glyph_positioned_t* pg = &layout->glyphs[i];
+        if (pg->char_index < 0 || pg->char_index >= atlas->num_chars) continue;
+        const glyph_atlas_char_t* ch = &atlas->chars[pg->char_index];
+        if (visible && !glyph_emit__glyph_visibility(ch, x + pg->x, y + pg->y, pg->advance, layout->scale, effects, visible)) {
+            continue;
+        }
+        glyph_quad_t quads[GLYPH_EMIT_MAX_QUADS];
+        int n = glyph_emit_glyph(atlas, ch, x + pg->x, y + pg->y, pg->advance, layout->scale, effects, quads);
+        for (int k = 0; k < n; k++) {
+            quads[k].codepoint = pg->codepoint;
+            quads[k].byte_offset = pg->byte_offset;
+            callback(&quads[k], user);
+        }
+        emitted += (size_t)n;
+    }
+    return emitted;
+}
+
+#endif
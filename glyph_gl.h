@@ -107,9 +107,30 @@ typedef ptrdiff_t GLintptr;    /* Pointer offset type */
 #ifndef GL_RED
 #define GL_RED 0x1903  /* Red color channel */
 #endif
+#ifndef GL_TEXTURE_MAX_LEVEL
+#define GL_TEXTURE_MAX_LEVEL 0x813D  /* Last mip level of a texture */
+#endif
+#ifndef GL_LINEAR_MIPMAP_LINEAR
+#define GL_LINEAR_MIPMAP_LINEAR 0x2703  /* Trilinear minification */
+#endif
+#ifndef GL_COMPRESSED_RED_RGTC1
+#define GL_COMPRESSED_RED_RGTC1 0x8DBB  /* BC4: one channel in 4x4 blocks of 8 bytes */
+#endif
 #ifndef GL_FUNC_ADD
 #define GL_FUNC_ADD 0x8006  /* Blend equation: add */
 #endif
+#ifndef GL_RGBA32F
+#define GL_RGBA32F 0x8814  /* 32-bit float RGBA texture format */
+#endif
+#ifndef GL_TIME_ELAPSED
+#define GL_TIME_ELAPSED 0x88BF  /* Timer query target: GPU time between begin and end */
+#endif
+#ifndef GL_QUERY_RESULT
+#define GL_QUERY_RESULT 0x8866  /* Query result (waits for it) */
+#endif
+#ifndef GL_QUERY_RESULT_AVAILABLE
+#define GL_QUERY_RESULT_AVAILABLE 0x8867  /* Whether the query result can be read without waiting */
+#endif
 
 /* Function pointer typedefs for OpenGL extension functions */
 /* Buffer management functions */
@@ -159,6 +180,7 @@ typedef void (*PFNGLBINDTEXTUREPROC)(GLenum target, GLuint texture);
 typedef void (*PFNGLPIXELSTOREIPROC)(GLenum pname, GLint param);
 typedef void (*PFNGLTEXIMAGE2DPROC)(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void *pixels);
 typedef void (*PFNGLTEXPARAMETERIPROC)(GLenum target, GLenum pname, GLint param);
+typedef void (*PFNGLCOMPRESSEDTEXIMAGE2DPROC)(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void *data);
 
 /* Drawing functions */
 typedef void (*PFNGLDRAWARRAYSPROC)(GLenum mode, GLint first, GLsizei count);
@@ -173,6 +195,19 @@ typedef void (*PFNGLGENVERTEXARRAYSPROC)(GLsizei n, GLuint *arrays);
 typedef void (*PFNGLDELETEVERTEXARRAYSPROC)(GLsizei n, const GLuint *arrays);
 typedef void (*PFNGLBINDVERTEXARRAYPROC)(GLuint array);
 
+/* Instancing (core since OpenGL 3.3) */
+typedef void (*PFNGLDRAWARRAYSINSTANCEDPROC)(GLenum mode, GLint first, GLsizei count, GLsizei instancecount);
+typedef void (*PFNGLVERTEXATTRIBDIVISORPROC)(GLuint index, GLuint divisor);
+typedef void (*PFNGLVERTEXATTRIBIPOINTERPROC)(GLuint index, GLint size, GLenum type, GLsizei stride, const void *pointer);
+
+/* Timer queries (core since OpenGL 3.3) */
+typedef void (*PFNGLGENQUERIESPROC)(GLsizei n, GLuint *ids);
+typedef void (*PFNGLDELETEQUERIESPROC)(GLsizei n, const GLuint *ids);
+typedef void (*PFNGLBEGINQUERYPROC)(GLenum target, GLuint id);
+typedef void (*PFNGLENDQUERYPROC)(GLenum target);
+typedef void (*PFNGLGETQUERYOBJECTIVPROC)(GLuint id, GLenum pname, GLint *params);
+typedef void (*PFNGLGETQUERYOBJECTUI64VPROC)(GLuint id, GLenum pname, uint64_t *params);
+
 /* Static function pointers for loaded OpenGL functions */
 /* Buffer management */
 static PFNGLGENBUFFERSPROC glyph__glGenBuffers;
@@ -221,6 +256,7 @@ static PFNGLBINDTEXTUREPROC glyph__glBindTexture;
 static PFNGLPIXELSTOREIPROC glyph__glPixelStorei;
 static PFNGLTEXIMAGE2DPROC glyph__glTexImage2D;
 static PFNGLTEXPARAMETERIPROC glyph__glTexParameteri;
+static PFNGLCOMPRESSEDTEXIMAGE2DPROC glyph__glCompressedTexImage2D;
 
 /* Drawing */
 static PFNGLDRAWARRAYSPROC glyph__glDrawArrays;
@@ -235,7 +271,259 @@ static PFNGLGENVERTEXARRAYSPROC glyph__glGenVertexArrays;
 static PFNGLDELETEVERTEXARRAYSPROC glyph__glDeleteVertexArrays;
 static PFNGLBINDVERTEXARRAYPROC glyph__glBindVertexArray;
 
-#if defined(_WIN32) || defined(_WIN64)
+/* Instancing */
+static PFNGLDRAWARRAYSINSTANCEDPROC glyph__glDrawArraysInstanced;
+static PFNGLVERTEXATTRIBDIVISORPROC glyph__glVertexAttribDivisor;
+static PFNGLVERTEXATTRIBIPOINTERPROC glyph__glVertexAttribIPointer;
+
+/* Timer queries */
+static PFNGLGENQUERIESPROC glyph__glGenQueries;
+static PFNGLDELETEQUERIESPROC glyph__glDeleteQueries;
+static PFNGLBEGINQUERYPROC glyph__glBeginQuery;
+static PFNGLENDQUERYPROC glyph__glEndQuery;
+static PFNGLGETQUERYOBJECTIVPROC glyph__glGetQueryObjectiv;
+static PFNGLGETQUERYOBJECTUI64VPROC glyph__glGetQueryObjectui64v;
+
+#ifdef GLYPHGL_GL_STUB
+
+/*
+ * Recording GL stub (GLYPHGL_GL_STUB)
+ *
+ * Instead of loading a driver, glyph_gl_load_functions points every glyph__gl*
+ * function at a no-op that records what the library asked of the GPU. Renderers
+ * can then be created and drawn without a context, display or GPU, which makes
+ * the CPU cost of the library measurable on headless machines. Object names are
+ * handed out sequentially, shaders always compile and programs always link.
+ *
+ * The counters are plain integers: like a real context, the stub expects GL to
+ * be called from one thread at a time.
+ */
+typedef struct {
+    size_t calls;            /* Every GL call */
+    size_t draw_calls;       /* glDrawArrays + glDrawArraysInstanced */
+    size_t vertices;         /* Vertices submitted by draws (times instances) */
+    size_t buffer_uploads;   /* glBufferData with data + glBufferSubData */
+    size_t texture_uploads;  /* glTexImage2D / glCompressedTexImage2D with pixels */
+    size_t bytes_uploaded;   /* Bytes passed to the uploads above */
+    size_t uniform_updates;  /* glUniform* calls */
+    size_t state_changes;    /* Binds, enables, blend/pixel-store/texture parameters, viewport */
+    size_t redundant_binds;  /* Binds of the object already bound to that target */
+    size_t objects_created;  /* Buffers, textures, VAOs, shaders and programs */
+    size_t objects_deleted;
+} glyph_gl_stub_stats_t;
+
+static glyph_gl_stub_stats_t glyph__gl_stub_stats;
+static GLuint glyph__gl_stub_next_name = 1;
+static GLuint glyph__gl_stub_program, glyph__gl_stub_vao, glyph__gl_stub_buffer, glyph__gl_stub_texture;
+
+/* Returns: The stub's counters since the last glyph_gl_stub_reset_stats */
+static inline glyph_gl_stub_stats_t glyph_gl_stub_get_stats(void) {
+    return glyph__gl_stub_stats;
+}
+
+/* Clears the stub's counters, e.g. at the start of a measured frame */
+static inline void glyph_gl_stub_reset_stats(void) {
+    memset(&glyph__gl_stub_stats, 0, sizeof(glyph__gl_stub_stats));
+}
+
+static void glyph__gl_stub_gen(GLsizei n, GLuint* names) {
+    GLsizei i;
+    glyph__gl_stub_stats.calls++;
+    for (i = 0; i < n; i++) names[i] = glyph__gl_stub_next_name++;
+    glyph__gl_stub_stats.objects_created += (size_t)n;
+}
+
+static void glyph__gl_stub_delete(GLsizei n, const GLuint* names) {
+    (void)names;
+    glyph__gl_stub_stats.calls++;
+    glyph__gl_stub_stats.objects_deleted += (size_t)n;
+}
+
+static void glyph__gl_stub_bind(GLuint* bound, GLuint name) {
+    glyph__gl_stub_stats.calls++;
+    glyph__gl_stub_stats.state_changes++;
+    if (*bound == name) glyph__gl_stub_stats.redundant_binds++;
+    *bound = name;
+}
+
+static void glyph__gl_stub_state(void) {
+    glyph__gl_stub_stats.calls++;
+    glyph__gl_stub_stats.state_changes++;
+}
+
+static void glyph__gl_stub_uniform(void) {
+    glyph__gl_stub_stats.calls++;
+    glyph__gl_stub_stats.uniform_updates++;
+}
+
+static void glyph__stub_glGenBuffers(GLsizei n, GLuint* buffers) { glyph__gl_stub_gen(n, buffers); }
+static void glyph__stub_glDeleteBuffers(GLsizei n, const GLuint* buffers) { glyph__gl_stub_delete(n, buffers); }
+static void glyph__stub_glBindBuffer(GLenum target, GLuint buffer) { (void)target; glyph__gl_stub_bind(&glyph__gl_stub_buffer, buffer); }
+static void glyph__stub_glBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
+    (void)target; (void)usage;
+    glyph__gl_stub_stats.calls++;
+    if (data) {
+        glyph__gl_stub_stats.buffer_uploads++;
+        glyph__gl_stub_stats.bytes_uploaded += (size_t)size;
+    }
+}
+static void glyph__stub_glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) {
+    (void)target; (void)offset; (void)data;
+    glyph__gl_stub_stats.calls++;
+    glyph__gl_stub_stats.buffer_uploads++;
+    glyph__gl_stub_stats.bytes_uploaded += (size_t)size;
+}
+
+static GLuint glyph__stub_glCreateShader(GLenum type) {
+    GLuint name;
+    (void)type;
+    glyph__gl_stub_gen(1, &name);
+    return name;
+}
+static void glyph__stub_glDeleteShader(GLuint shader) { glyph__gl_stub_delete(1, &shader); }
+static void glyph__stub_glShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length) {
+    (void)shader; (void)count; (void)string; (void)length;
+    glyph__gl_stub_stats.calls++;
+}
+static void glyph__stub_glCompileShader(GLuint shader) { (void)shader; glyph__gl_stub_stats.calls++; }
+static void glyph__stub_glGetShaderiv(GLuint shader, GLenum pname, GLint* params) {
+    (void)shader;
+    glyph__gl_stub_stats.calls++;
+    *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+}
+static void glyph__stub_glGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog) {
+    (void)shader;
+    glyph__gl_stub_stats.calls++;
+    if (length) *length = 0;
+    if (infoLog && bufSize > 0) infoLog[0] = '\0';
+}
+
+static GLuint glyph__stub_glCreateProgram(void) {
+    GLuint name;
+    glyph__gl_stub_gen(1, &name);
+    return name;
+}
+static void glyph__stub_glDeleteProgram(GLuint program) { glyph__gl_stub_delete(1, &program); }
+static void glyph__stub_glAttachShader(GLuint program, GLuint shader) { (void)program; (void)shader; glyph__gl_stub_stats.calls++; }
+static void glyph__stub_glLinkProgram(GLuint program) { (void)program; glyph__gl_stub_stats.calls++; }
+static void glyph__stub_glGetProgramiv(GLuint program, GLenum pname, GLint* params) {
+    (void)program;
+    glyph__gl_stub_stats.calls++;
+    *params = pname == GL_LINK_STATUS ? GL_TRUE : 0;
+}
+static void glyph__stub_glGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog) {
+    glyph__stub_glGetShaderInfoLog(program, bufSize, length, infoLog);
+}
+static void glyph__stub_glUseProgram(GLuint program) { glyph__gl_stub_bind(&glyph__gl_stub_program, program); }
+
+static GLint glyph__stub_glGetAttribLocation(GLuint program, const GLchar* name) {
+    (void)program; (void)name;
+    glyph__gl_stub_stats.calls++;
+    return 0;
+}
+static GLint glyph__stub_glGetUniformLocation(GLuint program, const GLchar* name) {
+    (void)program; (void)name;
+    glyph__gl_stub_stats.calls++;
+    return 0;
+}
+static void glyph__stub_glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer) {
+    (void)index; (void)size; (void)type; (void)normalized; (void)stride; (void)pointer;
+    glyph__gl_stub_state();
+}
+static void glyph__stub_glEnableVertexAttribArray(GLuint index) { (void)index; glyph__gl_stub_state(); }
+static void glyph__stub_glDisableVertexAttribArray(GLuint index) { (void)index; glyph__gl_stub_state(); }
+
+static void glyph__stub_glUniform1i(GLint location, GLint v0) { (void)location; (void)v0; glyph__gl_stub_uniform(); }
+static void glyph__stub_glUniform1f(GLint location, GLfloat v0) { (void)location; (void)v0; glyph__gl_stub_uniform(); }
+static void glyph__stub_glUniform2f(GLint location, GLfloat v0, GLfloat v1) { (void)location; (void)v0; (void)v1; glyph__gl_stub_uniform(); }
+static void glyph__stub_glUniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2) {
+    (void)location; (void)v0; (void)v1; (void)v2;
+    glyph__gl_stub_uniform();
+}
+static void glyph__stub_glUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) {
+    (void)location; (void)v0; (void)v1; (void)v2; (void)v3;
+    glyph__gl_stub_uniform();
+}
+static void glyph__stub_glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+    (void)location; (void)count; (void)transpose; (void)value;
+    glyph__gl_stub_uniform();
+}
+
+static void glyph__stub_glActiveTexture(GLenum texture) { (void)texture; glyph__gl_stub_state(); }
+static void glyph__stub_glGenTextures(GLsizei n, GLuint* textures) { glyph__gl_stub_gen(n, textures); }
+static void glyph__stub_glDeleteTextures(GLsizei n, const GLuint* textures) { glyph__gl_stub_delete(n, textures); }
+static void glyph__stub_glBindTexture(GLenum target, GLuint texture) { (void)target; glyph__gl_stub_bind(&glyph__gl_stub_texture, texture); }
+static void glyph__stub_glPixelStorei(GLenum pname, GLint param) { (void)pname; (void)param; glyph__gl_stub_state(); }
+static void glyph__stub_glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels) {
+    size_t channels = format == GL_RED ? 1 : format == GL_RGB ? 3 : 4;
+    size_t component = type == GL_FLOAT ? 4 : 1;
+    (void)target; (void)level; (void)internalformat; (void)border;
+    glyph__gl_stub_stats.calls++;
+    if (pixels) {
+        glyph__gl_stub_stats.texture_uploads++;
+        glyph__gl_stub_stats.bytes_uploaded += (size_t)width * (size_t)height * channels * component;
+    }
+}
+static void glyph__stub_glTexParameteri(GLenum target, GLenum pname, GLint param) { (void)target; (void)pname; (void)param; glyph__gl_stub_state(); }
+static void glyph__stub_glCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void* data) {
+    (void)target; (void)level; (void)internalformat; (void)width; (void)height; (void)border;
+    glyph__gl_stub_stats.calls++;
+    if (data) {
+        glyph__gl_stub_stats.texture_uploads++;
+        glyph__gl_stub_stats.bytes_uploaded += (size_t)imageSize;
+    }
+}
+
+static void glyph__stub_glDrawArrays(GLenum mode, GLint first, GLsizei count) {
+    (void)mode; (void)first;
+    glyph__gl_stub_stats.calls++;
+    glyph__gl_stub_stats.draw_calls++;
+    glyph__gl_stub_stats.vertices += (size_t)count;
+}
+static void glyph__stub_glViewport(GLint x, GLint y, GLsizei width, GLsizei height) { (void)x; (void)y; (void)width; (void)height; glyph__gl_stub_state(); }
+static void glyph__stub_glEnable(GLenum cap) { (void)cap; glyph__gl_stub_state(); }
+static void glyph__stub_glBlendFunc(GLenum sfactor, GLenum dfactor) { (void)sfactor; (void)dfactor; glyph__gl_stub_state(); }
+static void glyph__stub_glClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {
+    (void)red; (void)green; (void)blue; (void)alpha;
+    glyph__gl_stub_state();
+}
+static void glyph__stub_glClear(GLbitfield mask) { (void)mask; glyph__gl_stub_stats.calls++; }
+
+static void glyph__stub_glGenVertexArrays(GLsizei n, GLuint* arrays) { glyph__gl_stub_gen(n, arrays); }
+static void glyph__stub_glDeleteVertexArrays(GLsizei n, const GLuint* arrays) { glyph__gl_stub_delete(n, arrays); }
+static void glyph__stub_glBindVertexArray(GLuint array) { glyph__gl_stub_bind(&glyph__gl_stub_vao, array); }
+
+static void glyph__stub_glDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount) {
+    (void)mode; (void)first;
+    glyph__gl_stub_stats.calls++;
+    glyph__gl_stub_stats.draw_calls++;
+    glyph__gl_stub_stats.vertices += (size_t)count * (size_t)instancecount;
+}
+static void glyph__stub_glVertexAttribDivisor(GLuint index, GLuint divisor) { (void)index; (void)divisor; glyph__gl_stub_state(); }
+static void glyph__stub_glVertexAttribIPointer(GLuint index, GLint size, GLenum type, GLsizei stride, const void* pointer) {
+    (void)index; (void)size; (void)type; (void)stride; (void)pointer;
+    glyph__gl_stub_state();
+}
+
+static void glyph__stub_glGenQueries(GLsizei n, GLuint* ids) { glyph__gl_stub_gen(n, ids); }
+static void glyph__stub_glDeleteQueries(GLsizei n, const GLuint* ids) { glyph__gl_stub_delete(n, ids); }
+static void glyph__stub_glBeginQuery(GLenum target, GLuint id) { (void)target; (void)id; glyph__gl_stub_stats.calls++; }
+static void glyph__stub_glEndQuery(GLenum target) { (void)target; glyph__gl_stub_stats.calls++; }
+static void glyph__stub_glGetQueryObjectiv(GLuint id, GLenum pname, GLint* params) {
+    (void)id;
+    glyph__gl_stub_stats.calls++;
+    *params = pname == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+}
+static void glyph__stub_glGetQueryObjectui64v(GLuint id, GLenum pname, uint64_t* params) {
+    (void)id; (void)pname;
+    glyph__gl_stub_stats.calls++;
+    *params = 0; /* No GPU, no GPU time */
+}
+
+/* glyph_gl__load_functions below installs the stubs instead of driver entry points */
+#define GLYPH_GL_LOAD_PROC(type, name) glyph__##name = glyph__stub_##name
+
+#elif defined(_WIN32) || defined(_WIN64)
     static HMODULE glyph__opengl_dll = NULL;
     #define GLYPH_GL_LOAD_PROC(type, name) \
         glyph__##name = (type)wglGetProcAddress(#name); \
@@ -295,10 +583,13 @@ static PFNGLBINDVERTEXARRAYPROC glyph__glBindVertexArray;
  * - Windows: wglGetProcAddress
  * - Linux/Unix: glXGetProcAddressARB or dlsym
  * - macOS: dlsym (OpenGL functions are available in system frameworks)
+ * - GLYPHGL_GL_STUB: the recording stubs above, no driver involved
+ *
+ * Called through glyph_gl_load_functions, which runs it at most once.
  *
  * Returns: 1 on success, 0 on failure (with error logging)
  */
-static int glyph_gl_load_functions(void) {
+static int glyph_gl__load_functions(void) {
     /* Load buffer management functions */
     GLYPH_GL_LOAD_PROC(PFNGLGENBUFFERSPROC, glGenBuffers);
     GLYPH_GL_LOAD_PROC(PFNGLDELETEBUFFERSPROC, glDeleteBuffers);
@@ -346,6 +637,7 @@ static int glyph_gl_load_functions(void) {
     GLYPH_GL_LOAD_PROC(PFNGLPIXELSTOREIPROC, glPixelStorei);
     GLYPH_GL_LOAD_PROC(PFNGLTEXIMAGE2DPROC, glTexImage2D);
     GLYPH_GL_LOAD_PROC(PFNGLTEXPARAMETERIPROC, glTexParameteri);
+    GLYPH_GL_LOAD_PROC(PFNGLCOMPRESSEDTEXIMAGE2DPROC, glCompressedTexImage2D);
 
     /* Load drawing functions */
     GLYPH_GL_LOAD_PROC(PFNGLDRAWARRAYSPROC, glDrawArrays);
@@ -360,9 +652,40 @@ static int glyph_gl_load_functions(void) {
     GLYPH_GL_LOAD_PROC(PFNGLDELETEVERTEXARRAYSPROC, glDeleteVertexArrays);
     GLYPH_GL_LOAD_PROC(PFNGLBINDVERTEXARRAYPROC, glBindVertexArray);
 
+    /* Load instancing functions */
+    GLYPH_GL_LOAD_PROC(PFNGLDRAWARRAYSINSTANCEDPROC, glDrawArraysInstanced);
+    GLYPH_GL_LOAD_PROC(PFNGLVERTEXATTRIBDIVISORPROC, glVertexAttribDivisor);
+    GLYPH_GL_LOAD_PROC(PFNGLVERTEXATTRIBIPOINTERPROC, glVertexAttribIPointer);
+
+    /* Load timer query functions */
+    GLYPH_GL_LOAD_PROC(PFNGLGENQUERIESPROC, glGenQueries);
+    GLYPH_GL_LOAD_PROC(PFNGLDELETEQUERIESPROC, glDeleteQueries);
+    GLYPH_GL_LOAD_PROC(PFNGLBEGINQUERYPROC, glBeginQuery);
+    GLYPH_GL_LOAD_PROC(PFNGLENDQUERYPROC, glEndQuery);
+    GLYPH_GL_LOAD_PROC(PFNGLGETQUERYOBJECTIVPROC, glGetQueryObjectiv);
+    GLYPH_GL_LOAD_PROC(PFNGLGETQUERYOBJECTUI64VPROC, glGetQueryObjectui64v);
+
     return 1; /* Success - all functions loaded */
 }
 
+static glyph_once_t glyph__gl_load_once = GLYPH_ONCE_INIT;
+
+/*
+ * Loads the OpenGL function pointers once per process
+ *
+ * Safe to call from several threads (e.g. renderers created on different
+ * contexts at the same time): the first caller loads, the others wait for it.
+ * A failed load, typically with no current context, is retried on the next call.
+ *
+ * Returns: 1 on success, 0 on failure (with error logging)
+ */
+static int glyph_gl_load_functions(void) {
+    if (glyph__once_begin(&glyph__gl_load_once)) {
+        glyph__once_end(&glyph__gl_load_once, glyph_gl__load_functions());
+    }
+    return glyph__once_done(&glyph__gl_load_once);
+}
+
 /* Define macros to map standard OpenGL function names to loaded function pointers */
 #define glGenBuffers glyph__glGenBuffers
 #define glDeleteBuffers glyph__glDeleteBuffers
@@ -400,6 +723,7 @@ static int glyph_gl_load_functions(void) {
 #define glPixelStorei glyph__glPixelStorei
 #define glTexImage2D glyph__glTexImage2D
 #define glTexParameteri glyph__glTexParameteri
+#define glCompressedTexImage2D glyph__glCompressedTexImage2D
 #define glGenVertexArrays glyph__glGenVertexArrays
 #define glDeleteVertexArrays glyph__glDeleteVertexArrays
 #define glBindVertexArray glyph__glBindVertexArray
@@ -409,6 +733,15 @@ static int glyph_gl_load_functions(void) {
 #define glBlendFunc glyph__glBlendFunc
 #define glClearColor glyph__glClearColor
 #define glClear glyph__glClear
+#define glDrawArraysInstanced glyph__glDrawArraysInstanced
+#define glVertexAttribDivisor glyph__glVertexAttribDivisor
+#define glVertexAttribIPointer glyph__glVertexAttribIPointer
+#define glGenQueries glyph__glGenQueries
+#define glDeleteQueries glyph__glDeleteQueries
+#define glBeginQuery glyph__glBeginQuery
+#define glEndQuery glyph__glEndQuery
+#define glGetQueryObjectiv glyph__glGetQueryObjectiv
+#define glGetQueryObjectui64v glyph__glGetQueryObjectui64v
 
 #else
 
@@ -442,9 +775,19 @@ static int glyph_gl_load_functions(void) {
 #define glyph__glUniform4f glUniform4f
 #define glyph__glUniformMatrix4fv glUniformMatrix4fv
 #define glyph__glActiveTexture glActiveTexture
+#define glyph__glCompressedTexImage2D glCompressedTexImage2D
 #define glyph__glGenVertexArrays glGenVertexArrays
 #define glyph__glDeleteVertexArrays glDeleteVertexArrays
 #define glyph__glBindVertexArray glBindVertexArray
+#define glyph__glDrawArraysInstanced glDrawArraysInstanced
+#define glyph__glVertexAttribDivisor glVertexAttribDivisor
+#define glyph__glVertexAttribIPointer glVertexAttribIPointer
+#define glyph__glGenQueries glGenQueries
+#define glyph__glDeleteQueries glDeleteQueries
+#define glyph__glBeginQuery glBeginQuery
+#define glyph__glEndQuery glEndQuery
+#define glyph__glGetQueryObjectiv glGetQueryObjectiv
+#define glyph__glGetQueryObjectui64v glGetQueryObjectui64v
 
 static int glyph_gl_load_functions(void) {
     return 1;
@@ -464,10 +807,13 @@ static char glyph_glsl_version_str[32] = "#version 330 core\n";
  *   major: Major OpenGL version (e.g., 3 for OpenGL 3.x)
  *   minor: Minor OpenGL version (e.g., 3 for OpenGL 3.3)
  *
+ * Shader sources are built once, on first use, so this must be called before
+ * the first renderer or effect is created and not concurrently with them.
+ *
  * Example: glyph_gl_set_opengl_version(4, 1) sets "#version 410 core\n"
  */
 static inline void glyph_gl_set_opengl_version(int major, int minor) {
-    sprintf(glyph_glsl_version_str, "#version %d%d0 core\n", major, minor);
+    snprintf(glyph_glsl_version_str, sizeof(glyph_glsl_version_str), "#version %d%d0 core\n", major, minor);
 }
 /* Built-in vertex shader source for text rendering */
 /* Transforms vertex positions and passes texture coordinates to fragment shader */
@@ -494,13 +840,11 @@ static const char* glyph__fragment_shader_body =
 "void main() {\n"
 "    float sample;\n"                              /* Texture sample value */
 "#ifndef GLYPHGL_MINIMAL\n"                        /* Full mode with effects support */
-"    if (TexCoord.x == -1.0 && TexCoord.y == -1.0 && (effects & 4) != 0) {\n"
-"        sample = 1.0;\n"                          /* Special case for underline rendering */
-"    } else {\n"
-"        sample = texture(textTexture, TexCoord).r;\n"  /* Sample red channel */
-"    }\n"
+"    sample = texture(textTexture, TexCoord).r;\n"  /* Sample red channel */
 "    float alpha;\n"                               /* Final alpha value */
-"    if ((effects & 8) != 0) {\n"                  /* SDF rendering mode */
+"    if (TexCoord.x == -1.0 && TexCoord.y == -1.0) {\n"
+"        alpha = 1.0;\n"                          /* Solid quads (underline, selection) */
+"    } else if ((effects & 8) != 0) {\n"           /* SDF rendering mode */
 "        float dist = sample * 2.0 - 1.0;\n"      /* Convert to signed distance */
 "        alpha = dist < 0.0 ? 1.0 : 0.0;\n"       /* Threshold for glyph interior */
 "    } else {\n"
@@ -510,61 +854,62 @@ static const char* glyph__fragment_shader_body =
 "    sample = texture(textTexture, TexCoord).r;\n"
 "    float dist = sample * 2.0 - 1.0;\n"          /* Always use SDF in minimal mode */
 "    float alpha = dist < 0.0 ? 1.0 : 0.0;\n"
+"    if (TexCoord.x == -1.0 && TexCoord.y == -1.0) alpha = 1.0;\n"  /* Solid quads */
 "#endif\n"
 "    FragColor = vec4(textColor, alpha);\n"       /* Combine color and alpha */
 "}\n";
-/* Shader source buffers for dynamic GLSL version insertion */
-static char glyph__vertex_shader_buffer[2048];
-static char glyph__fragment_shader_buffer[2048];
-
-/*
- * Generates complete vertex shader source with version directive
- *
- * Combines the GLSL version string with the vertex shader body
- * to create a complete, compilable shader source string.
- *
- * Returns: Pointer to buffer containing complete vertex shader source
- */
-static const char* glyph__get_vertex_shader_source() {
-    sprintf(glyph__vertex_shader_buffer, "%s%s", glyph_glsl_version_str, glyph__vertex_shader_body);
-    return glyph__vertex_shader_buffer;
-}
-
-/*
- * Generates complete fragment shader source with version directive
- *
- * Combines the GLSL version string with the fragment shader body
- * to create a complete, compilable shader source string.
- *
- * Returns: Pointer to buffer containing complete fragment shader source
- */
-static const char* glyph__get_fragment_shader_source() {
-    sprintf(glyph__fragment_shader_buffer, "%s%s", glyph_glsl_version_str, glyph__fragment_shader_body);
-    return glyph__fragment_shader_buffer;
-}
-
-/* Pre-generated shader sources for default effects - initialized on first use */
+/* Pre-generated shader sources for default effects - built once on first use */
 static char glyph__vertex_shader_source_buffer[2048];
 static char glyph__fragment_shader_source_buffer[2048];
 static const char* glyph__vertex_shader_source = NULL;
 static const char* glyph__fragment_shader_source = NULL;
+static glyph_once_t glyph__vertex_shader_source_once = GLYPH_ONCE_INIT;
+static glyph_once_t glyph__fragment_shader_source_once = GLYPH_ONCE_INIT;
 
 static const char* glyph__get_vertex_shader_source_cached() {
-    if (!glyph__vertex_shader_source) {
-        sprintf(glyph__vertex_shader_source_buffer, "%s%s", glyph_glsl_version_str, glyph__vertex_shader_body);
+    if (glyph__once_begin(&glyph__vertex_shader_source_once)) {
+        snprintf(glyph__vertex_shader_source_buffer, sizeof(glyph__vertex_shader_source_buffer), "%s%s",
+                 glyph_glsl_version_str, glyph__vertex_shader_body);
         glyph__vertex_shader_source = glyph__vertex_shader_source_buffer;
+        glyph__once_end(&glyph__vertex_shader_source_once, 1);
     }
     return glyph__vertex_shader_source;
 }
 
 static const char* glyph__get_fragment_shader_source_cached() {
-    if (!glyph__fragment_shader_source) {
-        sprintf(glyph__fragment_shader_source_buffer, "%s%s", glyph_glsl_version_str, glyph__fragment_shader_body);
+    if (glyph__once_begin(&glyph__fragment_shader_source_once)) {
+        snprintf(glyph__fragment_shader_source_buffer, sizeof(glyph__fragment_shader_source_buffer), "%s%s",
+                 glyph_glsl_version_str, glyph__fragment_shader_body);
         glyph__fragment_shader_source = glyph__fragment_shader_source_buffer;
+        glyph__once_end(&glyph__fragment_shader_source_once, 1);
     }
     return glyph__fragment_shader_source;
 }
 
+/*
+ * Returns the complete vertex shader source with version directive
+ *
+ * Combines the GLSL version string with the vertex shader body. The source is
+ * built once and shared, so concurrent callers never write the same buffer.
+ *
+ * Returns: Pointer to buffer containing complete vertex shader source
+ */
+static const char* glyph__get_vertex_shader_source() {
+    return glyph__get_vertex_shader_source_cached();
+}
+
+/*
+ * Returns the complete fragment shader source with version directive
+ *
+ * Combines the GLSL version string with the fragment shader body. The source
+ * is built once and shared, so concurrent callers never write the same buffer.
+ *
+ * Returns: Pointer to buffer containing complete fragment shader source
+ */
+static const char* glyph__get_fragment_shader_source() {
+    return glyph__get_fragment_shader_source_cached();
+}
+
 /*
  * Compiles a GLSL shader and returns the shader object
  *
@@ -0,0 +1,442 @@
+/*
+    MIT License
+
+    Copyright (c) 2025 Darek
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/*
+ * Glyph Grid Module - Instanced Cell Renderer for Terminals and Consoles
+ *
+ * Renders a fixed grid of monospace cells, each with its own glyph,
+ * foreground and background color:
+ * - The cell buffer lives on the GPU, 12 bytes per cell (glyph slot + two RGBA8 colors)
+ * - Glyph rectangles and texture coordinates are stored once in a float texture
+ * - Changed rows are tracked and only those rows are re-uploaded
+ * - The whole grid is drawn with a single instanced call (one quad per cell)
+ *
+ * Glyphs are clipped to their cell and composited over the cell background
+ * in the fragment shader, so no separate background pass is needed.
+ *
+ * Uses the renderer's atlas texture and projection. Requires OpenGL 3.3.
+ */
+
+#ifndef __GLYPH_GRID_H
+#define __GLYPH_GRID_H
+
+#include "glyph.h"
+
+/* Packs an 8-bit RGBA color into a cell color */
+#define GLYPH_RGBA(r, g, b, a) ((uint32_t)(r) | ((uint32_t)(g) << 8) | ((uint32_t)(b) << 16) | ((uint32_t)(a) << 24))
+
+/* Slot value of a cell without a glyph (background only) */
+#define GLYPH_GRID_EMPTY 0xFFFFFFFFu
+
+/* Glyphs per row of the glyph table texture (passed to the grid shader) */
+#ifndef GLYPH_GRID_TABLE_WIDTH
+#define GLYPH_GRID_TABLE_WIDTH 1024
+#endif
+
+/*
+ * GPU layout of one cell (12 bytes, matches the instance attributes)
+ */
+typedef struct {
+    uint32_t slot;                    /* Index into atlas->chars, or GLYPH_GRID_EMPTY */
+    uint32_t fg;                      /* Foreground color (GLYPH_RGBA) */
+    uint32_t bg;                      /* Background color (GLYPH_RGBA) */
+} glyph_grid_cell_t;
+
+/*
+ * Grid state - CPU mirror of the cells, dirty rows and GL objects
+ */
+typedef struct {
+    int columns, rows;                /* Grid size in cells */
+    float cell_width, cell_height;    /* Cell size in pixels */
+    float baseline;                   /* Baseline offset from the cell top */
+    float scale;                      /* Text scaling factor */
+    glyph_atlas_t* atlas;             /* Atlas of the renderer the grid was created for */
+    glyph_grid_cell_t* cells;         /* Row-major cell array */
+    unsigned char* dirty;             /* One flag per row */
+    int dirty_first, dirty_last;      /* Range containing all dirty rows (-1 = clean) */
+    int uploaded_rows;                /* Rows uploaded by the last draw */
+    GLuint program;                   /* Grid shader program */
+    GLuint vao;                       /* Vertex Array Object with the instance attributes */
+    GLuint vbo;                       /* GPU cell buffer */
+    GLuint glyph_table;               /* RGBA32F texture: texture rect and metrics per slot */
+    GLint loc_projection, loc_origin, loc_cell_size, loc_columns, loc_baseline, loc_scale, loc_sdf;
+    int initialized;                  /* Flag indicating if the grid was successfully created */
+} glyph_grid_t;
+
+static const char* glyph__grid_vertex_shader_body =
+"layout (location = 0) in uint aSlot;\n"
+"layout (location = 1) in vec4 aFg;\n"
+"layout (location = 2) in vec4 aBg;\n"
+"uniform mat4 projection;\n"
+"uniform vec2 origin;\n"
+"uniform vec2 cellSize;\n"
+"uniform int columns;\n"
+"uniform float baseline;\n"
+"uniform float glyphScale;\n"
+"uniform sampler2D glyphTable;\n"
+"out vec2 CellPos;\n"
+"flat out vec4 Fg;\n"
+"flat out vec4 Bg;\n"
+"flat out vec4 GlyphRect;\n"
+"flat out vec4 GlyphUV;\n"
+"void main() {\n"
+"    vec2 corner = vec2(float(gl_VertexID & 1), float((gl_VertexID >> 1) & 1));\n"  /* Triangle strip quad */
+"    vec2 cell = vec2(float(gl_InstanceID % columns), float(gl_InstanceID / columns));\n"
+"    CellPos = corner * cellSize;\n"
+"    gl_Position = projection * vec4(origin + cell * cellSize + CellPos, 0.0, 1.0);\n"
+"    Fg = aFg;\n"
+"    Bg = aBg;\n"
+"    GlyphRect = vec4(0.0);\n"
+"    GlyphUV = vec4(0.0);\n"
+"    if (aSlot != 0xFFFFFFFFu) {\n"
+"        ivec2 t = ivec2(int(aSlot % TABLE_WIDTH), int(aSlot / TABLE_WIDTH) * 2);\n"
+"        GlyphUV = texelFetch(glyphTable, t, 0);\n"                  /* u0, v0, u1, v1 */
+"        vec4 m = texelFetch(glyphTable, t + ivec2(0, 1), 0);\n"     /* xoff, yoff, width, height */
+"        GlyphRect = vec4(m.x * glyphScale, baseline - m.y * glyphScale, m.z * glyphScale, m.w * glyphScale);\n"
+"    }\n"
+"}\n";
+
+static const char* glyph__grid_fragment_shader_body =
+"in vec2 CellPos;\n"
+"flat in vec4 Fg;\n"
+"flat in vec4 Bg;\n"
+"flat in vec4 GlyphRect;\n"
+"flat in vec4 GlyphUV;\n"
+"out vec4 FragColor;\n"
+"uniform sampler2D textTexture;\n"
+"uniform int sdf;\n"
+"void main() {\n"
+"    vec2 local = (CellPos - GlyphRect.xy) / max(GlyphRect.zw, vec2(1e-6));\n"
+"    float s = texture(textTexture, mix(GlyphUV.xy, GlyphUV.zw, local)).r;\n"  /* Outside control flow: derivatives stay defined */
+"    bool inside = GlyphRect.z > 0.0 && all(greaterThanEqual(local, vec2(0.0))) && all(lessThan(local, vec2(1.0)));\n"
+"    float coverage = inside ? (sdf != 0 ? (s < 0.5 ? 1.0 : 0.0) : s) : 0.0;\n"
+"    float t = coverage * Fg.a;\n"                                 /* Foreground over background */
+"    float a = t + Bg.a * (1.0 - t);\n"
+"    vec3 c = a > 0.0 ? (Fg.rgb * t + Bg.rgb * Bg.a * (1.0 - t)) / a : vec3(0.0);\n"
+"    FragColor = vec4(c, a);\n"
+"}\n";
+
+/*
+ * Uploads the glyph table: per atlas character, its texture rectangle (row 2n)
+ * and its metrics in atlas pixels (row 2n + 1)
+ */
+static inline GLuint glyph_grid__create_glyph_table(const glyph_atlas_t* atlas) {
+    int width = GLYPH_GRID_TABLE_WIDTH;
+    int bands = (atlas->num_chars + width - 1) / width;
+    if (bands < 1) bands = 1;
+    float* table = (float*)GLYPH_MALLOC((size_t)width * bands * 2 * 4 * sizeof(float));
+    if (!table) return 0;
+    memset(table, 0, (size_t)width * bands * 2 * 4 * sizeof(float));
+    for (int i = 0; i < atlas->num_chars; i++) {
+        const glyph_atlas_char_t* ch = &atlas->chars[i];
+        float* uv = table + ((size_t)(i / width) * 2 * width + (i % width)) * 4;
+        float* metrics = uv + (size_t)width * 4;
+        uv[0] = (float)ch->x / atlas->image.width;
+        uv[1] = (float)ch->y / atlas->image.height;
+        uv[2] = (float)(ch->x + ch->width) / atlas->image.width;
+        uv[3] = (float)(ch->y + ch->height) / atlas->image.height;
+        metrics[0] = (float)ch->xoff;
+        metrics[1] = (float)ch->yoff;
+        metrics[2] = (float)ch->width;
+        metrics[3] = (float)ch->height;
+    }
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, bands * 2, 0, GL_RGBA, GL_FLOAT, table);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    GLYPH_FREE(table);
+    return texture;
+}
+
+/*
+ * Creates a grid renderer for a monospace font
+ *
+ * The cell width is the advance of 'M' and the cell height the hhea line
+ * height, both multiplied by scale. All cells start empty with a transparent
+ * background.
+ *
+ * Parameters:
+ *   renderer: Pointer to initialized glyph renderer (atlas, texture and projection are shared)
+ *   columns, rows: Grid size in cells
+ *   scale: Text scaling factor (1.0 = atlas pixel height)
+ *
+ * Returns: Initialized grid, or a zeroed struct on failure
+ */
+static inline glyph_grid_t glyph_grid_create(glyph_renderer_t* renderer, int columns, int rows, float scale) {
+    glyph_grid_t grid;
+    memset(&grid, 0, sizeof(grid));
+    if (!renderer || !renderer->initialized || columns <= 0 || rows <= 0) return grid;
+
+    grid.columns = columns;
+    grid.rows = rows;
+    grid.scale = scale;
+    grid.atlas = &renderer->atlas;
+    grid.cell_width = glyph_atlas_get_advance(&renderer->atlas, 'M') * scale;
+    grid.cell_height = (renderer->atlas.ascender - renderer->atlas.descender + renderer->atlas.line_gap) * scale;
+    grid.baseline = renderer->atlas.ascender * scale;
+    if (grid.cell_height <= 0.0f) {
+        grid.cell_height = renderer->atlas.pixel_height * scale;
+        grid.baseline = grid.cell_height * 0.8f;
+    }
+
+    size_t count = (size_t)columns * rows;
+    grid.cells = (glyph_grid_cell_t*)GLYPH_MALLOC(count * sizeof(glyph_grid_cell_t));
+    grid.dirty = (unsigned char*)GLYPH_MALLOC((size_t)rows);
+    if (!grid.cells || !grid.dirty) {
+        GLYPH_FREE(grid.cells);
+        GLYPH_FREE(grid.dirty);
+        memset(&grid, 0, sizeof(grid));
+        return grid;
+    }
+    for (size_t i = 0; i < count; i++) {
+        grid.cells[i].slot = GLYPH_GRID_EMPTY;
+        grid.cells[i].fg = GLYPH_RGBA(255, 255, 255, 255);
+        grid.cells[i].bg = 0;
+    }
+    memset(grid.dirty, 0, (size_t)rows);
+    grid.dirty_first = -1;
+    grid.dirty_last = -1;
+
+    /* Shader program */
+    char vertex_source[4096];
+    char fragment_source[2048];
+    snprintf(vertex_source, sizeof(vertex_source), "%s#define TABLE_WIDTH %uu\n%s", glyph_glsl_version_str,
+             (unsigned)GLYPH_GRID_TABLE_WIDTH, glyph__grid_vertex_shader_body);
+    snprintf(fragment_source, sizeof(fragment_source), "%s%s", glyph_glsl_version_str, glyph__grid_fragment_shader_body);
+    grid.program = glyph__create_program(vertex_source, fragment_source);
+    grid.glyph_table = glyph_grid__create_glyph_table(&renderer->atlas);
+    if (!grid.program || !grid.glyph_table) {
+        if (grid.program) glyph__glDeleteProgram(grid.program);
+        if (grid.glyph_table) glDeleteTextures(1, &grid.glyph_table);
+        GLYPH_FREE(grid.cells);
+        GLYPH_FREE(grid.dirty);
+        memset(&grid, 0, sizeof(grid));
+        return grid;
+    }
+    glyph__glUseProgram(grid.program);
+    glyph__glUniform1i(glyph__glGetUniformLocation(grid.program, "textTexture"), 0);
+    glyph__glUniform1i(glyph__glGetUniformLocation(grid.program, "glyphTable"), 1);
+    grid.loc_projection = glyph__glGetUniformLocation(grid.program, "projection");
+    grid.loc_origin = glyph__glGetUniformLocation(grid.program, "origin");
+    grid.loc_cell_size = glyph__glGetUniformLocation(grid.program, "cellSize");
+    grid.loc_columns = glyph__glGetUniformLocation(grid.program, "columns");
+    grid.loc_baseline = glyph__glGetUniformLocation(grid.program, "baseline");
+    grid.loc_scale = glyph__glGetUniformLocation(grid.program, "glyphScale");
+    grid.loc_sdf = glyph__glGetUniformLocation(grid.program, "sdf");
+    glyph__glUseProgram(0);
+
+    /* Instance buffer - one quad per cell, attributes advance per instance */
+    glyph__glGenVertexArrays(1, &grid.vao);
+    glyph__glGenBuffers(1, &grid.vbo);
+    glyph__glBindVertexArray(grid.vao);
+    glyph__glBindBuffer(GL_ARRAY_BUFFER, grid.vbo);
+    glyph__glBufferData(GL_ARRAY_BUFFER, count * sizeof(glyph_grid_cell_t), grid.cells, GL_DYNAMIC_DRAW);
+    glyph__glEnableVertexAttribArray(0);
+    glyph__glVertexAttribIPointer(0, 1, GL_UNSIGNED_INT, sizeof(glyph_grid_cell_t), (void*)0);
+    glyph__glVertexAttribDivisor(0, 1);
+    glyph__glEnableVertexAttribArray(1);
+    glyph__glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(glyph_grid_cell_t), (void*)offsetof(glyph_grid_cell_t, fg));
+    glyph__glVertexAttribDivisor(1, 1);
+    glyph__glEnableVertexAttribArray(2);
+    glyph__glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(glyph_grid_cell_t), (void*)offsetof(glyph_grid_cell_t, bg));
+    glyph__glVertexAttribDivisor(2, 1);
+    glyph__glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glyph__glBindVertexArray(0);
+
+    grid.initialized = 1;
+    return grid;
+}
+
+/*
+ * Releases the GPU resources and cell memory of a grid
+ */
+static inline void glyph_grid_free(glyph_grid_t* grid) {
+    if (!grid || !grid->initialized) return;
+    glyph__glDeleteVertexArrays(1, &grid->vao);
+    glyph__glDeleteBuffers(1, &grid->vbo);
+    glDeleteTextures(1, &grid->glyph_table);
+    glyph__glDeleteProgram(grid->program);
+    GLYPH_FREE(grid->cells);
+    GLYPH_FREE(grid->dirty);
+    memset(grid, 0, sizeof(*grid));
+}
+
+/* Marks a row for re-upload */
+static inline void glyph_grid__mark_row(glyph_grid_t* grid, int row) {
+    if (grid->dirty[row]) return;
+    grid->dirty[row] = 1;
+    if (grid->dirty_first < 0 || row < grid->dirty_first) grid->dirty_first = row;
+    if (row > grid->dirty_last) grid->dirty_last = row;
+}
+
+/* Resolves a codepoint to a grid slot ('?' for missing glyphs, empty for blank ones) */
+static inline uint32_t glyph_grid__slot(glyph_grid_t* grid, int codepoint) {
+    glyph_atlas_char_t* ch = glyph_atlas_find_char(grid->atlas, codepoint);
+    if (!ch) ch = glyph_atlas_find_char(grid->atlas, '?');
+    if (!ch || ch->width == 0) return GLYPH_GRID_EMPTY;
+    return (uint32_t)(ch - grid->atlas->chars);
+}
+
+/*
+ * Sets one cell
+ *
+ * The row is only marked dirty when the cell actually changes.
+ *
+ * Parameters:
+ *   grid: Grid
+ *   column, row: Cell position (ignored if outside the grid)
+ *   codepoint: Character to show (space or 0 for none)
+ *   fg, bg: Foreground and background colors (GLYPH_RGBA)
+ */
+static inline void glyph_grid_set_cell(glyph_grid_t* grid, int column, int row, int codepoint, uint32_t fg, uint32_t bg) {
+    if (!grid || !grid->initialized || column < 0 || row < 0 || column >= grid->columns || row >= grid->rows) return;
+    glyph_grid_cell_t* cell = &grid->cells[(size_t)row * grid->columns + column];
+    uint32_t slot = codepoint > ' ' ? glyph_grid__slot(grid, codepoint) : GLYPH_GRID_EMPTY;
+    if (cell->slot == slot && cell->fg == fg && cell->bg == bg) return;
+    cell->slot = slot;
+    cell->fg = fg;
+    cell->bg = bg;
+    glyph_grid__mark_row(grid, row);
+}
+
+/*
+ * Writes a string into consecutive cells of a row
+ *
+ * Parameters:
+ *   grid: Grid
+ *   column, row: Position of the first cell
+ *   text: UTF-8 string (one cell per codepoint)
+ *   len: Length of the string in bytes
+ *   fg, bg: Foreground and background colors (GLYPH_RGBA)
+ *
+ * Returns: Number of cells written (stops at the end of the row)
+ */
+static inline int glyph_grid_write(glyph_grid_t* grid, int column, int row, const char* text, size_t len, uint32_t fg, uint32_t bg) {
+    if (!grid || !grid->initialized || !text || row < 0 || row >= grid->rows) return 0;
+    int written = 0;
+    size_t i = 0;
+    while (i < len && column < grid->columns) {
+        int codepoint = glyph_atlas_utf8_decode_len(text, len, &i);
+        glyph_grid_set_cell(grid, column, row, codepoint, fg, bg);
+        column++;
+        written++;
+    }
+    return written;
+}
+
+/*
+ * Clears every cell to an empty cell with the given background
+ */
+static inline void glyph_grid_clear(glyph_grid_t* grid, uint32_t bg) {
+    if (!grid || !grid->initialized) return;
+    for (int row = 0; row < grid->rows; row++) {
+        for (int column = 0; column < grid->columns; column++) {
+            glyph_grid_set_cell(grid, column, row, ' ', GLYPH_RGBA(255, 255, 255, 255), bg);
+        }
+    }
+}
+
+/*
+ * Scrolls the grid up by a number of rows, clearing the rows that scroll in
+ *
+ * Parameters:
+ *   grid: Grid
+ *   lines: Number of rows to scroll (clamped to the grid height)
+ *   bg: Background of the new rows
+ */
+static inline void glyph_grid_scroll(glyph_grid_t* grid, int lines, uint32_t bg) {
+    if (!grid || !grid->initialized || lines <= 0) return;
+    if (lines > grid->rows) lines = grid->rows;
+    size_t row_cells = (size_t)grid->columns;
+    memmove(grid->cells, grid->cells + row_cells * lines, row_cells * (grid->rows - lines) * sizeof(glyph_grid_cell_t));
+    for (size_t i = row_cells * (grid->rows - lines); i < row_cells * grid->rows; i++) {
+        grid->cells[i].slot = GLYPH_GRID_EMPTY;
+        grid->cells[i].fg = GLYPH_RGBA(255, 255, 255, 255);
+        grid->cells[i].bg = bg;
+    }
+    for (int row = 0; row < grid->rows; row++) glyph_grid__mark_row(grid, row);
+}
+
+/*
+ * Uploads the dirty rows and draws the whole grid in one instanced call
+ *
+ * Consecutive dirty rows are uploaded with a single glBufferSubData.
+ *
+ * Parameters:
+ *   renderer: Renderer the grid was created for (projection must be set)
+ *   grid: Grid to draw
+ *   x, y: Screen position of the grid's top-left corner
+ *   effects: Only GLYPHGL_SDF is honored (atlas created with SDF)
+ */
+static inline void glyph_renderer_draw_grid(glyph_renderer_t* renderer, glyph_grid_t* grid, float x, float y, int effects) {
+    if (!renderer || !renderer->initialized || !grid || !grid->initialized) return;
+
+    /* Upload runs of dirty rows */
+    grid->uploaded_rows = 0;
+    if (grid->dirty_first >= 0) {
+        size_t row_bytes = (size_t)grid->columns * sizeof(glyph_grid_cell_t);
+        glyph__glBindBuffer(GL_ARRAY_BUFFER, grid->vbo);
+        int row = grid->dirty_first;
+        while (row <= grid->dirty_last) {
+            if (!grid->dirty[row]) { row++; continue; }
+            int end = row;
+            while (end <= grid->dirty_last && grid->dirty[end]) {
+                grid->dirty[end] = 0;
+                end++;
+            }
+            glyph__glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)(row * row_bytes), (GLsizeiptr)((end - row) * row_bytes),
+                                   grid->cells + (size_t)row * grid->columns);
+            grid->uploaded_rows += end - row;
+            row = end;
+        }
+        glyph__glBindBuffer(GL_ARRAY_BUFFER, 0);
+        grid->dirty_first = -1;
+        grid->dirty_last = -1;
+    }
+
+    glyph__glUseProgram(grid->program);
+    glyph__glUniformMatrix4fv(grid->loc_projection, 1, GL_FALSE, renderer->projection);
+    glyph__glUniform2f(grid->loc_origin, x, y);
+    glyph__glUniform2f(grid->loc_cell_size, grid->cell_width, grid->cell_height);
+    glyph__glUniform1i(grid->loc_columns, grid->columns);
+    glyph__glUniform1f(grid->loc_baseline, grid->baseline);
+    glyph__glUniform1f(grid->loc_scale, grid->scale);
+    glyph__glUniform1i(grid->loc_sdf, (effects & GLYPHGL_SDF) ? 1 : 0);
+    glyph__glActiveTexture(GL_TEXTURE0 + 1);
+    glBindTexture(GL_TEXTURE_2D, grid->glyph_table);
+    glyph__glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, renderer->texture);
+    glyph__glBindVertexArray(grid->vao);
+
+    glyph__glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, grid->columns * grid->rows);
+
+    glyph__glBindVertexArray(0);
+    glyph__glUseProgram(0);
+}
+
+#endif
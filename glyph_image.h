@@ -36,6 +36,11 @@
  * - BMP export for uncompressed bitmaps
  * - CRC32 and Adler32 checksum calculations
  * - Cross-platform compatibility
+ *
+ * Checksums use slice-by-8 CRC32 and block-deferred Adler32, with
+ * carry-less multiply (PCLMULQDQ) CRC32 and SSSE3 Adler32 kernels selected
+ * at runtime on x86, and the ARMv8 CRC32 instructions when the target has
+ * them. Define GLYPHGL_NO_SIMD to keep the portable kernels only.
  */
 
 #ifndef __GLYPH_IMAGE_h
@@ -68,6 +73,28 @@
     #include <math.h>
 #endif
 
+/* Checksum kernels: x86 ones are compiled per function and picked by CPUID at runtime */
+#if !defined(GLYPHGL_NO_SIMD) && (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    #define GLYPH_IMAGE__X86 1
+    #define GLYPH_IMAGE__TARGET(isa) __attribute__((target(isa)))
+    #include <cpuid.h>
+    #include <immintrin.h>
+#elif !defined(GLYPHGL_NO_SIMD) && (defined(_M_X64) || defined(_M_IX86)) && defined(_MSC_VER)
+    #define GLYPH_IMAGE__X86 1
+    #define GLYPH_IMAGE__TARGET(isa)
+    #include <intrin.h>
+    #include <immintrin.h>
+#elif !defined(GLYPHGL_NO_SIMD) && defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+    #define GLYPH_IMAGE__ARM_CRC32 1
+    #include <arm_acle.h>
+#endif
+
+/* Downsampling uses SSE2 where it is part of the baseline (as in glyph_soft.h) */
+#if !defined(GLYPHGL_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define GLYPH_IMAGE__SSE2 1
+    #include <emmintrin.h>
+#endif
+
 /*
  * Basic RGB image structure
  *
@@ -80,6 +107,21 @@ typedef struct {
     unsigned char* data;     /* RGB pixel data: width * height * 3 bytes */
 } glyph_image_t;
 
+/*
+ * Output sink for the image writers
+ *
+ * Receives the encoded file's bytes in order, in pieces of any size, so
+ * images can go to memory buffers, pipes or asset packers without a
+ * temporary file. Return 0 to continue or nonzero to abort the write (the
+ * writer then returns -1).
+ */
+typedef int (*glyph_write_func_t)(void* user, const void* data, size_t len);
+
+/* glyph_write_func_t writing to the stdio FILE* passed as 'user' */
+static int glyph_write_stdio(void* user, const void* data, size_t len) {
+    return fwrite(data, 1, len, (FILE*)user) == len ? 0 : -1;
+}
+
 /*
  * Creates a new RGB image with the specified dimensions
  *
@@ -103,6 +145,15 @@ static glyph_image_t glyph_image_create(unsigned int width, unsigned int height)
     return img;
 }
 
+/* glyph_image_create taking the pixels from 'allocator' (NULL = GLYPH_MALLOC); free with glyph_image_free_ex */
+static glyph_image_t glyph_image_create_ex(unsigned int width, unsigned int height, glyph_allocator_t* allocator) {
+    glyph_image_t img;
+    img.width = width;
+    img.height = height;
+    img.data = (unsigned char*)glyph__mem_alloc(allocator, (size_t)width * height * 3, GLYPH_MEMORY_ATLAS);
+    return img;
+}
+
 /*
  * Frees memory associated with a glyph image
  *
@@ -118,97 +169,776 @@ static void glyph_image_free(glyph_image_t* img) {
     img->data = NULL;
 }
 
-/* CRC32 lookup table and initialization flag for PNG checksums */
-static uint32_t crc32_table[256];
-static int crc32_table_inited = 0;
+/* Frees an image created by glyph_image_create_ex with the same allocator */
+static void glyph_image_free_ex(glyph_image_t* img, glyph_allocator_t* allocator) {
+    if (!img) return;
+    glyph__mem_free(allocator, img->data);
+    img->data = NULL;
+}
 
 /*
- * Initializes the CRC32 lookup table for efficient checksum calculation
+ * Halves 8-bit pixels in each dimension with a 2x2 box filter
  *
- * Creates a precomputed table using the IEEE 802.3 polynomial (0xEDB88320).
- * This table-based approach is much faster than computing CRC bit-by-bit.
- * The table is computed only once and reused for all CRC calculations.
+ * Produces the next level of a mip chain the way GL sizes it: the result is
+ * max(1, width / 2) by max(1, height / 2) pixels, each the rounded average
+ * of a 2x2 block (an odd last row or column is dropped, and a dimension of 1
+ * is kept). Single-channel rows are averaged 8 output pixels at a time with
+ * SSE2 when available.
+ *
+ * Parameters:
+ *   src: Tightly packed source pixels, 'channels' bytes each
+ *   width, height: Source size in pixels
+ *   channels: Bytes per pixel (1 for coverage planes, 3 for glyph_image_t data)
+ *   dst: Receives the downsampled pixels
  */
-static void crc32_init_table(void) {
-    if (crc32_table_inited) return; /* Already initialized */
-    uint32_t poly = 0xEDB88320u;    /* IEEE 802.3 CRC32 polynomial */
-    for (uint32_t i = 0; i < 256; ++i) {
-        uint32_t crc = i;
-        /* Process each bit of the byte */
-        for (int j = 0; j < 8; ++j) {
-            if (crc & 1) crc = (crc >> 1) ^ poly;
-            else crc >>= 1;
+static void glyph_image_downsample(const unsigned char* src, unsigned int width, unsigned int height, int channels, unsigned char* dst) {
+    unsigned int dst_width = width > 1 ? width / 2 : 1;
+    unsigned int dst_height = height > 1 ? height / 2 : 1;
+    size_t src_stride = (size_t)width * channels;
+    int dx = width > 1 ? channels : 0;   /* Offset of the second pixel of a pair */
+    for (unsigned int y = 0; y < dst_height; y++) {
+        const unsigned char* row0 = src + (size_t)(height > 1 ? y * 2 : 0) * src_stride;
+        const unsigned char* row1 = height > 1 ? row0 + src_stride : row0;
+        unsigned char* out = dst + (size_t)y * dst_width * channels;
+        unsigned int x = 0;
+#ifdef GLYPH_IMAGE__SSE2
+        if (channels == 1 && width > 1) {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i ones = _mm_set1_epi16(1);
+            const __m128i round = _mm_set1_epi16(2);
+            for (; x + 8 <= dst_width; x += 8) {
+                __m128i a = _mm_loadu_si128((const __m128i*)(row0 + x * 2));
+                __m128i b = _mm_loadu_si128((const __m128i*)(row1 + x * 2));
+                /* Vertical sums as 16-bit lanes, then horizontal pairs summed by PMADDWD */
+                __m128i lo = _mm_madd_epi16(_mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)), ones);
+                __m128i hi = _mm_madd_epi16(_mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero)), ones);
+                __m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_packs_epi32(lo, hi), round), 2);
+                _mm_storel_epi64((__m128i*)(out + x), _mm_packus_epi16(sum, sum));
+            }
+        }
+#endif
+        for (; x < dst_width; x++) {
+            const unsigned char* p0 = row0 + (size_t)x * 2 * channels;
+            const unsigned char* p1 = row1 + (size_t)x * 2 * channels;
+            for (int c = 0; c < channels; c++) {
+                out[(size_t)x * channels + c] = (unsigned char)((p0[c] + p0[c + dx] + p1[c] + p1[c + dx] + 2) >> 2);
+            }
         }
-        crc32_table[i] = crc;
     }
-    crc32_table_inited = 1;
 }
 
 /*
- * Computes CRC32 checksum of data using the precomputed lookup table
+ * Sizes a mip chain built with glyph_image_downsample
  *
- * CRC32 provides a digital fingerprint of data that changes dramatically
- * with even single-bit modifications. Used in PNG format for data integrity
- * verification and in networking protocols for error detection.
+ * Parameters:
+ *   width, height: Level 0 size in pixels
+ *   channels: Bytes per pixel
+ *   max_levels: Most levels wanted, level 0 included
+ *   chain_bytes: Receives the size of levels 1.. stored back to back (may be NULL)
+ *
+ * Returns: Number of levels, at most max_levels and ending no lower than 1x1
+ */
+static int glyph_image_mip_chain(unsigned int width, unsigned int height, int channels, int max_levels, size_t* chain_bytes) {
+    int levels = 1;
+    size_t bytes = 0;
+    while (levels < max_levels && levels < 32 && (width >> levels || height >> levels)) {
+        size_t w = width >> levels ? width >> levels : 1;
+        size_t h = height >> levels ? height >> levels : 1;
+        bytes += w * h * channels;
+        levels++;
+    }
+    if (chain_bytes) *chain_bytes = bytes;
+    return levels;
+}
+
+/*
+ * Builds mip levels 1.. by repeated glyph_image_downsample
  *
  * Parameters:
- *   data: Input data buffer
- *   len: Length of data in bytes
+ *   base: Level 0 pixels
+ *   width, height: Level 0 size in pixels
+ *   channels: Bytes per pixel
+ *   levels: Level count from glyph_image_mip_chain
+ *   chain: Receives levels 1.. back to back (chain_bytes from glyph_image_mip_chain)
+ */
+static void glyph_image_build_mips(const unsigned char* base, unsigned int width, unsigned int height, int channels,
+                                   int levels, unsigned char* chain) {
+    const unsigned char* src = base;
+    for (int level = 1; level < levels; level++) {
+        glyph_image_downsample(src, width, height, channels, chain);
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+        src = chain;
+        chain += (size_t)width * height * channels;
+    }
+}
+
+/*
+ * CRC32 lookup tables for PNG checksums
+ *
+ * Precomputed for the IEEE 802.3 polynomial (0xEDB88320, reflected). Slice 0
+ * is the classic byte table; slice k holds the CRC of a byte followed by k
+ * zero bytes, which lets glyph__crc32_slice8 fold 8 bytes per step. Being
+ * constant, they need no initialization and are safe to share between
+ * threads writing PNGs concurrently.
+ */
+static const uint32_t crc32_table[8][256] = {
+    { /* Slice 0 */
+        0x00000000u, 0x77073096u, 0xEE0E612Cu, 0x990951BAu, 0x076DC419u, 0x706AF48Fu,
+        0xE963A535u, 0x9E6495A3u, 0x0EDB8832u, 0x79DCB8A4u, 0xE0D5E91Eu, 0x97D2D988u,
+        0x09B64C2Bu, 0x7EB17CBDu, 0xE7B82D07u, 0x90BF1D91u, 0x1DB71064u, 0x6AB020F2u,
+        0xF3B97148u, 0x84BE41DEu, 0x1ADAD47Du, 0x6DDDE4EBu, 0xF4D4B551u, 0x83D385C7u,
+        0x136C9856u, 0x646BA8C0u, 0xFD62F97Au, 0x8A65C9ECu, 0x14015C4Fu, 0x63066CD9u,
+        0xFA0F3D63u, 0x8D080DF5u, 0x3B6E20C8u, 0x4C69105Eu, 0xD56041E4u, 0xA2677172u,
+        0x3C03E4D1u, 0x4B04D447u, 0xD20D85FDu, 0xA50AB56Bu, 0x35B5A8FAu, 0x42B2986Cu,
+        0xDBBBC9D6u, 0xACBCF940u, 0x32D86CE3u, 0x45DF5C75u, 0xDCD60DCFu, 0xABD13D59u,
+        0x26D930ACu, 0x51DE003Au, 0xC8D75180u, 0xBFD06116u, 0x21B4F4B5u, 0x56B3C423u,
+        0xCFBA9599u, 0xB8BDA50Fu, 0x2802B89Eu, 0x5F058808u, 0xC60CD9B2u, 0xB10BE924u,
+        0x2F6F7C87u, 0x58684C11u, 0xC1611DABu, 0xB6662D3Du, 0x76DC4190u, 0x01DB7106u,
+        0x98D220BCu, 0xEFD5102Au, 0x71B18589u, 0x06B6B51Fu, 0x9FBFE4A5u, 0xE8B8D433u,
+        0x7807C9A2u, 0x0F00F934u, 0x9609A88Eu, 0xE10E9818u, 0x7F6A0DBBu, 0x086D3D2Du,
+        0x91646C97u, 0xE6635C01u, 0x6B6B51F4u, 0x1C6C6162u, 0x856530D8u, 0xF262004Eu,
+        0x6C0695EDu, 0x1B01A57Bu, 0x8208F4C1u, 0xF50FC457u, 0x65B0D9C6u, 0x12B7E950u,
+        0x8BBEB8EAu, 0xFCB9887Cu, 0x62DD1DDFu, 0x15DA2D49u, 0x8CD37CF3u, 0xFBD44C65u,
+        0x4DB26158u, 0x3AB551CEu, 0xA3BC0074u, 0xD4BB30E2u, 0x4ADFA541u, 0x3DD895D7u,
+        0xA4D1C46Du, 0xD3D6F4FBu, 0x4369E96Au, 0x346ED9FCu, 0xAD678846u, 0xDA60B8D0u,
+        0x44042D73u, 0x33031DE5u, 0xAA0A4C5Fu, 0xDD0D7CC9u, 0x5005713Cu, 0x270241AAu,
+        0xBE0B1010u, 0xC90C2086u, 0x5768B525u, 0x206F85B3u, 0xB966D409u, 0xCE61E49Fu,
+        0x5EDEF90Eu, 0x29D9C998u, 0xB0D09822u, 0xC7D7A8B4u, 0x59B33D17u, 0x2EB40D81u,
+        0xB7BD5C3Bu, 0xC0BA6CADu, 0xEDB88320u, 0x9ABFB3B6u, 0x03B6E20Cu, 0x74B1D29Au,
+        0xEAD54739u, 0x9DD277AFu, 0x04DB2615u, 0x73DC1683u, 0xE3630B12u, 0x94643B84u,
+        0x0D6D6A3Eu, 0x7A6A5AA8u, 0xE40ECF0Bu, 0x9309FF9Du, 0x0A00AE27u, 0x7D079EB1u,
+        0xF00F9344u, 0x8708A3D2u, 0x1E01F268u, 0x6906C2FEu, 0xF762575Du, 0x806567CBu,
+        0x196C3671u, 0x6E6B06E7u, 0xFED41B76u, 0x89D32BE0u, 0x10DA7A5Au, 0x67DD4ACCu,
+        0xF9B9DF6Fu, 0x8EBEEFF9u, 0x17B7BE43u, 0x60B08ED5u, 0xD6D6A3E8u, 0xA1D1937Eu,
+        0x38D8C2C4u, 0x4FDFF252u, 0xD1BB67F1u, 0xA6BC5767u, 0x3FB506DDu, 0x48B2364Bu,
+        0xD80D2BDAu, 0xAF0A1B4Cu, 0x36034AF6u, 0x41047A60u, 0xDF60EFC3u, 0xA867DF55u,
+        0x316E8EEFu, 0x4669BE79u, 0xCB61B38Cu, 0xBC66831Au, 0x256FD2A0u, 0x5268E236u,
+        0xCC0C7795u, 0xBB0B4703u, 0x220216B9u, 0x5505262Fu, 0xC5BA3BBEu, 0xB2BD0B28u,
+        0x2BB45A92u, 0x5CB36A04u, 0xC2D7FFA7u, 0xB5D0CF31u, 0x2CD99E8Bu, 0x5BDEAE1Du,
+        0x9B64C2B0u, 0xEC63F226u, 0x756AA39Cu, 0x026D930Au, 0x9C0906A9u, 0xEB0E363Fu,
+        0x72076785u, 0x05005713u, 0x95BF4A82u, 0xE2B87A14u, 0x7BB12BAEu, 0x0CB61B38u,
+        0x92D28E9Bu, 0xE5D5BE0Du, 0x7CDCEFB7u, 0x0BDBDF21u, 0x86D3D2D4u, 0xF1D4E242u,
+        0x68DDB3F8u, 0x1FDA836Eu, 0x81BE16CDu, 0xF6B9265Bu, 0x6FB077E1u, 0x18B74777u,
+        0x88085AE6u, 0xFF0F6A70u, 0x66063BCAu, 0x11010B5Cu, 0x8F659EFFu, 0xF862AE69u,
+        0x616BFFD3u, 0x166CCF45u, 0xA00AE278u, 0xD70DD2EEu, 0x4E048354u, 0x3903B3C2u,
+        0xA7672661u, 0xD06016F7u, 0x4969474Du, 0x3E6E77DBu, 0xAED16A4Au, 0xD9D65ADCu,
+        0x40DF0B66u, 0x37D83BF0u, 0xA9BCAE53u, 0xDEBB9EC5u, 0x47B2CF7Fu, 0x30B5FFE9u,
+        0xBDBDF21Cu, 0xCABAC28Au, 0x53B39330u, 0x24B4A3A6u, 0xBAD03605u, 0xCDD70693u,
+        0x54DE5729u, 0x23D967BFu, 0xB3667A2Eu, 0xC4614AB8u, 0x5D681B02u, 0x2A6F2B94u,
+        0xB40BBE37u, 0xC30C8EA1u, 0x5A05DF1Bu, 0x2D02EF8Du
+    },
+    { /* Slice 1 */
+        0x00000000u, 0x191B3141u, 0x32366282u, 0x2B2D53C3u, 0x646CC504u, 0x7D77F445u,
+        0x565AA786u, 0x4F4196C7u, 0xC8D98A08u, 0xD1C2BB49u, 0xFAEFE88Au, 0xE3F4D9CBu,
+        0xACB54F0Cu, 0xB5AE7E4Du, 0x9E832D8Eu, 0x87981CCFu, 0x4AC21251u, 0x53D92310u,
+        0x78F470D3u, 0x61EF4192u, 0x2EAED755u, 0x37B5E614u, 0x1C98B5D7u, 0x05838496u,
+        0x821B9859u, 0x9B00A918u, 0xB02DFADBu, 0xA936CB9Au, 0xE6775D5Du, 0xFF6C6C1Cu,
+        0xD4413FDFu, 0xCD5A0E9Eu, 0x958424A2u, 0x8C9F15E3u, 0xA7B24620u, 0xBEA97761u,
+        0xF1E8E1A6u, 0xE8F3D0E7u, 0xC3DE8324u, 0xDAC5B265u, 0x5D5DAEAAu, 0x44469FEBu,
+        0x6F6BCC28u, 0x7670FD69u, 0x39316BAEu, 0x202A5AEFu, 0x0B07092Cu, 0x121C386Du,
+        0xDF4636F3u, 0xC65D07B2u, 0xED705471u, 0xF46B6530u, 0xBB2AF3F7u, 0xA231C2B6u,
+        0x891C9175u, 0x9007A034u, 0x179FBCFBu, 0x0E848DBAu, 0x25A9DE79u, 0x3CB2EF38u,
+        0x73F379FFu, 0x6AE848BEu, 0x41C51B7Du, 0x58DE2A3Cu, 0xF0794F05u, 0xE9627E44u,
+        0xC24F2D87u, 0xDB541CC6u, 0x94158A01u, 0x8D0EBB40u, 0xA623E883u, 0xBF38D9C2u,
+        0x38A0C50Du, 0x21BBF44Cu, 0x0A96A78Fu, 0x138D96CEu, 0x5CCC0009u, 0x45D73148u,
+        0x6EFA628Bu, 0x77E153CAu, 0xBABB5D54u, 0xA3A06C15u, 0x888D3FD6u, 0x91960E97u,
+        0xDED79850u, 0xC7CCA911u, 0xECE1FAD2u, 0xF5FACB93u, 0x7262D75Cu, 0x6B79E61Du,
+        0x4054B5DEu, 0x594F849Fu, 0x160E1258u, 0x0F152319u, 0x243870DAu, 0x3D23419Bu,
+        0x65FD6BA7u, 0x7CE65AE6u, 0x57CB0925u, 0x4ED03864u, 0x0191AEA3u, 0x188A9FE2u,
+        0x33A7CC21u, 0x2ABCFD60u, 0xAD24E1AFu, 0xB43FD0EEu, 0x9F12832Du, 0x8609B26Cu,
+        0xC94824ABu, 0xD05315EAu, 0xFB7E4629u, 0xE2657768u, 0x2F3F79F6u, 0x362448B7u,
+        0x1D091B74u, 0x04122A35u, 0x4B53BCF2u, 0x52488DB3u, 0x7965DE70u, 0x607EEF31u,
+        0xE7E6F3FEu, 0xFEFDC2BFu, 0xD5D0917Cu, 0xCCCBA03Du, 0x838A36FAu, 0x9A9107BBu,
+        0xB1BC5478u, 0xA8A76539u, 0x3B83984Bu, 0x2298A90Au, 0x09B5FAC9u, 0x10AECB88u,
+        0x5FEF5D4Fu, 0x46F46C0Eu, 0x6DD93FCDu, 0x74C20E8Cu, 0xF35A1243u, 0xEA412302u,
+        0xC16C70C1u, 0xD8774180u, 0x9736D747u, 0x8E2DE606u, 0xA500B5C5u, 0xBC1B8484u,
+        0x71418A1Au, 0x685ABB5Bu, 0x4377E898u, 0x5A6CD9D9u, 0x152D4F1Eu, 0x0C367E5Fu,
+        0x271B2D9Cu, 0x3E001CDDu, 0xB9980012u, 0xA0833153u, 0x8BAE6290u, 0x92B553D1u,
+        0xDDF4C516u, 0xC4EFF457u, 0xEFC2A794u, 0xF6D996D5u, 0xAE07BCE9u, 0xB71C8DA8u,
+        0x9C31DE6Bu, 0x852AEF2Au, 0xCA6B79EDu, 0xD37048ACu, 0xF85D1B6Fu, 0xE1462A2Eu,
+        0x66DE36E1u, 0x7FC507A0u, 0x54E85463u, 0x4DF36522u, 0x02B2F3E5u, 0x1BA9C2A4u,
+        0x30849167u, 0x299FA026u, 0xE4C5AEB8u, 0xFDDE9FF9u, 0xD6F3CC3Au, 0xCFE8FD7Bu,
+        0x80A96BBCu, 0x99B25AFDu, 0xB29F093Eu, 0xAB84387Fu, 0x2C1C24B0u, 0x350715F1u,
+        0x1E2A4632u, 0x07317773u, 0x4870E1B4u, 0x516BD0F5u, 0x7A468336u, 0x635DB277u,
+        0xCBFAD74Eu, 0xD2E1E60Fu, 0xF9CCB5CCu, 0xE0D7848Du, 0xAF96124Au, 0xB68D230Bu,
+        0x9DA070C8u, 0x84BB4189u, 0x03235D46u, 0x1A386C07u, 0x31153FC4u, 0x280E0E85u,
+        0x674F9842u, 0x7E54A903u, 0x5579FAC0u, 0x4C62CB81u, 0x8138C51Fu, 0x9823F45Eu,
+        0xB30EA79Du, 0xAA1596DCu, 0xE554001Bu, 0xFC4F315Au, 0xD7626299u, 0xCE7953D8u,
+        0x49E14F17u, 0x50FA7E56u, 0x7BD72D95u, 0x62CC1CD4u, 0x2D8D8A13u, 0x3496BB52u,
+        0x1FBBE891u, 0x06A0D9D0u, 0x5E7EF3ECu, 0x4765C2ADu, 0x6C48916Eu, 0x7553A02Fu,
+        0x3A1236E8u, 0x230907A9u, 0x0824546Au, 0x113F652Bu, 0x96A779E4u, 0x8FBC48A5u,
+        0xA4911B66u, 0xBD8A2A27u, 0xF2CBBCE0u, 0xEBD08DA1u, 0xC0FDDE62u, 0xD9E6EF23u,
+        0x14BCE1BDu, 0x0DA7D0FCu, 0x268A833Fu, 0x3F91B27Eu, 0x70D024B9u, 0x69CB15F8u,
+        0x42E6463Bu, 0x5BFD777Au, 0xDC656BB5u, 0xC57E5AF4u, 0xEE530937u, 0xF7483876u,
+        0xB809AEB1u, 0xA1129FF0u, 0x8A3FCC33u, 0x9324FD72u
+    },
+    { /* Slice 2 */
+        0x00000000u, 0x01C26A37u, 0x0384D46Eu, 0x0246BE59u, 0x0709A8DCu, 0x06CBC2EBu,
+        0x048D7CB2u, 0x054F1685u, 0x0E1351B8u, 0x0FD13B8Fu, 0x0D9785D6u, 0x0C55EFE1u,
+        0x091AF964u, 0x08D89353u, 0x0A9E2D0Au, 0x0B5C473Du, 0x1C26A370u, 0x1DE4C947u,
+        0x1FA2771Eu, 0x1E601D29u, 0x1B2F0BACu, 0x1AED619Bu, 0x18ABDFC2u, 0x1969B5F5u,
+        0x1235F2C8u, 0x13F798FFu, 0x11B126A6u, 0x10734C91u, 0x153C5A14u, 0x14FE3023u,
+        0x16B88E7Au, 0x177AE44Du, 0x384D46E0u, 0x398F2CD7u, 0x3BC9928Eu, 0x3A0BF8B9u,
+        0x3F44EE3Cu, 0x3E86840Bu, 0x3CC03A52u, 0x3D025065u, 0x365E1758u, 0x379C7D6Fu,
+        0x35DAC336u, 0x3418A901u, 0x3157BF84u, 0x3095D5B3u, 0x32D36BEAu, 0x331101DDu,
+        0x246BE590u, 0x25A98FA7u, 0x27EF31FEu, 0x262D5BC9u, 0x23624D4Cu, 0x22A0277Bu,
+        0x20E69922u, 0x2124F315u, 0x2A78B428u, 0x2BBADE1Fu, 0x29FC6046u, 0x283E0A71u,
+        0x2D711CF4u, 0x2CB376C3u, 0x2EF5C89Au, 0x2F37A2ADu, 0x709A8DC0u, 0x7158E7F7u,
+        0x731E59AEu, 0x72DC3399u, 0x7793251Cu, 0x76514F2Bu, 0x7417F172u, 0x75D59B45u,
+        0x7E89DC78u, 0x7F4BB64Fu, 0x7D0D0816u, 0x7CCF6221u, 0x798074A4u, 0x78421E93u,
+        0x7A04A0CAu, 0x7BC6CAFDu, 0x6CBC2EB0u, 0x6D7E4487u, 0x6F38FADEu, 0x6EFA90E9u,
+        0x6BB5866Cu, 0x6A77EC5Bu, 0x68315202u, 0x69F33835u, 0x62AF7F08u, 0x636D153Fu,
+        0x612BAB66u, 0x60E9C151u, 0x65A6D7D4u, 0x6464BDE3u, 0x662203BAu, 0x67E0698Du,
+        0x48D7CB20u, 0x4915A117u, 0x4B531F4Eu, 0x4A917579u, 0x4FDE63FCu, 0x4E1C09CBu,
+        0x4C5AB792u, 0x4D98DDA5u, 0x46C49A98u, 0x4706F0AFu, 0x45404EF6u, 0x448224C1u,
+        0x41CD3244u, 0x400F5873u, 0x4249E62Au, 0x438B8C1Du, 0x54F16850u, 0x55330267u,
+        0x5775BC3Eu, 0x56B7D609u, 0x53F8C08Cu, 0x523AAABBu, 0x507C14E2u, 0x51BE7ED5u,
+        0x5AE239E8u, 0x5B2053DFu, 0x5966ED86u, 0x58A487B1u, 0x5DEB9134u, 0x5C29FB03u,
+        0x5E6F455Au, 0x5FAD2F6Du, 0xE1351B80u, 0xE0F771B7u, 0xE2B1CFEEu, 0xE373A5D9u,
+        0xE63CB35Cu, 0xE7FED96Bu, 0xE5B86732u, 0xE47A0D05u, 0xEF264A38u, 0xEEE4200Fu,
+        0xECA29E56u, 0xED60F461u, 0xE82FE2E4u, 0xE9ED88D3u, 0xEBAB368Au, 0xEA695CBDu,
+        0xFD13B8F0u, 0xFCD1D2C7u, 0xFE976C9Eu, 0xFF5506A9u, 0xFA1A102Cu, 0xFBD87A1Bu,
+        0xF99EC442u, 0xF85CAE75u, 0xF300E948u, 0xF2C2837Fu, 0xF0843D26u, 0xF1465711u,
+        0xF4094194u, 0xF5CB2BA3u, 0xF78D95FAu, 0xF64FFFCDu, 0xD9785D60u, 0xD8BA3757u,
+        0xDAFC890Eu, 0xDB3EE339u, 0xDE71F5BCu, 0xDFB39F8Bu, 0xDDF521D2u, 0xDC374BE5u,
+        0xD76B0CD8u, 0xD6A966EFu, 0xD4EFD8B6u, 0xD52DB281u, 0xD062A404u, 0xD1A0CE33u,
+        0xD3E6706Au, 0xD2241A5Du, 0xC55EFE10u, 0xC49C9427u, 0xC6DA2A7Eu, 0xC7184049u,
+        0xC25756CCu, 0xC3953CFBu, 0xC1D382A2u, 0xC011E895u, 0xCB4DAFA8u, 0xCA8FC59Fu,
+        0xC8C97BC6u, 0xC90B11F1u, 0xCC440774u, 0xCD866D43u, 0xCFC0D31Au, 0xCE02B92Du,
+        0x91AF9640u, 0x906DFC77u, 0x922B422Eu, 0x93E92819u, 0x96A63E9Cu, 0x976454ABu,
+        0x9522EAF2u, 0x94E080C5u, 0x9FBCC7F8u, 0x9E7EADCFu, 0x9C381396u, 0x9DFA79A1u,
+        0x98B56F24u, 0x99770513u, 0x9B31BB4Au, 0x9AF3D17Du, 0x8D893530u, 0x8C4B5F07u,
+        0x8E0DE15Eu, 0x8FCF8B69u, 0x8A809DECu, 0x8B42F7DBu, 0x89044982u, 0x88C623B5u,
+        0x839A6488u, 0x82580EBFu, 0x801EB0E6u, 0x81DCDAD1u, 0x8493CC54u, 0x8551A663u,
+        0x8717183Au, 0x86D5720Du, 0xA9E2D0A0u, 0xA820BA97u, 0xAA6604CEu, 0xABA46EF9u,
+        0xAEEB787Cu, 0xAF29124Bu, 0xAD6FAC12u, 0xACADC625u, 0xA7F18118u, 0xA633EB2Fu,
+        0xA4755576u, 0xA5B73F41u, 0xA0F829C4u, 0xA13A43F3u, 0xA37CFDAAu, 0xA2BE979Du,
+        0xB5C473D0u, 0xB40619E7u, 0xB640A7BEu, 0xB782CD89u, 0xB2CDDB0Cu, 0xB30FB13Bu,
+        0xB1490F62u, 0xB08B6555u, 0xBBD72268u, 0xBA15485Fu, 0xB853F606u, 0xB9919C31u,
+        0xBCDE8AB4u, 0xBD1CE083u, 0xBF5A5EDAu, 0xBE9834EDu
+    },
+    { /* Slice 3 */
+        0x00000000u, 0xB8BC6765u, 0xAA09C88Bu, 0x12B5AFEEu, 0x8F629757u, 0x37DEF032u,
+        0x256B5FDCu, 0x9DD738B9u, 0xC5B428EFu, 0x7D084F8Au, 0x6FBDE064u, 0xD7018701u,
+        0x4AD6BFB8u, 0xF26AD8DDu, 0xE0DF7733u, 0x58631056u, 0x5019579Fu, 0xE8A530FAu,
+        0xFA109F14u, 0x42ACF871u, 0xDF7BC0C8u, 0x67C7A7ADu, 0x75720843u, 0xCDCE6F26u,
+        0x95AD7F70u, 0x2D111815u, 0x3FA4B7FBu, 0x8718D09Eu, 0x1ACFE827u, 0xA2738F42u,
+        0xB0C620ACu, 0x087A47C9u, 0xA032AF3Eu, 0x188EC85Bu, 0x0A3B67B5u, 0xB28700D0u,
+        0x2F503869u, 0x97EC5F0Cu, 0x8559F0E2u, 0x3DE59787u, 0x658687D1u, 0xDD3AE0B4u,
+        0xCF8F4F5Au, 0x7733283Fu, 0xEAE41086u, 0x525877E3u, 0x40EDD80Du, 0xF851BF68u,
+        0xF02BF8A1u, 0x48979FC4u, 0x5A22302Au, 0xE29E574Fu, 0x7F496FF6u, 0xC7F50893u,
+        0xD540A77Du, 0x6DFCC018u, 0x359FD04Eu, 0x8D23B72Bu, 0x9F9618C5u, 0x272A7FA0u,
+        0xBAFD4719u, 0x0241207Cu, 0x10F48F92u, 0xA848E8F7u, 0x9B14583Du, 0x23A83F58u,
+        0x311D90B6u, 0x89A1F7D3u, 0x1476CF6Au, 0xACCAA80Fu, 0xBE7F07E1u, 0x06C36084u,
+        0x5EA070D2u, 0xE61C17B7u, 0xF4A9B859u, 0x4C15DF3Cu, 0xD1C2E785u, 0x697E80E0u,
+        0x7BCB2F0Eu, 0xC377486Bu, 0xCB0D0FA2u, 0x73B168C7u, 0x6104C729u, 0xD9B8A04Cu,
+        0x446F98F5u, 0xFCD3FF90u, 0xEE66507Eu, 0x56DA371Bu, 0x0EB9274Du, 0xB6054028u,
+        0xA4B0EFC6u, 0x1C0C88A3u, 0x81DBB01Au, 0x3967D77Fu, 0x2BD27891u, 0x936E1FF4u,
+        0x3B26F703u, 0x839A9066u, 0x912F3F88u, 0x299358EDu, 0xB4446054u, 0x0CF80731u,
+        0x1E4DA8DFu, 0xA6F1CFBAu, 0xFE92DFECu, 0x462EB889u, 0x549B1767u, 0xEC277002u,
+        0x71F048BBu, 0xC94C2FDEu, 0xDBF98030u, 0x6345E755u, 0x6B3FA09Cu, 0xD383C7F9u,
+        0xC1366817u, 0x798A0F72u, 0xE45D37CBu, 0x5CE150AEu, 0x4E54FF40u, 0xF6E89825u,
+        0xAE8B8873u, 0x1637EF16u, 0x048240F8u, 0xBC3E279Du, 0x21E91F24u, 0x99557841u,
+        0x8BE0D7AFu, 0x335CB0CAu, 0xED59B63Bu, 0x55E5D15Eu, 0x47507EB0u, 0xFFEC19D5u,
+        0x623B216Cu, 0xDA874609u, 0xC832E9E7u, 0x708E8E82u, 0x28ED9ED4u, 0x9051F9B1u,
+        0x82E4565Fu, 0x3A58313Au, 0xA78F0983u, 0x1F336EE6u, 0x0D86C108u, 0xB53AA66Du,
+        0xBD40E1A4u, 0x05FC86C1u, 0x1749292Fu, 0xAFF54E4Au, 0x322276F3u, 0x8A9E1196u,
+        0x982BBE78u, 0x2097D91Du, 0x78F4C94Bu, 0xC048AE2Eu, 0xD2FD01C0u, 0x6A4166A5u,
+        0xF7965E1Cu, 0x4F2A3979u, 0x5D9F9697u, 0xE523F1F2u, 0x4D6B1905u, 0xF5D77E60u,
+        0xE762D18Eu, 0x5FDEB6EBu, 0xC2098E52u, 0x7AB5E937u, 0x680046D9u, 0xD0BC21BCu,
+        0x88DF31EAu, 0x3063568Fu, 0x22D6F961u, 0x9A6A9E04u, 0x07BDA6BDu, 0xBF01C1D8u,
+        0xADB46E36u, 0x15080953u, 0x1D724E9Au, 0xA5CE29FFu, 0xB77B8611u, 0x0FC7E174u,
+        0x9210D9CDu, 0x2AACBEA8u, 0x38191146u, 0x80A57623u, 0xD8C66675u, 0x607A0110u,
+        0x72CFAEFEu, 0xCA73C99Bu, 0x57A4F122u, 0xEF189647u, 0xFDAD39A9u, 0x45115ECCu,
+        0x764DEE06u, 0xCEF18963u, 0xDC44268Du, 0x64F841E8u, 0xF92F7951u, 0x41931E34u,
+        0x5326B1DAu, 0xEB9AD6BFu, 0xB3F9C6E9u, 0x0B45A18Cu, 0x19F00E62u, 0xA14C6907u,
+        0x3C9B51BEu, 0x842736DBu, 0x96929935u, 0x2E2EFE50u, 0x2654B999u, 0x9EE8DEFCu,
+        0x8C5D7112u, 0x34E11677u, 0xA9362ECEu, 0x118A49ABu, 0x033FE645u, 0xBB838120u,
+        0xE3E09176u, 0x5B5CF613u, 0x49E959FDu, 0xF1553E98u, 0x6C820621u, 0xD43E6144u,
+        0xC68BCEAAu, 0x7E37A9CFu, 0xD67F4138u, 0x6EC3265Du, 0x7C7689B3u, 0xC4CAEED6u,
+        0x591DD66Fu, 0xE1A1B10Au, 0xF3141EE4u, 0x4BA87981u, 0x13CB69D7u, 0xAB770EB2u,
+        0xB9C2A15Cu, 0x017EC639u, 0x9CA9FE80u, 0x241599E5u, 0x36A0360Bu, 0x8E1C516Eu,
+        0x866616A7u, 0x3EDA71C2u, 0x2C6FDE2Cu, 0x94D3B949u, 0x090481F0u, 0xB1B8E695u,
+        0xA30D497Bu, 0x1BB12E1Eu, 0x43D23E48u, 0xFB6E592Du, 0xE9DBF6C3u, 0x516791A6u,
+        0xCCB0A91Fu, 0x740CCE7Au, 0x66B96194u, 0xDE0506F1u
+    },
+    { /* Slice 4 */
+        0x00000000u, 0x3D6029B0u, 0x7AC05360u, 0x47A07AD0u, 0xF580A6C0u, 0xC8E08F70u,
+        0x8F40F5A0u, 0xB220DC10u, 0x30704BC1u, 0x0D106271u, 0x4AB018A1u, 0x77D03111u,
+        0xC5F0ED01u, 0xF890C4B1u, 0xBF30BE61u, 0x825097D1u, 0x60E09782u, 0x5D80BE32u,
+        0x1A20C4E2u, 0x2740ED52u, 0x95603142u, 0xA80018F2u, 0xEFA06222u, 0xD2C04B92u,
+        0x5090DC43u, 0x6DF0F5F3u, 0x2A508F23u, 0x1730A693u, 0xA5107A83u, 0x98705333u,
+        0xDFD029E3u, 0xE2B00053u, 0xC1C12F04u, 0xFCA106B4u, 0xBB017C64u, 0x866155D4u,
+        0x344189C4u, 0x0921A074u, 0x4E81DAA4u, 0x73E1F314u, 0xF1B164C5u, 0xCCD14D75u,
+        0x8B7137A5u, 0xB6111E15u, 0x0431C205u, 0x3951EBB5u, 0x7EF19165u, 0x4391B8D5u,
+        0xA121B886u, 0x9C419136u, 0xDBE1EBE6u, 0xE681C256u, 0x54A11E46u, 0x69C137F6u,
+        0x2E614D26u, 0x13016496u, 0x9151F347u, 0xAC31DAF7u, 0xEB91A027u, 0xD6F18997u,
+        0x64D15587u, 0x59B17C37u, 0x1E1106E7u, 0x23712F57u, 0x58F35849u, 0x659371F9u,
+        0x22330B29u, 0x1F532299u, 0xAD73FE89u, 0x9013D739u, 0xD7B3ADE9u, 0xEAD38459u,
+        0x68831388u, 0x55E33A38u, 0x124340E8u, 0x2F236958u, 0x9D03B548u, 0xA0639CF8u,
+        0xE7C3E628u, 0xDAA3CF98u, 0x3813CFCBu, 0x0573E67Bu, 0x42D39CABu, 0x7FB3B51Bu,
+        0xCD93690Bu, 0xF0F340BBu, 0xB7533A6Bu, 0x8A3313DBu, 0x0863840Au, 0x3503ADBAu,
+        0x72A3D76Au, 0x4FC3FEDAu, 0xFDE322CAu, 0xC0830B7Au, 0x872371AAu, 0xBA43581Au,
+        0x9932774Du, 0xA4525EFDu, 0xE3F2242Du, 0xDE920D9Du, 0x6CB2D18Du, 0x51D2F83Du,
+        0x167282EDu, 0x2B12AB5Du, 0xA9423C8Cu, 0x9422153Cu, 0xD3826FECu, 0xEEE2465Cu,
+        0x5CC29A4Cu, 0x61A2B3FCu, 0x2602C92Cu, 0x1B62E09Cu, 0xF9D2E0CFu, 0xC4B2C97Fu,
+        0x8312B3AFu, 0xBE729A1Fu, 0x0C52460Fu, 0x31326FBFu, 0x7692156Fu, 0x4BF23CDFu,
+        0xC9A2AB0Eu, 0xF4C282BEu, 0xB362F86Eu, 0x8E02D1DEu, 0x3C220DCEu, 0x0142247Eu,
+        0x46E25EAEu, 0x7B82771Eu, 0xB1E6B092u, 0x8C869922u, 0xCB26E3F2u, 0xF646CA42u,
+        0x44661652u, 0x79063FE2u, 0x3EA64532u, 0x03C66C82u, 0x8196FB53u, 0xBCF6D2E3u,
+        0xFB56A833u, 0xC6368183u, 0x74165D93u, 0x49767423u, 0x0ED60EF3u, 0x33B62743u,
+        0xD1062710u, 0xEC660EA0u, 0xABC67470u, 0x96A65DC0u, 0x248681D0u, 0x19E6A860u,
+        0x5E46D2B0u, 0x6326FB00u, 0xE1766CD1u, 0xDC164561u, 0x9BB63FB1u, 0xA6D61601u,
+        0x14F6CA11u, 0x2996E3A1u, 0x6E369971u, 0x5356B0C1u, 0x70279F96u, 0x4D47B626u,
+        0x0AE7CCF6u, 0x3787E546u, 0x85A73956u, 0xB8C710E6u, 0xFF676A36u, 0xC2074386u,
+        0x4057D457u, 0x7D37FDE7u, 0x3A978737u, 0x07F7AE87u, 0xB5D77297u, 0x88B75B27u,
+        0xCF1721F7u, 0xF2770847u, 0x10C70814u, 0x2DA721A4u, 0x6A075B74u, 0x576772C4u,
+        0xE547AED4u, 0xD8278764u, 0x9F87FDB4u, 0xA2E7D404u, 0x20B743D5u, 0x1DD76A65u,
+        0x5A7710B5u, 0x67173905u, 0xD537E515u, 0xE857CCA5u, 0xAFF7B675u, 0x92979FC5u,
+        0xE915E8DBu, 0xD475C16Bu, 0x93D5BBBBu, 0xAEB5920Bu, 0x1C954E1Bu, 0x21F567ABu,
+        0x66551D7Bu, 0x5B3534CBu, 0xD965A31Au, 0xE4058AAAu, 0xA3A5F07Au, 0x9EC5D9CAu,
+        0x2CE505DAu, 0x11852C6Au, 0x562556BAu, 0x6B457F0Au, 0x89F57F59u, 0xB49556E9u,
+        0xF3352C39u, 0xCE550589u, 0x7C75D999u, 0x4115F029u, 0x06B58AF9u, 0x3BD5A349u,
+        0xB9853498u, 0x84E51D28u, 0xC34567F8u, 0xFE254E48u, 0x4C059258u, 0x7165BBE8u,
+        0x36C5C138u, 0x0BA5E888u, 0x28D4C7DFu, 0x15B4EE6Fu, 0x521494BFu, 0x6F74BD0Fu,
+        0xDD54611Fu, 0xE03448AFu, 0xA794327Fu, 0x9AF41BCFu, 0x18A48C1Eu, 0x25C4A5AEu,
+        0x6264DF7Eu, 0x5F04F6CEu, 0xED242ADEu, 0xD044036Eu, 0x97E479BEu, 0xAA84500Eu,
+        0x4834505Du, 0x755479EDu, 0x32F4033Du, 0x0F942A8Du, 0xBDB4F69Du, 0x80D4DF2Du,
+        0xC774A5FDu, 0xFA148C4Du, 0x78441B9Cu, 0x4524322Cu, 0x028448FCu, 0x3FE4614Cu,
+        0x8DC4BD5Cu, 0xB0A494ECu, 0xF704EE3Cu, 0xCA64C78Cu
+    },
+    { /* Slice 5 */
+        0x00000000u, 0xCB5CD3A5u, 0x4DC8A10Bu, 0x869472AEu, 0x9B914216u, 0x50CD91B3u,
+        0xD659E31Du, 0x1D0530B8u, 0xEC53826Du, 0x270F51C8u, 0xA19B2366u, 0x6AC7F0C3u,
+        0x77C2C07Bu, 0xBC9E13DEu, 0x3A0A6170u, 0xF156B2D5u, 0x03D6029Bu, 0xC88AD13Eu,
+        0x4E1EA390u, 0x85427035u, 0x9847408Du, 0x531B9328u, 0xD58FE186u, 0x1ED33223u,
+        0xEF8580F6u, 0x24D95353u, 0xA24D21FDu, 0x6911F258u, 0x7414C2E0u, 0xBF481145u,
+        0x39DC63EBu, 0xF280B04Eu, 0x07AC0536u, 0xCCF0D693u, 0x4A64A43Du, 0x81387798u,
+        0x9C3D4720u, 0x57619485u, 0xD1F5E62Bu, 0x1AA9358Eu, 0xEBFF875Bu, 0x20A354FEu,
+        0xA6372650u, 0x6D6BF5F5u, 0x706EC54Du, 0xBB3216E8u, 0x3DA66446u, 0xF6FAB7E3u,
+        0x047A07ADu, 0xCF26D408u, 0x49B2A6A6u, 0x82EE7503u, 0x9FEB45BBu, 0x54B7961Eu,
+        0xD223E4B0u, 0x197F3715u, 0xE82985C0u, 0x23755665u, 0xA5E124CBu, 0x6EBDF76Eu,
+        0x73B8C7D6u, 0xB8E41473u, 0x3E7066DDu, 0xF52CB578u, 0x0F580A6Cu, 0xC404D9C9u,
+        0x4290AB67u, 0x89CC78C2u, 0x94C9487Au, 0x5F959BDFu, 0xD901E971u, 0x125D3AD4u,
+        0xE30B8801u, 0x28575BA4u, 0xAEC3290Au, 0x659FFAAFu, 0x789ACA17u, 0xB3C619B2u,
+        0x35526B1Cu, 0xFE0EB8B9u, 0x0C8E08F7u, 0xC7D2DB52u, 0x4146A9FCu, 0x8A1A7A59u,
+        0x971F4AE1u, 0x5C439944u, 0xDAD7EBEAu, 0x118B384Fu, 0xE0DD8A9Au, 0x2B81593Fu,
+        0xAD152B91u, 0x6649F834u, 0x7B4CC88Cu, 0xB0101B29u, 0x36846987u, 0xFDD8BA22u,
+        0x08F40F5Au, 0xC3A8DCFFu, 0x453CAE51u, 0x8E607DF4u, 0x93654D4Cu, 0x58399EE9u,
+        0xDEADEC47u, 0x15F13FE2u, 0xE4A78D37u, 0x2FFB5E92u, 0xA96F2C3Cu, 0x6233FF99u,
+        0x7F36CF21u, 0xB46A1C84u, 0x32FE6E2Au, 0xF9A2BD8Fu, 0x0B220DC1u, 0xC07EDE64u,
+        0x46EAACCAu, 0x8DB67F6Fu, 0x90B34FD7u, 0x5BEF9C72u, 0xDD7BEEDCu, 0x16273D79u,
+        0xE7718FACu, 0x2C2D5C09u, 0xAAB92EA7u, 0x61E5FD02u, 0x7CE0CDBAu, 0xB7BC1E1Fu,
+        0x31286CB1u, 0xFA74BF14u, 0x1EB014D8u, 0xD5ECC77Du, 0x5378B5D3u, 0x98246676u,
+        0x852156CEu, 0x4E7D856Bu, 0xC8E9F7C5u, 0x03B52460u, 0xF2E396B5u, 0x39BF4510u,
+        0xBF2B37BEu, 0x7477E41Bu, 0x6972D4A3u, 0xA22E0706u, 0x24BA75A8u, 0xEFE6A60Du,
+        0x1D661643u, 0xD63AC5E6u, 0x50AEB748u, 0x9BF264EDu, 0x86F75455u, 0x4DAB87F0u,
+        0xCB3FF55Eu, 0x006326FBu, 0xF135942Eu, 0x3A69478Bu, 0xBCFD3525u, 0x77A1E680u,
+        0x6AA4D638u, 0xA1F8059Du, 0x276C7733u, 0xEC30A496u, 0x191C11EEu, 0xD240C24Bu,
+        0x54D4B0E5u, 0x9F886340u, 0x828D53F8u, 0x49D1805Du, 0xCF45F2F3u, 0x04192156u,
+        0xF54F9383u, 0x3E134026u, 0xB8873288u, 0x73DBE12Du, 0x6EDED195u, 0xA5820230u,
+        0x2316709Eu, 0xE84AA33Bu, 0x1ACA1375u, 0xD196C0D0u, 0x5702B27Eu, 0x9C5E61DBu,
+        0x815B5163u, 0x4A0782C6u, 0xCC93F068u, 0x07CF23CDu, 0xF6999118u, 0x3DC542BDu,
+        0xBB513013u, 0x700DE3B6u, 0x6D08D30Eu, 0xA65400ABu, 0x20C07205u, 0xEB9CA1A0u,
+        0x11E81EB4u, 0xDAB4CD11u, 0x5C20BFBFu, 0x977C6C1Au, 0x8A795CA2u, 0x41258F07u,
+        0xC7B1FDA9u, 0x0CED2E0Cu, 0xFDBB9CD9u, 0x36E74F7Cu, 0xB0733DD2u, 0x7B2FEE77u,
+        0x662ADECFu, 0xAD760D6Au, 0x2BE27FC4u, 0xE0BEAC61u, 0x123E1C2Fu, 0xD962CF8Au,
+        0x5FF6BD24u, 0x94AA6E81u, 0x89AF5E39u, 0x42F38D9Cu, 0xC467FF32u, 0x0F3B2C97u,
+        0xFE6D9E42u, 0x35314DE7u, 0xB3A53F49u, 0x78F9ECECu, 0x65FCDC54u, 0xAEA00FF1u,
+        0x28347D5Fu, 0xE368AEFAu, 0x16441B82u, 0xDD18C827u, 0x5B8CBA89u, 0x90D0692Cu,
+        0x8DD55994u, 0x46898A31u, 0xC01DF89Fu, 0x0B412B3Au, 0xFA1799EFu, 0x314B4A4Au,
+        0xB7DF38E4u, 0x7C83EB41u, 0x6186DBF9u, 0xAADA085Cu, 0x2C4E7AF2u, 0xE712A957u,
+        0x15921919u, 0xDECECABCu, 0x585AB812u, 0x93066BB7u, 0x8E035B0Fu, 0x455F88AAu,
+        0xC3CBFA04u, 0x089729A1u, 0xF9C19B74u, 0x329D48D1u, 0xB4093A7Fu, 0x7F55E9DAu,
+        0x6250D962u, 0xA90C0AC7u, 0x2F987869u, 0xE4C4ABCCu
+    },
+    { /* Slice 6 */
+        0x00000000u, 0xA6770BB4u, 0x979F1129u, 0x31E81A9Du, 0xF44F2413u, 0x52382FA7u,
+        0x63D0353Au, 0xC5A73E8Eu, 0x33EF4E67u, 0x959845D3u, 0xA4705F4Eu, 0x020754FAu,
+        0xC7A06A74u, 0x61D761C0u, 0x503F7B5Du, 0xF64870E9u, 0x67DE9CCEu, 0xC1A9977Au,
+        0xF0418DE7u, 0x56368653u, 0x9391B8DDu, 0x35E6B369u, 0x040EA9F4u, 0xA279A240u,
+        0x5431D2A9u, 0xF246D91Du, 0xC3AEC380u, 0x65D9C834u, 0xA07EF6BAu, 0x0609FD0Eu,
+        0x37E1E793u, 0x9196EC27u, 0xCFBD399Cu, 0x69CA3228u, 0x582228B5u, 0xFE552301u,
+        0x3BF21D8Fu, 0x9D85163Bu, 0xAC6D0CA6u, 0x0A1A0712u, 0xFC5277FBu, 0x5A257C4Fu,
+        0x6BCD66D2u, 0xCDBA6D66u, 0x081D53E8u, 0xAE6A585Cu, 0x9F8242C1u, 0x39F54975u,
+        0xA863A552u, 0x0E14AEE6u, 0x3FFCB47Bu, 0x998BBFCFu, 0x5C2C8141u, 0xFA5B8AF5u,
+        0xCBB39068u, 0x6DC49BDCu, 0x9B8CEB35u, 0x3DFBE081u, 0x0C13FA1Cu, 0xAA64F1A8u,
+        0x6FC3CF26u, 0xC9B4C492u, 0xF85CDE0Fu, 0x5E2BD5BBu, 0x440B7579u, 0xE27C7ECDu,
+        0xD3946450u, 0x75E36FE4u, 0xB044516Au, 0x16335ADEu, 0x27DB4043u, 0x81AC4BF7u,
+        0x77E43B1Eu, 0xD19330AAu, 0xE07B2A37u, 0x460C2183u, 0x83AB1F0Du, 0x25DC14B9u,
+        0x14340E24u, 0xB2430590u, 0x23D5E9B7u, 0x85A2E203u, 0xB44AF89Eu, 0x123DF32Au,
+        0xD79ACDA4u, 0x71EDC610u, 0x4005DC8Du, 0xE672D739u, 0x103AA7D0u, 0xB64DAC64u,
+        0x87A5B6F9u, 0x21D2BD4Du, 0xE47583C3u, 0x42028877u, 0x73EA92EAu, 0xD59D995Eu,
+        0x8BB64CE5u, 0x2DC14751u, 0x1C295DCCu, 0xBA5E5678u, 0x7FF968F6u, 0xD98E6342u,
+        0xE86679DFu, 0x4E11726Bu, 0xB8590282u, 0x1E2E0936u, 0x2FC613ABu, 0x89B1181Fu,
+        0x4C162691u, 0xEA612D25u, 0xDB8937B8u, 0x7DFE3C0Cu, 0xEC68D02Bu, 0x4A1FDB9Fu,
+        0x7BF7C102u, 0xDD80CAB6u, 0x1827F438u, 0xBE50FF8Cu, 0x8FB8E511u, 0x29CFEEA5u,
+        0xDF879E4Cu, 0x79F095F8u, 0x48188F65u, 0xEE6F84D1u, 0x2BC8BA5Fu, 0x8DBFB1EBu,
+        0xBC57AB76u, 0x1A20A0C2u, 0x8816EAF2u, 0x2E61E146u, 0x1F89FBDBu, 0xB9FEF06Fu,
+        0x7C59CEE1u, 0xDA2EC555u, 0xEBC6DFC8u, 0x4DB1D47Cu, 0xBBF9A495u, 0x1D8EAF21u,
+        0x2C66B5BCu, 0x8A11BE08u, 0x4FB68086u, 0xE9C18B32u, 0xD82991AFu, 0x7E5E9A1Bu,
+        0xEFC8763Cu, 0x49BF7D88u, 0x78576715u, 0xDE206CA1u, 0x1B87522Fu, 0xBDF0599Bu,
+        0x8C184306u, 0x2A6F48B2u, 0xDC27385Bu, 0x7A5033EFu, 0x4BB82972u, 0xEDCF22C6u,
+        0x28681C48u, 0x8E1F17FCu, 0xBFF70D61u, 0x198006D5u, 0x47ABD36Eu, 0xE1DCD8DAu,
+        0xD034C247u, 0x7643C9F3u, 0xB3E4F77Du, 0x1593FCC9u, 0x247BE654u, 0x820CEDE0u,
+        0x74449D09u, 0xD23396BDu, 0xE3DB8C20u, 0x45AC8794u, 0x800BB91Au, 0x267CB2AEu,
+        0x1794A833u, 0xB1E3A387u, 0x20754FA0u, 0x86024414u, 0xB7EA5E89u, 0x119D553Du,
+        0xD43A6BB3u, 0x724D6007u, 0x43A57A9Au, 0xE5D2712Eu, 0x139A01C7u, 0xB5ED0A73u,
+        0x840510EEu, 0x22721B5Au, 0xE7D525D4u, 0x41A22E60u, 0x704A34FDu, 0xD63D3F49u,
+        0xCC1D9F8Bu, 0x6A6A943Fu, 0x5B828EA2u, 0xFDF58516u, 0x3852BB98u, 0x9E25B02Cu,
+        0xAFCDAAB1u, 0x09BAA105u, 0xFFF2D1ECu, 0x5985DA58u, 0x686DC0C5u, 0xCE1ACB71u,
+        0x0BBDF5FFu, 0xADCAFE4Bu, 0x9C22E4D6u, 0x3A55EF62u, 0xABC30345u, 0x0DB408F1u,
+        0x3C5C126Cu, 0x9A2B19D8u, 0x5F8C2756u, 0xF9FB2CE2u, 0xC813367Fu, 0x6E643DCBu,
+        0x982C4D22u, 0x3E5B4696u, 0x0FB35C0Bu, 0xA9C457BFu, 0x6C636931u, 0xCA146285u,
+        0xFBFC7818u, 0x5D8B73ACu, 0x03A0A617u, 0xA5D7ADA3u, 0x943FB73Eu, 0x3248BC8Au,
+        0xF7EF8204u, 0x519889B0u, 0x6070932Du, 0xC6079899u, 0x304FE870u, 0x9638E3C4u,
+        0xA7D0F959u, 0x01A7F2EDu, 0xC400CC63u, 0x6277C7D7u, 0x539FDD4Au, 0xF5E8D6FEu,
+        0x647E3AD9u, 0xC209316Du, 0xF3E12BF0u, 0x55962044u, 0x90311ECAu, 0x3646157Eu,
+        0x07AE0FE3u, 0xA1D90457u, 0x579174BEu, 0xF1E67F0Au, 0xC00E6597u, 0x66796E23u,
+        0xA3DE50ADu, 0x05A95B19u, 0x34414184u, 0x92364A30u
+    },
+    { /* Slice 7 */
+        0x00000000u, 0xCCAA009Eu, 0x4225077Du, 0x8E8F07E3u, 0x844A0EFAu, 0x48E00E64u,
+        0xC66F0987u, 0x0AC50919u, 0xD3E51BB5u, 0x1F4F1B2Bu, 0x91C01CC8u, 0x5D6A1C56u,
+        0x57AF154Fu, 0x9B0515D1u, 0x158A1232u, 0xD92012ACu, 0x7CBB312Bu, 0xB01131B5u,
+        0x3E9E3656u, 0xF23436C8u, 0xF8F13FD1u, 0x345B3F4Fu, 0xBAD438ACu, 0x767E3832u,
+        0xAF5E2A9Eu, 0x63F42A00u, 0xED7B2DE3u, 0x21D12D7Du, 0x2B142464u, 0xE7BE24FAu,
+        0x69312319u, 0xA59B2387u, 0xF9766256u, 0x35DC62C8u, 0xBB53652Bu, 0x77F965B5u,
+        0x7D3C6CACu, 0xB1966C32u, 0x3F196BD1u, 0xF3B36B4Fu, 0x2A9379E3u, 0xE639797Du,
+        0x68B67E9Eu, 0xA41C7E00u, 0xAED97719u, 0x62737787u, 0xECFC7064u, 0x205670FAu,
+        0x85CD537Du, 0x496753E3u, 0xC7E85400u, 0x0B42549Eu, 0x01875D87u, 0xCD2D5D19u,
+        0x43A25AFAu, 0x8F085A64u, 0x562848C8u, 0x9A824856u, 0x140D4FB5u, 0xD8A74F2Bu,
+        0xD2624632u, 0x1EC846ACu, 0x9047414Fu, 0x5CED41D1u, 0x299DC2EDu, 0xE537C273u,
+        0x6BB8C590u, 0xA712C50Eu, 0xADD7CC17u, 0x617DCC89u, 0xEFF2CB6Au, 0x2358CBF4u,
+        0xFA78D958u, 0x36D2D9C6u, 0xB85DDE25u, 0x74F7DEBBu, 0x7E32D7A2u, 0xB298D73Cu,
+        0x3C17D0DFu, 0xF0BDD041u, 0x5526F3C6u, 0x998CF358u, 0x1703F4BBu, 0xDBA9F425u,
+        0xD16CFD3Cu, 0x1DC6FDA2u, 0x9349FA41u, 0x5FE3FADFu, 0x86C3E873u, 0x4A69E8EDu,
+        0xC4E6EF0Eu, 0x084CEF90u, 0x0289E689u, 0xCE23E617u, 0x40ACE1F4u, 0x8C06E16Au,
+        0xD0EBA0BBu, 0x1C41A025u, 0x92CEA7C6u, 0x5E64A758u, 0x54A1AE41u, 0x980BAEDFu,
+        0x1684A93Cu, 0xDA2EA9A2u, 0x030EBB0Eu, 0xCFA4BB90u, 0x412BBC73u, 0x8D81BCEDu,
+        0x8744B5F4u, 0x4BEEB56Au, 0xC561B289u, 0x09CBB217u, 0xAC509190u, 0x60FA910Eu,
+        0xEE7596EDu, 0x22DF9673u, 0x281A9F6Au, 0xE4B09FF4u, 0x6A3F9817u, 0xA6959889u,
+        0x7FB58A25u, 0xB31F8ABBu, 0x3D908D58u, 0xF13A8DC6u, 0xFBFF84DFu, 0x37558441u,
+        0xB9DA83A2u, 0x7570833Cu, 0x533B85DAu, 0x9F918544u, 0x111E82A7u, 0xDDB48239u,
+        0xD7718B20u, 0x1BDB8BBEu, 0x95548C5Du, 0x59FE8CC3u, 0x80DE9E6Fu, 0x4C749EF1u,
+        0xC2FB9912u, 0x0E51998Cu, 0x04949095u, 0xC83E900Bu, 0x46B197E8u, 0x8A1B9776u,
+        0x2F80B4F1u, 0xE32AB46Fu, 0x6DA5B38Cu, 0xA10FB312u, 0xABCABA0Bu, 0x6760BA95u,
+        0xE9EFBD76u, 0x2545BDE8u, 0xFC65AF44u, 0x30CFAFDAu, 0xBE40A839u, 0x72EAA8A7u,
+        0x782FA1BEu, 0xB485A120u, 0x3A0AA6C3u, 0xF6A0A65Du, 0xAA4DE78Cu, 0x66E7E712u,
+        0xE868E0F1u, 0x24C2E06Fu, 0x2E07E976u, 0xE2ADE9E8u, 0x6C22EE0Bu, 0xA088EE95u,
+        0x79A8FC39u, 0xB502FCA7u, 0x3B8DFB44u, 0xF727FBDAu, 0xFDE2F2C3u, 0x3148F25Du,
+        0xBFC7F5BEu, 0x736DF520u, 0xD6F6D6A7u, 0x1A5CD639u, 0x94D3D1DAu, 0x5879D144u,
+        0x52BCD85Du, 0x9E16D8C3u, 0x1099DF20u, 0xDC33DFBEu, 0x0513CD12u, 0xC9B9CD8Cu,
+        0x4736CA6Fu, 0x8B9CCAF1u, 0x8159C3E8u, 0x4DF3C376u, 0xC37CC495u, 0x0FD6C40Bu,
+        0x7AA64737u, 0xB60C47A9u, 0x3883404Au, 0xF42940D4u, 0xFEEC49CDu, 0x32464953u,
+        0xBCC94EB0u, 0x70634E2Eu, 0xA9435C82u, 0x65E95C1Cu, 0xEB665BFFu, 0x27CC5B61u,
+        0x2D095278u, 0xE1A352E6u, 0x6F2C5505u, 0xA386559Bu, 0x061D761Cu, 0xCAB77682u,
+        0x44387161u, 0x889271FFu, 0x825778E6u, 0x4EFD7878u, 0xC0727F9Bu, 0x0CD87F05u,
+        0xD5F86DA9u, 0x19526D37u, 0x97DD6AD4u, 0x5B776A4Au, 0x51B26353u, 0x9D1863CDu,
+        0x1397642Eu, 0xDF3D64B0u, 0x83D02561u, 0x4F7A25FFu, 0xC1F5221Cu, 0x0D5F2282u,
+        0x079A2B9Bu, 0xCB302B05u, 0x45BF2CE6u, 0x89152C78u, 0x50353ED4u, 0x9C9F3E4Au,
+        0x121039A9u, 0xDEBA3937u, 0xD47F302Eu, 0x18D530B0u, 0x965A3753u, 0x5AF037CDu,
+        0xFF6B144Au, 0x33C114D4u, 0xBD4E1337u, 0x71E413A9u, 0x7B211AB0u, 0xB78B1A2Eu,
+        0x39041DCDu, 0xF5AE1D53u, 0x2C8E0FFFu, 0xE0240F61u, 0x6EAB0882u, 0xA201081Cu,
+        0xA8C40105u, 0x646E019Bu, 0xEAE10678u, 0x264B06E6u
+    }
+};
+
+/*
+ * Portable CRC32 kernel, 8 bytes per step (slice-by-8)
+ *
+ * Works on the raw register (pre- and post-inversion left to the caller).
+ * Bytes are combined explicitly, so it is endian-independent.
+ */
+static uint32_t glyph__crc32_slice8(uint32_t crc, const unsigned char* data, size_t len) {
+    while (len >= 8) {
+        uint32_t lo = crc ^ ((uint32_t)data[0] | (uint32_t)data[1] << 8 | (uint32_t)data[2] << 16 | (uint32_t)data[3] << 24);
+        crc = crc32_table[7][lo & 0xFF] ^ crc32_table[6][(lo >> 8) & 0xFF] ^
+              crc32_table[5][(lo >> 16) & 0xFF] ^ crc32_table[4][lo >> 24] ^
+              crc32_table[3][data[4]] ^ crc32_table[2][data[5]] ^
+              crc32_table[1][data[6]] ^ crc32_table[0][data[7]];
+        data += 8;
+        len -= 8;
+    }
+    while (len--) crc = (crc >> 8) ^ crc32_table[0][(uint8_t)(crc ^ *data++)];
+    return crc;
+}
+
+/* Largest Adler32 run before the sums must be reduced: 255n(n+1)/2 + (n+1)(65520) < 2^32 */
+#define GLYPH__ADLER32_NMAX 5552
+
+/*
+ * Portable Adler32 kernel
  *
- * Returns: 32-bit CRC32 checksum
+ * Accumulates up to GLYPH__ADLER32_NMAX bytes before reducing, so the two
+ * modulo operations happen once per block instead of once per byte.
  */
-static uint32_t crc32(const unsigned char* data, size_t len) {
-    crc32_init_table();           /* Ensure table is ready */
-    uint32_t crc = 0xFFFFFFFFu;   /* Standard initial value */
-    for (size_t i = 0; i < len; ++i) {
-        uint8_t idx = (uint8_t)(crc ^ data[i]);
-        crc = (crc >> 8) ^ crc32_table[idx];
+static uint32_t glyph__adler32_scalar(uint32_t adler, const unsigned char* data, size_t len) {
+    const uint32_t MOD_ADLER = 65521u; /* Adler32 modulus */
+    uint32_t a = adler & 0xFFFF;  /* Primary sum */
+    uint32_t b = adler >> 16;     /* Secondary sum */
+    while (len > 0) {
+        size_t n = len < GLYPH__ADLER32_NMAX ? len : GLYPH__ADLER32_NMAX;
+        len -= n;
+        for (; n >= 8; n -= 8, data += 8) {
+            a += data[0]; b += a;
+            a += data[1]; b += a;
+            a += data[2]; b += a;
+            a += data[3]; b += a;
+            a += data[4]; b += a;
+            a += data[5]; b += a;
+            a += data[6]; b += a;
+            a += data[7]; b += a;
+        }
+        for (; n > 0; n--) {
+            a += *data++;
+            b += a;
+        }
+        a %= MOD_ADLER;
+        b %= MOD_ADLER;
     }
-    return crc ^ 0xFFFFFFFFu;     /* Final XOR with all 1s */
+    return (b << 16) | a; /* Combine sums into 32-bit value */
+}
+
+#ifdef GLYPH_IMAGE__X86
+#define GLYPH__CPU_PCLMUL 1 /* PCLMULQDQ and SSE4.1 */
+#define GLYPH__CPU_SSSE3 2
+
+static glyph_once_t glyph__cpu_once = GLYPH_ONCE_INIT;
+static int glyph__cpu_features = 0;
+
+/* Returns the GLYPH__CPU_* bits supported by this CPU, queried once */
+static int glyph__image_cpu_features(void) {
+    if (glyph__once_begin(&glyph__cpu_once)) {
+        int features = 0;
+        unsigned int ecx;
+#ifdef _MSC_VER
+        int regs[4];
+        __cpuid(regs, 1);
+        ecx = (unsigned int)regs[2];
+#else
+        unsigned int eax, ebx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) ecx = 0;
+#endif
+        if ((ecx & (1u << 1)) && (ecx & (1u << 19))) features |= GLYPH__CPU_PCLMUL;
+        if (ecx & (1u << 9)) features |= GLYPH__CPU_SSSE3;
+        glyph__cpu_features = features;
+        glyph__once_end(&glyph__cpu_once, 1);
+    }
+    return glyph__cpu_features;
 }
 
 /*
- * Computes Adler32 checksum - a fast alternative to CRC32
+ * CRC32 by carry-less multiplication (PCLMULQDQ)
  *
- * Adler32 is a simple, fast checksum algorithm that maintains two 16-bit
- * sums. It's not as robust as CRC32 for error detection but is faster
- * and used in zlib compression for the DEFLATE compressed data checksum.
+ * Folds four 128-bit lanes over 64-byte blocks, then reduces to 32 bits
+ * with a Barrett reduction ("Fast CRC Computation for Generic Polynomials
+ * Using PCLMULQDQ Instruction", Intel 2009). Works on the raw register like
+ * glyph__crc32_slice8; 'len' must be at least 64 and a multiple of 16.
+ */
+GLYPH_IMAGE__TARGET("pclmul,sse4.1")
+static uint32_t glyph__crc32_pclmul(uint32_t crc, const unsigned char* data, size_t len) {
+    /* Bit-reflected folding constants x^(4*128+32) mod P, x^(4*128-32) mod P, ... and the Barrett pair */
+    const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596LL, 0x0154442bd4LL);
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009eLL, 0x01751997d0LL);
+    const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124LL);
+    const __m128i poly = _mm_set_epi64x(0x01f7011641LL, 0x01db710641LL);
+    const __m128i mask32 = _mm_setr_epi32(-1, 0, -1, 0);
+
+    __m128i x1 = _mm_loadu_si128((const __m128i*)(data + 0x00));
+    __m128i x2 = _mm_loadu_si128((const __m128i*)(data + 0x10));
+    __m128i x3 = _mm_loadu_si128((const __m128i*)(data + 0x20));
+    __m128i x4 = _mm_loadu_si128((const __m128i*)(data + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+    data += 64;
+    len -= 64;
+
+    /* Fold four lanes at once */
+    while (len >= 64) {
+        __m128i x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+        __m128i x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+        __m128i x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+        __m128i x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i*)(data + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i*)(data + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i*)(data + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i*)(data + 0x30)));
+        data += 64;
+        len -= 64;
+    }
+
+    /* Fold the four lanes into one */
+    __m128i x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x4), x5);
+
+    /* Remaining 16-byte blocks */
+    while (len >= 16) {
+        x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+        x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), _mm_loadu_si128((const __m128i*)data)), x5);
+        data += 16;
+        len -= 16;
+    }
+
+    /* 128 -> 64 bits */
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask32);
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(x1, k5k0, 0x00), x2);
+
+    /* Barrett reduction to 32 bits */
+    x2 = _mm_and_si128(x1, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    return (uint32_t)_mm_extract_epi32(x1, 1);
+}
+
+/*
+ * Adler32 with SSSE3, 32 bytes per step
+ *
+ * Byte sums come from PSADBW and the position-weighted sums from PMADDUBSW;
+ * both sums are reduced once per GLYPH__ADLER32_NMAX bytes, as in the
+ * scalar kernel.
+ */
+GLYPH_IMAGE__TARGET("ssse3")
+static uint32_t glyph__adler32_ssse3(uint32_t adler, const unsigned char* data, size_t len) {
+    const uint32_t MOD_ADLER = 65521u;
+    uint32_t a = adler & 0xFFFF;
+    uint32_t b = adler >> 16;
+    size_t blocks = len / 32;
+    len -= blocks * 32;
+    const __m128i tap1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+    const __m128i tap2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi16(1);
+    while (blocks > 0) {
+        size_t n = blocks < GLYPH__ADLER32_NMAX / 32 ? blocks : GLYPH__ADLER32_NMAX / 32;
+        blocks -= n;
+        /* v_ps accumulates 'a' before each block; every byte of a block adds it 32 times to 'b' */
+        __m128i v_ps = _mm_cvtsi32_si128((int)(a * n));
+        __m128i v_b = _mm_cvtsi32_si128((int)b);
+        __m128i v_a = zero;
+        do {
+            __m128i bytes1 = _mm_loadu_si128((const __m128i*)data);
+            __m128i bytes2 = _mm_loadu_si128((const __m128i*)(data + 16));
+            v_ps = _mm_add_epi32(v_ps, v_a);
+            v_a = _mm_add_epi32(v_a, _mm_sad_epu8(bytes1, zero));
+            v_b = _mm_add_epi32(v_b, _mm_madd_epi16(_mm_maddubs_epi16(bytes1, tap1), ones));
+            v_a = _mm_add_epi32(v_a, _mm_sad_epu8(bytes2, zero));
+            v_b = _mm_add_epi32(v_b, _mm_madd_epi16(_mm_maddubs_epi16(bytes2, tap2), ones));
+            data += 32;
+        } while (--n);
+        v_b = _mm_add_epi32(v_b, _mm_slli_epi32(v_ps, 5));
+        /* Horizontal sums */
+        v_a = _mm_add_epi32(v_a, _mm_shuffle_epi32(v_a, _MM_SHUFFLE(2, 3, 0, 1)));
+        v_a = _mm_add_epi32(v_a, _mm_shuffle_epi32(v_a, _MM_SHUFFLE(1, 0, 3, 2)));
+        v_b = _mm_add_epi32(v_b, _mm_shuffle_epi32(v_b, _MM_SHUFFLE(2, 3, 0, 1)));
+        v_b = _mm_add_epi32(v_b, _mm_shuffle_epi32(v_b, _MM_SHUFFLE(1, 0, 3, 2)));
+        a = (a + (uint32_t)_mm_cvtsi128_si32(v_a)) % MOD_ADLER;
+        b = (uint32_t)_mm_cvtsi128_si32(v_b) % MOD_ADLER;
+    }
+    return glyph__adler32_scalar((b << 16) | a, data, len);
+}
+#endif /* GLYPH_IMAGE__X86 */
+
+#ifdef GLYPH_IMAGE__ARM_CRC32
+/* CRC32 with the ARMv8 CRC32 instructions, on the raw register like glyph__crc32_slice8 */
+static uint32_t glyph__crc32_armv8(uint32_t crc, const unsigned char* data, size_t len) {
+    while (len >= 8) {
+        uint64_t v;
+        memcpy(&v, data, 8);
+        crc = __crc32d(crc, v);
+        data += 8;
+        len -= 8;
+    }
+    while (len--) crc = __crc32b(crc, *data++);
+    return crc;
+}
+#endif
+
+/*
+ * Continues a CRC32 over more data
+ *
+ * Uses the fastest kernel this CPU supports: PCLMULQDQ folding or the ARMv8
+ * CRC32 instructions for the bulk, slice-by-8 otherwise and for the tail.
  *
  * Parameters:
- *   data: Input data buffer
+ *   crc: CRC32 of the preceding data (0 for none)
+ *   data: Next data buffer
  *   len: Length of data in bytes
  *
- * Returns: 32-bit Adler32 checksum (b << 16 | a)
+ * Returns: CRC32 of the preceding data followed by 'data'
  */
-static uint32_t adler32(const unsigned char* data, size_t len) {
-    const uint32_t MOD_ADLER = 65521u; /* Adler32 modulus */
-    uint32_t a = 1;  /* Primary sum */
-    uint32_t b = 0;  /* Secondary sum */
-    for (size_t i = 0; i < len; ++i) {
-        a = (a + data[i]) % MOD_ADLER;
-        b = (b + a) % MOD_ADLER;
+static uint32_t glyph__crc32_update(uint32_t crc, const unsigned char* data, size_t len) {
+    crc ^= 0xFFFFFFFFu;   /* Undo the final XOR of the previous result */
+#if defined(GLYPH_IMAGE__X86)
+    if (len >= 64 && (glyph__image_cpu_features() & GLYPH__CPU_PCLMUL)) {
+        size_t bulk = len & ~(size_t)15;
+        crc = glyph__crc32_pclmul(crc, data, bulk);
+        data += bulk;
+        len -= bulk;
     }
-    return (b << 16) | a; /* Combine sums into 32-bit value */
+#elif defined(GLYPH_IMAGE__ARM_CRC32)
+    return glyph__crc32_armv8(crc, data, len) ^ 0xFFFFFFFFu;
+#endif
+    return glyph__crc32_slice8(crc, data, len) ^ 0xFFFFFFFFu;
 }
 
 /*
- * Writes a 32-bit unsigned integer to file in big-endian byte order
+ * Continues an Adler32 over more data
  *
- * Big-endian (network byte order) stores the most significant byte first.
- * This is required for PNG format compatibility and ensures cross-platform
- * data consistency regardless of the host system's endianness.
+ * Uses the SSSE3 kernel when this CPU has it, the portable one otherwise.
  *
  * Parameters:
- *   f: Open file handle to write to
- *   v: 32-bit value to write
+ *   adler: Adler32 of the preceding data (1 for none)
+ *   data: Next data buffer
+ *   len: Length of data in bytes
+ *
+ * Returns: Adler32 of the preceding data followed by 'data'
  */
-static void write_u32_be(FILE* f, uint32_t v) {
-    unsigned char b[4];
-    b[0] = (v >> 24) & 0xFF; /* Most significant byte */
-    b[1] = (v >> 16) & 0xFF;
-    b[2] = (v >> 8) & 0xFF;
-    b[3] = v & 0xFF;         /* Least significant byte */
-    fwrite(b, 1, 4, f);
+static uint32_t glyph__adler32_update(uint32_t adler, const unsigned char* data, size_t len) {
+#ifdef GLYPH_IMAGE__X86
+    if (len >= 64 && (glyph__image_cpu_features() & GLYPH__CPU_SSSE3)) return glyph__adler32_ssse3(adler, data, len);
+#endif
+    return glyph__adler32_scalar(adler, data, len);
+}
+
+/*
+ * Combines the Adler32 values of two adjacent pieces of data
+ *
+ * Lets pieces be checksummed independently (on different threads) and
+ * joined afterwards, as zlib's adler32_combine does.
+ *
+ * Parameters:
+ *   adler1: Adler32 of the first piece
+ *   adler2: Adler32 of the second piece
+ *   len2: Length of the second piece in bytes
+ *
+ * Returns: Adler32 of the first piece followed by the second
+ */
+static uint32_t glyph__adler32_combine(uint32_t adler1, uint32_t adler2, size_t len2) {
+    const uint32_t MOD_ADLER = 65521u;
+    uint32_t rem = (uint32_t)(len2 % MOD_ADLER);
+    uint32_t sum1 = adler1 & 0xFFFF;
+    uint32_t sum2 = (rem * sum1) % MOD_ADLER;
+    sum1 += (adler2 & 0xFFFF) + MOD_ADLER - 1;
+    sum2 += (adler1 >> 16) + (adler2 >> 16) + MOD_ADLER - rem;
+    if (sum1 >= MOD_ADLER) sum1 -= MOD_ADLER;
+    if (sum1 >= MOD_ADLER) sum1 -= MOD_ADLER;
+    if (sum2 >= (MOD_ADLER << 1)) sum2 -= (MOD_ADLER << 1);
+    if (sum2 >= MOD_ADLER) sum2 -= MOD_ADLER;
+    return (sum2 << 16) | sum1;
 }
 
 /*
@@ -228,25 +958,23 @@ static void write_u32_le(unsigned char* buf, uint32_t v) {
     buf[3] = (v >> 24) & 0xFF; /* Most significant byte */
 }
 /*
- * Exports a glyph image to BMP (Bitmap) file format
+ * Streams a glyph image to a sink as a BMP (Bitmap)
  *
  * BMP is a simple, uncompressed image format supported by most image viewers.
  * This implementation creates a 24-bit RGB BMP with proper headers and row padding.
- * Pixels are written bottom-to-top (BMP convention) with BGR color order.
+ * Pixels are written bottom-to-top (BMP convention) with BGR color order, one
+ * padded row at a time through a single row buffer.
  *
  * Parameters:
- *   filename: Output BMP file path
+ *   write: Sink receiving the file's bytes in order
+ *   user: Passed to 'write'
  *   img: Pointer to glyph_image_t to export
  *
  * Returns: 0 on success, -1 on failure
  */
-static int glyph_write_bmp(const char* filename, glyph_image_t* img) {
+static int glyph_write_bmp_to(glyph_write_func_t write, void* user, const glyph_image_t* img) {
     /* Validate input parameters */
-    if (!img || !img->data) return -1;
-
-    /* Open file for binary writing */
-    FILE* f = fopen(filename, "wb");
-    if (!f) return -1;
+    if (!write || !img || !img->data) return -1;
 
     /* Calculate BMP parameters */
     int width = (int)img->width;
@@ -255,8 +983,8 @@ static int glyph_write_bmp(const char* filename, glyph_image_t* img) {
     int data_size = row_size * height;
     int file_size = 54 + data_size; /* 54 bytes for headers */
 
-    /* Write BMP file header (14 bytes) */
-    unsigned char fileheader[14] = {
+    /* BMP file header (14 bytes) */
+    unsigned char header[54] = {
         'B','M',  /* BMP signature */
         (unsigned char)(file_size & 0xFF),
         (unsigned char)((file_size >> 8) & 0xFF),
@@ -265,200 +993,1218 @@ static int glyph_write_bmp(const char* filename, glyph_image_t* img) {
         0,0,0,0,  /* Reserved */
         54,0,0,0 /* Data offset */
     };
-    fwrite(fileheader, 1, 14, f);
 
-    /* Write BMP info header (40 bytes) */
-    unsigned char infoheader[40] = {0};
+    /* BMP info header (40 bytes) */
+    unsigned char* infoheader = header + 14;
     infoheader[0] = 40;  /* Header size */
     /* Image dimensions */
-    infoheader[4] = (unsigned char)(width & 0xFF);
-    infoheader[5] = (unsigned char)((width >> 8) & 0xFF);
-    infoheader[6] = (unsigned char)((width >> 16) & 0xFF);
-    infoheader[7] = (unsigned char)((width >> 24) & 0xFF);
-    infoheader[8] = (unsigned char)(height & 0xFF);
-    infoheader[9] = (unsigned char)((height >> 8) & 0xFF);
-    infoheader[10] = (unsigned char)((height >> 16) & 0xFF);
-    infoheader[11] = (unsigned char)((height >> 24) & 0xFF);
+    write_u32_le(infoheader + 4, (uint32_t)width);
+    write_u32_le(infoheader + 8, (uint32_t)height);
     infoheader[12] = 1;    /* Planes */
     infoheader[14] = 24;   /* Bits per pixel */
     /* Image size */
-    infoheader[20] = (unsigned char)(data_size & 0xFF);
-    infoheader[21] = (unsigned char)((data_size >> 8) & 0xFF);
-    infoheader[22] = (unsigned char)((data_size >> 16) & 0xFF);
-    infoheader[23] = (unsigned char)((data_size >> 24) & 0xFF);
-    fwrite(infoheader, 1, 40, f);
+    write_u32_le(infoheader + 20, (uint32_t)data_size);
+    if (write(user, header, 54) != 0) return -1;
 
     /* Write pixel data bottom-to-top (BMP convention) with BGR color order */
-    for (int y = height - 1; y >= 0; y--) {
+    unsigned char* row = (unsigned char*)GLYPH_MALLOC(row_size > 0 ? (size_t)row_size : 1);
+    if (!row) return -1;
+    memset(row, 0, (size_t)row_size); /* Row padding stays zero */
+    int result = 0;
+    for (int y = height - 1; y >= 0 && result == 0; y--) {
+        const unsigned char* src = &img->data[(size_t)y * width * 3];
         for (int x = 0; x < width; x++) {
-            /* Extract RGB components from image data */
-            unsigned char r = img->data[(y * width + x) * 3 + 0];
-            unsigned char g = img->data[(y * width + x) * 3 + 1];
-            unsigned char b = img->data[(y * width + x) * 3 + 2];
-            /* Write in BGR order (BMP format) */
-            fputc(b, f);
-            fputc(g, f);
-            fputc(r, f);
+            row[x * 3 + 0] = src[x * 3 + 2];
+            row[x * 3 + 1] = src[x * 3 + 1];
+            row[x * 3 + 2] = src[x * 3 + 0];
         }
-        /* Add row padding to align to 4-byte boundaries */
-        int padding = (4 - (width * 3 % 4)) % 4;
-        for (int p = 0; p < padding; p++) fputc(0, f);
+        result = write(user, row, (size_t)row_size) == 0 ? 0 : -1;
     }
-    fclose(f);
-    return 0;
+    GLYPH_FREE(row);
+    return result;
 }
+
 /*
- * Exports a glyph image to PNG (Portable Network Graphics) file format
- *
- * PNG is a compressed, lossless image format widely supported on the web and
- * in applications. This implementation creates a valid PNG with IHDR, IDAT,
- * and IEND chunks, using DEFLATE compression for the image data.
+ * Exports a glyph image to BMP (Bitmap) file format
  *
  * Parameters:
- *   filename: Output PNG file path
+ *   filename: Output BMP file path
  *   img: Pointer to glyph_image_t to export
  *
  * Returns: 0 on success, -1 on failure
  */
-static int glyph_write_png(const char* filename, glyph_image_t* img) {
+static int glyph_write_bmp(const char* filename, glyph_image_t* img) {
     /* Validate input parameters */
     if (!img || !img->data) return -1;
 
     /* Open file for binary writing */
     FILE* f = fopen(filename, "wb");
     if (!f) return -1;
+    int result = glyph_write_bmp_to(glyph_write_stdio, f, img);
+    if (fclose(f) != 0) result = -1;
+    return result;
+}
+/*
+ * ================== DEFLATE COMPRESSION (RFC 1951) ==================
+ *
+ * LZ77 over a 32 KB window with hash chains and one-step lazy matching,
+ * followed by Huffman coding. Symbols are collected in blocks of
+ * GLYPH__DEFLATE_BLOCK_SYMBOLS; each block is written with whichever of
+ * dynamic Huffman, fixed Huffman or stored encoding is smallest, so the
+ * output never grows much beyond the input.
+ */
+
+#ifndef GLYPHGL_DEFLATE_MAX_CHAIN
+#define GLYPHGL_DEFLATE_MAX_CHAIN 64  /* Hash chain links followed per match search (higher = smaller, slower) */
+#endif
+
+#define GLYPH__DEFLATE_WINDOW 32768        /* LZ77 window size (maximum distance) */
+#define GLYPH__DEFLATE_HASH_BITS 15        /* Hash table size: 2^15 chains */
+#define GLYPH__DEFLATE_MIN_MATCH 3
+#define GLYPH__DEFLATE_MAX_MATCH 258
+#define GLYPH__DEFLATE_NICE_MATCH 128      /* Matches this long are taken without a lazy look-ahead */
+#define GLYPH__DEFLATE_BLOCK_SYMBOLS 16384 /* Literals/matches per block before codes are rebuilt */
+
+/* Base values and extra bits of the length (257..285) and distance (0..29) codes */
+static const uint16_t glyph__deflate_len_base[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t glyph__deflate_len_extra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t glyph__deflate_dist_base[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769,
+    1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t glyph__deflate_dist_extra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+/* Transmission order of the code length code lengths */
+static const uint8_t glyph__deflate_cl_order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+/* Growable output buffer with an LSB-first bit writer */
+typedef struct {
+    unsigned char* data;        /* Output bytes (GLYPH_MALLOC'd) */
+    size_t size;                /* Bytes written */
+    size_t capacity;            /* Bytes allocated */
+    uint64_t bits;              /* Pending bits, LSB first */
+    int bit_count;              /* Number of pending bits */
+    int failed;                 /* Set when growing the buffer failed */
+} glyph__deflate_out_t;
+
+/* Makes room for 'n' more bytes. Returns: 1 on success, 0 on failure */
+static int glyph__deflate_reserve(glyph__deflate_out_t* out, size_t n) {
+    if (out->failed) return 0;
+    if (out->size + n <= out->capacity) return 1;
+    size_t capacity = out->capacity ? out->capacity : 4096;
+    while (capacity < out->size + n) capacity *= 2;
+    unsigned char* data = (unsigned char*)GLYPH_REALLOC(out->data, capacity);
+    if (!data) {
+        out->failed = 1;
+        return 0;
+    }
+    out->data = data;
+    out->capacity = capacity;
+    return 1;
+}
+
+static void glyph__deflate_put_bits(glyph__deflate_out_t* out, uint32_t bits, int count) {
+    out->bits |= (uint64_t)bits << out->bit_count;
+    out->bit_count += count;
+    if (out->bit_count >= 32) {
+        if (glyph__deflate_reserve(out, 4)) {
+            out->data[out->size++] = (unsigned char)out->bits;
+            out->data[out->size++] = (unsigned char)(out->bits >> 8);
+            out->data[out->size++] = (unsigned char)(out->bits >> 16);
+            out->data[out->size++] = (unsigned char)(out->bits >> 24);
+        }
+        out->bits >>= 32;
+        out->bit_count -= 32;
+    }
+}
+
+/* Pads the pending bits with zeros to a byte boundary and writes them out */
+static void glyph__deflate_align(glyph__deflate_out_t* out) {
+    while (out->bit_count > 0) {
+        if (glyph__deflate_reserve(out, 1)) out->data[out->size++] = (unsigned char)out->bits;
+        out->bits >>= 8;
+        out->bit_count = out->bit_count > 8 ? out->bit_count - 8 : 0;
+    }
+    out->bits = 0;
+}
+
+/* Appends whole bytes; the writer must be byte aligned */
+static void glyph__deflate_put_bytes(glyph__deflate_out_t* out, const unsigned char* data, size_t len) {
+    if (!glyph__deflate_reserve(out, len)) return;
+    memcpy(out->data + out->size, data, len);
+    out->size += len;
+}
+
+/* Symbol frequency used while building a Huffman code */
+typedef struct {
+    uint32_t freq;
+    uint16_t symbol;
+} glyph__huff_leaf_t;
+
+static int glyph__huff_leaf_compare(const void* a, const void* b) {
+    const glyph__huff_leaf_t* x = (const glyph__huff_leaf_t*)a;
+    const glyph__huff_leaf_t* y = (const glyph__huff_leaf_t*)b;
+    if (x->freq != y->freq) return x->freq < y->freq ? -1 : 1;
+    return (int)x->symbol - (int)y->symbol;
+}
+
+/*
+ * Computes length-limited Huffman code lengths
+ *
+ * Builds an optimal tree with the two-queue method over the sorted leaves,
+ * then, if it is deeper than 'max_bits', moves codes up to the limit and
+ * rebalances the Kraft sum by lengthening the deepest short codes (as zlib
+ * and miniz do). Unused symbols get length 0; a lone used symbol is paired
+ * with a dummy one so that every code is complete.
+ *
+ * Parameters:
+ *   freq: Frequency of each symbol
+ *   n: Number of symbols (at most 288)
+ *   max_bits: Maximum code length (15 for literals/distances, 7 for code lengths)
+ *   lengths: Output code length of each symbol
+ */
+static void glyph__huff_build_lengths(const uint32_t* freq, int n, int max_bits, uint8_t* lengths) {
+    glyph__huff_leaf_t leaves[288];
+    uint32_t weight[2 * 288];
+    int parent[2 * 288];
+    int used = 0;
+
+    memset(lengths, 0, (size_t)n);
+    for (int i = 0; i < n; i++) {
+        if (freq[i]) {
+            leaves[used].freq = freq[i];
+            leaves[used].symbol = (uint16_t)i;
+            used++;
+        }
+    }
+    if (used == 0) return;
+    if (used == 1) {
+        lengths[leaves[0].symbol] = 1;
+        lengths[leaves[0].symbol == 0 ? 1 : 0] = 1;
+        return;
+    }
+    qsort(leaves, (size_t)used, sizeof(leaves[0]), glyph__huff_leaf_compare);
+
+    /* Two-queue construction: leaves 0..used-1, internal nodes used.. in creation order */
+    for (int i = 0; i < used; i++) weight[i] = leaves[i].freq;
+    int next_leaf = 0, next_node = used, nodes = used;
+    for (int k = 0; k < used - 1; k++) {
+        int pick[2];
+        for (int j = 0; j < 2; j++) {
+            if (next_leaf < used && (next_node >= nodes || weight[next_leaf] <= weight[next_node])) {
+                pick[j] = next_leaf++;
+            } else {
+                pick[j] = next_node++;
+            }
+        }
+        weight[nodes] = weight[pick[0]] + weight[pick[1]];
+        parent[pick[0]] = nodes;
+        parent[pick[1]] = nodes;
+        nodes++;
+    }
+
+    /* Depths: the root is the last node; parents always come after children */
+    int depth[2 * 288];
+    int count[33];
+    memset(count, 0, sizeof(count));
+    depth[nodes - 1] = 0;
+    for (int i = nodes - 2; i >= 0; i--) {
+        depth[i] = depth[parent[i]] + 1;
+        if (i < used) count[depth[i] > 32 ? 32 : depth[i]]++;
+    }
+
+    /* Clamp to max_bits and restore sum(2^-len) == 1 */
+    for (int i = max_bits + 1; i <= 32; i++) {
+        count[max_bits] += count[i];
+        count[i] = 0;
+    }
+    uint32_t total = 0;
+    for (int i = max_bits; i > 0; i--) total += (uint32_t)count[i] << (max_bits - i);
+    while (total != (1u << max_bits)) {
+        count[max_bits]--;
+        for (int i = max_bits - 1; i > 0; i--) {
+            if (count[i]) {
+                count[i]--;
+                count[i + 1] += 2;
+                break;
+            }
+        }
+        total--;
+    }
+
+    /* The most frequent symbols (end of the sorted array) get the shortest codes */
+    int j = used;
+    for (int len = 1; len <= max_bits; len++) {
+        for (int c = count[len]; c > 0; c--) lengths[leaves[--j].symbol] = (uint8_t)len;
+    }
+}
+
+/* Assigns canonical codes (bit-reversed for the LSB-first stream) from code lengths */
+static void glyph__huff_build_codes(const uint8_t* lengths, int n, uint16_t* codes) {
+    int count[16] = {0};
+    uint32_t next[16];
+    for (int i = 0; i < n; i++) count[lengths[i]]++;
+    count[0] = 0;
+    uint32_t code = 0;
+    for (int len = 1; len < 16; len++) {
+        code = (code + (uint32_t)count[len - 1]) << 1;
+        next[len] = code;
+    }
+    for (int i = 0; i < n; i++) {
+        int len = lengths[i];
+        if (!len) continue;
+        uint32_t c = next[len]++, reversed = 0;
+        for (int b = 0; b < len; b++) {
+            reversed = (reversed << 1) | (c & 1);
+            c >>= 1;
+        }
+        codes[i] = (uint16_t)reversed;
+    }
+}
+
+/* Compressor state for one deflate_raw call */
+typedef struct {
+    uint32_t head[1 << GLYPH__DEFLATE_HASH_BITS];   /* Most recent position + 1 per hash (0 = none) */
+    uint32_t prev[GLYPH__DEFLATE_WINDOW];           /* Previous position + 1 with the same hash */
+    uint16_t sym_len[GLYPH__DEFLATE_BLOCK_SYMBOLS]; /* Literal byte, or match length when sym_dist != 0 */
+    uint16_t sym_dist[GLYPH__DEFLATE_BLOCK_SYMBOLS];/* Match distance, 0 for literals */
+    size_t symbols;                                 /* Symbols in the current block */
+    uint32_t litlen_freq[286];
+    uint32_t dist_freq[30];
+    uint8_t len_code[GLYPH__DEFLATE_MAX_MATCH + 1]; /* Length -> length code index (0..28) */
+    uint8_t dist_code[512];                         /* Distance -> distance code (see glyph__deflate_dist_index) */
+} glyph__deflate_t;
+
+static int glyph__deflate_dist_index(const glyph__deflate_t* d, unsigned dist) {
+    return dist <= 256 ? d->dist_code[dist - 1] : d->dist_code[256 + ((dist - 1) >> 7)];
+}
+
+static void glyph__deflate_init_tables(glyph__deflate_t* d) {
+    for (int code = 0; code < 29; code++) {
+        int end = code + 1 < 29 ? glyph__deflate_len_base[code + 1] : GLYPH__DEFLATE_MAX_MATCH + 1;
+        for (int len = glyph__deflate_len_base[code]; len < end; len++) d->len_code[len] = (uint8_t)code;
+    }
+    for (int code = 0; code < 30; code++) {
+        unsigned first = glyph__deflate_dist_base[code];
+        unsigned last = first + (1u << glyph__deflate_dist_extra[code]) - 1;
+        for (unsigned dist = first; dist <= last; dist++) {
+            if (dist <= 256) d->dist_code[dist - 1] = (uint8_t)code;
+            else d->dist_code[256 + ((dist - 1) >> 7)] = (uint8_t)code;
+        }
+    }
+}
+
+/* Bits needed by the current block's symbols with the given code lengths */
+static uint64_t glyph__deflate_symbol_bits(const glyph__deflate_t* d, const uint8_t* litlen_len, const uint8_t* dist_len) {
+    uint64_t bits = 0;
+    for (int i = 0; i < 286; i++) {
+        uint32_t extra = i >= 257 ? glyph__deflate_len_extra[i - 257] : 0;
+        bits += (uint64_t)d->litlen_freq[i] * (litlen_len[i] + extra);
+    }
+    for (int i = 0; i < 30; i++) bits += (uint64_t)d->dist_freq[i] * (dist_len[i] + glyph__deflate_dist_extra[i]);
+    return bits;
+}
+
+static void glyph__deflate_write_symbols(const glyph__deflate_t* d, glyph__deflate_out_t* out,
+                                         const uint8_t* litlen_len, const uint16_t* litlen_code,
+                                         const uint8_t* dist_len, const uint16_t* dist_code) {
+    for (size_t i = 0; i < d->symbols; i++) {
+        unsigned len = d->sym_len[i], dist = d->sym_dist[i];
+        if (!dist) {
+            glyph__deflate_put_bits(out, litlen_code[len], litlen_len[len]);
+            continue;
+        }
+        int lc = d->len_code[len];
+        glyph__deflate_put_bits(out, litlen_code[257 + lc], litlen_len[257 + lc]);
+        glyph__deflate_put_bits(out, len - glyph__deflate_len_base[lc], glyph__deflate_len_extra[lc]);
+        int dc = glyph__deflate_dist_index(d, dist);
+        glyph__deflate_put_bits(out, dist_code[dc], dist_len[dc]);
+        glyph__deflate_put_bits(out, dist - glyph__deflate_dist_base[dc], glyph__deflate_dist_extra[dc]);
+    }
+    glyph__deflate_put_bits(out, litlen_code[256], litlen_len[256]);
+}
+
+/*
+ * Writes the collected symbols as one block, choosing the smallest encoding
+ *
+ * Parameters:
+ *   raw, raw_len: The input bytes the symbols encode (for a stored block)
+ *   final: Set BFINAL on this block
+ */
+static void glyph__deflate_flush_block(glyph__deflate_t* d, glyph__deflate_out_t* out,
+                                       const unsigned char* raw, size_t raw_len, int final) {
+    uint8_t litlen_len[286], dist_len[30];
+    uint16_t litlen_code[286], dist_code[30];
+
+    d->litlen_freq[256] = 1; /* End of block */
+    glyph__huff_build_lengths(d->litlen_freq, 286, 15, litlen_len);
+    glyph__huff_build_lengths(d->dist_freq, 30, 15, dist_len);
+    int dist_used = 0;
+    for (int i = 0; i < 30; i++) dist_used |= dist_len[i];
+    if (!dist_used) {
+        /* No matches: still transmit a (complete) distance code */
+        dist_len[0] = 1;
+        dist_len[1] = 1;
+    }
+
+    /* Run-length encode the code lengths with codes 16 (repeat), 17 and 18 (zeros) */
+    int hlit = 286, hdist = 30;
+    while (hlit > 257 && !litlen_len[hlit - 1]) hlit--;
+    while (hdist > 1 && !dist_len[hdist - 1]) hdist--;
+    uint8_t all[286 + 30];
+    memcpy(all, litlen_len, (size_t)hlit);
+    memcpy(all + hlit, dist_len, (size_t)hdist);
+    int total = hlit + hdist;
+    uint8_t rle[286 + 30];
+    uint8_t rle_extra[286 + 30];
+    int rle_count = 0;
+    uint32_t cl_freq[19] = {0};
+    for (int i = 0; i < total;) {
+        int run = 1;
+        while (i + run < total && all[i + run] == all[i]) run++;
+        if (all[i] == 0 && run >= 3) {
+            if (run > 138) run = 138;
+            rle[rle_count] = run >= 11 ? 18 : 17;
+            rle_extra[rle_count] = (uint8_t)(run >= 11 ? run - 11 : run - 3);
+        } else if (all[i] != 0 && i > 0 && all[i - 1] == all[i] && run >= 3) {
+            /* Repeat the previous length 3..6 times */
+            if (run > 6) run = 6;
+            rle[rle_count] = 16;
+            rle_extra[rle_count] = (uint8_t)(run - 3);
+        } else {
+            run = 1;
+            rle[rle_count] = all[i];
+            rle_extra[rle_count] = 0;
+        }
+        cl_freq[rle[rle_count++]]++;
+        i += run;
+    }
+    uint8_t cl_len[19];
+    uint16_t cl_code[19];
+    glyph__huff_build_lengths(cl_freq, 19, 7, cl_len);
+    int hclen = 19;
+    while (hclen > 4 && !cl_len[glyph__deflate_cl_order[hclen - 1]]) hclen--;
+
+    /* Sizes of the three encodings, in bits after the 3-bit block header */
+    uint64_t dynamic_bits = 5 + 5 + 4 + 3 * (uint64_t)hclen + glyph__deflate_symbol_bits(d, litlen_len, dist_len);
+    for (int i = 0; i < 19; i++) {
+        uint32_t extra = i == 16 ? 2 : i == 17 ? 3 : i == 18 ? 7 : 0;
+        dynamic_bits += (uint64_t)cl_freq[i] * (cl_len[i] + extra);
+    }
+    /* The fixed code is defined over 288 literal/length symbols; the unused 286 and 287 still shift the 9-bit codes */
+    uint8_t fixed_litlen_len[288], fixed_dist_len[30];
+    for (int i = 0; i < 288; i++) fixed_litlen_len[i] = i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8;
+    for (int i = 0; i < 30; i++) fixed_dist_len[i] = 5;
+    uint64_t fixed_bits = glyph__deflate_symbol_bits(d, fixed_litlen_len, fixed_dist_len);
+    uint64_t stored_bits = (uint64_t)raw_len * 8 + ((raw_len + 65534) / 65535 + (raw_len == 0)) * 40 + 7;
+
+    if (stored_bits < dynamic_bits && stored_bits < fixed_bits) {
+        size_t pos = 0;
+        do {
+            size_t n = raw_len - pos > 65535 ? 65535 : raw_len - pos;
+            unsigned char header[4];
+            glyph__deflate_put_bits(out, (pos + n == raw_len && final) ? 1u : 0u, 3);
+            glyph__deflate_align(out);
+            header[0] = (unsigned char)n;
+            header[1] = (unsigned char)(n >> 8);
+            header[2] = (unsigned char)~n;
+            header[3] = (unsigned char)(~n >> 8);
+            glyph__deflate_put_bytes(out, header, 4);
+            glyph__deflate_put_bytes(out, raw + pos, n);
+            pos += n;
+        } while (pos < raw_len);
+    } else if (fixed_bits <= dynamic_bits) {
+        uint16_t fixed_litlen_code[288], fixed_dist_code[30];
+        glyph__huff_build_codes(fixed_litlen_len, 288, fixed_litlen_code);
+        glyph__huff_build_codes(fixed_dist_len, 30, fixed_dist_code);
+        glyph__deflate_put_bits(out, (final ? 1u : 0u) | (1u << 1), 3);
+        glyph__deflate_write_symbols(d, out, fixed_litlen_len, fixed_litlen_code, fixed_dist_len, fixed_dist_code);
+    } else {
+        glyph__huff_build_codes(litlen_len, 286, litlen_code);
+        glyph__huff_build_codes(dist_len, 30, dist_code);
+        glyph__huff_build_codes(cl_len, 19, cl_code);
+        glyph__deflate_put_bits(out, (final ? 1u : 0u) | (2u << 1), 3);
+        glyph__deflate_put_bits(out, (uint32_t)(hlit - 257), 5);
+        glyph__deflate_put_bits(out, (uint32_t)(hdist - 1), 5);
+        glyph__deflate_put_bits(out, (uint32_t)(hclen - 4), 4);
+        for (int i = 0; i < hclen; i++) glyph__deflate_put_bits(out, cl_len[glyph__deflate_cl_order[i]], 3);
+        for (int i = 0; i < rle_count; i++) {
+            int sym = rle[i];
+            glyph__deflate_put_bits(out, cl_code[sym], cl_len[sym]);
+            if (sym == 16) glyph__deflate_put_bits(out, rle_extra[i], 2);
+            else if (sym == 17) glyph__deflate_put_bits(out, rle_extra[i], 3);
+            else if (sym == 18) glyph__deflate_put_bits(out, rle_extra[i], 7);
+        }
+        glyph__deflate_write_symbols(d, out, litlen_len, litlen_code, dist_len, dist_code);
+    }
+
+    d->symbols = 0;
+    memset(d->litlen_freq, 0, sizeof(d->litlen_freq));
+    memset(d->dist_freq, 0, sizeof(d->dist_freq));
+}
+
+static uint32_t glyph__deflate_hash(const unsigned char* p) {
+    uint32_t v = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16);
+    return (v * 2654435761u) >> (32 - GLYPH__DEFLATE_HASH_BITS);
+}
+
+/* Adds position 'pos' (relative to the window base) to its hash chain */
+static void glyph__deflate_insert(glyph__deflate_t* d, const unsigned char* base, uint32_t pos) {
+    uint32_t h = glyph__deflate_hash(base + pos);
+    d->prev[pos & (GLYPH__DEFLATE_WINDOW - 1)] = d->head[h];
+    d->head[h] = pos + 1;
+}
+
+/* Finds the longest earlier match for 'pos'. Returns: Match length (0 if shorter than 3) */
+static unsigned glyph__deflate_find_match(const glyph__deflate_t* d, const unsigned char* base, uint32_t pos,
+                                          uint32_t end, unsigned* match_dist) {
+    unsigned max_len = end - pos > GLYPH__DEFLATE_MAX_MATCH ? GLYPH__DEFLATE_MAX_MATCH : (unsigned)(end - pos);
+    if (max_len < GLYPH__DEFLATE_MIN_MATCH) return 0;
+    const unsigned char* cur = base + pos;
+    unsigned best = GLYPH__DEFLATE_MIN_MATCH - 1;
+    uint32_t cand = d->head[glyph__deflate_hash(cur)];
+    int chain = GLYPHGL_DEFLATE_MAX_CHAIN;
+    while (cand && chain-- > 0) {
+        uint32_t c = cand - 1;
+        if (c >= pos || pos - c > GLYPH__DEFLATE_WINDOW) break;
+        const unsigned char* m = base + c;
+        if (m[best] == cur[best] && m[0] == cur[0] && m[1] == cur[1]) {
+            unsigned len = 2;
+            while (len < max_len && m[len] == cur[len]) len++;
+            if (len > best) {
+                best = len;
+                *match_dist = pos - c;
+                if (len >= max_len) break;
+            }
+        }
+        uint32_t next = d->prev[c & (GLYPH__DEFLATE_WINDOW - 1)];
+        if (next >= cand) break; /* Slot reused by a newer position: the chain ends here */
+        cand = next;
+    }
+    return best >= GLYPH__DEFLATE_MIN_MATCH ? best : 0;
+}
+
+static void glyph__deflate_record(glyph__deflate_t* d, unsigned len, unsigned dist) {
+    d->sym_len[d->symbols] = (uint16_t)len;
+    d->sym_dist[d->symbols] = (uint16_t)dist;
+    d->symbols++;
+    if (dist) {
+        d->litlen_freq[257 + d->len_code[len]]++;
+        d->dist_freq[glyph__deflate_dist_index(d, dist)]++;
+    } else {
+        d->litlen_freq[len]++;
+    }
+}
+
+/*
+ * Compresses data[start, end) into raw DEFLATE blocks appended to 'out'
+ *
+ * Up to 32 KB before 'start' serve as a preset dictionary: matches may
+ * reach back into them, as they do when the stream continues a previous
+ * call's output. With 'final' the last block carries BFINAL and the stream
+ * is padded to a byte; otherwise it ends with an empty stored block (a sync
+ * flush) so that further blocks can be appended at a byte boundary.
+ *
+ * Parameters:
+ *   data: Input buffer
+ *   start, end: Range to compress
+ *   final: Whether this ends the DEFLATE stream
+ *   out: Output buffer (appended to)
+ *
+ * Returns: 0 on success, -1 on allocation failure
+ */
+static int glyph__deflate_raw(const unsigned char* data, size_t start, size_t end, int final, glyph__deflate_out_t* out) {
+    glyph__deflate_t* d = (glyph__deflate_t*)GLYPH_MALLOC(sizeof(glyph__deflate_t));
+    if (!d) return -1;
+    memset(d->head, 0, sizeof(d->head));
+    d->symbols = 0;
+    memset(d->litlen_freq, 0, sizeof(d->litlen_freq));
+    memset(d->dist_freq, 0, sizeof(d->dist_freq));
+    glyph__deflate_init_tables(d);
+
+    /* Positions are relative to the dictionary start so they fit 32 bits per chunk */
+    size_t dict_start = start > GLYPH__DEFLATE_WINDOW ? start - GLYPH__DEFLATE_WINDOW : 0;
+    const unsigned char* base = data + dict_start;
+    uint32_t pos = (uint32_t)(start - dict_start);
+    uint32_t stop = (uint32_t)(end - dict_start);
+    for (uint32_t p = 0; p + GLYPH__DEFLATE_MIN_MATCH <= pos; p++) glyph__deflate_insert(d, base, p);
+
+    uint32_t block_start = pos;
+    unsigned next_len = 0, next_dist = 0;
+    int have_next = 0;
+    while (pos < stop) {
+        unsigned len, dist = 0;
+        if (have_next) {
+            len = next_len;
+            dist = next_dist;
+            have_next = 0;
+        } else {
+            len = glyph__deflate_find_match(d, base, pos, stop, &dist);
+        }
+        if (pos + GLYPH__DEFLATE_MIN_MATCH <= stop) glyph__deflate_insert(d, base, pos);
+
+        if (len && len < GLYPH__DEFLATE_NICE_MATCH && pos + 1 < stop) {
+            /* Lazy evaluation: prefer a literal if the next position has a longer match */
+            next_len = glyph__deflate_find_match(d, base, pos + 1, stop, &next_dist);
+            if (next_len > len) {
+                glyph__deflate_record(d, base[pos], 0);
+                pos++;
+                have_next = 1;
+                len = 0;
+            }
+        }
+        if (len) {
+            glyph__deflate_record(d, len, dist);
+            for (uint32_t p = pos + 1; p < pos + len; p++) {
+                if (p + GLYPH__DEFLATE_MIN_MATCH <= stop) glyph__deflate_insert(d, base, p);
+            }
+            pos += len;
+        } else if (!have_next) {
+            glyph__deflate_record(d, base[pos], 0);
+            pos++;
+        }
+
+        if (d->symbols == GLYPH__DEFLATE_BLOCK_SYMBOLS) {
+            glyph__deflate_flush_block(d, out, base + block_start, pos - block_start, 0);
+            block_start = pos;
+        }
+    }
+    if (d->symbols > 0 || final) glyph__deflate_flush_block(d, out, base + block_start, pos - block_start, final);
+    if (!final) {
+        /* Sync flush: empty stored block ending on a byte boundary */
+        static const unsigned char sync[4] = {0x00, 0x00, 0xFF, 0xFF};
+        glyph__deflate_put_bits(out, 0, 3);
+        glyph__deflate_align(out);
+        glyph__deflate_put_bytes(out, sync, 4);
+    } else {
+        glyph__deflate_align(out);
+    }
+    GLYPH_FREE(d);
+    return out->failed ? -1 : 0;
+}
+
+/* Rows filtered per task when encoding PNG data */
+#define GLYPH_PNG__FILTER_BAND 64
+
+/* Largest IDAT chunk written; longer streams are split over several chunks */
+#define GLYPH_PNG__IDAT_CHUNK (1u << 20)
+
+/*
+ * Filtered bytes per DEFLATE chunk (rounded to whole rows). The encoder
+ * holds one chunk of filtered rows at a time, or GLYPHGL_PNG_PARALLEL_CHUNKS
+ * of them when an executor is installed, plus the 32 KB LZ77 window. Smaller
+ * chunks use less memory and spread better over workers, but each one costs
+ * a few bytes of sync flush and restarts its Huffman statistics.
+ */
+#ifndef GLYPHGL_PNG_CHUNK_SIZE
+#define GLYPHGL_PNG_CHUNK_SIZE (128 * 1024)
+#endif
+
+/* DEFLATE chunks compressed concurrently when an executor is installed */
+#ifndef GLYPHGL_PNG_PARALLEL_CHUNKS
+#define GLYPHGL_PNG_PARALLEL_CHUNKS 16
+#endif
+
+/* Shared state of the PNG row filtering tasks for one group of rows */
+typedef struct {
+    const unsigned char* pixels;    /* Source pixels, 'channels' bytes each */
+    size_t row_bytes;               /* Bytes per source row */
+    size_t bpp;                     /* Bytes per pixel */
+    unsigned int y0, y1;            /* Rows filtered by this job */
+    unsigned char* raw;             /* Filtered scanlines for rows y0.. (filter byte + row) */
+} glyph_png__filter_job_t;
+
+/* Shared state of the PNG compression tasks, one DEFLATE chunk per task */
+typedef struct {
+    const unsigned char* raw;       /* Dictionary followed by the group's filtered scanlines */
+    size_t start;                   /* Offset of the group's first scanline (dictionary size) */
+    size_t end;                     /* Offset past the group's last scanline */
+    size_t chunk_size;              /* Filtered bytes per chunk (the last may be shorter) */
+    size_t num_chunks;
+    int final;                      /* Group holds the image's last rows */
+    glyph__deflate_out_t* outs;     /* Compressed output per chunk */
+    uint32_t* adlers;               /* Adler32 of each chunk's filtered bytes */
+} glyph_png__deflate_job_t;
+
+/*
+ * Compresses one chunk of the filtered data (a glyph_task_func_t)
+ *
+ * Like pigz, each chunk uses the 32 KB before it as a preset dictionary and
+ * ends in a sync flush (the last in a final block), so the chunk outputs
+ * concatenate into a single DEFLATE stream.
+ */
+static void glyph_png__deflate_task(void* arg, size_t index) {
+    const glyph_png__deflate_job_t* job = (const glyph_png__deflate_job_t*)arg;
+    size_t start = job->start + index * job->chunk_size;
+    size_t end = start + job->chunk_size < job->end ? start + job->chunk_size : job->end;
+    int final = job->final && index + 1 == job->num_chunks;
+    if (glyph__deflate_raw(job->raw, start, end, final, &job->outs[index]) != 0) job->outs[index].failed = 1;
+    job->adlers[index] = glyph__adler32_update(1, job->raw + start, end - start);
+}
+
+/* Paeth predictor (PNG specification, section 9.4) */
+static unsigned char glyph_png__paeth(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+    if (pa <= pb && pa <= pc) return (unsigned char)a;
+    return (unsigned char)(pb <= pc ? b : c);
+}
+
+/*
+ * Applies one PNG filter to a row
+ *
+ * Parameters:
+ *   type: 0 (None), 1 (Sub), 2 (Up) or 4 (Paeth)
+ *   row: Source row
+ *   up: Source row above, or NULL for the first row
+ *   out: Receives the filtered bytes
+ *   n: Bytes per row
+ *   bpp: Bytes per pixel
+ *
+ * Returns: Sum of the filtered bytes' magnitudes as signed values
+ */
+static uint64_t glyph_png__filter_row(int type, const unsigned char* row, const unsigned char* up, unsigned char* out, size_t n, size_t bpp) {
+    size_t i;
+    if (!up && (type == 2 || type == 4)) type = type == 2 ? 0 : 1; /* Missing row above reads as zeros */
+    switch (type) {
+        case 1:
+            for (i = 0; i < bpp && i < n; ++i) out[i] = row[i];
+            for (; i < n; ++i) out[i] = (unsigned char)(row[i] - row[i - bpp]);
+            break;
+        case 2:
+            for (i = 0; i < n; ++i) out[i] = (unsigned char)(row[i] - up[i]);
+            break;
+        case 4:
+            for (i = 0; i < bpp && i < n; ++i) out[i] = (unsigned char)(row[i] - up[i]);
+            for (; i < n; ++i) out[i] = (unsigned char)(row[i] - glyph_png__paeth(row[i - bpp], up[i], up[i - bpp]));
+            break;
+        default:
+            memcpy(out, row, n);
+            break;
+    }
+    uint64_t cost = 0;
+    for (i = 0; i < n; ++i) {
+        int v = (signed char)out[i];
+        cost += (uint64_t)(v < 0 ? -v : v);
+    }
+    return cost;
+}
+
+/*
+ * Filters one band of rows (a glyph_task_func_t)
+ *
+ * Each row gets the filter among None, Sub, Up and Paeth whose output has
+ * the smallest sum of absolute values as signed bytes, the usual heuristic
+ * for what DEFLATE compresses best. Filters read only source rows, so bands
+ * are independent.
+ */
+static void glyph_png__filter_task(void* arg, size_t index) {
+    static const int types[4] = {0, 1, 2, 4};
+    const glyph_png__filter_job_t* job = (const glyph_png__filter_job_t*)arg;
+    size_t row_bytes = job->row_bytes;
+    size_t y_begin = job->y0 + index * GLYPH_PNG__FILTER_BAND;
+    size_t y_end = y_begin + GLYPH_PNG__FILTER_BAND;
+    if (y_end > job->y1) y_end = job->y1;
+    for (size_t y = y_begin; y < y_end; ++y) {
+        const unsigned char* row = &job->pixels[y * row_bytes];
+        const unsigned char* up = y > 0 ? row - row_bytes : NULL;
+        unsigned char* out = job->raw + (y - job->y0) * (row_bytes + 1);
+
+        /* Try each filter in place, then redo the best one unless it was the last tried */
+        int best_type = 0;
+        uint64_t best_cost = 0;
+        for (int t = 0; t < 4; t++) {
+            uint64_t cost = glyph_png__filter_row(types[t], row, up, out + 1, row_bytes, job->bpp);
+            if (t == 0 || cost < best_cost) {
+                best_cost = cost;
+                best_type = types[t];
+            }
+            if (best_cost == 0) break; /* Nothing beats an all-zero row */
+        }
+        out[0] = (unsigned char)best_type;
+        if (best_type != 4 && best_cost != 0) glyph_png__filter_row(best_type, row, up, out + 1, row_bytes, job->bpp);
+    }
+}
+
+/*
+ * Writes one PNG chunk: length, type, data and the CRC32 of type and data
+ *
+ * Returns: 0 on success, -1 on write error
+ */
+static int glyph_png__write_chunk(glyph_write_func_t write, void* user, const char* type, const unsigned char* data, size_t len) {
+    unsigned char header[8];
+    unsigned char footer[4];
+    uint32_t crc = glyph__crc32_update(0, (const unsigned char*)type, 4);
+    crc = glyph__crc32_update(crc, data, len);
+    header[0] = (unsigned char)(len >> 24);
+    header[1] = (unsigned char)(len >> 16);
+    header[2] = (unsigned char)(len >> 8);
+    header[3] = (unsigned char)len;
+    memcpy(header + 4, type, 4);
+    footer[0] = (unsigned char)(crc >> 24);
+    footer[1] = (unsigned char)(crc >> 16);
+    footer[2] = (unsigned char)(crc >> 8);
+    footer[3] = (unsigned char)crc;
+    if (write(user, header, 8) != 0) return -1;
+    if (len && write(user, data, len) != 0) return -1;
+    return write(user, footer, 4) != 0 ? -1 : 0;
+}
+
+/*
+ * Streams pixels to a sink as a PNG
+ *
+ * Rows are filtered adaptively and compressed with LZ77 and Huffman coding
+ * (see glyph__deflate_raw) one group at a time: memory use is bounded by
+ * GLYPHGL_PNG_CHUNK_SIZE (times GLYPHGL_PNG_PARALLEL_CHUNKS with an
+ * executor) plus the 32 KB LZ77 window, whatever the image size, and IDAT
+ * chunks reach the sink as each group is compressed.
+ *
+ * With an executor installed (glyph_set_executor) each group's chunks are
+ * filtered and compressed in parallel, pigz-style, and their Adler32 values
+ * combined afterwards; the output is still a single ordinary zlib stream.
+ *
+ * Parameters:
+ *   write: Sink receiving the file's bytes in order
+ *   user: Passed to 'write'
+ *   pixels: Top-to-bottom rows of width * channels bytes
+ *   width, height: Image size in pixels
+ *   channels: 1 (grayscale), 3 (RGB) or 4 (RGBA)
+ *
+ * Returns: 0 on success, -1 on invalid input, allocation or sink failure
+ */
+static int glyph_write_png_pixels_to(glyph_write_func_t write, void* user, const unsigned char* pixels,
+                                     unsigned int width, unsigned int height, int channels) {
+    /* Validate input parameters */
+    if (!write || !pixels || width == 0 || height == 0) return -1;
+    int color_type;
+    switch (channels) {
+        case 1: color_type = 0; break; /* Grayscale */
+        case 3: color_type = 2; break; /* RGB */
+        case 4: color_type = 6; break; /* RGBA */
+        default: return -1;
+    }
+
+    /* Rows per DEFLATE chunk and per group of chunks compressed together */
+    size_t row_bytes = (size_t)width * channels;
+    size_t raw_row_bytes = row_bytes + 1; /* +1 for filter byte */
+    size_t rows_per_chunk = GLYPHGL_PNG_CHUNK_SIZE / raw_row_bytes;
+    if (rows_per_chunk == 0) rows_per_chunk = 1;
+    size_t chunk_size = rows_per_chunk * raw_row_bytes;
+    size_t max_chunks = glyph__executor.submit ? GLYPHGL_PNG_PARALLEL_CHUNKS : 1;
+    size_t rows_per_group = rows_per_chunk * max_chunks;
+
+    /* Window buffer: up to 32 KB of already compressed scanlines (the dictionary), then the group's */
+    unsigned char* raw = (unsigned char*)GLYPH_MALLOC(GLYPH__DEFLATE_WINDOW + rows_per_group * raw_row_bytes);
+    glyph__deflate_out_t* outs = (glyph__deflate_out_t*)GLYPH_MALLOC(max_chunks * sizeof(glyph__deflate_out_t));
+    uint32_t* adlers = (uint32_t*)GLYPH_MALLOC(max_chunks * sizeof(uint32_t));
+    if (!raw || !outs || !adlers) {
+        GLYPH_FREE(raw);
+        GLYPH_FREE(outs);
+        GLYPH_FREE(adlers);
+        return -1;
+    }
+    memset(outs, 0, max_chunks * sizeof(glyph__deflate_out_t));
 
     /* Write PNG signature (required first 8 bytes of all PNG files) */
-    const unsigned char png_sig[8] = {137,80,78,71,13,10,26,10};
-    fwrite(png_sig, 1, 8, f);
+    static const unsigned char png_sig[8] = {137,80,78,71,13,10,26,10};
+    int result = write(user, png_sig, 8) == 0 ? 0 : -1;
 
     /* Create IHDR chunk data (Image Header) */
     unsigned char ihdr_data[13];
     /* Image width in big-endian */
-    ihdr_data[0] = (img->width >> 24) & 0xFF;
-    ihdr_data[1] = (img->width >> 16) & 0xFF;
-    ihdr_data[2] = (img->width >> 8) & 0xFF;
-    ihdr_data[3] = img->width & 0xFF;
+    ihdr_data[0] = (width >> 24) & 0xFF;
+    ihdr_data[1] = (width >> 16) & 0xFF;
+    ihdr_data[2] = (width >> 8) & 0xFF;
+    ihdr_data[3] = width & 0xFF;
     /* Image height in big-endian */
-    ihdr_data[4] = (img->height >> 24) & 0xFF;
-    ihdr_data[5] = (img->height >> 16) & 0xFF;
-    ihdr_data[6] = (img->height >> 8) & 0xFF;
-    ihdr_data[7] = img->height & 0xFF;
+    ihdr_data[4] = (height >> 24) & 0xFF;
+    ihdr_data[5] = (height >> 16) & 0xFF;
+    ihdr_data[6] = (height >> 8) & 0xFF;
+    ihdr_data[7] = height & 0xFF;
     ihdr_data[8] = 8;  /* Bit depth: 8 bits per channel */
-    ihdr_data[9] = 2;  /* Color type: RGB (2) */
+    ihdr_data[9] = (unsigned char)color_type;
     ihdr_data[10] = 0; /* Compression method: DEFLATE (0) */
     ihdr_data[11] = 0; /* Filter method: Adaptive (0) */
     ihdr_data[12] = 0; /* Interlace method: None (0) */
+    if (result == 0) result = glyph_png__write_chunk(write, user, "IHDR", ihdr_data, 13);
 
-    /* Write IHDR chunk */
-    write_u32_be(f, 13);              /* Chunk length */
-    fwrite("IHDR", 1, 4, f);         /* Chunk type */
-    fwrite(ihdr_data, 1, 13, f);     /* Chunk data */
-    /* Calculate and write CRC32 checksum */
-    {
-        unsigned char* tmp = (unsigned char*)GLYPH_MALLOC(4 + 13);
-        memcpy(tmp, "IHDR", 4);
-        memcpy(tmp + 4, ihdr_data, 13);
-        uint32_t crc = crc32(tmp, 4 + 13);
-        write_u32_be(f, crc);
-        GLYPH_FREE(tmp);
-    }
-
-    /* Prepare image data for DEFLATE compression */
-    /* PNG uses "filter bytes" and requires big-endian storage */
-    size_t raw_row_bytes = (size_t)img->width * 3 + 1; /* +1 for filter byte */
-    size_t raw_size = raw_row_bytes * img->height;
-    unsigned char* raw = (unsigned char*)GLYPH_MALLOC(raw_size);
-    if (!raw) { fclose(f); return -1; }
-
-    int bpp = 3; /* Bytes per pixel (RGB) */
-    /* Apply PNG filtering (Sub filter for simplicity) */
-    unsigned char* row_data = (unsigned char*)GLYPH_MALLOC((size_t)img->width * bpp);
-    for (unsigned int y = 0; y < img->height; ++y) {
-        unsigned char* row_ptr = raw + y * raw_row_bytes;
-        /* Copy current row */
-        memcpy(row_data, &img->data[(y * img->width) * bpp], (size_t)img->width * bpp);
-        row_ptr[0] = 1; /* Filter type: Sub (1) */
-        /* Apply Sub filter: each pixel = current - left neighbor */
-        for (size_t i = 0; i < (size_t)img->width * bpp; ++i) {
-            if (i < bpp) {
-                row_ptr[i + 1] = row_data[i]; /* First pixel unchanged */
-            } else {
-                row_ptr[i + 1] = row_data[i] - row_data[i - bpp]; /* Subtract left pixel */
+    /* zlib stream: header (deflate, 32 KB window, default level), DEFLATE chunks, Adler32 of the raw data */
+    static const unsigned char zlib_header[2] = {0x78, 0x9C};
+    glyph__deflate_put_bytes(&outs[0], zlib_header, 2);
+    uint32_t a32 = 1;
+    size_t dict = 0;
+    for (unsigned int y0 = 0; y0 < height && result == 0; ) {
+        unsigned int y1 = height - y0 > rows_per_group ? y0 + (unsigned int)rows_per_group : height;
+        size_t group_bytes = (size_t)(y1 - y0) * raw_row_bytes;
+
+        /* Filter the group's rows in bands through the executor */
+        glyph_png__filter_job_t filter_job;
+        filter_job.pixels = pixels;
+        filter_job.row_bytes = row_bytes;
+        filter_job.bpp = (size_t)channels;
+        filter_job.y0 = y0;
+        filter_job.y1 = y1;
+        filter_job.raw = raw + dict;
+        glyph__parallel_for(glyph_png__filter_task, &filter_job, (y1 - y0 + GLYPH_PNG__FILTER_BAND - 1) / GLYPH_PNG__FILTER_BAND);
+
+        /* Compress its chunks, one per task */
+        glyph_png__deflate_job_t deflate_job;
+        deflate_job.raw = raw;
+        deflate_job.start = dict;
+        deflate_job.end = dict + group_bytes;
+        deflate_job.chunk_size = chunk_size;
+        deflate_job.num_chunks = (group_bytes + chunk_size - 1) / chunk_size;
+        deflate_job.final = y1 == height;
+        deflate_job.outs = outs;
+        deflate_job.adlers = adlers;
+        glyph__parallel_for(glyph_png__deflate_task, &deflate_job, deflate_job.num_chunks);
+
+        for (size_t i = 0; i < deflate_job.num_chunks; i++) {
+            size_t len = i + 1 < deflate_job.num_chunks ? chunk_size : group_bytes - i * chunk_size;
+            a32 = glyph__adler32_combine(a32, adlers[i], len);
+        }
+        if (deflate_job.final) {
+            unsigned char trailer[4] = {(unsigned char)(a32 >> 24), (unsigned char)(a32 >> 16), (unsigned char)(a32 >> 8), (unsigned char)a32};
+            glyph__deflate_put_bytes(&outs[deflate_job.num_chunks - 1], trailer, 4);
+        }
+
+        /* Write the chunks as IDAT chunks (Image Data), CRCs computed in place, and reuse their buffers */
+        for (size_t i = 0; i < deflate_job.num_chunks; i++) {
+            glyph__deflate_out_t* comp = &outs[i];
+            if (comp->failed) result = -1;
+            for (size_t pos = 0; pos < comp->size && result == 0; pos += GLYPH_PNG__IDAT_CHUNK) {
+                size_t len = comp->size - pos > GLYPH_PNG__IDAT_CHUNK ? GLYPH_PNG__IDAT_CHUNK : comp->size - pos;
+                result = glyph_png__write_chunk(write, user, "IDAT", comp->data + pos, len);
             }
+            comp->size = 0;
         }
-    }
-    GLYPH_FREE(row_data);
-
-    /* Compress using DEFLATE algorithm (stored/uncompressed for simplicity) */
-    /* Zlib header for DEFLATE compression */
-    unsigned char zlib_header[2] = {0x78, 0x01}; /* Fastest compression, stored blocks */
-
-    /* Calculate maximum compressed size (worst case) */
-    size_t max_blocks = (raw_size + 65534) / 65535; /* Number of 64KB blocks needed */
-    size_t comp_cap = 2 + raw_size + max_blocks * 5 + 4; /* Header + data + block overhead + checksum */
-    unsigned char* comp = (unsigned char*)GLYPH_MALLOC(comp_cap);
-    if (!comp) { GLYPH_FREE(raw); fclose(f); return -1; }
-
-    /* Build compressed data stream */
-    size_t comp_pos = 0;
-    comp[comp_pos++] = zlib_header[0]; /* Zlib compression method/flags */
-    comp[comp_pos++] = zlib_header[1];
-
-    /* Process data in 64KB blocks (DEFLATE stored blocks) */
-    size_t remaining = raw_size;
-    size_t raw_pos = 0;
-    while (remaining > 0) {
-        uint16_t block_len = (uint16_t)((remaining > 65535) ? 65535 : remaining);
-        uint8_t bfinal = (remaining <= 65535) ? 1 : 0; /* Final block flag */
-        uint8_t block_hdr = (uint8_t)((bfinal & 1) | (0 << 1)); /* Stored block type */
-        comp[comp_pos++] = block_hdr;
-        /* Block length and one's complement */
-        comp[comp_pos++] = (uint8_t)(block_len & 0xFF);
-        comp[comp_pos++] = (uint8_t)((block_len >> 8) & 0xFF);
-        uint16_t nlen = (uint16_t)(~block_len);
-        comp[comp_pos++] = (uint8_t)(nlen & 0xFF);
-        comp[comp_pos++] = (uint8_t)((nlen >> 8) & 0xFF);
-        /* Copy uncompressed data */
-        memcpy(comp + comp_pos, raw + raw_pos, block_len);
-        comp_pos += block_len;
-        raw_pos += block_len;
-        remaining -= block_len;
-    }
-
-    /* Append Adler32 checksum (required by zlib) */
-    uint32_t a32 = adler32(raw, raw_size);
-    comp[comp_pos++] = (unsigned char)((a32 >> 24) & 0xFF);
-    comp[comp_pos++] = (unsigned char)((a32 >> 16) & 0xFF);
-    comp[comp_pos++] = (unsigned char)((a32 >> 8) & 0xFF);
-    comp[comp_pos++] = (unsigned char)(a32 & 0xFF);
 
+        /* Keep the last 32 KB of scanlines as the next group's dictionary */
+        size_t keep = dict + group_bytes < GLYPH__DEFLATE_WINDOW ? dict + group_bytes : GLYPH__DEFLATE_WINDOW;
+        memmove(raw, raw + dict + group_bytes - keep, keep);
+        dict = keep;
+        y0 = y1;
+    }
     GLYPH_FREE(raw); /* Free uncompressed data */
-
-    /* Write IDAT chunk (Image Data) */
-    uint32_t comp_len = (uint32_t)comp_pos;
-    write_u32_be(f, comp_len);        /* Chunk length */
-    fwrite("IDAT", 1, 4, f);         /* Chunk type */
-    fwrite(comp, 1, comp_len, f);    /* Compressed data */
-    /* Calculate and write CRC32 */
-    {
-        unsigned char* tmp = (unsigned char*)GLYPH_MALLOC(4 + comp_len);
-        memcpy(tmp, "IDAT", 4);
-        memcpy(tmp + 4, comp, comp_len);
-        uint32_t crc = crc32(tmp, 4 + comp_len);
-        write_u32_be(f, crc);
-        GLYPH_FREE(tmp);
-    }
-    GLYPH_FREE(comp); /* Free compressed data */
+    for (size_t i = 0; i < max_chunks; i++) GLYPH_FREE(outs[i].data); /* Free compressed data */
+    GLYPH_FREE(outs);
+    GLYPH_FREE(adlers);
 
     /* Write IEND chunk (Image End) - marks end of PNG file */
-    write_u32_be(f, 0);                          /* Empty chunk */
-    fwrite("IEND", 1, 4, f);                     /* Chunk type */
-    uint32_t iend_crc = crc32((const unsigned char*)"IEND", 4);
-    write_u32_be(f, iend_crc);                   /* CRC32 checksum */
+    if (result == 0) result = glyph_png__write_chunk(write, user, "IEND", NULL, 0);
+    return result;
+}
 
-    fclose(f);
-    return 0;
+/*
+ * Streams a glyph image to a sink as an RGB PNG
+ *
+ * Parameters:
+ *   write: Sink receiving the file's bytes in order
+ *   user: Passed to 'write'
+ *   img: Pointer to glyph_image_t to export
+ *
+ * Returns: 0 on success, -1 on failure
+ */
+static int glyph_write_png_to(glyph_write_func_t write, void* user, const glyph_image_t* img) {
+    if (!img || !img->data) return -1;
+    return glyph_write_png_pixels_to(write, user, img->data, img->width, img->height, 3);
+}
+
+/*
+ * Exports a glyph image to PNG (Portable Network Graphics) file format
+ *
+ * PNG is a compressed, lossless image format widely supported on the web and
+ * in applications. This implementation creates a valid PNG with IHDR, IDAT,
+ * and IEND chunks, streamed to the file by glyph_write_png_pixels_to; atlases,
+ * being mostly empty, shrink to a small fraction of their raw size.
+ *
+ * Parameters:
+ *   filename: Output PNG file path
+ *   img: Pointer to glyph_image_t to export
+ *
+ * Returns: 0 on success, -1 on failure
+ */
+static int glyph_write_png(const char* filename, glyph_image_t* img) {
+    /* Validate input parameters */
+    if (!img || !img->data) return -1;
+
+    /* Open file for binary writing */
+    FILE* f = fopen(filename, "wb");
+    if (!f) return -1;
+    int result = glyph_write_png_to(glyph_write_stdio, f, img);
+    if (fclose(f) != 0) result = -1;
+    return result;
+}
+
+/*
+ * BC4 (RGTC1) block compression
+ *
+ * BC4 stores a single channel in 4x4 blocks of 8 bytes: two 8-bit endpoints
+ * and a 3-bit palette index per texel, half the size of an R8 texture. With
+ * endpoint 0 above endpoint 1 the palette is the endpoints and six values
+ * between them; otherwise it is the endpoints, four values between them, 0
+ * and 255. Coverage and SDF atlases compress well in either mode: most
+ * blocks are empty or solid and encode exactly.
+ */
+
+/* Block rows encoded per task */
+#define GLYPH_BC4__BAND 16
+
+/* Returns: Bytes of BC4 data for a width x height image (whole 4x4 blocks, 8 bytes each) */
+static size_t glyph_image_bc4_size(unsigned int width, unsigned int height) {
+    return (size_t)((width + 3) / 4) * ((height + 3) / 4) * 8;
+}
+
+/* Fills the 8-entry palette a decoder derives from endpoints a0 and a1 */
+static void glyph_image__bc4_palette(int a0, int a1, unsigned char palette[8]) {
+    palette[0] = (unsigned char)a0;
+    palette[1] = (unsigned char)a1;
+    if (a0 > a1) {
+        for (int i = 2; i < 8; i++) palette[i] = (unsigned char)(((8 - i) * a0 + (i - 1) * a1 + 3) / 7);
+    } else {
+        for (int i = 2; i < 6; i++) palette[i] = (unsigned char)(((6 - i) * a0 + (i - 1) * a1 + 2) / 5);
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+/*
+ * Maps each texel of a block to its nearest palette entry
+ *
+ * Ties go to the lower index. The SSE2 path compares all 16 texels with one
+ * palette entry per step and gives the same indices as the scalar loop.
+ *
+ * Returns: Sum of absolute errors over the block
+ */
+static unsigned int glyph_image__bc4_fit(const unsigned char texels[16], const unsigned char palette[8], unsigned char indices[16]) {
+#ifdef GLYPH_IMAGE__SSE2
+    const __m128i t = _mm_loadu_si128((const __m128i*)texels);
+    const __m128i all = _mm_set1_epi8(-1);
+    __m128i best = all;
+    __m128i best_index = _mm_setzero_si128();
+    for (int i = 0; i < 8; i++) {
+        __m128i p = _mm_set1_epi8((char)palette[i]);
+        __m128i d = _mm_or_si128(_mm_subs_epu8(t, p), _mm_subs_epu8(p, t));
+        __m128i nearest = _mm_min_epu8(d, best);
+        __m128i better = _mm_xor_si128(_mm_cmpeq_epi8(nearest, best), all); /* d < best */
+        best = nearest;
+        best_index = _mm_or_si128(_mm_and_si128(better, _mm_set1_epi8((char)i)), _mm_andnot_si128(better, best_index));
+    }
+    _mm_storeu_si128((__m128i*)indices, best_index);
+    __m128i sad = _mm_sad_epu8(best, _mm_setzero_si128());
+    return (unsigned int)(_mm_cvtsi128_si32(sad) + _mm_cvtsi128_si32(_mm_srli_si128(sad, 8)));
+#else
+    unsigned int error = 0;
+    for (int k = 0; k < 16; k++) {
+        int best = 256, best_index = 0;
+        for (int i = 0; i < 8; i++) {
+            int d = texels[k] - palette[i];
+            if (d < 0) d = -d;
+            if (d < best) {
+                best = d;
+                best_index = i;
+            }
+        }
+        indices[k] = (unsigned char)best_index;
+        error += (unsigned int)best;
+    }
+    return error;
+#endif
+}
+
+/*
+ * Encodes one 4x4 block of texels (row-major) into 8 bytes of BC4
+ *
+ * Uses the block's range with six interpolated values, and for blocks that
+ * touch 0 or 255 also tries the mode with exact 0 and 255 entries and the
+ * range of the remaining texels, keeping whichever fits better.
+ */
+static void glyph_image__bc4_encode_block(const unsigned char texels[16], unsigned char out[8]) {
+    int lo = 255, hi = 0, inner_lo = 255, inner_hi = 0;
+    for (int k = 0; k < 16; k++) {
+        int v = texels[k];
+        if (v < lo) lo = v;
+        if (v > hi) hi = v;
+        if (v != 0 && v != 255) {
+            if (v < inner_lo) inner_lo = v;
+            if (v > inner_hi) inner_hi = v;
+        }
+    }
+    if (lo == hi) {
+        /* Empty or solid block: both endpoints hold the value, all indices 0 */
+        out[0] = out[1] = (unsigned char)lo;
+        memset(out + 2, 0, 6);
+        return;
+    }
+
+    unsigned char palette[8], indices[16], alt_indices[16];
+    int a0 = hi, a1 = lo;
+    glyph_image__bc4_palette(a0, a1, palette);
+    unsigned int error = glyph_image__bc4_fit(texels, palette, indices);
+    if (error && (lo == 0 || hi == 255) && inner_lo <= inner_hi) {
+        glyph_image__bc4_palette(inner_lo, inner_hi, palette);
+        unsigned int alt_error = glyph_image__bc4_fit(texels, palette, alt_indices);
+        if (alt_error < error) {
+            a0 = inner_lo;
+            a1 = inner_hi;
+            memcpy(indices, alt_indices, 16);
+        }
+    }
+
+    /* 48 bits of indices, texel 0 in the lowest bits */
+    uint64_t bits = 0;
+    for (int k = 0; k < 16; k++) bits |= (uint64_t)indices[k] << (3 * k);
+    out[0] = (unsigned char)a0;
+    out[1] = (unsigned char)a1;
+    for (int i = 0; i < 6; i++) out[2 + i] = (unsigned char)(bits >> (8 * i));
+}
+
+/* Shared state of the BC4 encoding tasks */
+typedef struct {
+    const unsigned char* pixels;    /* Single-channel source rows */
+    unsigned int width, height;     /* Source size in pixels */
+    unsigned char* blocks;          /* Output blocks, row-major */
+} glyph_image__bc4_job_t;
+
+/* Encodes GLYPH_BC4__BAND rows of blocks (a glyph_task_func_t) */
+static void glyph_image__bc4_task(void* arg, size_t index) {
+    const glyph_image__bc4_job_t* job = (const glyph_image__bc4_job_t*)arg;
+    unsigned int blocks_x = (job->width + 3) / 4;
+    unsigned int blocks_y = (job->height + 3) / 4;
+    unsigned int by_end = (unsigned int)(index + 1) * GLYPH_BC4__BAND;
+    if (by_end > blocks_y) by_end = blocks_y;
+    unsigned char texels[16];
+    for (unsigned int by = (unsigned int)index * GLYPH_BC4__BAND; by < by_end; by++) {
+        unsigned char* out = job->blocks + (size_t)by * blocks_x * 8;
+        for (unsigned int bx = 0; bx < blocks_x; bx++, out += 8) {
+            /* Texels past the right or bottom edge repeat the edge */
+            for (unsigned int r = 0; r < 4; r++) {
+                unsigned int y = by * 4 + r < job->height ? by * 4 + r : job->height - 1;
+                const unsigned char* row = job->pixels + (size_t)y * job->width;
+                if (bx * 4 + 4 <= job->width) {
+                    memcpy(texels + r * 4, row + bx * 4, 4);
+                } else {
+                    for (unsigned int c = 0; c < 4; c++) texels[r * 4 + c] = row[bx * 4 + c < job->width ? bx * 4 + c : job->width - 1];
+                }
+            }
+            glyph_image__bc4_encode_block(texels, out);
+        }
+    }
+}
+
+/*
+ * Compresses single-channel pixels to BC4 (GL_COMPRESSED_RED_RGTC1)
+ *
+ * Bands of block rows are encoded in parallel on the executor installed with
+ * glyph_set_executor, serially without one. Partial blocks at the right and
+ * bottom edges repeat the edge texels.
+ *
+ * Parameters:
+ *   pixels: Top-to-bottom rows of 'width' bytes
+ *   width, height: Image size in pixels
+ *   blocks: Receives glyph_image_bc4_size(width, height) bytes of blocks, row-major
+ */
+static void glyph_image_encode_bc4(const unsigned char* pixels, unsigned int width, unsigned int height, unsigned char* blocks) {
+    if (!pixels || !blocks || width == 0 || height == 0) return;
+    glyph_image__bc4_job_t job = {pixels, width, height, blocks};
+    glyph__parallel_for(glyph_image__bc4_task, &job, ((height + 3) / 4 + GLYPH_BC4__BAND - 1) / GLYPH_BC4__BAND);
+}
+
+/*
+ * Streams single-channel pixels to a sink as a BC4-compressed KTX texture
+ *
+ * Writes a KTX 1.1 file (GL_COMPRESSED_RED_RGTC1, little-endian) holding the
+ * image and up to 'levels' box-filtered mip levels (glyph_image_build_mips),
+ * so engines and texture tools can pass the blocks straight to
+ * glCompressedTexImage2D instead of encoding them at load time. One level is
+ * encoded at a time.
+ *
+ * Parameters:
+ *   write: Sink receiving the file's bytes in order
+ *   user: Passed to 'write'
+ *   pixels: Top-to-bottom rows of 'width' bytes
+ *   width, height: Image size in pixels
+ *   levels: Mip levels to store, level 0 included (clamped to the full chain)
+ *
+ * Returns: 0 on success, -1 on invalid input, allocation or sink failure
+ */
+static int glyph_write_ktx_bc4_to(glyph_write_func_t write, void* user, const unsigned char* pixels,
+                                  unsigned int width, unsigned int height, int levels) {
+    static const unsigned char identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+    if (!write || !pixels || width == 0 || height == 0) return -1;
+    size_t chain_bytes;
+    levels = glyph_image_mip_chain(width, height, 1, levels, &chain_bytes);
+
+    /* Header: identifier, endianness, then glType .. bytesOfKeyValueData */
+    uint32_t fields[13] = {
+        0x04030201u,
+        0, 1, 0,                /* glType, glTypeSize, glFormat: compressed */
+        0x8DBBu, 0x1903u,       /* GL_COMPRESSED_RED_RGTC1, base format GL_RED */
+        width, height, 0,       /* pixelDepth 0: 2D */
+        0, 1, (uint32_t)levels, /* Not an array, one face */
+        0                       /* No key/value data */
+    };
+    unsigned char header[64];
+    memcpy(header, identifier, 12);
+    for (int i = 0; i < 13; i++) {
+        header[12 + i * 4 + 0] = (unsigned char)fields[i];
+        header[12 + i * 4 + 1] = (unsigned char)(fields[i] >> 8);
+        header[12 + i * 4 + 2] = (unsigned char)(fields[i] >> 16);
+        header[12 + i * 4 + 3] = (unsigned char)(fields[i] >> 24);
+    }
+    if (write(user, header, sizeof(header)) != 0) return -1;
+
+    unsigned char* blocks = (unsigned char*)GLYPH_MALLOC(glyph_image_bc4_size(width, height));
+    unsigned char* chain = chain_bytes ? (unsigned char*)GLYPH_MALLOC(chain_bytes) : NULL;
+    if (!blocks || (chain_bytes && !chain)) {
+        GLYPH_FREE(blocks);
+        GLYPH_FREE(chain);
+        return -1;
+    }
+
+    int result = 0;
+    const unsigned char* level_pixels = pixels;
+    glyph_image_build_mips(pixels, width, height, 1, levels, chain);
+    for (int level = 0; level < levels && result == 0; level++) {
+        if (level > 0) {
+            level_pixels = level == 1 ? chain : level_pixels + (size_t)width * height;
+            width = width > 1 ? width / 2 : 1;
+            height = height > 1 ? height / 2 : 1;
+        }
+        /* imageSize, then the blocks (always a multiple of 4 bytes, so no mip padding) */
+        size_t size = glyph_image_bc4_size(width, height);
+        unsigned char size_bytes[4] = {(unsigned char)size, (unsigned char)(size >> 8), (unsigned char)(size >> 16), (unsigned char)(size >> 24)};
+        glyph_image_encode_bc4(level_pixels, width, height, blocks);
+        if (write(user, size_bytes, 4) != 0 || write(user, blocks, size) != 0) result = -1;
+    }
+    GLYPH_FREE(blocks);
+    GLYPH_FREE(chain);
+    return result;
+}
+
+/*
+ * Exports single-channel pixels as a BC4-compressed KTX file
+ *
+ * Parameters:
+ *   filename: Output KTX file path
+ *   pixels: Top-to-bottom rows of 'width' bytes
+ *   width, height: Image size in pixels
+ *   levels: Mip levels to store, level 0 included
+ *
+ * Returns: 0 on success, -1 on failure
+ */
+static int glyph_write_ktx_bc4(const char* filename, const unsigned char* pixels, unsigned int width, unsigned int height, int levels) {
+    if (!pixels) return -1;
+    FILE* f = fopen(filename, "wb");
+    if (!f) return -1;
+    int result = glyph_write_ktx_bc4_to(glyph_write_stdio, f, pixels, width, height, levels);
+    if (fclose(f) != 0) result = -1;
+    return result;
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,1011 @@
+/*
+    MIT License
+
+    Copyright (c) 2025 Darek
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/*
+ * Glyph Layout Module - Multi-line Text Layout
+ *
+ * This module turns a string into positioned glyphs for a bounding box:
+ * - Greedy line breaking at spaces, tabs and after hyphens
+ * - Left, center, right and justified alignment
+ * - Hard line breaks on '\n' and tab stops for '\t'
+ * - Line height taken from the font's hhea metrics
+ *
+ * The result is a reusable array of positioned glyphs. Layout only depends
+ * on the atlas (no OpenGL), so it can be computed once and drawn every frame
+ * with glyph_renderer_draw_layout().
+ *
+ * Hit testing, caret and selection geometry are answered from the layout
+ * with binary searches (glyph_text_hit_test, glyph_text_caret_rect,
+ * glyph_text_selection_rects).
+ *
+ * For editable text, glyph_document_t splits the buffer into paragraphs that
+ * are laid out independently, so an edit only re-lays-out what it touched.
+ */
+
+#ifndef __GLYPH_LAYOUT_H
+#define __GLYPH_LAYOUT_H
+
+#include "glyph_atlas.h"
+#include "glyph_util.h"
+
+/* Horizontal alignment of laid-out lines */
+typedef enum {
+    GLYPH_ALIGN_LEFT,    /* Lines start at the left edge of the box */
+    GLYPH_ALIGN_CENTER,  /* Lines are centered in the box */
+    GLYPH_ALIGN_RIGHT,   /* Lines end at the right edge of the box */
+    GLYPH_ALIGN_JUSTIFY  /* Wrapped lines are stretched to the box width at spaces */
+} glyph_align_t;
+
+/*
+ * Layout configuration
+ *
+ * A zero-initialized struct gives unwrapped, left-aligned text with tab stops
+ * every four spaces and single line spacing.
+ */
+typedef struct {
+    float width;          /* Box width in pixels used for wrapping and alignment (<= 0 disables wrapping) */
+    glyph_align_t align;  /* Horizontal alignment of each line */
+    float tab_width;      /* Distance between tab stops in pixels (<= 0 uses four spaces) */
+    float line_spacing;   /* Multiplier applied to the hhea line height (<= 0 uses 1.0) */
+} glyph_layout_options_t;
+
+/*
+ * A single glyph placed by the layout
+ *
+ * Positions are relative to the top-left corner of the layout box with the
+ * y axis pointing down, matching the renderer's projection.
+ */
+typedef struct {
+    float x, y;           /* Pen position on the baseline */
+    float advance;        /* Scaled advance including kerning to the next glyph on the line */
+    int codepoint;        /* Unicode codepoint */
+    int char_index;       /* Index into atlas->chars, or -1 for characters without a glyph */
+    size_t byte_offset;   /* Offset of the character in the source text */
+} glyph_positioned_t;
+
+/*
+ * A laid-out line referencing a range of positioned glyphs
+ */
+typedef struct {
+    size_t first_glyph;   /* Index of the first glyph of the line */
+    size_t num_glyphs;    /* Number of glyphs on the line (including trailing spaces) */
+    size_t byte_start;    /* Offset of the first byte of the line in the source text */
+    size_t byte_end;      /* Offset one past the last byte (excluding the line break) */
+    float x;              /* Left edge of the line content after alignment */
+    float baseline;       /* Baseline y coordinate */
+    float width;          /* Width of the line content excluding trailing spaces */
+    int wrapped;          /* 1 if the line was ended by wrapping rather than '\n' or end of text */
+} glyph_layout_line_t;
+
+/*
+ * Result of a layout pass
+ *
+ * Arrays are kept between calls to glyph_layout_text, so re-laying out into
+ * the same struct does not allocate once it has grown to its working size.
+ */
+typedef struct {
+    glyph_positioned_t* glyphs;   /* Positioned glyphs in text order */
+    size_t num_glyphs;            /* Number of positioned glyphs */
+    size_t glyph_capacity;        /* Allocated glyph slots */
+    glyph_layout_line_t* lines;   /* Lines in top-to-bottom order */
+    size_t num_lines;             /* Number of lines */
+    size_t line_capacity;         /* Allocated line slots */
+    float scale;                  /* Scale the layout was computed for */
+    float line_height;            /* Distance between baselines in pixels */
+    float ascender;               /* Scaled ascender (baseline of the first line) */
+    float descender;              /* Scaled descender (negative) */
+    float width;                  /* Width of the widest line */
+    float height;                 /* Height from the top of the first line to the bottom of the last */
+    glyph_allocator_t* allocator; /* Source of the arrays: the allocator of the atlas they were first grown for */
+} glyph_layout_t;
+
+/* Grows the glyph array of a layout to hold at least 'count' glyphs */
+static inline int glyph_layout__reserve_glyphs(glyph_layout_t* layout, size_t count) {
+    if (count <= layout->glyph_capacity) return 1;
+    size_t new_capacity = layout->glyph_capacity ? layout->glyph_capacity * 2 : 64;
+    while (new_capacity < count) new_capacity *= 2;
+    glyph_positioned_t* grown = (glyph_positioned_t*)glyph__mem_realloc(layout->allocator, layout->glyphs, new_capacity * sizeof(glyph_positioned_t), GLYPH_MEMORY_LAYOUT);
+    if (!grown) return 0;
+    layout->glyphs = grown;
+    layout->glyph_capacity = new_capacity;
+    return 1;
+}
+
+/* Appends an empty line to a layout, returning NULL on allocation failure */
+static inline glyph_layout_line_t* glyph_layout__push_line(glyph_layout_t* layout) {
+    if (layout->num_lines == layout->line_capacity) {
+        size_t new_capacity = layout->line_capacity ? layout->line_capacity * 2 : 16;
+        glyph_layout_line_t* grown = (glyph_layout_line_t*)glyph__mem_realloc(layout->allocator, layout->lines, new_capacity * sizeof(glyph_layout_line_t), GLYPH_MEMORY_LAYOUT);
+        if (!grown) return NULL;
+        layout->lines = grown;
+        layout->line_capacity = new_capacity;
+    }
+    glyph_layout_line_t* line = &layout->lines[layout->num_lines++];
+    memset(line, 0, sizeof(*line));
+    return line;
+}
+
+/*
+ * Applies horizontal alignment to one line
+ *
+ * Parameters:
+ *   layout: Layout owning the line
+ *   line: Line to align (glyph x positions start at 0)
+ *   box_width: Width to align within
+ *   align: Alignment mode
+ */
+static inline void glyph_layout__align_line(glyph_layout_t* layout, glyph_layout_line_t* line, float box_width, glyph_align_t align) {
+    glyph_positioned_t* glyphs = layout->glyphs + line->first_glyph;
+    float offset = 0.0f;
+    if (align == GLYPH_ALIGN_CENTER) offset = (box_width - line->width) * 0.5f;
+    else if (align == GLYPH_ALIGN_RIGHT) offset = box_width - line->width;
+
+    if (align == GLYPH_ALIGN_JUSTIFY && line->wrapped && line->width < box_width) {
+        /* Count inter-word spaces (trailing spaces are excluded) */
+        size_t last_visible = line->num_glyphs;
+        while (last_visible > 0 && (glyphs[last_visible - 1].codepoint == ' ' || glyphs[last_visible - 1].codepoint == '\t')) {
+            last_visible--;
+        }
+        int spaces = 0;
+        for (size_t g = 0; g < last_visible; g++) {
+            if (glyphs[g].codepoint == ' ') spaces++;
+        }
+        if (spaces > 0) {
+            float extra = (box_width - line->width) / spaces;
+            float shift = 0.0f;
+            for (size_t g = 0; g < line->num_glyphs; g++) {
+                glyphs[g].x += shift;
+                if (g < last_visible && glyphs[g].codepoint == ' ') {
+                    glyphs[g].advance += extra;
+                    shift += extra;
+                }
+            }
+            line->width = box_width;
+        }
+    }
+
+    if (offset != 0.0f) {
+        for (size_t g = 0; g < line->num_glyphs; g++) {
+            glyphs[g].x += offset;
+        }
+    }
+    line->x = offset;
+}
+
+/*
+ * Lays out text into lines of positioned glyphs
+ *
+ * Lines are broken greedily: a line is ended before the first word that would
+ * cross the box width, at the last space, tab or hyphen. Words wider than the
+ * box are split between characters. '\n' always ends a line ("\r\n" is
+ * accepted) and '\t' advances to the next tab stop.
+ *
+ * The layout struct is reused: existing arrays are overwritten and only grown
+ * when needed. Zero-initialize it before the first call. The arrays come from
+ * the allocator of the atlas passed to the first call that allocates them.
+ *
+ * Parameters:
+ *   layout: Layout to fill
+ *   atlas: Glyph atlas providing advances, kerning and line metrics
+ *   text: UTF-8 or ASCII string (encoding taken from the atlas)
+ *   len: Length of the string in bytes
+ *   scale: Text scaling factor (1.0 = atlas pixel height)
+ *   options: Layout options (NULL for defaults)
+ *
+ * Returns: 0 on success, -1 on failure
+ */
+static inline int glyph_layout_text(glyph_layout_t* layout, glyph_atlas_t* atlas, const char* text, size_t len,
+                                    float scale, const glyph_layout_options_t* options) {
+    if (!layout || !atlas || !atlas->chars || (!text && len)) return -1;
+
+    glyph_layout_options_t defaults;
+    memset(&defaults, 0, sizeof(defaults));
+    if (!options) options = &defaults;
+    float box_width = options->width;
+    float tab_width = options->tab_width > 0.0f ? options->tab_width : glyph_atlas_get_advance(atlas, ' ') * 4.0f * scale;
+    float spacing = options->line_spacing > 0.0f ? options->line_spacing : 1.0f;
+    if (tab_width <= 0.0f) tab_width = atlas->pixel_height * scale;
+
+    if (!layout->glyphs && !layout->lines) layout->allocator = atlas->allocator;
+    layout->num_glyphs = 0;
+    layout->num_lines = 0;
+    layout->scale = scale;
+    layout->ascender = atlas->ascender * scale;
+    layout->descender = atlas->descender * scale;
+    layout->line_height = (atlas->ascender - atlas->descender + atlas->line_gap) * scale * spacing;
+    layout->width = 0.0f;
+    layout->height = 0.0f;
+
+    /* Worst case one glyph per byte */
+    if (!glyph_layout__reserve_glyphs(layout, len ? len : 1)) return -1;
+
+    glyph_layout_line_t* line = glyph_layout__push_line(layout);
+    if (!line) return -1;
+    line->baseline = layout->ascender;
+
+    float pen_x = 0.0f;
+    float content_width = 0.0f;     /* Width up to the end of the last non-space glyph */
+    int prev = -1;                  /* Previous codepoint on the line for kerning */
+    size_t break_byte = 0;          /* Byte offset after the last break opportunity */
+    size_t break_glyph = 0;         /* Glyph count at the last break opportunity */
+    float break_width = 0.0f;       /* Line width at the last break opportunity */
+    int has_break = 0;
+    int pending_break = 0;          /* A break opportunity follows the run of spaces being read */
+    size_t i = 0;
+
+    while (i < len) {
+        size_t start = i;
+        int codepoint;
+        if (atlas->char_type == GLYPH_UTF8) {
+            codepoint = glyph_atlas_utf8_decode_len(text, len, &i);
+        } else {
+            codepoint = (unsigned char)text[i++];
+        }
+
+        if (codepoint == '\r' && i < len && text[i] == '\n') continue;
+
+        /* Record the break opportunity once the run of spaces ends */
+        int is_space = (codepoint == ' ' || codepoint == '\t');
+        if (pending_break && !is_space && codepoint != '\n') {
+            break_byte = start;
+            break_glyph = layout->num_glyphs;
+            has_break = 1;
+            pending_break = 0;
+        }
+
+        if (codepoint == '\n') {
+            /* Hard line break */
+            line->byte_end = start;
+            line->num_glyphs = layout->num_glyphs - line->first_glyph;
+            line->width = content_width;
+            line = glyph_layout__push_line(layout);
+            if (!line) return -1;
+            line->first_glyph = layout->num_glyphs;
+            line->byte_start = i;
+            line->baseline = layout->ascender + (layout->num_lines - 1) * layout->line_height;
+            pen_x = 0.0f;
+            content_width = 0.0f;
+            prev = -1;
+            has_break = 0;
+            pending_break = 0;
+            continue;
+        }
+
+        /* Resolve advance, kerning and atlas glyph */
+        glyph_atlas_char_t* ch = glyph_atlas_find_char(atlas, codepoint);
+        if (!ch) ch = glyph_atlas_find_char(atlas, '?');
+        float advance;
+        if (codepoint == '\t') {
+            float stop = (floorf(pen_x / tab_width) + 1.0f) * tab_width;
+            advance = stop - pen_x;
+            ch = NULL;
+        } else {
+            if (prev >= 0) pen_x += glyph_atlas_get_kerning(atlas, prev, codepoint) * scale;
+            advance = (ch ? (float)ch->advance : atlas->pixel_height * 0.5f) * scale;
+        }
+
+        /* Wrap when a visible glyph crosses the box edge */
+        if (box_width > 0.0f && !is_space && pen_x + advance > box_width && layout->num_glyphs > line->first_glyph) {
+            if (has_break && break_glyph > line->first_glyph) {
+                /* Rewind to the last break opportunity */
+                layout->num_glyphs = break_glyph;
+                i = break_byte;
+                line->width = break_width;
+            } else {
+                /* No opportunity on this line - split the word here */
+                i = start;
+                line->width = content_width;
+            }
+            line->byte_end = i;
+            line->num_glyphs = layout->num_glyphs - line->first_glyph;
+            line->wrapped = 1;
+            line = glyph_layout__push_line(layout);
+            if (!line) return -1;
+            line->first_glyph = layout->num_glyphs;
+            line->byte_start = i;
+            line->baseline = layout->ascender + (layout->num_lines - 1) * layout->line_height;
+            pen_x = 0.0f;
+            content_width = 0.0f;
+            prev = -1;
+            has_break = 0;
+            pending_break = 0;
+            continue;
+        }
+
+        glyph_positioned_t* g = &layout->glyphs[layout->num_glyphs++];
+        g->x = pen_x;
+        g->y = line->baseline;
+        g->advance = advance;
+        g->codepoint = codepoint;
+        g->char_index = (ch && ch->width > 0) ? (int)(ch - atlas->chars) : -1;
+        g->byte_offset = start;
+        if (layout->num_glyphs - 1 > line->first_glyph && prev >= 0 && codepoint != '\t') {
+            /* Fold kerning into the previous glyph's advance for hit testing */
+            layout->glyphs[layout->num_glyphs - 2].advance = pen_x - layout->glyphs[layout->num_glyphs - 2].x;
+        }
+
+        pen_x += advance;
+        prev = (codepoint == '\t') ? -1 : codepoint;
+        if (is_space) {
+            if (!pending_break) break_width = content_width;
+            pending_break = 1;
+        } else {
+            content_width = pen_x;
+            if (codepoint == '-') {
+                /* Break opportunity after a hyphen */
+                break_byte = i;
+                break_glyph = layout->num_glyphs;
+                break_width = content_width;
+                has_break = 1;
+            }
+        }
+    }
+
+    line->byte_end = len;
+    line->num_glyphs = layout->num_glyphs - line->first_glyph;
+    line->width = content_width;
+
+    /* Alignment pass - without a box width align within the widest line */
+    float max_width = 0.0f;
+    for (size_t l = 0; l < layout->num_lines; l++) {
+        if (layout->lines[l].width > max_width) max_width = layout->lines[l].width;
+    }
+    float align_width = box_width > 0.0f ? box_width : max_width;
+    for (size_t l = 0; l < layout->num_lines; l++) {
+        glyph_layout__align_line(layout, &layout->lines[l], align_width, options->align);
+    }
+
+    layout->width = max_width;
+    layout->height = layout->ascender - layout->descender + (layout->num_lines - 1) * layout->line_height;
+    return 0;
+}
+
+/*
+ * Frees the arrays owned by a layout
+ *
+ * Parameters:
+ *   layout: Layout to free (left zero-initialized and reusable)
+ */
+static inline void glyph_layout_free(glyph_layout_t* layout) {
+    if (!layout) return;
+    glyph__mem_free(layout->allocator, layout->glyphs);
+    glyph__mem_free(layout->allocator, layout->lines);
+    memset(layout, 0, sizeof(*layout));
+}
+
+/*
+ * Axis-aligned rectangle in layout coordinates (y down)
+ */
+typedef struct {
+    float x, y;           /* Top-left corner */
+    float w, h;           /* Width and height */
+} glyph_rect_t;
+
+/*
+ * Hit testing
+ *
+ * Glyph x positions in a layout are the running sum of the advances on their
+ * line (kerning and justification are folded into the advances), and line
+ * baselines increase monotonically. Both are therefore sorted and are searched
+ * directly with binary search - no walk over the text is needed.
+ */
+
+/* Index of the line whose box contains y (clamped to the first/last line) */
+static inline size_t glyph_text__line_at_y(const glyph_layout_t* layout, float y) {
+    size_t lo = 0, hi = layout->num_lines;
+    while (hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if (layout->lines[mid].baseline - layout->ascender <= y) lo = mid;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/* Index of the line containing a byte offset (a wrap point belongs to the following line) */
+static inline size_t glyph_text__line_at_offset(const glyph_layout_t* layout, size_t offset) {
+    size_t lo = 0, hi = layout->num_lines;
+    while (hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if (layout->lines[mid].byte_start <= offset) lo = mid;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/* X coordinate of the caret before 'offset' on a given line */
+static inline float glyph_text__line_x(const glyph_layout_t* layout, const glyph_layout_line_t* line, size_t offset) {
+    if (line->num_glyphs == 0) return line->x;
+    const glyph_positioned_t* glyphs = layout->glyphs + line->first_glyph;
+    /* First glyph at or after the offset */
+    size_t lo = 0, hi = line->num_glyphs;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (glyphs[mid].byte_offset < offset) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo < line->num_glyphs) return glyphs[lo].x;
+    return glyphs[line->num_glyphs - 1].x + glyphs[line->num_glyphs - 1].advance;
+}
+
+/*
+ * Maps a point to the nearest caret position
+ *
+ * Parameters:
+ *   layout: Layout produced by glyph_layout_text
+ *   x, y: Point in layout coordinates (relative to the layout box)
+ *
+ * Returns: Byte offset in the source text of the caret position closest to the point
+ */
+static inline size_t glyph_text_hit_test(const glyph_layout_t* layout, float x, float y) {
+    if (!layout || layout->num_lines == 0) return 0;
+    const glyph_layout_line_t* line = &layout->lines[glyph_text__line_at_y(layout, y)];
+    if (line->num_glyphs == 0) return line->byte_start;
+    const glyph_positioned_t* glyphs = layout->glyphs + line->first_glyph;
+
+    /* Last glyph starting at or before x */
+    size_t lo = 0, hi = line->num_glyphs;
+    while (hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if (glyphs[mid].x <= x) lo = mid;
+        else hi = mid;
+    }
+    if (x < glyphs[lo].x + glyphs[lo].advance * 0.5f) return glyphs[lo].byte_offset;
+    if (lo + 1 < line->num_glyphs) return glyphs[lo + 1].byte_offset;
+
+    /* Past the end - keep the caret on a wrapped line instead of the next one */
+    if (line->wrapped) return glyphs[lo].byte_offset;
+    return line->byte_end;
+}
+
+/*
+ * Returns the caret rectangle for a byte offset
+ *
+ * Parameters:
+ *   layout: Layout produced by glyph_layout_text
+ *   offset: Byte offset in the source text
+ *
+ * Returns: 1 pixel wide rectangle spanning the line box, in layout coordinates
+ */
+static inline glyph_rect_t glyph_text_caret_rect(const glyph_layout_t* layout, size_t offset) {
+    glyph_rect_t rect = {0.0f, 0.0f, 0.0f, 0.0f};
+    if (!layout || layout->num_lines == 0) return rect;
+    const glyph_layout_line_t* line = &layout->lines[glyph_text__line_at_offset(layout, offset)];
+    rect.x = glyph_text__line_x(layout, line, offset);
+    rect.y = line->baseline - layout->ascender;
+    rect.w = 1.0f;
+    rect.h = layout->line_height;
+    return rect;
+}
+
+/*
+ * Selection rectangle of one line for an ordered byte range
+ *
+ * Returns: 1 if the line has a non-empty part of the selection, 0 otherwise
+ */
+static inline int glyph_text__line_selection(const glyph_layout_t* layout, size_t l, size_t start, size_t end, glyph_rect_t* rect) {
+    const glyph_layout_line_t* line = &layout->lines[l];
+    size_t a = start > line->byte_start ? start : line->byte_start;
+    size_t b = end < line->byte_end ? end : line->byte_end;
+    if (a > b) return 0;
+    float x0 = glyph_text__line_x(layout, line, a);
+    float x1 = glyph_text__line_x(layout, line, b);
+    if (!line->wrapped && l + 1 < layout->num_lines && end > line->byte_end) {
+        x1 += layout->ascender * 0.25f;
+    }
+    if (x1 <= x0) return 0;
+    rect->x = x0;
+    rect->y = line->baseline - layout->ascender;
+    rect->w = x1 - x0;
+    rect->h = layout->line_height;
+    return 1;
+}
+
+/*
+ * Computes the selection rectangles for a byte range, one per line
+ *
+ * Lines whose line break is selected are extended by a quarter of the
+ * ascender so selected empty lines stay visible.
+ *
+ * Parameters:
+ *   layout: Layout produced by glyph_layout_text
+ *   start, end: Selected byte range (order does not matter)
+ *   rects: Output array (may be NULL to query the count)
+ *   max_rects: Capacity of the output array
+ *
+ * Returns: Number of rectangles in the selection (may exceed max_rects)
+ */
+static inline size_t glyph_text_selection_rects(const glyph_layout_t* layout, size_t start, size_t end,
+                                                glyph_rect_t* rects, size_t max_rects) {
+    if (!layout || layout->num_lines == 0) return 0;
+    if (start > end) { size_t t = start; start = end; end = t; }
+    if (start == end) return 0;
+
+    size_t first = glyph_text__line_at_offset(layout, start);
+    size_t last = glyph_text__line_at_offset(layout, end);
+    size_t count = 0;
+    for (size_t l = first; l <= last; l++) {
+        glyph_rect_t rect;
+        if (!glyph_text__line_selection(layout, l, start, end, &rect)) continue;
+        if (rects && count < max_rects) rects[count] = rect;
+        count++;
+    }
+    return count;
+}
+
+/*
+ * A paragraph of a document: the text between two '\n' characters
+ *
+ * Each paragraph owns its own layout so an edit only re-lays-out the
+ * paragraphs it touches. The vertex_* fields and emitted_y are bookkeeping
+ * for glyph_renderer_draw_document and should not be modified by callers.
+ */
+typedef struct {
+    size_t start;              /* Byte offset of the paragraph in the document text */
+    size_t length;             /* Length in bytes, excluding the terminating '\n' */
+    float y;                   /* Top of the paragraph in document coordinates */
+    int dirty;                 /* Text changed since the last layout */
+    int stale;                 /* Geometry must be re-emitted */
+    glyph_layout_t layout;     /* Paragraph layout, positions relative to the paragraph top */
+    size_t vertex_offset;      /* First vertex of the paragraph's slot in the document buffer */
+    size_t vertex_capacity;    /* Vertices reserved for the slot (0 = no slot) */
+    float emitted_y;           /* Paragraph y baked into the uploaded vertices */
+} glyph_paragraph_t;
+
+/*
+ * Editable text with incremental layout
+ *
+ * Edits mark only the paragraphs they touch as dirty. glyph_document_update
+ * re-lays-out the dirty range and moves the following paragraphs by the change
+ * in height, so inserting a character costs one paragraph layout regardless
+ * of the size of the buffer.
+ */
+typedef struct {
+    char* text;                       /* Document bytes (not NUL-terminated) */
+    size_t length;                    /* Length of the text in bytes */
+    size_t capacity;                  /* Allocated text bytes */
+    glyph_paragraph_t* paragraphs;    /* Paragraphs in text order (always at least one) */
+    size_t num_paragraphs;            /* Number of paragraphs */
+    size_t paragraph_capacity;        /* Allocated paragraph slots */
+    glyph_atlas_t* atlas;             /* Atlas used for layout (not owned) */
+    float scale;                      /* Text scaling factor */
+    glyph_layout_options_t options;   /* Layout options applied to every paragraph */
+    float height;                     /* Total height of the document */
+    size_t dirty_first;               /* First paragraph needing layout ((size_t)-1 = none) */
+    size_t dirty_last;                /* Last paragraph needing layout */
+    size_t released_vertices;         /* Vertex slots freed by removed paragraphs (for compaction) */
+} glyph_document_t;
+
+/*
+ * Initializes an empty document
+ *
+ * The text, paragraphs and paragraph layouts are allocated through the
+ * atlas's allocator.
+ *
+ * Parameters:
+ *   doc: Document to initialize
+ *   atlas: Glyph atlas used for layout (must outlive the document)
+ *   scale: Text scaling factor (1.0 = atlas pixel height)
+ *   options: Layout options (NULL for defaults)
+ *
+ * Returns: 0 on success, -1 on failure
+ */
+static inline int glyph_document_init(glyph_document_t* doc, glyph_atlas_t* atlas, float scale, const glyph_layout_options_t* options) {
+    if (!doc || !atlas) return -1;
+    memset(doc, 0, sizeof(*doc));
+    doc->paragraphs = (glyph_paragraph_t*)glyph__mem_alloc(atlas->allocator, 16 * sizeof(glyph_paragraph_t), GLYPH_MEMORY_LAYOUT);
+    doc->text = (char*)glyph__mem_alloc(atlas->allocator, 256, GLYPH_MEMORY_LAYOUT);
+    if (!doc->paragraphs || !doc->text) {
+        glyph__mem_free(atlas->allocator, doc->paragraphs);
+        glyph__mem_free(atlas->allocator, doc->text);
+        doc->paragraphs = NULL;
+        doc->text = NULL;
+        return -1;
+    }
+    doc->capacity = 256;
+    memset(doc->paragraphs, 0, sizeof(glyph_paragraph_t));
+    doc->paragraph_capacity = 16;
+    doc->num_paragraphs = 1;
+    doc->paragraphs[0].dirty = 1;
+    doc->paragraphs[0].stale = 1;
+    doc->atlas = atlas;
+    doc->scale = scale;
+    if (options) doc->options = *options;
+    doc->dirty_first = 0;
+    doc->dirty_last = 0;
+    return 0;
+}
+
+/*
+ * Frees all memory owned by a document
+ */
+static inline void glyph_document_free(glyph_document_t* doc) {
+    if (!doc) return;
+    for (size_t i = 0; i < doc->num_paragraphs; i++) {
+        glyph_layout_free(&doc->paragraphs[i].layout);
+    }
+    glyph_allocator_t* allocator = doc->atlas ? doc->atlas->allocator : NULL;
+    glyph__mem_free(allocator, doc->paragraphs);
+    glyph__mem_free(allocator, doc->text);
+    memset(doc, 0, sizeof(*doc));
+}
+
+/*
+ * Finds the paragraph containing a byte offset
+ *
+ * Returns: Index of the paragraph whose range [start, start + length] contains pos
+ */
+static inline size_t glyph_document_find_paragraph(const glyph_document_t* doc, size_t pos) {
+    size_t lo = 0, hi = doc->num_paragraphs;
+    while (hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if (doc->paragraphs[mid].start <= pos) lo = mid;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/*
+ * Finds the paragraph at a document y coordinate (clamped to the first/last)
+ *
+ * Only valid after glyph_document_update.
+ */
+static inline size_t glyph_document_paragraph_at_y(const glyph_document_t* doc, float y) {
+    size_t lo = 0, hi = doc->num_paragraphs;
+    while (hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if (doc->paragraphs[mid].y <= y) lo = mid;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/*
+ * Replaces a byte range of the document with new text
+ *
+ * Paragraphs overlapping the edited range are re-split and marked dirty,
+ * paragraphs after it only have their byte offsets moved. Layout is deferred
+ * to glyph_document_update.
+ *
+ * Parameters:
+ *   doc: Document to edit
+ *   pos: Byte offset of the range to replace (clamped to the text length)
+ *   remove: Number of bytes to remove (clamped to the text length)
+ *   text: Replacement bytes (may be NULL when len is 0, must not point into doc->text)
+ *   len: Number of replacement bytes
+ *
+ * Returns: 0 on success, -1 on failure
+ */
+static inline int glyph_document_replace(glyph_document_t* doc, size_t pos, size_t remove, const char* text, size_t len) {
+    if (!doc || !doc->paragraphs || (!text && len)) return -1;
+    if (pos > doc->length) pos = doc->length;
+    if (remove > doc->length - pos) remove = doc->length - pos;
+
+    /* Paragraphs touched by the edit */
+    size_t first = glyph_document_find_paragraph(doc, pos);
+    size_t last = glyph_document_find_paragraph(doc, pos + remove);
+    size_t region_start = doc->paragraphs[first].start;
+    size_t old_region_end = doc->paragraphs[last].start + doc->paragraphs[last].length;
+    size_t region_end = old_region_end - remove + len;
+
+    /* Count the paragraphs the edited region will split into, from the kept and inserted bytes */
+    size_t count = 1;
+    for (size_t i = region_start; i < pos; i++) {
+        if (doc->text[i] == '\n') count++;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (text[i] == '\n') count++;
+    }
+    for (size_t i = pos + remove; i < old_region_end; i++) {
+        if (doc->text[i] == '\n') count++;
+    }
+    size_t old_count = last - first + 1;
+
+    /* Reserve the text and paragraph storage before changing either, so a failed
+       allocation leaves the document as it was */
+    size_t new_length = doc->length - remove + len;
+    if (new_length > doc->capacity) {
+        size_t new_capacity = doc->capacity * 2;
+        while (new_capacity < new_length) new_capacity *= 2;
+        char* grown = (char*)glyph__mem_realloc(doc->atlas->allocator, doc->text, new_capacity, GLYPH_MEMORY_LAYOUT);
+        if (!grown) return -1;
+        doc->text = grown;
+        doc->capacity = new_capacity;
+    }
+    size_t needed = doc->num_paragraphs + (count > old_count ? count - old_count : 0);
+    if (needed > doc->paragraph_capacity) {
+        size_t new_capacity = doc->paragraph_capacity * 2;
+        while (new_capacity < needed) new_capacity *= 2;
+        glyph_paragraph_t* grown = (glyph_paragraph_t*)glyph__mem_realloc(doc->atlas->allocator, doc->paragraphs, new_capacity * sizeof(glyph_paragraph_t), GLYPH_MEMORY_LAYOUT);
+        if (!grown) return -1;
+        doc->paragraphs = grown;
+        doc->paragraph_capacity = new_capacity;
+    }
+
+    /* Edit the text */
+    memmove(doc->text + pos + len, doc->text + pos + remove, doc->length - pos - remove);
+    if (len) memcpy(doc->text + pos, text, len);
+    doc->length = new_length;
+
+    if (count > old_count) {
+        memmove(doc->paragraphs + first + count, doc->paragraphs + last + 1,
+                (doc->num_paragraphs - last - 1) * sizeof(glyph_paragraph_t));
+        memset(doc->paragraphs + first + old_count, 0, (count - old_count) * sizeof(glyph_paragraph_t));
+    } else if (count < old_count) {
+        for (size_t i = first + count; i <= last; i++) {
+            doc->released_vertices += doc->paragraphs[i].vertex_capacity;
+            glyph_layout_free(&doc->paragraphs[i].layout);
+        }
+        memmove(doc->paragraphs + first + count, doc->paragraphs + last + 1,
+                (doc->num_paragraphs - last - 1) * sizeof(glyph_paragraph_t));
+    }
+    doc->num_paragraphs += count - old_count;
+
+    /* Re-split the edited region */
+    size_t start = region_start;
+    for (size_t i = first; i < first + count; i++) {
+        size_t end = start;
+        while (end < region_end && doc->text[end] != '\n') end++;
+        glyph_paragraph_t* para = &doc->paragraphs[i];
+        para->start = start;
+        para->length = end - start;
+        para->dirty = 1;
+        para->stale = 1;
+        start = end + 1;
+    }
+
+    /* Shift the byte offsets of the following paragraphs */
+    size_t tail = first + count;
+    for (size_t i = tail; i < doc->num_paragraphs; i++) {
+        doc->paragraphs[i].start = doc->paragraphs[i].start + len - remove;
+    }
+
+    /* Track the dirty range, remapping an existing range across the index shift */
+    size_t range_first = first, range_last = first + count - 1;
+    if (doc->dirty_first != (size_t)-1) {
+        size_t df = doc->dirty_first, dl = doc->dirty_last;
+        if (df > last) df = df + count - old_count;
+        else if (df >= first) df = first;
+        if (dl > last) dl = dl + count - old_count;
+        else if (dl >= first) dl = first + count - 1;
+        if (df < range_first) range_first = df;
+        if (dl > range_last) range_last = dl;
+    }
+    doc->dirty_first = range_first;
+    doc->dirty_last = range_last;
+    return 0;
+}
+
+/* Inserts bytes at a byte offset (see glyph_document_replace) */
+static inline int glyph_document_insert(glyph_document_t* doc, size_t pos, const char* text, size_t len) {
+    return glyph_document_replace(doc, pos, 0, text, len);
+}
+
+/* Erases a byte range (see glyph_document_replace) */
+static inline int glyph_document_erase(glyph_document_t* doc, size_t pos, size_t len) {
+    return glyph_document_replace(doc, pos, len, NULL, 0);
+}
+
+/* Replaces the whole document text */
+static inline int glyph_document_set_text(glyph_document_t* doc, const char* text, size_t len) {
+    if (!doc) return -1;
+    return glyph_document_replace(doc, 0, doc->length, text, len);
+}
+
+/* Shared state of the paragraph layout tasks */
+typedef struct {
+    glyph_document_t* doc;     /* Document being updated */
+    size_t first;              /* Paragraph index of task 0 */
+} glyph_document__layout_job_t;
+
+/* Lays out one paragraph if it is dirty (a glyph_task_func_t); it stays dirty on failure */
+static inline void glyph_document__layout_task(void* arg, size_t index) {
+    glyph_document__layout_job_t* job = (glyph_document__layout_job_t*)arg;
+    glyph_document_t* doc = job->doc;
+    glyph_paragraph_t* para = &doc->paragraphs[job->first + index];
+    if (!para->dirty) return;
+    if (glyph_layout_text(&para->layout, doc->atlas, doc->text + para->start, para->length,
+                          doc->scale, &doc->options) != 0) {
+        return;
+    }
+    para->dirty = 0;
+    para->stale = 1;
+}
+
+/*
+ * Lays out the paragraphs dirtied since the last update
+ *
+ * Dirty paragraphs are laid out again and marked stale for the renderer.
+ * Paragraph y positions after the dirty range are moved by the change in
+ * height, stopping as soon as a paragraph is already in place.
+ *
+ * Parameters:
+ *   doc: Document to update
+ *
+ * Returns: Number of paragraphs laid out, or -1 on failure
+ */
+static inline int glyph_document_update(glyph_document_t* doc) {
+    if (!doc || !doc->paragraphs) return -1;
+    if (doc->dirty_first == (size_t)-1) return 0;
+
+    /* Paragraphs are independent - lay them out through the executor, one task each */
+    int count = 0;
+    size_t last = doc->dirty_last;
+    for (size_t i = doc->dirty_first; i <= last; i++) {
+        if (doc->paragraphs[i].dirty) count++;
+    }
+    glyph_document__layout_job_t job;
+    job.doc = doc;
+    job.first = doc->dirty_first;
+    glyph__parallel_for(glyph_document__layout_task, &job, last - doc->dirty_first + 1);
+    for (size_t i = doc->dirty_first; i <= last; i++) {
+        if (doc->paragraphs[i].dirty) return -1; /* Layout failed */
+    }
+
+    /* Move paragraph tops - later paragraphs only shift when a height changed */
+    size_t i = doc->dirty_first;
+    float y = 0.0f;
+    if (i > 0) {
+        glyph_paragraph_t* prev = &doc->paragraphs[i - 1];
+        y = prev->y + prev->layout.num_lines * prev->layout.line_height;
+    }
+    for (; i < doc->num_paragraphs; i++) {
+        glyph_paragraph_t* para = &doc->paragraphs[i];
+        if (i > last && para->y == y) break;
+        para->y = y;
+        y += para->layout.num_lines * para->layout.line_height;
+    }
+    glyph_paragraph_t* tail = &doc->paragraphs[doc->num_paragraphs - 1];
+    doc->height = tail->y + tail->layout.height;
+
+    doc->dirty_first = (size_t)-1;
+    doc->dirty_last = 0;
+    return count;
+}
+
+/*
+ * Maps a point in document coordinates to the nearest caret position
+ *
+ * Only valid after glyph_document_update.
+ *
+ * Returns: Byte offset in the document text
+ */
+static inline size_t glyph_document_hit_test(const glyph_document_t* doc, float x, float y) {
+    if (!doc || !doc->paragraphs) return 0;
+    const glyph_paragraph_t* para = &doc->paragraphs[glyph_document_paragraph_at_y(doc, y)];
+    return para->start + glyph_text_hit_test(&para->layout, x, y - para->y);
+}
+
+/*
+ * Returns the caret rectangle for a byte offset in document coordinates
+ *
+ * Only valid after glyph_document_update.
+ */
+static inline glyph_rect_t glyph_document_caret_rect(const glyph_document_t* doc, size_t offset) {
+    glyph_rect_t rect = {0.0f, 0.0f, 0.0f, 0.0f};
+    if (!doc || !doc->paragraphs) return rect;
+    const glyph_paragraph_t* para = &doc->paragraphs[glyph_document_find_paragraph(doc, offset)];
+    rect = glyph_text_caret_rect(&para->layout, offset - para->start);
+    rect.y += para->y;
+    return rect;
+}
+
+/*
+ * Line-offset index over a large text buffer
+ *
+ * Stores the byte offset of every line start so any line can be located
+ * in O(1) and the line containing a byte offset in O(log n). The text is
+ * not copied, so the buffer may be memory-mapped. Indexing is incremental:
+ * calling glyph_line_index_update again after data was appended only scans
+ * the new bytes.
+ */
+typedef struct {
+    size_t* starts;       /* Byte offset of the first byte of each line */
+    size_t num_lines;     /* Number of lines (a text without '\n' has one line) */
+    size_t capacity;      /* Allocated entries in starts */
+    size_t indexed;       /* Number of bytes scanned so far */
+    glyph_allocator_t* allocator; /* Source of 'starts' (NULL = GLYPH_MALLOC); set before the first update */
+} glyph_line_index_t;
+
+/*
+ * Indexes the bytes of 'text' that were not scanned yet
+ *
+ * Parameters:
+ *   index: Index to update (zero-initialized before the first call)
+ *   text: Text buffer whose first index->indexed bytes are unchanged since the last call
+ *   len: Current length of the text in bytes (a shorter length restarts indexing)
+ *
+ * Returns: 0 on success, -1 on failure
+ */
+static inline int glyph_line_index_update(glyph_line_index_t* index, const char* text, size_t len) {
+    if (!index || (!text && len)) return -1;
+    if (len < index->indexed || index->num_lines == 0) {
+        index->num_lines = 0;
+        index->indexed = 0;
+        if (index->capacity == 0) {
+            index->starts = (size_t*)glyph__mem_alloc(index->allocator, 1024 * sizeof(size_t), GLYPH_MEMORY_LAYOUT);
+            if (!index->starts) return -1;
+            index->capacity = 1024;
+        }
+        index->starts[index->num_lines++] = 0;
+    }
+
+    const char* cursor = text + index->indexed;
+    const char* end = text + len;
+    while (cursor < end) {
+        const char* newline = (const char*)memchr(cursor, '\n', (size_t)(end - cursor));
+        if (!newline) break;
+        if (index->num_lines == index->capacity) {
+            size_t* grown = (size_t*)glyph__mem_realloc(index->allocator, index->starts, index->capacity * 2 * sizeof(size_t), GLYPH_MEMORY_LAYOUT);
+            if (!grown) return -1;
+            index->starts = grown;
+            index->capacity *= 2;
+        }
+        index->starts[index->num_lines++] = (size_t)(newline + 1 - text);
+        cursor = newline + 1;
+    }
+    index->indexed = len;
+    return 0;
+}
+
+/*
+ * Returns the byte range of a line, excluding its "\n" or "\r\n" terminator
+ *
+ * A '\r' ending the last line is dropped as well, so text whose final
+ * "\r\n" is cut short (or still being appended) reads the same.
+ *
+ * Parameters:
+ *   index: Line index
+ *   text: Indexed text
+ *   line: Line number (must be < index->num_lines)
+ *   start, end: Receive the byte range [start, end)
+ */
+static inline void glyph_line_index_range(const glyph_line_index_t* index, const char* text, size_t line, size_t* start, size_t* end) {
+    *start = index->starts[line];
+    if (line + 1 < index->num_lines) {
+        *end = index->starts[line + 1] - 1;
+    } else {
+        *end = index->indexed;
+    }
+    if (*end > *start && text[*end - 1] == '\r') (*end)--;
+}
+
+/* Returns the line containing a byte offset */
+static inline size_t glyph_line_index_find(const glyph_line_index_t* index, size_t offset) {
+    size_t lo = 0, hi = index->num_lines;
+    while (hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if (index->starts[mid] <= offset) lo = mid;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/* Frees the memory owned by a line index */
+static inline void glyph_line_index_free(glyph_line_index_t* index) {
+    if (!index) return;
+    glyph__mem_free(index->allocator, index->starts);
+    memset(index, 0, sizeof(*index));
+}
+
+#endif
@@ -0,0 +1,428 @@
+/*
+    MIT License
+
+    Copyright (c) 2025 Darek
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/*
+ * Glyph Soft Module - Headless CPU Text Rendering
+ *
+ * Renders text into memory without OpenGL, for servers, thumbnails and
+ * burned-in captions:
+ * - Targets are RGB glyph_image_t images or caller-owned RGBA/RGB framebuffers
+ * - Geometry comes from glyph_emit.h, so output matches the GL renderer
+ *   (same layout, kerning, effects, bilinear sampling and SDF threshold)
+ * - Quads are scan-converted into coverage spans that are alpha blended
+ *   16 bytes at a time with SSE2 (scalar fallback elsewhere)
+ *
+ * Define GLYPHGL_NO_SIMD to force the scalar blend.
+ */
+
+#ifndef __GLYPH_SOFT_H
+#define __GLYPH_SOFT_H
+
+#include "glyph_emit.h"
+
+#if !defined(GLYPHGL_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define GLYPH_SOFT__SSE2 1
+#include <emmintrin.h>
+#endif
+
+/*
+ * A CPU render target
+ *
+ * Rows are stored top to bottom. Channels are R, G, B (and A) in that order.
+ */
+typedef struct {
+    unsigned char* pixels;            /* First byte of the top row */
+    int width, height;                /* Size in pixels */
+    int stride;                       /* Bytes between the starts of consecutive rows */
+    int channels;                     /* 3 (RGB) or 4 (RGBA) */
+} glyph_surface_t;
+
+/*
+ * Software renderer state - atlas, coverage map and span scratch memory
+ *
+ * A renderer may only be used by one thread at a time.
+ */
+typedef struct {
+    glyph_atlas_t atlas;              /* Glyph atlas containing pre-rasterized character data */
+    unsigned char* coverage;          /* Single-channel copy of the atlas image */
+    uint32_t char_type;               /* Character encoding type (ASCII or UTF-8) */
+    unsigned char* span_alpha;        /* Per-byte blend factors of the current span */
+    unsigned char* span_color;        /* Row of the current color in target channel order */
+    size_t span_capacity;             /* Size of both span buffers in bytes */
+    uint32_t span_key;                /* Packed color and channel count held by span_color */
+    int initialized;                  /* Flag indicating if the renderer was successfully created */
+} glyph_soft_renderer_t;
+
+/*
+ * Wraps an RGB glyph_image_t as a render target
+ */
+static inline glyph_surface_t glyph_surface_from_image(glyph_image_t* image) {
+    glyph_surface_t surface;
+    memset(&surface, 0, sizeof(surface));
+    if (!image || !image->data) return surface;
+    surface.pixels = image->data;
+    surface.width = (int)image->width;
+    surface.height = (int)image->height;
+    surface.stride = (int)image->width * 3;
+    surface.channels = 3;
+    return surface;
+}
+
+/*
+ * Wraps a caller-owned framebuffer as a render target
+ *
+ * Parameters:
+ *   pixels: Top row first, R, G, B(, A) byte order
+ *   width, height: Size in pixels
+ *   stride: Bytes per row (0 = width * channels)
+ *   channels: 3 for RGB, 4 for RGBA
+ */
+static inline glyph_surface_t glyph_surface_create(unsigned char* pixels, int width, int height, int stride, int channels) {
+    glyph_surface_t surface;
+    memset(&surface, 0, sizeof(surface));
+    if (!pixels || width <= 0 || height <= 0 || (channels != 3 && channels != 4)) return surface;
+    surface.pixels = pixels;
+    surface.width = width;
+    surface.height = height;
+    surface.stride = stride > 0 ? stride : width * channels;
+    surface.channels = channels;
+    return surface;
+}
+
+/*
+ * Creates a software renderer
+ *
+ * Parameters are the same as for glyph_renderer_create, minus the shader effect.
+ *
+ * Returns: Renderer with 'initialized' set on success
+ */
+static inline glyph_soft_renderer_t glyph_soft_renderer_create(const char* font_path, float pixel_height, const char* charset,
+                                                               uint32_t char_type, int use_sdf) {
+    glyph_soft_renderer_t soft;
+    memset(&soft, 0, sizeof(soft));
+    soft.char_type = char_type;
+    soft.atlas = glyph_atlas_create(font_path, pixel_height, charset, char_type, use_sdf);
+    if (!soft.atlas.chars || !soft.atlas.image.data) {
+        #ifdef GLYPHGL_DEBUG
+        GLYPH_LOG("Failed to create font atlas\n");
+        #endif
+        return soft;
+    }
+
+    /* Keep only the red channel - glyph rasterization produces grayscale */
+    size_t texels = (size_t)soft.atlas.image.width * soft.atlas.image.height;
+    soft.coverage = (unsigned char*)GLYPH_MALLOC(texels);
+    if (!soft.coverage) {
+        glyph_atlas_free(&soft.atlas);
+        memset(&soft, 0, sizeof(soft));
+        return soft;
+    }
+    for (size_t i = 0; i < texels; i++) {
+        soft.coverage[i] = soft.atlas.image.data[i * 3];
+    }
+    soft.initialized = 1;
+    return soft;
+}
+
+/*
+ * Releases the atlas and scratch memory of a software renderer
+ */
+static inline void glyph_soft_renderer_free(glyph_soft_renderer_t* soft) {
+    if (!soft) return;
+    glyph_atlas_free(&soft->atlas);
+    GLYPH_FREE(soft->coverage);
+    GLYPH_FREE(soft->span_alpha);
+    GLYPH_FREE(soft->span_color);
+    memset(soft, 0, sizeof(*soft));
+}
+
+/*
+ * Blends 'n' bytes: dst = dst + (src - dst) * alpha / 255, rounded
+ *
+ * Works per byte, so the same kernel serves RGB and RGBA targets; for RGBA the
+ * source alpha byte is 255, which gives the usual "over" result in the alpha channel.
+ */
+static inline void glyph_soft__blend_bytes(unsigned char* dst, const unsigned char* src, const unsigned char* alpha, size_t n) {
+    size_t i = 0;
+#ifdef GLYPH_SOFT__SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi8((char)0xFF);
+    const __m128i c255 = _mm_set1_epi16(255);
+    const __m128i c128 = _mm_set1_epi16(128);
+    for (; i + 16 <= n; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(alpha + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(a, zero)) == 0xFFFF) continue;      /* Fully transparent */
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(a, ones)) == 0xFFFF) {              /* Fully opaque */
+            _mm_storeu_si128((__m128i*)(dst + i), s);
+            continue;
+        }
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+
+        __m128i a_lo = _mm_unpacklo_epi8(a, zero), a_hi = _mm_unpackhi_epi8(a, zero);
+        __m128i x_lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_sub_epi16(c255, a_lo)),
+                                     _mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), a_lo));
+        __m128i x_hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_sub_epi16(c255, a_hi)),
+                                     _mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), a_hi));
+
+        /* Exact rounded division by 255: (x + 128 + ((x + 128) >> 8)) >> 8 */
+        x_lo = _mm_add_epi16(x_lo, c128);
+        x_hi = _mm_add_epi16(x_hi, c128);
+        x_lo = _mm_srli_epi16(_mm_add_epi16(x_lo, _mm_srli_epi16(x_lo, 8)), 8);
+        x_hi = _mm_srli_epi16(_mm_add_epi16(x_hi, _mm_srli_epi16(x_hi, 8)), 8);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(x_lo, x_hi));
+    }
+#endif
+    for (; i < n; i++) {
+        unsigned int a = alpha[i];
+        unsigned int x = dst[i] * (255u - a) + src[i] * a + 128u;
+        dst[i] = (unsigned char)((x + (x >> 8)) >> 8);
+    }
+}
+
+/* State of one draw call, passed to glyph_soft__fill_quad through the emit callback */
+typedef struct {
+    glyph_soft_renderer_t* soft;
+    const glyph_surface_t* surface;
+    int sdf;
+} glyph_soft__target_t;
+
+/*
+ * Scan-converts one quad into coverage spans and blends them into the target
+ *
+ * Pixels whose centers lie inside the quad are covered, like GL rasterization.
+ * Italic quads shift each row by the interpolated skew.
+ */
+static inline void glyph_soft__fill_quad(const glyph_quad_t* quad, void* user) {
+    glyph_soft__target_t* target = (glyph_soft__target_t*)user;
+    glyph_soft_renderer_t* soft = target->soft;
+    const glyph_surface_t* surface = target->surface;
+    float qw = quad->x1 - quad->x0, qh = quad->y1 - quad->y0;
+    if (qw <= 0.0f || qh <= 0.0f) return;
+
+    int solid = quad->u0 == GLYPHGL_SOLID_UV && quad->v0 == GLYPHGL_SOLID_UV;
+    int channels = surface->channels;
+    int row_start = (int)ceilf(quad->y0 - 0.5f);
+    int row_end = (int)ceilf(quad->y1 - 0.5f);
+    if (row_start < 0) row_start = 0;
+    if (row_end > surface->height) row_end = surface->height;
+
+    float tex_w = (float)soft->atlas.image.width;
+    float tex_h = (float)soft->atlas.image.height;
+    float du = (quad->u1 - quad->u0) / qw * tex_w;  /* Texels per pixel */
+    int32_t du_fixed = (int32_t)(du * 65536.0f);
+    int sdf = target->sdf;
+    int tex_stride = (int)soft->atlas.image.width;
+    int tex_max_x = tex_stride - 1;
+    int tex_max_y = (int)soft->atlas.image.height - 1;
+
+    for (int row = row_start; row < row_end; row++) {
+        float t = (row + 0.5f - quad->y0) / qh;
+        float left = quad->x0 + quad->skew * t;
+        int col_start = (int)ceilf(left - 0.5f);
+        int col_end = (int)ceilf(left + qw - 0.5f);
+        if (col_start < 0) col_start = 0;
+        if (col_end > surface->width) col_end = surface->width;
+        if (col_start >= col_end) continue;
+
+        /* Coverage, expanded to one blend factor per target byte */
+        unsigned char* alpha = soft->span_alpha;
+        int n = col_end - col_start;
+        if (solid) {
+            memset(alpha, 255, (size_t)n * channels);
+        } else {
+            /* Bilinear sampling like GL_LINEAR (texel centers at +0.5, clamp to edge) in 16.16 fixed point */
+            float ty = (quad->v0 + (quad->v1 - quad->v0) * t) * tex_h - 0.5f;
+            float fy0 = floorf(ty);
+            int y0 = (int)fy0, y1 = y0 + 1;
+            unsigned int fy = (unsigned int)((ty - fy0) * 256.0f);
+            y0 = y0 < 0 ? 0 : (y0 > tex_max_y ? tex_max_y : y0);
+            y1 = y1 < 0 ? 0 : (y1 > tex_max_y ? tex_max_y : y1);
+            const unsigned char* row0 = soft->coverage + (size_t)y0 * tex_stride;
+            const unsigned char* row1 = soft->coverage + (size_t)y1 * tex_stride;
+
+            float tx = quad->u0 * tex_w + (col_start + 0.5f - left) * du - 0.5f;
+            int32_t fx_pos = (int32_t)floorf(tx * 65536.0f);
+            int32_t fx_last = fx_pos + du_fixed * (n - 1);
+            unsigned int any = 0;
+            if (fx_pos >= 0 && (fx_last >> 16) < tex_max_x) {
+                /* The whole span samples inside the atlas, so no clamping is needed */
+                for (int i = 0; i < n; i++, fx_pos += du_fixed) {
+                    const unsigned char* p0 = row0 + (fx_pos >> 16);
+                    const unsigned char* p1 = row1 + (fx_pos >> 16);
+                    unsigned int fx = ((uint32_t)fx_pos >> 8) & 255u;
+                    unsigned int top = p0[0] * (256u - fx) + p0[1] * fx;
+                    unsigned int bottom = p1[0] * (256u - fx) + p1[1] * fx;
+                    unsigned int c = (top * (256u - fy) + bottom * fy + 32768u) >> 16;
+                    alpha[i] = (unsigned char)c;
+                    any |= c;
+                }
+            } else {
+                for (int i = 0; i < n; i++, fx_pos += du_fixed) {
+                    int x0 = fx_pos >> 16, x1 = x0 + 1;
+                    unsigned int fx = ((uint32_t)fx_pos >> 8) & 255u;
+                    x0 = x0 < 0 ? 0 : (x0 > tex_max_x ? tex_max_x : x0);
+                    x1 = x1 < 0 ? 0 : (x1 > tex_max_x ? tex_max_x : x1);
+                    unsigned int top = row0[x0] * (256u - fx) + row0[x1] * fx;
+                    unsigned int bottom = row1[x0] * (256u - fx) + row1[x1] * fx;
+                    unsigned int c = (top * (256u - fy) + bottom * fy + 32768u) >> 16;
+                    alpha[i] = (unsigned char)c;
+                    any |= c;
+                }
+            }
+
+            if (sdf) {
+                /* Same threshold as the SDF shader path */
+                any = 0;
+                for (int i = 0; i < n; i++) {
+                    alpha[i] = alpha[i] < 128 ? 255 : 0;
+                    any |= alpha[i];
+                }
+            }
+            if (!any) continue;  /* Empty glyph margin, nothing to blend */
+
+            /* Expand in place from the end so unread coverage is never overwritten */
+            if (channels == 4) {
+                for (int i = n - 1; i >= 0; i--) {
+                    uint32_t c4 = alpha[i] * 0x01010101u;
+                    memcpy(alpha + i * 4, &c4, 4);
+                }
+            } else {
+                for (int i = n - 1; i >= 0; i--) {
+                    unsigned char c = alpha[i];
+                    alpha[i * 3 + 0] = alpha[i * 3 + 1] = alpha[i * 3 + 2] = c;
+                }
+            }
+        }
+
+        unsigned char* dst = surface->pixels + (size_t)row * surface->stride + (size_t)col_start * channels;
+        glyph_soft__blend_bytes(dst, soft->span_color + (size_t)col_start * channels, alpha, (size_t)n * channels);
+    }
+}
+
+/*
+ * Prepares the span buffers for a target and color
+ *
+ * The color row is only rebuilt when the color, channel count or width changes.
+ *
+ * Returns: 1 on success, 0 on allocation failure
+ */
+static inline int glyph_soft__prepare(glyph_soft_renderer_t* soft, const glyph_surface_t* surface, float r, float g, float b) {
+    size_t bytes = (size_t)surface->width * surface->channels;
+    unsigned char rgba[4];
+    rgba[0] = (unsigned char)(r <= 0.0f ? 0 : r >= 1.0f ? 255 : (int)(r * 255.0f + 0.5f));
+    rgba[1] = (unsigned char)(g <= 0.0f ? 0 : g >= 1.0f ? 255 : (int)(g * 255.0f + 0.5f));
+    rgba[2] = (unsigned char)(b <= 0.0f ? 0 : b >= 1.0f ? 255 : (int)(b * 255.0f + 0.5f));
+    rgba[3] = 255;
+    uint32_t key = (uint32_t)rgba[0] | ((uint32_t)rgba[1] << 8) | ((uint32_t)rgba[2] << 16) | ((uint32_t)surface->channels << 24);
+
+    if (bytes > soft->span_capacity) {
+        unsigned char* alpha = (unsigned char*)GLYPH_REALLOC(soft->span_alpha, bytes);
+        if (!alpha) return 0;
+        soft->span_alpha = alpha;
+        unsigned char* color = (unsigned char*)GLYPH_REALLOC(soft->span_color, bytes);
+        if (!color) return 0;
+        soft->span_color = color;
+        soft->span_capacity = bytes;
+        soft->span_key = 0;
+    } else if (soft->span_key == key) {
+        return 1;
+    }
+    for (size_t i = 0; i + surface->channels <= soft->span_capacity; i += surface->channels) {
+        memcpy(soft->span_color + i, rgba, (size_t)surface->channels);
+    }
+    soft->span_key = key;
+    return 1;
+}
+
+/*
+ * Renders a line of text into a CPU render target
+ *
+ * Same parameters and output as glyph_renderer_draw_text. Glyphs outside the
+ * surface are culled before they are rasterized.
+ *
+ * Parameters:
+ *   soft: Initialized software renderer
+ *   surface: Render target (glyph_surface_from_image or glyph_surface_create)
+ *   text: UTF-8 or ASCII string to render
+ *   x, y: Baseline start position in pixels
+ *   scale: Text scaling factor (1.0 = normal size)
+ *   r, g, b: Text color as RGB values (0.0-1.0 range)
+ *   effects: Bitmask of text effects (GLYPHGL_BOLD, GLYPHGL_ITALIC, GLYPHGL_UNDERLINE, GLYPHGL_SDF)
+ *
+ * Returns: Number of quads rasterized, or -1 on failure
+ */
+static inline int glyph_soft_renderer_draw_text(glyph_soft_renderer_t* soft, const glyph_surface_t* surface, const char* text,
+                                                float x, float y, float scale, float r, float g, float b, int effects) {
+    if (!soft || !soft->initialized || !surface || !surface->pixels || !text) return -1;
+    if (!glyph_soft__prepare(soft, surface, r, g, b)) return -1;
+
+    glyph_rect_t bounds = {0.0f, 0.0f, (float)surface->width, (float)surface->height};
+    glyph_emit_options_t options;
+    options.effects = effects;
+    options.visible = &bounds;
+    options.char_type = soft->char_type;
+
+    glyph_soft__target_t target;
+    target.soft = soft;
+    target.surface = surface;
+    target.sdf = (effects & GLYPHGL_SDF) != 0;
+    return (int)glyph_emit_text(&soft->atlas, text, strlen(text), x, y, scale, &options, glyph_soft__fill_quad, &target);
+}
+
+/*
+ * Renders a precomputed layout into a CPU render target
+ *
+ * The layout must have been computed with this renderer's atlas.
+ *
+ * Parameters:
+ *   soft: Initialized software renderer
+ *   surface: Render target
+ *   layout: Layout produced by glyph_layout_text
+ *   x, y: Position of the top-left corner of the layout box
+ *   r, g, b: Text color as RGB values (0.0-1.0 range)
+ *   effects: Bitmask of text effects (GLYPHGL_BOLD, GLYPHGL_ITALIC, GLYPHGL_UNDERLINE, GLYPHGL_SDF)
+ *
+ * Returns: Number of quads rasterized, or -1 on failure
+ */
+static inline int glyph_soft_renderer_draw_layout(glyph_soft_renderer_t* soft, const glyph_surface_t* surface,
+                                                  const glyph_layout_t* layout, float x, float y,
+                                                  float r, float g, float b, int effects) {
+    if (!soft || !soft->initialized || !surface || !surface->pixels || !layout) return -1;
+    if (!glyph_soft__prepare(soft, surface, r, g, b)) return -1;
+
+    glyph_rect_t bounds = {0.0f, 0.0f, (float)surface->width, (float)surface->height};
+    glyph_emit_options_t options;
+    options.effects = effects;
+    options.visible = &bounds;
+    options.char_type = soft->char_type;
+
+    glyph_soft__target_t target;
+    target.soft = soft;
+    target.surface = surface;
+    target.sdf = (effects & GLYPHGL_SDF) != 0;
+    return (int)glyph_emit_layout(&soft->atlas, layout, x, y, &options, glyph_soft__fill_quad, &target);
+}
+
+#endif
@@ -48,6 +48,7 @@ typedef struct {
     int index_map;                 /* Offset to character-to-glyph mapping */
     int indexToLocFormat;          /* Format of loca table (short/long offsets) */
     float scale;                   /* Current font scale factor */
+    glyph_allocator_t* allocator;  /* Source of font data and glyph bitmaps (NULL = GLYPH_MALLOC) */
 } glyph_font_t;
 
 /*
@@ -81,9 +82,13 @@ static inline int glyph_ttf_find_glyph_index(const glyph_font_t* font, int codep
 static inline void glyph_ttf_get_glyph_bbox(const glyph_font_t* font, int glyph_index, glyph_bbox_t* bbox);
 static inline unsigned char* glyph_ttf_get_glyph_bitmap(const glyph_font_t* font, int glyph_index, float scale_x, float scale_y, int* width, int* height, int* xoff, int* yoff);
 static inline void glyph_ttf_free_bitmap(unsigned char* bitmap);
+static inline void glyph_ttf_free_font_bitmap(const glyph_font_t* font, unsigned char* bitmap);
 static inline unsigned char* glyph_ttf_get_glyph_sdf_bitmap(unsigned char* bitmap, int w, int h, int spread);
+static inline unsigned char* glyph_ttf_get_glyph_sdf_bitmap_ex(unsigned char* bitmap, int w, int h, int spread, glyph_allocator_t* allocator);
 static inline float glyph_ttf_scale_for_pixel_height(const glyph_font_t* font, float pixels);
 static inline int glyph_ttf_get_glyph_advance(const glyph_font_t* font, int glyph_index);
+static inline void glyph_ttf_get_vmetrics(const glyph_font_t* font, int* ascent, int* descent, int* line_gap);
+static inline int glyph_ttf_get_kern_advance(const glyph_font_t* font, int left_glyph, int right_glyph);
 
 static int glyph_ttf__isfont(const unsigned char* font);
 static int glyph_ttf__find_table(const unsigned char* data, int fontstart, const char* tag);
@@ -149,6 +154,7 @@ static int glyph_ttf__get32(const unsigned char* data, int offset) {
 static inline int glyph_ttf_init(glyph_font_t* font, const unsigned char* data, int offset) {
     font->data = (unsigned char*)data;
     font->fontstart = offset;
+    font->allocator = NULL;
     if (!glyph_ttf__isfont(data + offset)) return 0;
 
     font->cmap = glyph_ttf__find_table(data, offset, "cmap");
@@ -274,6 +280,83 @@ static inline float glyph_ttf_scale_for_pixel_height(const glyph_font_t* font, f
     return pixels / unitsPerEm;
 }
 
+/*
+ * Reads the vertical line metrics from the hhea table
+ *
+ * Parameters:
+ *   font: Font structure
+ *   ascent: Receives the typographic ascender in font units (may be NULL)
+ *   descent: Receives the typographic descender in font units, usually negative (may be NULL)
+ *   line_gap: Receives the additional spacing between lines in font units (may be NULL)
+ */
+static inline void glyph_ttf_get_vmetrics(const glyph_font_t* font, int* ascent, int* descent, int* line_gap) {
+    const unsigned char* data = font->data;
+    if (ascent) *ascent = glyph_ttf__get16(data, font->hhea + 4);
+    if (descent) *descent = glyph_ttf__get16(data, font->hhea + 6);
+    if (line_gap) *line_gap = glyph_ttf__get16(data, font->hhea + 8);
+}
+
+/*
+ * Locates the kerning pairs of the first horizontal format 0 'kern' subtable
+ *
+ * Only the Microsoft 'kern' layout (version 0) is supported; fonts that keep
+ * their kerning in GPOS report no pairs.
+ *
+ * Parameters:
+ *   font: Font structure
+ *   num_pairs: Receives the number of 6-byte pair records
+ *
+ * Returns: Offset to the first pair record, or 0 if no usable subtable exists
+ */
+static inline int glyph_ttf__find_kern_pairs(const glyph_font_t* font, int* num_pairs) {
+    const unsigned char* data = font->data;
+    *num_pairs = 0;
+    if (!font->kern) return 0;
+    if (glyph_ttf__get16u(data, font->kern) != 0) return 0; /* Apple 'kern' tables not supported */
+
+    int num_tables = glyph_ttf__get16u(data, font->kern + 2);
+    int offset = font->kern + 4;
+    for (int i = 0; i < num_tables; ++i) {
+        int length = glyph_ttf__get16u(data, offset + 2);
+        int coverage = glyph_ttf__get16u(data, offset + 4);
+        /* Horizontal (bit 0), not minimum/cross-stream, format 0 */
+        if ((coverage & 0x0007) == 0x0001 && (coverage >> 8) == 0) {
+            *num_pairs = glyph_ttf__get16u(data, offset + 6);
+            return offset + 14;
+        }
+        offset += length;
+    }
+    return 0;
+}
+
+/*
+ * Returns the kerning adjustment between two glyphs from the 'kern' table
+ *
+ * Pairs are sorted by (left, right) so the lookup is a binary search.
+ *
+ * Parameters:
+ *   font: Font structure
+ *   left_glyph, right_glyph: Glyph indices of the pair
+ *
+ * Returns: Advance adjustment in font units (0 if the pair is not kerned)
+ */
+static inline int glyph_ttf_get_kern_advance(const glyph_font_t* font, int left_glyph, int right_glyph) {
+    int num_pairs;
+    int pairs = glyph_ttf__find_kern_pairs(font, &num_pairs);
+    if (!pairs) return 0;
+
+    uint32_t needle = ((uint32_t)left_glyph << 16) | (uint32_t)right_glyph;
+    int lo = 0, hi = num_pairs - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) >> 1;
+        uint32_t key = (uint32_t)glyph_ttf__get32(font->data, pairs + mid * 6);
+        if (key < needle) lo = mid + 1;
+        else if (key > needle) hi = mid - 1;
+        else return glyph_ttf__get16(font->data, pairs + mid * 6 + 4);
+    }
+    return 0;
+}
+
 /*
  * Calculates the offset to a specific glyph's data in the glyf table
  *
@@ -337,9 +420,10 @@ static void glyph_ttf__add_edge(float* accum, int w, int h, float x0, float y0,
     }
 }
 
-static void glyph_ttf__rasterize_shape(unsigned char* bitmap, int w, int h, glyph_point_t** contours, int* contour_sizes, int num_contours) {
-    float* accum = (float*)calloc(w * h, sizeof(float));
+static void glyph_ttf__rasterize_shape(glyph_allocator_t* allocator, unsigned char* bitmap, int w, int h, glyph_point_t** contours, int* contour_sizes, int num_contours) {
+    float* accum = (float*)glyph__mem_alloc(allocator, (size_t)w * h * sizeof(float), GLYPH_MEMORY_SCRATCH);
     if (!accum) return;
+    memset(accum, 0, (size_t)w * h * sizeof(float));
     
     for (int c = 0; c < num_contours; ++c) {
         glyph_point_t* points = contours[c];
@@ -405,11 +489,12 @@ static void glyph_ttf__rasterize_shape(unsigned char* bitmap, int w, int h, glyp
         }
     }
     
-    GLYPH_FREE(accum);
+    glyph__mem_free(allocator, accum);
 }
 
 static inline unsigned char* glyph_ttf_get_glyph_bitmap(const glyph_font_t* font, int glyph_index, float scale_x, float scale_y, int* width, int* height, int* xoff, int* yoff) {
     const unsigned char* data = font->data;
+    glyph_allocator_t* allocator = font->allocator;
     int g = glyph_ttf__get_glyph_offset(font, glyph_index);
     if (g < 0) {
         *width = 0;
@@ -436,8 +521,9 @@ static inline unsigned char* glyph_ttf_get_glyph_bitmap(const glyph_font_t* font
             return NULL;
         }
 
-        unsigned char* bitmap = (unsigned char*)calloc(w * h, 1);
+        unsigned char* bitmap = (unsigned char*)glyph__mem_alloc(allocator, (size_t)w * h, GLYPH_MEMORY_SCRATCH);
         if (!bitmap) return NULL;
+        memset(bitmap, 0, (size_t)w * h);
 
         int endPtsOfContours = g + 10;
         int instructionLength = glyph_ttf__get16u(data, endPtsOfContours + numberOfContours * 2);
@@ -447,15 +533,15 @@ static inline unsigned char* glyph_ttf_get_glyph_bitmap(const glyph_font_t* font
         int lastEndPt = glyph_ttf__get16u(data, endPtsOfContours + (numberOfContours - 1) * 2);
         int n_points = lastEndPt + 1;
 
-        unsigned char* point_flags = (unsigned char*)GLYPH_MALLOC(n_points);
-        int* x_coords = (int*)GLYPH_MALLOC(n_points * sizeof(int));
-        int* y_coords = (int*)GLYPH_MALLOC(n_points * sizeof(int));
+        unsigned char* point_flags = (unsigned char*)glyph__mem_alloc(allocator, n_points, GLYPH_MEMORY_SCRATCH);
+        int* x_coords = (int*)glyph__mem_alloc(allocator, n_points * sizeof(int), GLYPH_MEMORY_SCRATCH);
+        int* y_coords = (int*)glyph__mem_alloc(allocator, n_points * sizeof(int), GLYPH_MEMORY_SCRATCH);
 
         if (!x_coords || !y_coords || !point_flags) {
-            GLYPH_FREE(x_coords);
-            GLYPH_FREE(y_coords);
-            GLYPH_FREE(point_flags);
-            GLYPH_FREE(bitmap);
+            glyph__mem_free(allocator, x_coords);
+            glyph__mem_free(allocator, y_coords);
+            glyph__mem_free(allocator, point_flags);
+            glyph__mem_free(allocator, bitmap);
             return NULL;
         }
 
@@ -500,16 +586,16 @@ static inline unsigned char* glyph_ttf_get_glyph_bitmap(const glyph_font_t* font
             y_coords[i] = y;
         }
 
-        glyph_point_t** contours = (glyph_point_t**)GLYPH_MALLOC(numberOfContours * sizeof(glyph_point_t*));
-        int* contour_sizes = (int*)GLYPH_MALLOC(numberOfContours * sizeof(int));
+        glyph_point_t** contours = (glyph_point_t**)glyph__mem_alloc(allocator, numberOfContours * sizeof(glyph_point_t*), GLYPH_MEMORY_SCRATCH);
+        int* contour_sizes = (int*)glyph__mem_alloc(allocator, numberOfContours * sizeof(int), GLYPH_MEMORY_SCRATCH);
         
         if (!contours || !contour_sizes) {
-            GLYPH_FREE(contours);
-            GLYPH_FREE(contour_sizes);
-            GLYPH_FREE(x_coords);
-            GLYPH_FREE(y_coords);
-            GLYPH_FREE(point_flags);
-            GLYPH_FREE(bitmap);
+            glyph__mem_free(allocator, contours);
+            glyph__mem_free(allocator, contour_sizes);
+            glyph__mem_free(allocator, x_coords);
+            glyph__mem_free(allocator, y_coords);
+            glyph__mem_free(allocator, point_flags);
+            glyph__mem_free(allocator, bitmap);
             return NULL;
         }
         
@@ -518,7 +604,7 @@ static inline unsigned char* glyph_ttf_get_glyph_bitmap(const glyph_font_t* font
             int end_pt = glyph_ttf__get16u(data, endPtsOfContours + c * 2);
             int contour_len = end_pt - start_pt + 1;
             
-            glyph_point_t* contour = (glyph_point_t*)GLYPH_MALLOC(contour_len * 3 * sizeof(glyph_point_t));
+            glyph_point_t* contour = (glyph_point_t*)glyph__mem_alloc(allocator, contour_len * 3 * sizeof(glyph_point_t), GLYPH_MEMORY_SCRATCH);
             if (!contour) {
                 contours[c] = NULL;
                 contour_sizes[c] = 0;
@@ -546,17 +632,17 @@ static inline unsigned char* glyph_ttf_get_glyph_bitmap(const glyph_font_t* font
             contour_sizes[c] = out_idx;
         }
         
-        glyph_ttf__rasterize_shape(bitmap, w, h, contours, contour_sizes, numberOfContours);
+        glyph_ttf__rasterize_shape(allocator, bitmap, w, h, contours, contour_sizes, numberOfContours);
         
         for (int c = 0; c < numberOfContours; ++c) {
-            GLYPH_FREE(contours[c]);
+            glyph__mem_free(allocator, contours[c]);
         }
-        GLYPH_FREE(contours);
-        GLYPH_FREE(contour_sizes);
+        glyph__mem_free(allocator, contours);
+        glyph__mem_free(allocator, contour_sizes);
 
-        GLYPH_FREE(x_coords);
-        GLYPH_FREE(y_coords);
-        GLYPH_FREE(point_flags);
+        glyph__mem_free(allocator, x_coords);
+        glyph__mem_free(allocator, y_coords);
+        glyph__mem_free(allocator, point_flags);
 
         *width = w;
         *height = h;
@@ -577,6 +663,16 @@ static inline void glyph_ttf_free_bitmap(unsigned char* bitmap) {
     GLYPH_FREE(bitmap);
 }
 
+/*
+ * Frees a bitmap returned by glyph_ttf_get_glyph_bitmap for 'font'
+ *
+ * Required instead of glyph_ttf_free_bitmap when the font was loaded with
+ * an allocator; works for any font.
+ */
+static inline void glyph_ttf_free_font_bitmap(const glyph_font_t* font, unsigned char* bitmap) {
+    glyph__mem_free(font->allocator, bitmap);
+}
+
 #include "glyph_image.h"
 
 static void glyph_ttf_debug_glyph(const glyph_font_t* font, int glyph_index) {
@@ -642,17 +738,29 @@ static glyph_image_t glyph_ttf_render_glyph_to_image(const glyph_font_t* font, i
             img.data[index + 2] = (unsigned char)((b * alpha) / 255);
         }
     }
-    glyph_ttf_free_bitmap(bitmap);
+    glyph_ttf_free_font_bitmap(font, bitmap);
     return img;
 }
 
-static int glyph_ttf_load_font_from_file(glyph_font_t* font, const char* filename) {
+/*
+ * Loads a font file, taking the font data and all later glyph bitmaps and
+ * rasterizer scratch from 'allocator' (NULL = GLYPH_MALLOC)
+ *
+ * Parameters:
+ *   font: Font to initialize
+ *   filename: Path to the TrueType file
+ *   allocator: Allocator kept in font->allocator until glyph_ttf_free_font
+ *
+ * Returns: 1 on success, 0 on failure
+ */
+static int glyph_ttf_load_font_from_file_ex(glyph_font_t* font, const char* filename, glyph_allocator_t* allocator) {
+    GLYPH__TRACE_BEGIN(trace_start);
     FILE* f = fopen(filename, "rb");
     if (!f) return 0;
     fseek(f, 0, SEEK_END);
     size_t size = ftell(f);
     fseek(f, 0, SEEK_SET);
-    unsigned char* data = (unsigned char*)GLYPH_MALLOC(size);
+    unsigned char* data = (unsigned char*)glyph__mem_alloc(allocator, size, GLYPH_MEMORY_FONT);
     if (!data) {
         fclose(f);
         return 0;
@@ -660,12 +768,21 @@ static int glyph_ttf_load_font_from_file(glyph_font_t* font, const char* filenam
     fread(data, 1, size, f);
     fclose(f);
     int result = glyph_ttf_init(font, data, 0);
-    if (!result) GLYPH_FREE(data);
+    font->allocator = allocator;
+    if (!result) {
+        glyph__mem_free(allocator, data);
+        font->data = NULL;
+    }
+    GLYPH__TRACE_END(trace_start, "font_load", "bytes", size);
     return result;
 }
 
+static int glyph_ttf_load_font_from_file(glyph_font_t* font, const char* filename) {
+    return glyph_ttf_load_font_from_file_ex(font, filename, NULL);
+}
+
 static void glyph_ttf_free_font(glyph_font_t* font) {
-    if (font->data) GLYPH_FREE(font->data);
+    if (font->data) glyph__mem_free(font->allocator, font->data);
     font->data = NULL;
 }
 
@@ -685,14 +802,23 @@ static void glyph_ttf_free_font(glyph_font_t* font) {
  *          Negative distances (inside) map to 0-127, positive (outside) to 128-255
  */
 static inline unsigned char* glyph_ttf_get_glyph_sdf_bitmap(unsigned char* bitmap, int w, int h, int spread) {
+    return glyph_ttf_get_glyph_sdf_bitmap_ex(bitmap, w, h, spread, NULL);
+}
+
+/*
+ * Same as glyph_ttf_get_glyph_sdf_bitmap, taking the result and its scratch
+ * buffers from 'allocator' (NULL = GLYPH_MALLOC). Free the result with
+ * glyph_ttf_free_font_bitmap on a font that uses the same allocator.
+ */
+static inline unsigned char* glyph_ttf_get_glyph_sdf_bitmap_ex(unsigned char* bitmap, int w, int h, int spread, glyph_allocator_t* allocator) {
     /* Create binary mask from alpha bitmap */
-    unsigned char* mask = (unsigned char*)GLYPH_MALLOC(w * h);
+    unsigned char* mask = (unsigned char*)glyph__mem_alloc(allocator, w * h, GLYPH_MEMORY_SCRATCH);
     for(int i = 0; i < w * h; i++) {
         mask[i] = bitmap[i] > 127 ? 1 : 0;  /* Threshold to binary */
     }
 
     /* Distance transform for outside distances (dt1) */
-    float* dt1 = (float*)GLYPH_MALLOC(w * h * sizeof(float));
+    float* dt1 = (float*)glyph__mem_alloc(allocator, w * h * sizeof(float), GLYPH_MEMORY_SCRATCH);
     for(int i = 0; i < w * h; i++) dt1[i] = mask[i] ? 0.0f : 1e9f;  /* Init distances */
 
     /* Forward pass (left to right, top to bottom) */
@@ -718,7 +844,7 @@ static inline unsigned char* glyph_ttf_get_glyph_sdf_bitmap(unsigned char* bitma
     }
 
     /* Distance transform for inside distances (dt0) */
-    float* dt0 = (float*)GLYPH_MALLOC(w * h * sizeof(float));
+    float* dt0 = (float*)glyph__mem_alloc(allocator, w * h * sizeof(float), GLYPH_MEMORY_SCRATCH);
     for(int i = 0; i < w * h; i++) dt0[i] = mask[i] ? 1e9f : 0.0f;  /* Init distances */
 
     /* Forward pass for inside distances */
@@ -744,7 +870,7 @@ static inline unsigned char* glyph_ttf_get_glyph_sdf_bitmap(unsigned char* bitma
     }
 
     /* Generate final SDF bitmap */
-    unsigned char* sdf = (unsigned char*)GLYPH_MALLOC(w * h);
+    unsigned char* sdf = (unsigned char*)glyph__mem_alloc(allocator, w * h, GLYPH_MEMORY_SCRATCH);
     for(int i = 0; i < w * h; i++) {
         /* Calculate signed distance (negative inside, positive outside) */
         float dist = mask[i] ? -dt0[i] : dt1[i];
@@ -756,9 +882,9 @@ static inline unsigned char* glyph_ttf_get_glyph_sdf_bitmap(unsigned char* bitma
     }
 
     /* Clean up temporary buffers */
-    GLYPH_FREE(mask);
-    GLYPH_FREE(dt1);
-    GLYPH_FREE(dt0);
+    glyph__mem_free(allocator, mask);
+    glyph__mem_free(allocator, dt1);
+    glyph__mem_free(allocator, dt0);
     return sdf;
 }
 
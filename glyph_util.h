@@ -5,6 +5,9 @@
  * utilities for the GlyphGL library. All memory operations can be overridden
  * by defining custom GLYPH_MALLOC, GLYPH_FREE, and GLYPH_REALLOC macros before
  * including this header, allowing integration with custom allocators.
+ * Fonts, atlases and renderers can additionally be given a glyph_allocator_t
+ * that routes their memory through user callbacks and accounts for it; the
+ * layouts, documents and text views built on them inherit it.
  *
  * The debugging system provides conditional logging that can be enabled by
  * defining GLYPHGL_DEBUG before including GlyphGL headers.
@@ -15,6 +18,7 @@
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 
 /* Portable byte swap functions for C99 compatibility */
 static inline uint16_t glyph__bswap16(uint16_t val) {
@@ -25,6 +29,158 @@ static inline uint32_t glyph__bswap32(uint32_t val) {
     return ((val & 0xFF) << 24) | ((val & 0xFF00) << 8) | ((val & 0xFF0000) >> 8) | ((val & 0xFF000000) >> 24);
 }
 
+/* One 8-byte round of glyph__hash64 */
+static inline uint64_t glyph__hash64_round(uint64_t h, uint64_t word) {
+    h ^= word * 0x87C37B91114253D5ull;
+    return ((h << 31) | (h >> 33)) * 0x4CF5AD432745937Full;
+}
+
+/*
+ * 64-bit hash used as the key for the text caches
+ *
+ * Consumes the data 8 bytes per round (the tail is zero-padded) and ends with
+ * the MurmurHash3 finalizer, so even short keys spread over all 64 bits.
+ */
+static inline uint64_t glyph__hash64(const void* data, size_t len, uint64_t seed) {
+    const unsigned char* p = (const unsigned char*)data;
+    uint64_t h = seed ^ (len * 0x9E3779B97F4A7C15ull);
+    uint64_t word;
+    for (; len >= 8; p += 8, len -= 8) {
+        memcpy(&word, p, 8);
+        h = glyph__hash64_round(h, word);
+    }
+    if (len) {
+        word = 0;
+        memcpy(&word, p, len);
+        h = glyph__hash64_round(h, word);
+    }
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+/*
+ * One-time initialization guard for lazily built global state
+ *
+ * glyph__once_begin returns 1 to exactly one caller, which runs the
+ * initialization and then calls glyph__once_end. Callers arriving while it
+ * runs wait for it to finish; they and all later callers get 0. Passing
+ * success = 0 to glyph__once_end resets the guard so the next caller retries
+ * (used by the GL loader when no context was current yet).
+ *
+ * Uses compiler atomics (GCC/Clang builtins, MSVC interlocked intrinsics);
+ * other compilers get a plain flag, which is only safe single-threaded.
+ */
+typedef volatile long glyph_once_t;
+#define GLYPH_ONCE_INIT 0
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+    #include <windows.h>
+    #define GLYPH__ONCE_LOAD(p) _InterlockedOr((p), 0)
+    #define GLYPH__ONCE_STORE(p, v) _InterlockedExchange((p), (v))
+    #define GLYPH__ONCE_CLAIM(p) (_InterlockedCompareExchange((p), 1, 0) == 0)
+    #define GLYPH__ONCE_YIELD() SwitchToThread()
+#elif defined(__GNUC__) || defined(__clang__)
+    #if defined(_WIN32)
+        #include <windows.h>
+        #define GLYPH__ONCE_YIELD() SwitchToThread()
+    #else
+        #include <sched.h>
+        #define GLYPH__ONCE_YIELD() sched_yield()
+    #endif
+    #define GLYPH__ONCE_LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+    #define GLYPH__ONCE_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+    #define GLYPH__ONCE_CLAIM(p) glyph__once_claim(p)
+    static inline int glyph__once_claim(glyph_once_t* once) {
+        long expected = 0;
+        return __atomic_compare_exchange_n(once, &expected, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE);
+    }
+#else
+    #define GLYPH__ONCE_LOAD(p) (*(p))
+    #define GLYPH__ONCE_STORE(p, v) (*(p) = (v))
+    #define GLYPH__ONCE_CLAIM(p) (*(p) == 0 ? (*(p) = 1, 1) : 0)
+    #define GLYPH__ONCE_YIELD() ((void)0)
+#endif
+
+/* Guard states: 0 = not run, 1 = running, 2 = done */
+static inline int glyph__once_begin(glyph_once_t* once) {
+    for (;;) {
+        long state = GLYPH__ONCE_LOAD(once);
+        if (state == 2) return 0;
+        if (state == 0 && GLYPH__ONCE_CLAIM(once)) return 1;
+        if (state == 1) GLYPH__ONCE_YIELD();
+    }
+}
+
+static inline void glyph__once_end(glyph_once_t* once, int success) {
+    GLYPH__ONCE_STORE(once, success ? 2 : 0);
+}
+
+/* Returns 1 once the guarded initialization has completed successfully */
+static inline int glyph__once_done(glyph_once_t* once) {
+    return GLYPH__ONCE_LOAD(once) == 2;
+}
+
+/*
+ * Executor hook for the library's parallelizable work
+ *
+ * GlyphGL never creates threads. Work that splits into independent tasks
+ * (per-glyph rasterization and SDF generation in glyph_atlas_create, PNG row
+ * filtering, paragraph layout in glyph_document_update) is handed to the
+ * executor installed with glyph_set_executor, so it runs on the host's job
+ * system. Without an executor everything runs serially on the calling thread.
+ *
+ * submit receives a batch of 'count' tasks; it must eventually call
+ * func(arg, i) exactly once for every i in [0, count), on any threads and in
+ * any order, and returns a handle for the batch. wait(user, handle) must not
+ * return before all tasks of that batch have finished (it may run other work
+ * meanwhile). Batches may be submitted from several threads at once.
+ */
+typedef void (*glyph_task_func_t)(void* arg, size_t index);
+typedef void* (*glyph_executor_submit_t)(void* user, glyph_task_func_t func, void* arg, size_t count);
+typedef void (*glyph_executor_wait_t)(void* user, void* batch);
+
+typedef struct {
+    glyph_executor_submit_t submit;   /* Schedules a batch of tasks (NULL = serial) */
+    glyph_executor_wait_t wait;       /* Blocks until a batch has finished */
+    void* user;                       /* Passed through to submit and wait */
+} glyph_executor_t;
+
+static glyph_executor_t glyph__executor = {NULL, NULL, NULL};
+
+/*
+ * Routes the library's parallel work through a host job system
+ *
+ * Call during startup, before any GlyphGL work is in flight; like the rest
+ * of the library state the executor is per translation unit. Passing NULL
+ * for submit restores serial execution.
+ *
+ * Parameters:
+ *   submit: Schedules a batch of tasks and returns its handle
+ *   wait: Blocks until the tasks of a batch have finished (may be NULL if submit runs them synchronously)
+ *   user: Pointer passed through to submit and wait
+ */
+static inline void glyph_set_executor(glyph_executor_submit_t submit, glyph_executor_wait_t wait, void* user) {
+    glyph__executor.submit = submit;
+    glyph__executor.wait = wait;
+    glyph__executor.user = user;
+}
+
+/* Runs func(arg, i) for i in [0, count) through the executor and waits for all of them */
+static inline void glyph__parallel_for(glyph_task_func_t func, void* arg, size_t count) {
+    if (count == 0) return;
+    if (count == 1 || !glyph__executor.submit) {
+        for (size_t i = 0; i < count; i++) func(arg, i);
+        return;
+    }
+    void* batch = glyph__executor.submit(glyph__executor.user, func, arg, count);
+    if (glyph__executor.wait) glyph__executor.wait(glyph__executor.user, batch);
+}
+
 /*
  * Memory allocation macro - defaults to standard malloc
  *
@@ -55,6 +211,479 @@ static inline uint32_t glyph__bswap32(uint32_t val) {
 #define GLYPH_REALLOC realloc
 #endif
 
+/*
+ * Context-aware allocator with memory accounting
+ *
+ * The GLYPH_MALLOC family is global and never learns the size of a block it
+ * frees. A glyph_allocator_t can instead be handed to
+ * glyph_ttf_load_font_from_file_ex, glyph_atlas_create_ex and
+ * glyph_renderer_create_ex; every allocation those objects make is routed
+ * through its callbacks together with the user pointer, the block size and a
+ * category, and is counted in the allocator's statistics. Layouts, documents
+ * and text views allocate through the allocator of the atlas (or renderer)
+ * they are built on; a line index takes one in its 'allocator' field.
+ *
+ * Any callback left NULL falls back to GLYPH_MALLOC/GLYPH_REALLOC/GLYPH_FREE
+ * (a NULL reallocate with a custom allocate is emulated with
+ * allocate/copy/deallocate), so a zeroed allocator only does accounting.
+ * Counters are updated atomically and one allocator may be shared by objects
+ * used on different threads; the callbacks must then be thread-safe too.
+ * Statistics count the bytes requested by the library; the sizes passed to
+ * the callbacks include a small per-block header.
+ */
+typedef enum {
+    GLYPH_MEMORY_FONT = 0,      /* Font file data */
+    GLYPH_MEMORY_ATLAS,         /* Atlas image, glyph tables and kerning pairs */
+    GLYPH_MEMORY_SCRATCH,       /* Rasterizer, SDF and upload temporaries */
+    GLYPH_MEMORY_VERTEX,        /* Vertex batches, command lists and text caches */
+    GLYPH_MEMORY_LAYOUT,        /* Layouts, documents, line indexes and text view rows */
+    GLYPH_MEMORY_CATEGORIES
+} glyph_memory_category_t;
+
+typedef void* (*glyph_allocate_func_t)(void* user, size_t size, glyph_memory_category_t category);
+typedef void* (*glyph_reallocate_func_t)(void* user, void* ptr, size_t old_size, size_t new_size, glyph_memory_category_t category);
+typedef void (*glyph_deallocate_func_t)(void* user, void* ptr, size_t size, glyph_memory_category_t category);
+
+typedef struct {
+    size_t current;                                 /* Bytes currently allocated */
+    size_t peak;                                    /* Highest value of current */
+    size_t category_current[GLYPH_MEMORY_CATEGORIES];
+    size_t category_peak[GLYPH_MEMORY_CATEGORIES];
+    size_t allocations;                             /* Live blocks */
+} glyph_memory_stats_t;
+
+typedef struct {
+    glyph_allocate_func_t allocate;       /* NULL = GLYPH_MALLOC */
+    glyph_reallocate_func_t reallocate;   /* NULL = GLYPH_REALLOC or emulated */
+    glyph_deallocate_func_t deallocate;   /* NULL = GLYPH_FREE */
+    void* user;                           /* Passed through to the callbacks */
+    glyph_memory_stats_t stats;           /* Updated atomically; read with glyph_allocator_get_stats */
+} glyph_allocator_t;
+
+#if defined(_MSC_VER)
+    #if defined(_WIN64)
+        #define GLYPH__MEM_ADD(p, d) ((size_t)_InterlockedExchangeAdd64((volatile __int64*)(p), (__int64)(d)) + (size_t)(d))
+        #define GLYPH__MEM_CAS(p, e, d) (_InterlockedCompareExchange64((volatile __int64*)(p), (__int64)(d), (__int64)(e)) == (__int64)(e))
+    #else
+        #define GLYPH__MEM_ADD(p, d) ((size_t)_InterlockedExchangeAdd((volatile long*)(p), (long)(d)) + (size_t)(d))
+        #define GLYPH__MEM_CAS(p, e, d) (_InterlockedCompareExchange((volatile long*)(p), (long)(d), (long)(e)) == (long)(e))
+    #endif
+    #define GLYPH__MEM_LOAD(p) (*(const volatile size_t*)(p))
+#elif defined(__GNUC__) || defined(__clang__)
+    #define GLYPH__MEM_ADD(p, d) __atomic_add_fetch((p), (size_t)(d), __ATOMIC_RELAXED)
+    #define GLYPH__MEM_CAS(p, e, d) glyph__mem_cas((p), (e), (d))
+    #define GLYPH__MEM_LOAD(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+    static inline int glyph__mem_cas(size_t* p, size_t expected, size_t desired) {
+        return __atomic_compare_exchange_n(p, &expected, desired, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+    }
+#else
+    #define GLYPH__MEM_ADD(p, d) (*(p) += (size_t)(d))
+    #define GLYPH__MEM_CAS(p, e, d) (*(p) == (e) ? (*(p) = (d), 1) : 0)
+    #define GLYPH__MEM_LOAD(p) (*(p))
+#endif
+
+/* Per-block header; the union keeps the payload at malloc alignment */
+typedef union {
+    struct {
+        size_t size;
+        glyph_memory_category_t category;
+    } info;
+    long double align;
+} glyph__mem_header_t;
+
+/*
+ * Prepares an allocator with the given callbacks and zeroed statistics
+ *
+ * Parameters:
+ *   allocator: Allocator to initialize
+ *   allocate, reallocate, deallocate: Callbacks (each may be NULL)
+ *   user: Pointer passed through to the callbacks
+ */
+static inline void glyph_allocator_init(glyph_allocator_t* allocator, glyph_allocate_func_t allocate,
+                                        glyph_reallocate_func_t reallocate, glyph_deallocate_func_t deallocate, void* user) {
+    memset(allocator, 0, sizeof(*allocator));
+    allocator->allocate = allocate;
+    allocator->reallocate = reallocate;
+    allocator->deallocate = deallocate;
+    allocator->user = user;
+}
+
+/*
+ * Returns a snapshot of an allocator's statistics
+ *
+ * Safe to call while other threads allocate; each counter is read
+ * atomically, though the snapshot as a whole is not.
+ */
+static inline glyph_memory_stats_t glyph_allocator_get_stats(const glyph_allocator_t* allocator) {
+    glyph_memory_stats_t stats;
+    stats.current = GLYPH__MEM_LOAD(&allocator->stats.current);
+    stats.peak = GLYPH__MEM_LOAD(&allocator->stats.peak);
+    for (int i = 0; i < GLYPH_MEMORY_CATEGORIES; i++) {
+        stats.category_current[i] = GLYPH__MEM_LOAD(&allocator->stats.category_current[i]);
+        stats.category_peak[i] = GLYPH__MEM_LOAD(&allocator->stats.category_peak[i]);
+    }
+    stats.allocations = GLYPH__MEM_LOAD(&allocator->stats.allocations);
+    return stats;
+}
+
+/* Lowers every peak to the current value, e.g. to measure a single frame */
+static inline void glyph_allocator_reset_peak(glyph_allocator_t* allocator) {
+    allocator->stats.peak = GLYPH__MEM_LOAD(&allocator->stats.current);
+    for (int i = 0; i < GLYPH_MEMORY_CATEGORIES; i++) {
+        allocator->stats.category_peak[i] = GLYPH__MEM_LOAD(&allocator->stats.category_current[i]);
+    }
+}
+
+static inline void glyph__mem_raise_peak(size_t* peak, size_t value) {
+    size_t seen = GLYPH__MEM_LOAD(peak);
+    while (value > seen && !GLYPH__MEM_CAS(peak, seen, value)) {
+        seen = GLYPH__MEM_LOAD(peak);
+    }
+}
+
+static inline void glyph__mem_account(glyph_allocator_t* a, glyph_memory_category_t category, size_t added, size_t removed) {
+    size_t delta = added - removed;  /* Wraps for net frees, which unsigned addition undoes */
+    size_t current = GLYPH__MEM_ADD(&a->stats.category_current[category], delta);
+    size_t total = GLYPH__MEM_ADD(&a->stats.current, delta);
+    if (added > removed) {
+        glyph__mem_raise_peak(&a->stats.category_peak[category], current);
+        glyph__mem_raise_peak(&a->stats.peak, total);
+    }
+}
+
+/*
+ * Recovers the header in front of a block from glyph__mem_alloc
+ *
+ * Steps back through uintptr_t rather than 'header - 1' so the compiler does
+ * not tie the result to the payload pointer and flag an out-of-bounds access.
+ */
+static inline glyph__mem_header_t* glyph__mem_header(void* ptr) {
+    return (glyph__mem_header_t*)((uintptr_t)ptr - sizeof(glyph__mem_header_t));
+}
+
+/*
+ * Internal allocation entry points
+ *
+ * With a NULL allocator these are exactly GLYPH_MALLOC/GLYPH_REALLOC/
+ * GLYPH_FREE, so objects created without one behave as before. Blocks must
+ * be released through the same allocator that produced them.
+ */
+static inline void* glyph__mem_alloc(glyph_allocator_t* a, size_t size, glyph_memory_category_t category) {
+    if (!a) return GLYPH_MALLOC(size);
+    size_t total = sizeof(glyph__mem_header_t) + size;
+    glyph__mem_header_t* header = (glyph__mem_header_t*)(a->allocate ? a->allocate(a->user, total, category) : GLYPH_MALLOC(total));
+    if (!header) return NULL;
+    header->info.size = size;
+    header->info.category = category;
+    glyph__mem_account(a, category, size, 0);
+    GLYPH__MEM_ADD(&a->stats.allocations, 1);
+    return header + 1;
+}
+
+static inline void glyph__mem_free(glyph_allocator_t* a, void* ptr) {
+    if (!ptr) return;
+    if (!a) {
+        GLYPH_FREE(ptr);
+        return;
+    }
+    glyph__mem_header_t* header = glyph__mem_header(ptr);
+    size_t size = header->info.size;
+    glyph_memory_category_t category = header->info.category;
+    glyph__mem_account(a, category, 0, size);
+    GLYPH__MEM_ADD(&a->stats.allocations, (size_t)0 - 1);
+    if (a->deallocate) a->deallocate(a->user, header, sizeof(glyph__mem_header_t) + size, category);
+    else GLYPH_FREE(header);
+}
+
+/* Like realloc; a NULL ptr allocates in 'category', otherwise the block keeps its category */
+static inline void* glyph__mem_realloc(glyph_allocator_t* a, void* ptr, size_t size, glyph_memory_category_t category) {
+    if (!a) return GLYPH_REALLOC(ptr, size);
+    if (!ptr) return glyph__mem_alloc(a, size, category);
+
+    glyph__mem_header_t* header = glyph__mem_header(ptr);
+    size_t old_size = header->info.size;
+    category = header->info.category;
+    size_t old_total = sizeof(glyph__mem_header_t) + old_size;
+    size_t total = sizeof(glyph__mem_header_t) + size;
+
+    glyph__mem_header_t* grown;
+    if (a->reallocate) {
+        grown = (glyph__mem_header_t*)a->reallocate(a->user, header, old_total, total, category);
+    } else if (!a->allocate && !a->deallocate) {
+        grown = (glyph__mem_header_t*)GLYPH_REALLOC(header, total);
+    } else {
+        grown = (glyph__mem_header_t*)(a->allocate ? a->allocate(a->user, total, category) : GLYPH_MALLOC(total));
+        if (grown) {
+            memcpy(grown, header, old_size < size ? old_total : total);
+            if (a->deallocate) a->deallocate(a->user, header, old_total, category);
+            else GLYPH_FREE(header);
+        }
+    }
+    if (!grown) return NULL;
+    grown->info.size = size;
+    glyph__mem_account(a, category, size, old_size);
+    return grown + 1;
+}
+
+/*
+ * Monotonic clock in nanoseconds, used by the GLYPHGL_STATS timers
+ *
+ * Uses QueryPerformanceCounter on Windows and clock_gettime(CLOCK_MONOTONIC)
+ * where the C library declares it; strict ISO builds without POSIX fall back
+ * to the much coarser clock().
+ */
+#if defined(_WIN32)
+    #include <windows.h>
+    static inline uint64_t glyph__now_ns(void) {
+        LARGE_INTEGER frequency, counter;
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&counter);
+        return (uint64_t)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+    }
+#else
+    #include <time.h>
+    static inline uint64_t glyph__now_ns(void) {
+    #if defined(CLOCK_MONOTONIC)
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+    #else
+        return (uint64_t)((double)clock() * 1e9 / CLOCKS_PER_SEC);
+    #endif
+    }
+#endif
+
+/*
+ * Performance counters (GLYPHGL_STATS)
+ *
+ * Define GLYPHGL_STATS before including GlyphGL to time the atlas build
+ * phases and count per-frame GPU work; atlases and renderers then carry a
+ * glyph_stats_t read with glyph_atlas_get_stats/glyph_renderer_get_stats.
+ * Without it the instrumentation compiles to nothing and the getters return
+ * zeros.
+ *
+ * Rasterization and SDF times are summed over glyphs, so with an executor
+ * they are CPU time across threads rather than wall time.
+ *
+ * GLYPHGL_GPU_TIMERS (which implies GLYPHGL_STATS) additionally wraps the
+ * renderer's draws and atlas upload in GL_TIME_ELAPSED queries. Their results
+ * are read GLYPHGL_GPU_TIMER_FRAMES - 1 frames later, only once available, so
+ * the GPU is never waited on. Draw times are filed under the renderer's effect
+ * type so that renderers with different shaders can be compared or summed.
+ */
+#define GLYPH_STATS_EFFECT_TYPES 8  /* Entries of gpu_draw_ns: one per glyph_effect_type_t (glyph_effect.h) */
+
+#if defined(GLYPHGL_GPU_TIMERS) && !defined(GLYPHGL_STATS)
+    #define GLYPHGL_STATS
+#endif
+
+typedef struct {
+    /* Atlas build and renderer creation, nanoseconds */
+    uint64_t font_load_ns;          /* Reading and parsing the font file */
+    uint64_t cmap_lookup_ns;        /* Codepoint to glyph index mapping */
+    uint64_t rasterize_ns;          /* Outline rasterization (summed over glyphs) */
+    uint64_t sdf_ns;                /* SDF conversion (summed over glyphs) */
+    uint64_t pack_ns;               /* Sorting, packing and blitting into the atlas image */
+    uint64_t upload_ns;             /* Atlas texture upload */
+    /* Per frame, reset by glyph_renderer_begin_frame */
+    uint64_t glyphs_emitted;        /* Quads drawn: glyphs and decoration rectangles (vertices / 6) */
+    uint64_t bytes_uploaded;        /* Vertex bytes sent with glBufferSubData */
+    uint64_t draw_calls;            /* glDrawArrays calls */
+    uint64_t uniform_updates;       /* glUniform calls */
+    /* GPU timer queries (GLYPHGL_GPU_TIMERS), nanoseconds of GPU time */
+    uint64_t gpu_upload_ns;         /* Atlas texture upload */
+    uint64_t gpu_draw_ns[GLYPH_STATS_EFFECT_TYPES]; /* Draws of the last resolved frame, by effect type */
+    uint64_t gpu_frames_resolved;   /* Frames whose draw times were read */
+    uint64_t gpu_frames_dropped;    /* Frames whose results were not ready when their queries were reused */
+    uint64_t gpu_untimed_draws;     /* Draws beyond GLYPHGL_GPU_TIMER_QUERIES in one frame */
+} glyph_stats_t;
+
+#ifdef GLYPHGL_STATS
+    #define GLYPH__STATS_BEGIN(t) uint64_t t = glyph__now_ns()
+    #define GLYPH__STATS_END(t, dst) ((dst) += glyph__now_ns() - (t))
+    #define GLYPH__STATS_ADD(dst, n) ((dst) += (uint64_t)(n))
+#else
+    #define GLYPH__STATS_BEGIN(t) ((void)0)
+    #define GLYPH__STATS_END(t, dst) ((void)0)
+    #define GLYPH__STATS_ADD(dst, n) ((void)0)
+#endif
+
+/*
+ * Timeline tracing (GLYPHGL_TRACE)
+ *
+ * Define GLYPHGL_TRACE to record spans around font loading, per-glyph
+ * rasterization and SDF conversion, atlas packing, texture upload and every
+ * draw call. Recording starts with glyph_trace_enable(1); while disabled a
+ * span costs one flag test. Without GLYPHGL_TRACE the hooks compile to
+ * nothing.
+ *
+ * Each thread appends complete events (name, start, duration) to its own
+ * ring of GLYPHGL_TRACE_RING_SIZE events without locks; once full, the
+ * oldest events are overwritten. glyph_trace_write_json dumps all rings in
+ * the Chrome trace-event format, loadable in chrome://tracing and Perfetto.
+ * Threads are numbered in the order they first record an event.
+ */
+#ifdef GLYPHGL_TRACE
+
+#include <stdio.h>
+
+#ifndef GLYPHGL_TRACE_RING_SIZE
+#define GLYPHGL_TRACE_RING_SIZE 8192   /* Events kept per thread (power of two) */
+#endif
+
+typedef struct {
+    const char* name;        /* Static span name */
+    const char* arg_name;    /* Static argument name (NULL = no argument) */
+    uint64_t start_ns;       /* glyph__now_ns() at the start of the span */
+    uint64_t end_ns;         /* glyph__now_ns() at the end of the span */
+    long arg;                /* Argument value (codepoint, vertex count, ...) */
+} glyph_trace_event_t;
+
+typedef struct glyph_trace_ring {
+    glyph_trace_event_t events[GLYPHGL_TRACE_RING_SIZE];
+    volatile size_t head;            /* Events ever written; published with release order */
+    int tid;                         /* Trace thread number */
+    struct glyph_trace_ring* next;   /* Registry link */
+} glyph_trace_ring_t;
+
+#if defined(_MSC_VER)
+    #define GLYPH__THREAD_LOCAL __declspec(thread)
+    #define GLYPH__TRACE_PUBLISH(p, v) (*(p) = (v))   /* volatile accesses have acquire/release semantics */
+    #define GLYPH__TRACE_READ(p) (*(p))
+    #define GLYPH__TRACE_PUSH(head, ring) \
+        do { (ring)->next = (glyph_trace_ring_t*)(head); } \
+        while (_InterlockedCompareExchangePointer((void* volatile*)&(head), (ring), (ring)->next) != (ring)->next)
+#elif defined(__GNUC__) || defined(__clang__)
+    #define GLYPH__THREAD_LOCAL __thread
+    #define GLYPH__TRACE_PUBLISH(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+    #define GLYPH__TRACE_READ(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+    #define GLYPH__TRACE_PUSH(head, ring) \
+        do { (ring)->next = __atomic_load_n(&(head), __ATOMIC_ACQUIRE); } \
+        while (!__atomic_compare_exchange_n(&(head), &(ring)->next, (ring), 0, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE))
+#else
+    #define GLYPH__THREAD_LOCAL
+    #define GLYPH__TRACE_PUBLISH(p, v) (*(p) = (v))
+    #define GLYPH__TRACE_READ(p) (*(p))
+    #define GLYPH__TRACE_PUSH(head, ring) ((ring)->next = (head), (head) = (ring))
+#endif
+
+static volatile long glyph__trace_enabled = 0;
+static volatile long glyph__trace_generation = 0;
+static volatile long glyph__trace_threads = 0;
+static glyph_trace_ring_t* volatile glyph__trace_rings = NULL;
+static GLYPH__THREAD_LOCAL glyph_trace_ring_t* glyph__trace_ring = NULL;
+static GLYPH__THREAD_LOCAL long glyph__trace_ring_generation = 0;
+
+/* Starts or stops recording; events already recorded are kept */
+static inline void glyph_trace_enable(int enabled) {
+    GLYPH__ONCE_STORE(&glyph__trace_enabled, enabled ? 1 : 0);
+}
+
+/* Returns a span start time, or 0 when recording is disabled */
+static inline uint64_t glyph__trace_begin(void) {
+    return GLYPH__ONCE_LOAD(&glyph__trace_enabled) ? glyph__now_ns() : 0;
+}
+
+/* Records a span started by glyph__trace_begin into the calling thread's ring */
+static inline void glyph__trace_end(uint64_t start_ns, const char* name, const char* arg_name, long arg) {
+    if (!start_ns) return;
+    uint64_t end_ns = glyph__now_ns();
+
+    glyph_trace_ring_t* ring = glyph__trace_ring;
+    long generation = GLYPH__ONCE_LOAD(&glyph__trace_generation);
+    if (!ring || glyph__trace_ring_generation != generation) {
+        /* First event of this thread (or since glyph_trace_shutdown): register a ring */
+        ring = (glyph_trace_ring_t*)GLYPH_MALLOC(sizeof(glyph_trace_ring_t));
+        if (!ring) return;
+        ring->head = 0;
+#if defined(_MSC_VER)
+        ring->tid = (int)_InterlockedIncrement(&glyph__trace_threads);
+#elif defined(__GNUC__) || defined(__clang__)
+        ring->tid = (int)__atomic_add_fetch(&glyph__trace_threads, 1, __ATOMIC_RELAXED);
+#else
+        ring->tid = (int)++glyph__trace_threads;
+#endif
+        GLYPH__TRACE_PUSH(glyph__trace_rings, ring);
+        glyph__trace_ring = ring;
+        glyph__trace_ring_generation = generation;
+    }
+
+    size_t head = ring->head;
+    glyph_trace_event_t* e = &ring->events[head & (GLYPHGL_TRACE_RING_SIZE - 1)];
+    e->name = name;
+    e->arg_name = arg_name;
+    e->start_ns = start_ns;
+    e->end_ns = end_ns;
+    e->arg = arg;
+    GLYPH__TRACE_PUBLISH(&ring->head, head + 1);
+}
+
+/*
+ * Writes all recorded events as Chrome trace-event JSON
+ *
+ * Best called while no thread is recording. Events being overwritten during
+ * the dump are skipped, but a thread that is recording concurrently may
+ * still race with the reader on the oldest slots of its ring.
+ *
+ * Parameters:
+ *   path: Output file path
+ *
+ * Returns: 0 on success, -1 on failure
+ */
+static inline int glyph_trace_write_json(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) return -1;
+    fprintf(f, "{\"traceEvents\":[");
+    int first = 1;
+    for (glyph_trace_ring_t* ring = GLYPH__TRACE_READ(&glyph__trace_rings); ring; ring = ring->next) {
+        size_t head = GLYPH__TRACE_READ(&ring->head);
+        size_t begin = head > GLYPHGL_TRACE_RING_SIZE ? head - GLYPHGL_TRACE_RING_SIZE : 0;
+        fprintf(f, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"glyph thread %d\"}}",
+                first ? "" : ",", ring->tid, ring->tid);
+        first = 0;
+        for (size_t i = begin; i < head; i++) {
+            glyph_trace_event_t e = ring->events[i & (GLYPHGL_TRACE_RING_SIZE - 1)];
+            /* Skip slots the owner may have overwritten while we copied them */
+            size_t now = GLYPH__TRACE_READ(&ring->head);
+            if (now > GLYPHGL_TRACE_RING_SIZE && i < now - GLYPHGL_TRACE_RING_SIZE) continue;
+            fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"glyphgl\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f",
+                    e.name, ring->tid, e.start_ns / 1000.0, (e.end_ns - e.start_ns) / 1000.0);
+            if (e.arg_name) fprintf(f, ",\"args\":{\"%s\":%ld}", e.arg_name, e.arg);
+            fprintf(f, "}");
+        }
+    }
+    fprintf(f, "\n]}\n");
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+/*
+ * Drops all recorded events and frees the per-thread rings
+ *
+ * Call only while no thread is recording. Threads get a fresh ring (and a
+ * new thread number) on their next event.
+ */
+static inline void glyph_trace_shutdown(void) {
+    glyph_trace_ring_t* ring = glyph__trace_rings;
+    glyph__trace_rings = NULL;
+    while (ring) {
+        glyph_trace_ring_t* next = ring->next;
+        GLYPH_FREE(ring);
+        ring = next;
+    }
+    GLYPH__ONCE_STORE(&glyph__trace_generation, glyph__trace_generation + 1);
+    glyph__trace_ring = NULL;
+}
+
+#define GLYPH__TRACE_BEGIN(t) uint64_t t = glyph__trace_begin()
+#define GLYPH__TRACE_END(t, name, arg_name, arg) glyph__trace_end((t), (name), (arg_name), (long)(arg))
+
+#else
+
+#define GLYPH__TRACE_BEGIN(t) ((void)0)
+#define GLYPH__TRACE_END(t, name, arg_name, arg) ((void)0)
+
+#endif
+
 /*
  * Debug logging macro - conditionally compiled based on GLYPHGL_DEBUG
  *
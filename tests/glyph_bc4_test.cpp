@@ -0,0 +1,168 @@
+/*
+ * GlyphGL BC4 encoder test
+ *
+ * Compresses coverage-like, smooth, noisy and solid images with
+ * glyph_image_encode_bc4 and decodes them with the reference BC4 (RGTC1)
+ * rules below. Every texel must come back within the step of its block's
+ * palette: half a step plus rounding in the 8-value mode (a0 > a1), and in
+ * the 6-value mode (a0 <= a1) 0 and 255 must be exact. Sizes that are not
+ * multiples of 4 check the edge blocks, and a tall image checks that the
+ * parallel bands give the same bytes as the serial encoder.
+ *
+ * Build:  g++ -O2 -std=c++11 -I.. glyph_bc4_test.cpp -o glyph_bc4_test
+ * Run:    ./glyph_bc4_test   (exit status 0 on success)
+ */
+
+#include <glyph_image.h>
+
+#include <string>
+#include <vector>
+
+static int g_failures = 0;
+
+static void check(bool ok, const std::string& what) {
+    printf("%s: %s\n", ok ? "ok  " : "FAIL", what.c_str());
+    if (!ok) g_failures++;
+}
+
+static uint32_t g_rng = 12345u;
+
+static uint32_t next_random() {
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return g_rng >> 8;
+}
+
+struct DecodeStats {
+    size_t blocks_8_value, blocks_6_value;
+    double worst_excess;    /* Largest error beyond the bound (<= 0 when all texels are within it) */
+    int max_error;
+};
+
+/* Decodes BC4 blocks as a GPU would and checks every texel against its palette step */
+static std::vector<unsigned char> decode_bc4(const std::vector<unsigned char>& blocks, const std::vector<unsigned char>& source,
+                                             unsigned width, unsigned height, DecodeStats& stats) {
+    std::vector<unsigned char> out((size_t)width * height);
+    unsigned blocks_x = (width + 3) / 4, blocks_y = (height + 3) / 4;
+    for (unsigned by = 0; by < blocks_y; by++) {
+        for (unsigned bx = 0; bx < blocks_x; bx++) {
+            const unsigned char* block = &blocks[((size_t)by * blocks_x + bx) * 8];
+            int a0 = block[0], a1 = block[1];
+            double palette[8] = {(double)a0, (double)a1};
+            double step;
+            if (a0 > a1) {
+                for (int i = 2; i < 8; i++) palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7.0;
+                step = (a0 - a1) / 7.0;
+                stats.blocks_8_value++;
+            } else {
+                for (int i = 2; i < 6; i++) palette[i] = ((6 - i) * a0 + (i - 1) * a1) / 5.0;
+                palette[6] = 0.0;
+                palette[7] = 255.0;
+                step = (a1 - a0) / 5.0;
+                stats.blocks_6_value++;
+            }
+            uint64_t bits = 0;
+            for (int i = 0; i < 6; i++) bits |= (uint64_t)block[2 + i] << (8 * i);
+            for (int t = 0; t < 16; t++) {
+                unsigned x = bx * 4 + t % 4, y = by * 4 + t / 4;
+                if (x >= width || y >= height) continue;
+                int value = (int)(palette[(bits >> (3 * t)) & 7] + 0.5);
+                int source_value = source[(size_t)y * width + x];
+                int error = abs(value - source_value);
+                /* In the 6-value mode 0 and 255 have exact entries; otherwise half a step, plus one for rounding */
+                double bound = a0 <= a1 && (source_value == 0 || source_value == 255) ? 0.0 : step / 2.0 + 1.0;
+                if (error - bound > stats.worst_excess) stats.worst_excess = error - bound;
+                if (error > stats.max_error) stats.max_error = error;
+                out[(size_t)y * width + x] = (unsigned char)value;
+            }
+        }
+    }
+    return out;
+}
+
+/* Fills an image with one of the test contents */
+static std::vector<unsigned char> make_image(int content, unsigned width, unsigned height) {
+    std::vector<unsigned char> pixels((size_t)width * height);
+    for (unsigned y = 0; y < height; y++) {
+        for (unsigned x = 0; x < width; x++) {
+            int v;
+            switch (content) {
+                case 0: {
+                    /* Antialiased disc edges: 0 and 255 with ramps between, as in coverage atlases */
+                    double dx = x - width * 0.5, dy = y - height * 0.45;
+                    double d = sqrt(dx * dx + dy * dy) - width * 0.3;
+                    v = d <= -1.5 ? 255 : d >= 1.5 ? 0 : (int)((1.5 - d) / 3.0 * 255.0);
+                    break;
+                }
+                case 1: v = (int)(x * 255 / (width > 1 ? width - 1 : 1) + y) & 255; break;   /* Smooth ramps */
+                case 2: v = (int)(next_random() & 255); break;                                /* Noise */
+                case 3: v = next_random() % 3 == 0 ? 0 : next_random() % 2 ? 255 : 60 + (int)(next_random() % 100); break;
+                default: v = 200; break;                                                       /* Solid */
+            }
+            pixels[(size_t)y * width + x] = (unsigned char)v;
+        }
+    }
+    return pixels;
+}
+
+/* Executor running every task synchronously, last first, like an out-of-order pool */
+static void* reverse_submit(void* user, glyph_task_func_t func, void* arg, size_t count) {
+    (void)user;
+    for (size_t i = count; i-- > 0;) func(arg, i);
+    return NULL;
+}
+
+int main() {
+    const char* contents[] = {"coverage", "ramps", "noise", "mixed", "solid"};
+    const unsigned sizes[][2] = {{1, 1}, {3, 2}, {4, 4}, {37, 13}, {64, 64}, {130, 71}};
+    DecodeStats total;
+    memset(&total, 0, sizeof(total));
+
+    for (int content = 0; content < 5; content++) {
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            unsigned width = sizes[s][0], height = sizes[s][1];
+            std::vector<unsigned char> pixels = make_image(content, width, height);
+            std::vector<unsigned char> blocks(glyph_image_bc4_size(width, height));
+            glyph_image_encode_bc4(pixels.data(), width, height, blocks.data());
+
+            DecodeStats stats;
+            memset(&stats, 0, sizeof(stats));
+            std::vector<unsigned char> decoded = decode_bc4(blocks, pixels, width, height, stats);
+            std::string what = std::string(contents[content]) + " " + std::to_string(width) + "x" + std::to_string(height) +
+                               " within the palette step (max error " + std::to_string(stats.max_error) + ")";
+            check(stats.worst_excess <= 0.0, what);
+            if (content == 4) check(decoded == pixels, "solid " + std::to_string(width) + "x" + std::to_string(height) + " is exact");
+
+            total.blocks_8_value += stats.blocks_8_value;
+            total.blocks_6_value += stats.blocks_6_value;
+        }
+    }
+    check(glyph_image_bc4_size(37, 13) == 10 * 4 * 8, "37x13 takes 10x4 blocks");
+    check(total.blocks_8_value > 0 && total.blocks_6_value > 0,
+          "both endpoint modes used (" + std::to_string(total.blocks_8_value) + " 8-value, " + std::to_string(total.blocks_6_value) +
+              " 6-value blocks)");
+
+    /* A block where only the 6-value mode can be exact at both extremes */
+    {
+        const unsigned char texels[16] = {0, 0, 255, 255, 0, 100, 110, 255, 0, 120, 130, 255, 0, 0, 255, 255};
+        std::vector<unsigned char> pixels(texels, texels + 16), blocks(8);
+        glyph_image_encode_bc4(pixels.data(), 4, 4, blocks.data());
+        DecodeStats stats;
+        memset(&stats, 0, sizeof(stats));
+        decode_bc4(blocks, pixels, 4, 4, stats);
+        check(stats.blocks_6_value == 1 && stats.worst_excess <= 0.0, "0/255 block with mid-range texels picks the 6-value mode");
+    }
+
+    /* Parallel bands (more than GLYPH_BC4__BAND block rows) match the serial encoder */
+    {
+        unsigned width = 45, height = 4 * GLYPH_BC4__BAND * 2 + 7;
+        std::vector<unsigned char> pixels = make_image(3, width, height);
+        std::vector<unsigned char> serial(glyph_image_bc4_size(width, height)), parallel(serial.size());
+        glyph_image_encode_bc4(pixels.data(), width, height, serial.data());
+        glyph_set_executor(reverse_submit, NULL, NULL);
+        glyph_image_encode_bc4(pixels.data(), width, height, parallel.data());
+        glyph_set_executor(NULL, NULL, NULL);
+        check(serial == parallel, "executor output matches serial for " + std::to_string(width) + "x" + std::to_string(height));
+    }
+
+    return g_failures ? 1 : 0;
+}
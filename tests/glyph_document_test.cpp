@@ -0,0 +1,64 @@
+/*
+ * GlyphGL document drawing regression test
+ *
+ * Builds with GLYPHGL_GL_STUB like the renderer benchmark, so it needs no GPU
+ * or display. Draws a document whose single paragraph needs more vertices
+ * than a fresh document view holds, which must grow the view's buffer once
+ * and draw instead of retrying forever.
+ *
+ * Build:  g++ -O2 -std=c++11 -I.. glyph_document_test.cpp -o glyph_document_test
+ * Run:    ./glyph_document_test   (exit status 0 on success)
+ */
+
+#define GLYPHGL_GL_STUB
+#include <glyph.h>
+
+#include "../benchmarks/bench_common.h"
+
+static int g_failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("%s: %s\n", ok ? "ok  " : "FAIL", what);
+    if (!ok) g_failures++;
+}
+
+int main() {
+    const char* font_path = "glyph_document_test.ttf";
+    if (!write_synthetic_font(font_path)) return 1;
+    std::string charset = synthetic_charset();
+    glyph_renderer_t renderer = glyph_renderer_create(font_path, 32.0f, charset.c_str(), GLYPH_UTF8, NULL, 0);
+    remove(font_path);
+    if (!renderer.initialized) {
+        fprintf(stderr, "renderer creation failed\n");
+        return 1;
+    }
+    glyph_renderer_set_projection(&renderer, 800, 600);
+
+    /* One unwrapped paragraph needing several times GLYPHGL_DOCUMENT_BUFFER_VERTICES */
+    const size_t glyphs = GLYPHGL_DOCUMENT_BUFFER_VERTICES / 2;
+    std::string text(glyphs, 'x');
+    glyph_document_t doc;
+    glyph_document_view_t view = glyph_document_view_create();
+    check(glyph_document_init(&doc, &renderer.atlas, 1.0f, NULL) == 0, "document init");
+    check(glyph_document_insert(&doc, 0, text.c_str(), text.size()) == 0, "insert paragraph");
+
+    int emitted = glyph_renderer_draw_document(&renderer, &view, &doc, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0);
+    check(emitted == 1, "paragraph larger than the buffer is drawn");
+    check(view.vbo_vertices >= glyphs * 6, "buffer grew to hold the paragraph");
+
+    /* Bold and underline triple the vertices: the buffer has to grow again */
+    emitted = glyph_renderer_draw_document(&renderer, &view, &doc, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f,
+                                           GLYPHGL_BOLD | GLYPHGL_UNDERLINE);
+    check(emitted == 1, "paragraph redrawn with more vertices per glyph");
+    check(view.vbo_vertices >= glyphs * 18, "buffer grew for the effects");
+
+    emitted = glyph_renderer_draw_document(&renderer, &view, &doc, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f,
+                                           GLYPHGL_BOLD | GLYPHGL_UNDERLINE);
+    check(emitted == 0, "unchanged document is not re-emitted");
+
+    glyph_document_view_free(&view);
+    glyph_document_free(&doc);
+    glyph_renderer_free(&renderer);
+    printf("%s\n", g_failures ? "FAILED" : "all passed");
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,401 @@
+/*
+ * GlyphGL PNG writer and checksum kernel test
+ *
+ * Encodes grayscale, RGB and RGBA images of assorted sizes and contents with
+ * glyph_write_png_pixels_to, serially and through an executor (parallel
+ * chunks joined with glyph__adler32_combine), and decodes them again with
+ * the small independent inflater below: chunk CRCs, the zlib Adler32 and
+ * every pixel must match. The CRC32 and Adler32 kernels (PCLMULQDQ, SSSE3
+ * or ARMv8 where the CPU has them) are compared with the portable ones and
+ * bitwise references over random lengths and split updates.
+ *
+ * Build:  g++ -O2 -std=c++11 -I.. glyph_png_test.cpp -o glyph_png_test
+ * Run:    ./glyph_png_test   (exit status 0 on success)
+ */
+
+#include <glyph_image.h>
+
+#include <string>
+#include <vector>
+
+static int g_failures = 0;
+
+static void check(bool ok, const std::string& what) {
+    printf("%s: %s\n", ok ? "ok  " : "FAIL", what.c_str());
+    if (!ok) g_failures++;
+}
+
+static uint32_t g_rng = 12345u;
+
+static uint32_t next_random() {
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return g_rng >> 8;
+}
+
+/* ---- Reference checksums, one bit and one byte at a time ---------------------------------- */
+
+static uint32_t reference_crc32(uint32_t crc, const unsigned char* data, size_t len) {
+    crc = ~crc;
+    while (len--) {
+        crc ^= *data++;
+        for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
+
+static uint32_t reference_adler32(uint32_t adler, const unsigned char* data, size_t len) {
+    uint32_t a = adler & 0xFFFF, b = adler >> 16;
+    while (len--) {
+        a = (a + *data++) % 65521u;
+        b = (b + a) % 65521u;
+    }
+    return (b << 16) | a;
+}
+
+/* ---- Minimal inflater (RFC 1951), independent of the encoder ------------------------------ */
+
+struct Inflater {
+    const unsigned char* in;
+    size_t len, pos;
+    uint32_t bit_buffer;
+    int bit_count;
+    bool error;
+    std::vector<unsigned char> out;
+};
+
+struct Huffman {
+    short counts[16];     /* Codes per length */
+    short symbols[288];   /* Symbols ordered by code */
+};
+
+static int read_bits(Inflater& s, int n) {
+    while (s.bit_count < n) {
+        if (s.pos >= s.len) {
+            s.error = true;
+            return 0;
+        }
+        s.bit_buffer |= (uint32_t)s.in[s.pos++] << s.bit_count;
+        s.bit_count += 8;
+    }
+    int v = (int)(s.bit_buffer & ((1u << n) - 1));
+    s.bit_buffer >>= n;
+    s.bit_count -= n;
+    return v;
+}
+
+/* Returns: false if the lengths over-subscribe the code space */
+static bool build_huffman(Huffman& h, const short* lengths, int n) {
+    short offsets[16];
+    memset(h.counts, 0, sizeof(h.counts));
+    for (int i = 0; i < n; i++) h.counts[lengths[i]]++;
+    int left = 1;
+    for (int len = 1; len < 16; len++) {
+        left = (left << 1) - h.counts[len];
+        if (left < 0) return false;
+    }
+    offsets[1] = 0;
+    for (int len = 1; len < 15; len++) offsets[len + 1] = offsets[len] + h.counts[len];
+    for (int i = 0; i < n; i++)
+        if (lengths[i]) h.symbols[offsets[lengths[i]]++] = (short)i;
+    return true;
+}
+
+static int decode_symbol(Inflater& s, const Huffman& h) {
+    int code = 0, first = 0, index = 0;
+    for (int len = 1; len < 16; len++) {
+        code |= read_bits(s, 1);
+        int count = h.counts[len];
+        if (code - count < first) return h.symbols[index + (code - first)];
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+    s.error = true;
+    return 0;
+}
+
+static void inflate_codes(Inflater& s, const Huffman& lit, const Huffman& dist) {
+    static const short len_base[] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const short len_extra[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static const short dist_base[] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769,
+                                      1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    static const short dist_extra[] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+    while (!s.error) {
+        int symbol = decode_symbol(s, lit);
+        if (symbol < 256) {
+            s.out.push_back((unsigned char)symbol);
+        } else if (symbol == 256) {
+            return;
+        } else {
+            symbol -= 257;
+            if (symbol >= 29) break;
+            size_t length = (size_t)(len_base[symbol] + read_bits(s, len_extra[symbol]));
+            int d = decode_symbol(s, dist);
+            if (d >= 30) break;
+            size_t distance = (size_t)(dist_base[d] + read_bits(s, dist_extra[d]));
+            if (distance > s.out.size()) break;
+            for (size_t i = 0; i < length; i++) s.out.push_back(s.out[s.out.size() - distance]);
+        }
+    }
+    s.error = true;
+}
+
+static bool inflate(const unsigned char* in, size_t len, std::vector<unsigned char>& out) {
+    Inflater s;
+    s.in = in;
+    s.len = len;
+    s.pos = 0;
+    s.bit_buffer = 0;
+    s.bit_count = 0;
+    s.error = false;
+    int last;
+    do {
+        last = read_bits(s, 1);
+        int type = read_bits(s, 2);
+        if (type == 0) {
+            s.bit_buffer = 0;
+            s.bit_count = 0;
+            if (s.pos + 4 > s.len) return false;
+            size_t n = s.in[s.pos] | s.in[s.pos + 1] << 8;
+            if ((n ^ 0xFFFF) != (size_t)(s.in[s.pos + 2] | s.in[s.pos + 3] << 8) || s.pos + 4 + n > s.len) return false;
+            s.out.insert(s.out.end(), s.in + s.pos + 4, s.in + s.pos + 4 + n);
+            s.pos += 4 + n;
+        } else if (type == 1) {
+            short lengths[288 + 30];
+            for (int i = 0; i < 288; i++) lengths[i] = i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8;
+            for (int i = 0; i < 30; i++) lengths[288 + i] = 5;
+            Huffman lit, dist;
+            build_huffman(lit, lengths, 288);
+            build_huffman(dist, lengths + 288, 30);
+            inflate_codes(s, lit, dist);
+        } else if (type == 2) {
+            static const int order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+            int nlen = read_bits(s, 5) + 257, ndist = read_bits(s, 5) + 1, ncode = read_bits(s, 4) + 4;
+            short lengths[320];
+            memset(lengths, 0, sizeof(lengths));
+            for (int i = 0; i < ncode; i++) lengths[order[i]] = (short)read_bits(s, 3);
+            Huffman code_lengths, lit, dist;
+            if (!build_huffman(code_lengths, lengths, 19)) return false;
+            int index = 0;
+            while (index < nlen + ndist && !s.error) {
+                int symbol = decode_symbol(s, code_lengths);
+                if (symbol < 16) {
+                    lengths[index++] = (short)symbol;
+                    continue;
+                }
+                short repeat = 0;
+                int count;
+                if (symbol == 16) {
+                    if (index == 0) return false;
+                    repeat = lengths[index - 1];
+                    count = 3 + read_bits(s, 2);
+                } else {
+                    count = symbol == 17 ? 3 + read_bits(s, 3) : 11 + read_bits(s, 7);
+                }
+                if (index + count > nlen + ndist) return false;
+                while (count--) lengths[index++] = repeat;
+            }
+            if (!build_huffman(lit, lengths, nlen) || !build_huffman(dist, lengths + nlen, ndist)) return false;
+            inflate_codes(s, lit, dist);
+        } else {
+            return false;
+        }
+    } while (!last && !s.error);
+    out.swap(s.out);
+    return !s.error;
+}
+
+/* ---- PNG decoding ------------------------------------------------------------------------- */
+
+static uint32_t read_u32_be(const unsigned char* p) {
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+static int writer_append(void* user, const void* data, size_t len) {
+    std::vector<unsigned char>* out = (std::vector<unsigned char>*)user;
+    out->insert(out->end(), (const unsigned char*)data, (const unsigned char*)data + len);
+    return 0;
+}
+
+/* Decodes an 8-bit gray, RGB or RGBA PNG; returns an empty string on success, else the failure */
+static std::string decode_png(const std::vector<unsigned char>& png, int channels, unsigned width, unsigned height,
+                              std::vector<unsigned char>& pixels) {
+    static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    if (png.size() < 8 || memcmp(png.data(), signature, 8) != 0) return "bad signature";
+    std::vector<unsigned char> idat;
+    bool header = false, end = false;
+    size_t pos = 8;
+    while (pos + 12 <= png.size() && !end) {
+        uint32_t len = read_u32_be(&png[pos]);
+        if (pos + 12 + len > png.size()) return "truncated chunk";
+        const unsigned char* type = &png[pos + 4];
+        const unsigned char* data = type + 4;
+        if (read_u32_be(data + len) != reference_crc32(0, type, len + 4)) return "chunk CRC mismatch";
+        if (!memcmp(type, "IHDR", 4)) {
+            static const int color_types[5] = {0, 0, 0, 2, 6};
+            if (len != 13 || read_u32_be(data) != width || read_u32_be(data + 4) != height || data[8] != 8 ||
+                data[9] != color_types[channels] || data[10] || data[11] || data[12])
+                return "bad IHDR";
+            header = true;
+        } else if (!memcmp(type, "IDAT", 4)) {
+            idat.insert(idat.end(), data, data + len);
+        } else if (!memcmp(type, "IEND", 4)) {
+            end = true;
+        }
+        pos += 12 + len;
+    }
+    if (!header || !end || pos != png.size()) return "missing IHDR or IEND";
+
+    if (idat.size() < 6 || (idat[0] & 0x0F) != 8 || ((idat[0] << 8) | idat[1]) % 31 != 0) return "bad zlib header";
+    std::vector<unsigned char> raw;
+    if (!inflate(idat.data() + 2, idat.size() - 6, raw)) return "inflate failed";
+    if (read_u32_be(&idat[idat.size() - 4]) != reference_adler32(1, raw.data(), raw.size())) return "zlib Adler32 mismatch";
+
+    size_t row_bytes = (size_t)width * channels;
+    if (raw.size() != (row_bytes + 1) * height) return "wrong decompressed size";
+    pixels.assign(row_bytes * height, 0);
+    for (unsigned y = 0; y < height; y++) {
+        const unsigned char* in = &raw[y * (row_bytes + 1)];
+        unsigned char* row = &pixels[y * row_bytes];
+        const unsigned char* up = y ? row - row_bytes : NULL;
+        for (size_t i = 0; i < row_bytes; i++) {
+            int a = i >= (size_t)channels ? row[i - channels] : 0;
+            int b = up ? up[i] : 0;
+            int c = up && i >= (size_t)channels ? up[i - channels] : 0;
+            int predictor;
+            switch (in[0]) {
+                case 0: predictor = 0; break;
+                case 1: predictor = a; break;
+                case 2: predictor = b; break;
+                case 3: predictor = (a + b) / 2; break;
+                case 4: {
+                    int p = a + b - c, pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+                    predictor = pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+                    break;
+                }
+                default: return "bad filter type";
+            }
+            row[i] = (unsigned char)(in[1 + i] + predictor);
+        }
+    }
+    return "";
+}
+
+/* Executor running every task synchronously, last first, like an out-of-order pool */
+static void* reverse_submit(void* user, glyph_task_func_t func, void* arg, size_t count) {
+    (void)user;
+    for (size_t i = count; i-- > 0;) func(arg, i);
+    return NULL;
+}
+
+static void test_png_round_trip() {
+    const unsigned sizes[][2] = {{1, 1}, {3, 2}, {17, 5}, {300, 7}, {7, 300}, {257, 129}, {700, 200}};
+    const char* contents[] = {"random", "gradient", "sparse", "coverage"};
+    for (int parallel = 0; parallel < 2; parallel++) {
+        glyph_set_executor(parallel ? reverse_submit : NULL, NULL, NULL);
+        for (int channels = 1; channels <= 4; channels++) {
+            if (channels == 2) continue;
+            for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+                unsigned width = sizes[s][0], height = sizes[s][1];
+                int content = (int)((s + channels) % 4);
+                std::vector<unsigned char> pixels((size_t)width * height * channels);
+                for (size_t i = 0; i < pixels.size(); i++) {
+                    size_t x = i / channels % width, y = i / channels / width;
+                    switch (content) {
+                        case 0: pixels[i] = (unsigned char)next_random(); break;
+                        case 1: pixels[i] = (unsigned char)(x * 7 + y * 3 + i % channels * 50); break;
+                        case 2: pixels[i] = next_random() % 50 == 0 ? (unsigned char)next_random() : 0; break;
+                        default: pixels[i] = (x / 5 + y / 3) % 4 == 0 ? 255 : x % 13 == 0 ? 128 : 0; break;
+                    }
+                }
+                std::vector<unsigned char> png, decoded;
+                std::string what = std::to_string(channels) + "-channel " + std::to_string(width) + "x" + std::to_string(height) +
+                                   " " + contents[content] + (parallel ? " (executor)" : "") + " round-trips";
+                if (glyph_write_png_pixels_to(writer_append, &png, pixels.data(), width, height, channels) != 0) {
+                    check(false, what + " (write failed)");
+                    continue;
+                }
+                std::string error = decode_png(png, channels, width, height, decoded);
+                if (error.empty() && decoded != pixels) error = "pixels differ";
+                check(error.empty(), error.empty() ? what : what + " (" + error + ")");
+            }
+        }
+    }
+    glyph_set_executor(NULL, NULL, NULL);
+}
+
+/* ---- Checksum kernels --------------------------------------------------------------------- */
+
+static void test_checksums() {
+    std::vector<unsigned char> data(300000);
+    for (size_t i = 0; i < data.size(); i++) data[i] = (unsigned char)next_random();
+    /* A run of 0xFF maximizes the Adler32 sums between reductions */
+    memset(&data[100000], 0xFF, 20000);
+
+    bool crc_ok = true, crc_split_ok = true, adler_ok = true, adler_split_ok = true, combine_ok = true;
+    for (int trial = 0; trial < 400; trial++) {
+        size_t len = trial < 160 ? (size_t)trial : next_random() % data.size();
+        size_t start = next_random() % (data.size() - len + 1);
+        const unsigned char* p = &data[start];
+
+        uint32_t crc = reference_crc32(0, p, len);
+        if (glyph__crc32_update(0, p, len) != crc || (glyph__crc32_slice8(0xFFFFFFFFu, p, len) ^ 0xFFFFFFFFu) != crc) crc_ok = false;
+#ifdef GLYPH_IMAGE__X86
+        if (len >= 64 && (glyph__image_cpu_features() & GLYPH__CPU_PCLMUL)) {
+            size_t bulk = len & ~(size_t)15;
+            uint32_t folded = glyph__crc32_pclmul(0xFFFFFFFFu, p, bulk);
+            if ((glyph__crc32_slice8(folded, p + bulk, len - bulk) ^ 0xFFFFFFFFu) != crc) crc_ok = false;
+        }
+#endif
+#ifdef GLYPH_IMAGE__ARM_CRC32
+        if ((glyph__crc32_armv8(0xFFFFFFFFu, p, len) ^ 0xFFFFFFFFu) != crc) crc_ok = false;
+#endif
+
+        uint32_t adler = reference_adler32(1, p, len);
+        if (glyph__adler32_update(1, p, len) != adler || glyph__adler32_scalar(1, p, len) != adler) adler_ok = false;
+#ifdef GLYPH_IMAGE__X86
+        if (glyph__image_cpu_features() & GLYPH__CPU_SSSE3) {
+            if (glyph__adler32_ssse3(1, p, len) != adler) adler_ok = false;
+        }
+#endif
+
+        /* Split at a random point, and into several pieces */
+        size_t split = len ? next_random() % (len + 1) : 0;
+        if (glyph__crc32_update(glyph__crc32_update(0, p, split), p + split, len - split) != crc) crc_split_ok = false;
+        if (glyph__adler32_update(glyph__adler32_update(1, p, split), p + split, len - split) != adler) adler_split_ok = false;
+        uint32_t crc_pieces = 0, adler_pieces = 1;
+        for (size_t at = 0; at < len;) {
+            size_t n = 1 + next_random() % 3000;
+            if (n > len - at) n = len - at;
+            crc_pieces = glyph__crc32_update(crc_pieces, p + at, n);
+            adler_pieces = glyph__adler32_update(adler_pieces, p + at, n);
+            at += n;
+        }
+        if (crc_pieces != crc) crc_split_ok = false;
+        if (adler_pieces != adler) adler_split_ok = false;
+
+        if (glyph__adler32_combine(glyph__adler32_update(1, p, split), glyph__adler32_update(1, p + split, len - split), len - split) != adler)
+            combine_ok = false;
+    }
+
+    /* Second pieces whose lengths are multiples of the modulus, or just around them */
+    const size_t lengths[] = {0, 1, 65520, 65521, 65522, 131042, 200000};
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        size_t len2 = lengths[i];
+        const unsigned char* p = &data[data.size() - len2 - 777];
+        uint32_t whole = reference_adler32(1, p, len2 + 777);
+        if (glyph__adler32_combine(reference_adler32(1, p, 777), reference_adler32(1, p + 777, len2), len2) != whole) combine_ok = false;
+    }
+
+    check(crc_ok, "CRC32 kernels match the bitwise reference");
+    check(crc_split_ok, "CRC32 split updates match one pass");
+    check(adler_ok, "Adler32 kernels match the bytewise reference");
+    check(adler_split_ok, "Adler32 split updates match one pass");
+    check(combine_ok, "glyph__adler32_combine matches one pass");
+}
+
+int main() {
+    test_checksums();
+    test_png_round_trip();
+    return g_failures ? 1 : 0;
+}